@@ -25,6 +25,7 @@
 #include "AppDelegate.h"
 #include "HelloWorldScene.h"
 #include "GameScene.h"
+#include "views/CardView.h"
 
 // #define USE_AUDIO_ENGINE 1
 // #define USE_SIMPLE_AUDIO_ENGINE 1
@@ -102,6 +103,22 @@ bool AppDelegate::applicationDidFinishLaunching() {
 
     register_all_packages();
 
+    // read the resources from one mapped pack when the build ships one (tools/asset-pack/build_asset_pack.py)
+    auto fileUtils = FileUtils::getInstance();
+    if (fileUtils->isFileExist("res.ccpk"))
+    {
+        fileUtils->addAssetPack("res.ccpk");
+    }
+
+    // pack the loose card images into shared pages, cached in the writable path after the first launch,
+    // so that a full tableau of cards is drawn in one batch
+    auto cardAtlas = RuntimeAtlas::create("card_atlas");
+    for (const auto& path : CardView::getCardTexturePaths())
+    {
+        cardAtlas->addImage(path);
+    }
+    cardAtlas->build();
+
     // create a scene. it's an autorelease object
     auto scene = GameScene::createScene();
 
@@ -36,6 +36,9 @@ bool GameScene::init()
         return false;
     }
     
+    // 场景只用节点变换，一次线性更新所有变化的世界矩阵，不再维护已废弃的矩阵栈
+    setTransformHierarchyEnabled(true);
+    
     // 创建游戏控制器
     _gameController = new GameController();
     
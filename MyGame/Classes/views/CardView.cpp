@@ -25,6 +25,17 @@
 #include "views/CardView.h"
 #include "configs/models/CardTypes.h"
 
+// 优先使用运行时图集中的精灵帧（帧名即图片路径），未打包时回退到散图
+static Sprite* createCardSprite(const std::string& path)
+{
+    SpriteFrame* frame = SpriteFrameCache::getInstance()->getSpriteFrameByName(path);
+    if (frame)
+    {
+        return Sprite::createWithSpriteFrame(frame);
+    }
+    return Sprite::create(path);
+}
+
 CardView::CardView()
     : _cardId(0)
     , _cardModel(nullptr)
@@ -59,8 +70,11 @@ bool CardView::init(const CardModel* cardModel)
     _cardModel = cardModel;
     _cardId = cardModel->getCardId();
     
-    // 加载卡牌背景
-    if (!Sprite::initWithFile(getCardBackgroundPath()))
+    // 加载卡牌背景（与数字、花色在同一图集中时整副牌可合批绘制）
+    std::string backgroundPath = getCardBackgroundPath();
+    SpriteFrame* backgroundFrame = SpriteFrameCache::getInstance()->getSpriteFrameByName(backgroundPath);
+    bool initialized = backgroundFrame ? Sprite::initWithSpriteFrame(backgroundFrame) : Sprite::initWithFile(backgroundPath);
+    if (!initialized)
     {
         return false;
     }
@@ -72,7 +86,7 @@ bool CardView::init(const CardModel* cardModel)
     std::string numberPathSmall = getCardNumberPathSmall();
     if (!numberPathSmall.empty())
     {
-        _numberSprite = Sprite::create(numberPathSmall);
+        _numberSprite = createCardSprite(numberPathSmall);
         if (_numberSprite)
         {
             // 左上角数字位置：更靠近左上角
@@ -87,7 +101,7 @@ bool CardView::init(const CardModel* cardModel)
     std::string suitPath = getCardSuitPath();
     if (!suitPath.empty())
     {
-        _suitSprite = Sprite::create(suitPath);
+        _suitSprite = createCardSprite(suitPath);
         if (_suitSprite)
         {
             // 左上角花色位置：在数字下方稍右
@@ -102,7 +116,7 @@ bool CardView::init(const CardModel* cardModel)
     std::string numberPathBig = getCardNumberPath();
     if (!numberPathBig.empty())
     {
-        Sprite* centerNumberSprite = Sprite::create(numberPathBig);
+        Sprite* centerNumberSprite = createCardSprite(numberPathBig);
         if (centerNumberSprite)
         {
             float cardWidth = getContentSize().width;
@@ -132,6 +146,8 @@ void CardView::reinstallEventListener()
     // 创建新的事件监听器
     auto listener = EventListenerTouchOneByOne::create();
     listener->setSwallowTouches(true);
+    // 只响应落在卡牌内容区域内的触摸，事件分发器可以通过空间索引跳过其他卡牌
+    listener->setHitTestByContentBounds(true);
     listener->onTouchBegan = [this](Touch* touch, Event* event) -> bool {
         Vec2 locationInNode = this->convertToNodeSpace(touch->getLocation());
         Size size = this->getContentSize();
@@ -179,6 +195,27 @@ void CardView::playMoveAnimation(const Vec2& targetPos, float duration, const st
     }
 }
 
+std::vector<std::string> CardView::getCardTexturePaths()
+{
+    static const char* faces[] = {"A", "2", "3", "4", "5", "6", "7", "8", "9", "10", "J", "Q", "K"};
+    static const char* prefixes[] = {"big_red_", "big_black_", "small_red_", "small_black_"};
+    
+    std::vector<std::string> paths;
+    paths.push_back("res/card_general.png");
+    for (const char* prefix : prefixes)
+    {
+        for (const char* face : faces)
+        {
+            paths.push_back(std::string("res/number/") + prefix + face + ".png");
+        }
+    }
+    paths.push_back("res/suits/club.png");
+    paths.push_back("res/suits/diamond.png");
+    paths.push_back("res/suits/heart.png");
+    paths.push_back("res/suits/spade.png");
+    return paths;
+}
+
 std::string CardView::getCardBackgroundPath() const
 {
     return "res/card_general.png";
@@ -85,6 +85,12 @@ public:
      */
     void reinstallEventListener();
     
+    /**
+     * @brief 获取所有卡牌用到的图片路径（背景、数字、花色），用于打包运行时图集
+     * @return 图片路径列表
+     */
+    static std::vector<std::string> getCardTexturePaths();
+    
 protected:
     CardView();
     virtual ~CardView();
@@ -49,8 +49,8 @@ void GameView::initUI()
     playfieldBg->setPosition(origin.x, origin.y + 580);
     addChild(playfieldBg, 0);
     
-    // 创建主牌区（1080x1500，位置在顶部）
-    _playfieldLayer = Layer::create();
+    // 创建主牌区（1080x1500，位置在顶部），牌面静止时缓存顶点，只提交一次绘制
+    _playfieldLayer = RetainedBatchNode::create();
     _playfieldLayer->setContentSize(Size(1080, 1500));
     _playfieldLayer->setPosition(origin.x, origin.y + 580);
     addChild(_playfieldLayer, 1);
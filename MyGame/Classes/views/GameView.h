@@ -118,7 +118,7 @@ public:
 private:
     void initUI();
     
-    Layer* _playfieldLayer;          // 主牌区层
+    Node* _playfieldLayer;           // 主牌区层（静止时整体缓存为一批绘制）
     Layer* _bottomLayer;             // 底部区域层（紫色区域）
     Layer* _reserveArea;             // 备用牌堆区域（左侧）
     Layer* _baseArea;                // 底牌堆区域（右侧）
@@ -42,6 +42,8 @@ Action::Action()
 ,_target(nullptr)
 ,_tag(Action::INVALID_TAG)
 ,_flags(0)
+,_poolType(-1)
+,_poolIndex(-1)
 {
 #if CC_ENABLE_SCRIPT_BINDING
     ScriptEngineProtocol* engine = ScriptEngineManager::getInstance()->getScriptEngine();
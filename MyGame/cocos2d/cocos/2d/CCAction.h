@@ -178,10 +178,15 @@ protected:
     int     _tag;
     /** The action flag field. To categorize action into certain groups.*/
     unsigned int _flags;
+    /** The ActionManager pool that updates this action, -1 when it is updated through step(). */
+    int     _poolType;
+    /** Index of the action's record inside that pool. */
+    int     _poolIndex;
 
 #if CC_ENABLE_SCRIPT_BINDING
     ccScriptType _scriptType;         ///< type of script binding, lua or javascript
 #endif
+    friend class ActionManager;
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Action);
 };
@@ -117,6 +117,7 @@ protected:
     float _elapsed;
     bool _firstTick;
     bool _done;
+    friend class ActionManager;
     
 protected:
     bool sendUpdateEventToScript(float dt, Action *actionObject);
@@ -507,6 +508,7 @@ protected:
     Vec3 _dstAngle;
     Vec3 _startAngle;
     Vec3 _diffAngle;
+    friend class ActionManager;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(RotateTo);
@@ -573,6 +575,7 @@ protected:
     bool _is3D;
     Vec3 _deltaAngle;
     Vec3 _startAngle;
+    friend class ActionManager;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(RotateBy);
@@ -629,6 +632,7 @@ protected:
     Vec3 _positionDelta;
     Vec3 _startPosition;
     Vec3 _previousPosition;
+    friend class ActionManager;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(MoveBy);
@@ -1124,6 +1128,7 @@ protected:
     float _deltaX;
     float _deltaY;
     float _deltaZ;
+    friend class ActionManager;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ScaleTo);
@@ -1264,6 +1269,7 @@ protected:
     GLubyte _fromOpacity;
     friend class FadeOut;
     friend class FadeIn;
+    friend class ActionManager;
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(FadeTo);
 };
@@ -30,6 +30,9 @@ THE SOFTWARE.
 #include "2d/CCActionManager.h"
 #include "2d/CCNode.h"
 #include "2d/CCAction.h"
+#include "2d/CCActionInterval.h"
+#include "2d/CCActionEase.h"
+#include "2d/CCTweenFunction.h"
 #include "base/CCScheduler.h"
 #include "base/ccMacros.h"
 #include "base/ccCArray.h"
@@ -47,15 +50,169 @@ typedef struct _hashElement
     Action              *currentAction;
     bool                currentActionSalvaged;
     bool                paused;
+    int                 pooledCount;
     UT_hash_handle      hh;
 } tHashElement;
 
+//
+// Action pools
+//
+// MoveBy/MoveTo, ScaleTo/ScaleBy, RotateTo/RotateBy and FadeTo/FadeIn/FadeOut, optionally
+// wrapped in one of the plain eases, don't need to go through the virtual step()/update() chain.
+// Their state is copied into contiguous per-type records when they are added, and the records
+// are updated in tight loops. The Action objects stay in the target's actions array so that
+// the tag/flag queries and removal work as before; only the per-frame update is moved.
+//
+enum ActionPoolType
+{
+    kActionPoolNone = -1,
+    kActionPoolPosition,
+    kActionPoolScale,
+    kActionPoolRotation,
+    kActionPoolOpacity,
+};
+
+typedef struct _pooledAction
+{
+    ActionInterval      *action;    // nullptr once the action was removed from the pool
+    Node                *target;
+    tHashElement        *element;
+    float               elapsed;
+    float               duration;
+    bool                firstTick;
+    float               (*easing)(float);
+    float               (*rateEasing)(float, float);
+    float               rate;
+} tPooledAction;
+
+typedef struct _pooledPosition : tPooledAction
+{
+    Vec3                start;
+    Vec3                delta;
+    Vec3                previous;
+} tPooledPosition;
+
+typedef struct _pooledScale : tPooledAction
+{
+    Vec3                start;
+    Vec3                delta;
+} tPooledScale;
+
+typedef struct _pooledRotation : tPooledAction
+{
+    Vec3                start;
+    Vec3                delta;
+    bool                is3D;
+} tPooledRotation;
+
+typedef struct _pooledOpacity : tPooledAction
+{
+    float               from;
+    float               to;
+} tPooledOpacity;
+
+struct _actionPools
+{
+    std::vector<tPooledPosition>    positions;
+    std::vector<tPooledScale>       scales;
+    std::vector<tPooledRotation>    rotations;
+    std::vector<tPooledOpacity>     opacities;
+    std::vector<ActionInterval*>    finished;
+    bool                            hasRemoved;
+    bool                            updating;
+};
+
+namespace {
+
+struct EaseFunction
+{
+    const std::type_info    *type;
+    float                   (*easing)(float);
+    float                   (*rateEasing)(float, float);
+};
+
+// only the eases whose update() is exactly _inner->update(TWEEN_FUNC(time[, _rate]))
+const EaseFunction s_easeFunctions[] =
+{
+    { &typeid(EaseIn), nullptr, tweenfunc::easeIn },
+    { &typeid(EaseOut), nullptr, tweenfunc::easeOut },
+    { &typeid(EaseInOut), nullptr, tweenfunc::easeInOut },
+    { &typeid(EaseExponentialIn), tweenfunc::expoEaseIn, nullptr },
+    { &typeid(EaseExponentialOut), tweenfunc::expoEaseOut, nullptr },
+    { &typeid(EaseExponentialInOut), tweenfunc::expoEaseInOut, nullptr },
+    { &typeid(EaseSineIn), tweenfunc::sineEaseIn, nullptr },
+    { &typeid(EaseSineOut), tweenfunc::sineEaseOut, nullptr },
+    { &typeid(EaseSineInOut), tweenfunc::sineEaseInOut, nullptr },
+    { &typeid(EaseBounceIn), tweenfunc::bounceEaseIn, nullptr },
+    { &typeid(EaseBounceOut), tweenfunc::bounceEaseOut, nullptr },
+    { &typeid(EaseBounceInOut), tweenfunc::bounceEaseInOut, nullptr },
+    { &typeid(EaseBackIn), tweenfunc::backEaseIn, nullptr },
+    { &typeid(EaseBackOut), tweenfunc::backEaseOut, nullptr },
+    { &typeid(EaseBackInOut), tweenfunc::backEaseInOut, nullptr },
+    { &typeid(EaseQuadraticActionIn), tweenfunc::quadraticIn, nullptr },
+    { &typeid(EaseQuadraticActionOut), tweenfunc::quadraticOut, nullptr },
+    { &typeid(EaseQuadraticActionInOut), tweenfunc::quadraticInOut, nullptr },
+    { &typeid(EaseQuarticActionIn), tweenfunc::quartEaseIn, nullptr },
+    { &typeid(EaseQuarticActionOut), tweenfunc::quartEaseOut, nullptr },
+    { &typeid(EaseQuarticActionInOut), tweenfunc::quartEaseInOut, nullptr },
+    { &typeid(EaseQuinticActionIn), tweenfunc::quintEaseIn, nullptr },
+    { &typeid(EaseQuinticActionOut), tweenfunc::quintEaseOut, nullptr },
+    { &typeid(EaseQuinticActionInOut), tweenfunc::quintEaseInOut, nullptr },
+    { &typeid(EaseCircleActionIn), tweenfunc::circEaseIn, nullptr },
+    { &typeid(EaseCircleActionOut), tweenfunc::circEaseOut, nullptr },
+    { &typeid(EaseCircleActionInOut), tweenfunc::circEaseInOut, nullptr },
+    { &typeid(EaseCubicActionIn), tweenfunc::cubicEaseIn, nullptr },
+    { &typeid(EaseCubicActionOut), tweenfunc::cubicEaseOut, nullptr },
+    { &typeid(EaseCubicActionInOut), tweenfunc::cubicEaseInOut, nullptr },
+};
+
+const EaseFunction* findEaseFunction(const std::type_info& type)
+{
+    for (const auto& entry : s_easeFunctions)
+    {
+        if (*entry.type == type)
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+// same timing as ActionInterval::step(), followed by the ease
+inline float stepPooledAction(tPooledAction& record, float dt)
+{
+    if (record.firstTick)
+    {
+        record.firstTick = false;
+        record.elapsed = MATH_EPSILON;
+    }
+    else
+    {
+        record.elapsed += dt;
+    }
+
+    float time = std::max(0.0f, std::min(1.0f, record.elapsed / record.duration));
+    if (record.easing)
+    {
+        time = record.easing(time);
+    }
+    else if (record.rateEasing)
+    {
+        time = record.rateEasing(time, record.rate);
+    }
+    return time;
+}
+
+} // namespace
+
 ActionManager::ActionManager()
 : _targets(nullptr),
   _currentTarget(nullptr),
-  _currentTargetSalvaged(false)
+  _currentTargetSalvaged(false),
+  _pools(new _actionPools())
 {
-
+    _pools->hasRemoved = false;
+    _pools->updating = false;
 }
 
 ActionManager::~ActionManager()
@@ -63,12 +220,14 @@ ActionManager::~ActionManager()
     CCLOGINFO("deallocing ActionManager: %p", this);
 
     removeAllActions();
+    delete _pools;
 }
 
 // private
 
 void ActionManager::deleteHashElement(tHashElement *element)
 {
+    unpoolActionsOfElement(element);
     ccArrayFree(element->actions);
     HASH_DEL(_targets, element);
     element->target->release();
@@ -99,6 +258,7 @@ void ActionManager::removeActionAtIndex(ssize_t index, tHashElement *element)
         element->currentActionSalvaged = true;
     }
 
+    unpoolAction(action);
     ccArrayRemoveObjectAtIndex(element->actions, index, true);
 
     // update actionIndex in case we are in tick. looping over the actions
@@ -194,6 +354,7 @@ void ActionManager::addAction(Action *action, Node *target, bool paused)
      ccArrayAppendObject(element->actions, action);
  
      action->startWithTarget(target);
+     poolAction(action, element);
 }
 
 // remove
@@ -226,6 +387,7 @@ void ActionManager::removeAllActionsFromTarget(Node *target)
             element->currentActionSalvaged = true;
         }
 
+        unpoolActionsOfElement(element);
         ccArrayRemoveAllObjects(element->actions);
         if (_currentTarget == element)
         {
@@ -444,15 +606,17 @@ void ActionManager::update(float dt)
         _currentTarget = elt;
         _currentTargetSalvaged = false;
 
-        if (! _currentTarget->paused)
+        // targets whose actions all live in the pools are updated by updateActionPools()
+        if (! _currentTarget->paused && _currentTarget->pooledCount < _currentTarget->actions->num)
         {
             // The 'actions' MutableArray may change while inside this loop.
             for (_currentTarget->actionIndex = 0; _currentTarget->actionIndex < _currentTarget->actions->num;
                 _currentTarget->actionIndex++)
             {
                 _currentTarget->currentAction = static_cast<Action*>(_currentTarget->actions->arr[_currentTarget->actionIndex]);
-                if (_currentTarget->currentAction == nullptr)
+                if (_currentTarget->currentAction == nullptr || _currentTarget->currentAction->_poolType != kActionPoolNone)
                 {
+                    _currentTarget->currentAction = nullptr;
                     continue;
                 }
 
@@ -499,6 +663,319 @@ void ActionManager::update(float dt)
 
     // issue #635
     _currentTarget = nullptr;
+
+    updateActionPools(dt);
+}
+
+// pools
+
+bool ActionManager::poolAction(Action *action, tHashElement *element)
+{
+    // records can't be added while the pools are iterated, those actions just use step()
+    if (_pools->updating)
+    {
+        return false;
+    }
+#if CC_ENABLE_SCRIPT_BINDING
+    if (action->_scriptType != kScriptTypeNone)
+    {
+        return false;
+    }
+#endif
+
+    // exact types only: subclasses may override update()
+    Action *inner = action;
+    const EaseFunction *ease = findEaseFunction(typeid(*action));
+    if (ease)
+    {
+        inner = static_cast<ActionEase*>(action)->getInnerAction();
+        if (inner == nullptr)
+        {
+            return false;
+        }
+    }
+
+    auto interval = static_cast<ActionInterval*>(action);
+    tPooledAction base;
+    base.action = interval;
+    base.target = action->getTarget();
+    base.element = element;
+    base.elapsed = interval->_elapsed;
+    base.duration = interval->_duration;
+    base.firstTick = interval->_firstTick;
+    base.easing = ease ? ease->easing : nullptr;
+    base.rateEasing = ease ? ease->rateEasing : nullptr;
+    base.rate = (ease && ease->rateEasing) ? static_cast<EaseRateAction*>(action)->getRate() : 0.0f;
+
+    const std::type_info& type = typeid(*inner);
+    if (type == typeid(MoveBy) || type == typeid(MoveTo))
+    {
+        auto move = static_cast<MoveBy*>(inner);
+        tPooledPosition record;
+        static_cast<tPooledAction&>(record) = base;
+        record.start = move->_startPosition;
+        record.delta = move->_positionDelta;
+        record.previous = move->_previousPosition;
+        action->_poolType = kActionPoolPosition;
+        action->_poolIndex = (int)_pools->positions.size();
+        _pools->positions.push_back(record);
+    }
+    else if (type == typeid(ScaleTo) || type == typeid(ScaleBy))
+    {
+        auto scale = static_cast<ScaleTo*>(inner);
+        tPooledScale record;
+        static_cast<tPooledAction&>(record) = base;
+        record.start.set(scale->_startScaleX, scale->_startScaleY, scale->_startScaleZ);
+        record.delta.set(scale->_deltaX, scale->_deltaY, scale->_deltaZ);
+        action->_poolType = kActionPoolScale;
+        action->_poolIndex = (int)_pools->scales.size();
+        _pools->scales.push_back(record);
+    }
+    else if (type == typeid(RotateTo) || type == typeid(RotateBy))
+    {
+        tPooledRotation record;
+        static_cast<tPooledAction&>(record) = base;
+        if (type == typeid(RotateTo))
+        {
+            auto rotate = static_cast<RotateTo*>(inner);
+            record.start = rotate->_startAngle;
+            record.delta = rotate->_diffAngle;
+            record.is3D = rotate->_is3D;
+        }
+        else
+        {
+            auto rotate = static_cast<RotateBy*>(inner);
+            record.start = rotate->_startAngle;
+            record.delta = rotate->_deltaAngle;
+            record.is3D = rotate->_is3D;
+        }
+        action->_poolType = kActionPoolRotation;
+        action->_poolIndex = (int)_pools->rotations.size();
+        _pools->rotations.push_back(record);
+    }
+    else if (type == typeid(FadeTo) || type == typeid(FadeIn) || type == typeid(FadeOut))
+    {
+        auto fade = static_cast<FadeTo*>(inner);
+        tPooledOpacity record;
+        static_cast<tPooledAction&>(record) = base;
+        record.from = fade->_fromOpacity;
+        record.to = fade->_toOpacity;
+        action->_poolType = kActionPoolOpacity;
+        action->_poolIndex = (int)_pools->opacities.size();
+        _pools->opacities.push_back(record);
+    }
+    else
+    {
+        return false;
+    }
+
+    element->pooledCount++;
+    return true;
+}
+
+void ActionManager::unpoolAction(Action *action)
+{
+    if (action->_poolType == kActionPoolNone)
+    {
+        return;
+    }
+
+    tPooledAction *record = nullptr;
+    switch (action->_poolType)
+    {
+        case kActionPoolPosition:
+            record = &_pools->positions[action->_poolIndex];
+            break;
+        case kActionPoolScale:
+            record = &_pools->scales[action->_poolIndex];
+            break;
+        case kActionPoolRotation:
+            record = &_pools->rotations[action->_poolIndex];
+            break;
+        case kActionPoolOpacity:
+            record = &_pools->opacities[action->_poolIndex];
+            break;
+        default:
+            CCASSERT(false, "Invalid action pool");
+            return;
+    }
+
+    CCASSERT(record->action == action, "action pool record mismatch");
+    // the records are compacted at the end of the next update
+    record->element->pooledCount--;
+    record->action = nullptr;
+    action->_poolType = kActionPoolNone;
+    action->_poolIndex = -1;
+    _pools->hasRemoved = true;
+}
+
+void ActionManager::unpoolActionsOfElement(tHashElement *element)
+{
+    if (element->pooledCount == 0 || element->actions == nullptr)
+    {
+        return;
+    }
+
+    auto limit = element->actions->num;
+    for (int i = 0; i < limit && element->pooledCount > 0; ++i)
+    {
+        unpoolAction(static_cast<Action*>(element->actions->arr[i]));
+    }
+}
+
+template <typename T>
+void ActionManager::compactActionPool(std::vector<T>& pool)
+{
+    size_t count = 0;
+    for (size_t i = 0, size = pool.size(); i < size; ++i)
+    {
+        if (pool[i].action == nullptr)
+        {
+            continue;
+        }
+        if (count != i)
+        {
+            pool[count] = pool[i];
+            pool[count].action->_poolIndex = (int)count;
+        }
+        ++count;
+    }
+    pool.resize(count);
+}
+
+void ActionManager::updateActionPools(float dt)
+{
+    auto& finished = _pools->finished;
+    _pools->updating = true;
+
+    // Node setters may be overridden, so the records are always accessed by index and the
+    // finished actions are only stopped once every pool has been updated.
+    auto finishStep = [&finished](tPooledAction& record) {
+        ActionInterval *action = record.action;
+        if (action == nullptr)
+        {
+            // removed by the node setter
+            return;
+        }
+        action->_firstTick = false;
+        action->_elapsed = record.elapsed;
+        if (record.elapsed >= record.duration)
+        {
+            action->_done = true;
+            action->retain();
+            finished.push_back(action);
+        }
+    };
+
+    auto& positions = _pools->positions;
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+        auto& record = positions[i];
+        if (record.action == nullptr || record.element->paused)
+        {
+            continue;
+        }
+
+        float time = stepPooledAction(record, dt);
+#if CC_ENABLE_STACKABLE_ACTIONS
+        Vec3 currentPos = record.target->getPosition3D();
+        record.start += currentPos - record.previous;
+        record.previous = record.start + record.delta * time;
+        record.target->setPosition3D(record.previous);
+#else
+        record.target->setPosition3D(record.start + record.delta * time);
+#endif // CC_ENABLE_STACKABLE_ACTIONS
+        finishStep(positions[i]);
+    }
+
+    auto& scales = _pools->scales;
+    for (size_t i = 0; i < scales.size(); ++i)
+    {
+        auto& record = scales[i];
+        if (record.action == nullptr || record.element->paused)
+        {
+            continue;
+        }
+
+        float time = stepPooledAction(record, dt);
+        record.target->setScaleX(record.start.x + record.delta.x * time);
+        record.target->setScaleY(record.start.y + record.delta.y * time);
+        record.target->setScaleZ(record.start.z + record.delta.z * time);
+        finishStep(scales[i]);
+    }
+
+    auto& rotations = _pools->rotations;
+    for (size_t i = 0; i < rotations.size(); ++i)
+    {
+        auto& record = rotations[i];
+        if (record.action == nullptr || record.element->paused)
+        {
+            continue;
+        }
+
+        float time = stepPooledAction(record, dt);
+        if (record.is3D)
+        {
+            record.target->setRotation3D(record.start + record.delta * time);
+        }
+        else
+        {
+#if CC_USE_PHYSICS
+            if (record.start.x == record.start.y && record.delta.x == record.delta.y)
+            {
+                record.target->setRotation(record.start.x + record.delta.x * time);
+            }
+            else
+            {
+                record.target->setRotationSkewX(record.start.x + record.delta.x * time);
+                record.target->setRotationSkewY(record.start.y + record.delta.y * time);
+            }
+#else
+            record.target->setRotationSkewX(record.start.x + record.delta.x * time);
+            record.target->setRotationSkewY(record.start.y + record.delta.y * time);
+#endif // CC_USE_PHYSICS
+        }
+        finishStep(rotations[i]);
+    }
+
+    auto& opacities = _pools->opacities;
+    for (size_t i = 0; i < opacities.size(); ++i)
+    {
+        auto& record = opacities[i];
+        if (record.action == nullptr || record.element->paused)
+        {
+            continue;
+        }
+
+        float time = stepPooledAction(record, dt);
+        record.target->setOpacity((GLubyte)(record.from + (record.to - record.from) * time));
+        finishStep(opacities[i]);
+    }
+
+    _pools->updating = false;
+
+    // same as the isDone() branch of update(). An action may already have been removed by
+    // a target released while stopping another one.
+    for (size_t i = 0; i < finished.size(); ++i)
+    {
+        ActionInterval *action = finished[i];
+        if (action->_poolType != kActionPoolNone)
+        {
+            action->stop();
+            removeAction(action);
+        }
+        action->release();
+    }
+    finished.clear();
+
+    if (_pools->hasRemoved)
+    {
+        compactActionPool(_pools->positions);
+        compactActionPool(_pools->scales);
+        compactActionPool(_pools->rotations);
+        compactActionPool(_pools->opacities);
+        _pools->hasRemoved = false;
+    }
 }
 
 NS_CC_END
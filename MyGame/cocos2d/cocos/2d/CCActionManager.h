@@ -39,6 +39,7 @@ NS_CC_BEGIN
 class Action;
 
 struct _hashElement;
+struct _actionPools;
 
 /**
  * @addtogroup actions
@@ -206,10 +207,18 @@ protected:
     void deleteHashElement(struct _hashElement *element);
     void actionAllocWithHashElement(struct _hashElement *element);
 
+    // fast path for the common interval actions, see CCActionManager.cpp
+    bool poolAction(Action *action, struct _hashElement *element);
+    void unpoolAction(Action *action);
+    void unpoolActionsOfElement(struct _hashElement *element);
+    void updateActionPools(float dt);
+    template <typename T> void compactActionPool(std::vector<T>& pool);
+
 protected:
     struct _hashElement    *_targets;
     struct _hashElement    *_currentTarget;
     bool            _currentTargetSalvaged;
+    struct _actionPools    *_pools;
 };
 
 // end of actions group
@@ -946,4 +946,9 @@ void DrawNode::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t p
     }
 }
 
+bool DrawNode::getCullingBounds(AABB* /*bounds*/) const
+{
+    return false;
+}
+
 NS_CC_END
@@ -315,6 +315,8 @@ public:
     virtual void draw(Renderer *renderer, const Mat4 &transform, uint32_t flags) override;
 
     virtual void visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+    /** A DrawNode draws anywhere, whatever its content size, so it is never culled. */
+    virtual bool getCullingBounds(AABB* bounds) const override;
     
     void setLineWidth(GLfloat lineWidth);
 
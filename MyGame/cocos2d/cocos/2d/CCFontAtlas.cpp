@@ -36,6 +36,8 @@
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventType.h"
+#include "base/CCConfiguration.h"
+#include "platform/CCGL.h"
 
 NS_CC_BEGIN
 
@@ -44,15 +46,130 @@ const int FontAtlas::CacheTextureHeight = 512;
 const char* FontAtlas::CMD_PURGE_FONTATLAS = "__cc_PURGE_FONTATLAS";
 const char* FontAtlas::CMD_RESET_FONTATLAS = "__cc_RESET_FONTATLAS";
 
+static int s_defaultPageWidth = FontAtlas::CacheTextureWidth;
+static int s_defaultPageHeight = FontAtlas::CacheTextureHeight;
+static int s_defaultMaxPageCount = 0;
+
+void FontAtlas::setDefaultPageSize(int width, int height)
+{
+    CCASSERT(width > 0 && height > 0, "Invalid page size");
+    int maxTextureSize = Configuration::getInstance()->getMaxTextureSize();
+    if (maxTextureSize > 0)
+    {
+        width = std::min(width, maxTextureSize);
+        height = std::min(height, maxTextureSize);
+    }
+    s_defaultPageWidth = width;
+    s_defaultPageHeight = height;
+}
+
+int FontAtlas::getDefaultPageWidth()
+{
+    return s_defaultPageWidth;
+}
+
+int FontAtlas::getDefaultPageHeight()
+{
+    return s_defaultPageHeight;
+}
+
+void FontAtlas::setDefaultMaxPageCount(int count)
+{
+    s_defaultMaxPageCount = std::max(count, 0);
+}
+
+int FontAtlas::getDefaultMaxPageCount()
+{
+    return s_defaultMaxPageCount;
+}
+
+FontLetterTable::FontLetterTable(const FontLetterTable& other)
+: _size(0)
+{
+    *this = other;
+}
+
+FontLetterTable::FontLetterTable(FontLetterTable&& other)
+: _pages(std::move(other._pages))
+, _size(other._size)
+{
+    other._size = 0;
+}
+
+FontLetterTable& FontLetterTable::operator=(const FontLetterTable& other)
+{
+    if (this != &other)
+    {
+        _pages.clear();
+        _pages.resize(other._pages.size());
+        for (size_t page = 0; page < other._pages.size(); ++page)
+        {
+            if (other._pages[page])
+                _pages[page].reset(new Page(*other._pages[page]));
+        }
+        _size = other._size;
+    }
+    return *this;
+}
+
+FontLetterTable& FontLetterTable::operator=(FontLetterTable&& other)
+{
+    if (this != &other)
+    {
+        _pages = std::move(other._pages);
+        _size = other._size;
+        other._size = 0;
+    }
+    return *this;
+}
+
+FontLetterDefinition& FontLetterTable::operator[](char32_t utf32Char)
+{
+    auto page = utf32Char >> PAGE_BITS;
+    if (page >= MAX_PAGES)
+    {
+        _invalidLetter = FontLetterDefinition();
+        return _invalidLetter;
+    }
+
+    if (page >= _pages.size())
+        _pages.resize(page + 1);
+    if (!_pages[page])
+        _pages[page].reset(new Page());
+
+    auto index = utf32Char & PAGE_MASK;
+    if (!_pages[page]->defined[index])
+    {
+        _pages[page]->defined[index] = true;
+        _pages[page]->letters[index] = FontLetterDefinition();
+        ++_size;
+    }
+    return _pages[page]->letters[index];
+}
+
+void FontLetterTable::clear()
+{
+    _pages.clear();
+    _size = 0;
+}
+
 FontAtlas::FontAtlas(Font &theFont) 
 : _font(&theFont)
 , _fontFreeType(nullptr)
 , _iconv(nullptr)
 , _currentPageData(nullptr)
+, _pageWidth(s_defaultPageWidth)
+, _pageHeight(s_defaultPageHeight)
+, _maxPageCount(s_defaultMaxPageCount)
+, _packer(s_defaultPageWidth, s_defaultPageHeight)
+, _generation(0)
+, _dirtyLeft(s_defaultPageWidth)
+, _dirtyTop(s_defaultPageHeight)
+, _dirtyRight(0)
+, _dirtyBottom(0)
 , _fontAscender(0)
 , _rendererRecreatedListener(nullptr)
 , _antialiasEnabled(true)
-, _currLineHeight(0)
 {
     _font->retain();
 
@@ -62,8 +179,6 @@ FontAtlas::FontAtlas(Font &theFont)
         _lineHeight = _font->getFontMaxHeight();
         _fontAscender = _fontFreeType->getFontAscender();
         _currentPage = 0;
-        _currentPageOrigX = 0;
-        _currentPageOrigY = 0;
         _letterEdgeExtend = 2;
         _letterPadding = 0;
 
@@ -91,7 +206,7 @@ void FontAtlas::reinit()
     
     auto texture = new (std::nothrow) Texture2D;
     
-    _currentPageDataSize = CacheTextureWidth * CacheTextureHeight;
+    _currentPageDataSize = _pageWidth * _pageHeight;
     
     auto outlineSize = _fontFreeType->getOutlineSize();
     if(outlineSize > 0)
@@ -105,10 +220,13 @@ void FontAtlas::reinit()
     
     auto  pixelFormat = outlineSize > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8;
     texture->initWithData(_currentPageData, _currentPageDataSize,
-                          pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth,CacheTextureHeight) );
+                          pixelFormat, _pageWidth, _pageHeight, Size(_pageWidth, _pageHeight) );
     
     addTexture(texture,0);
     texture->release();
+
+    _packer.reset(_pageWidth, _pageHeight);
+    _pageLastUsed.assign(1, 0);
 }
 
 FontAtlas::~FontAtlas()
@@ -140,10 +258,7 @@ void FontAtlas::reset()
 {
     releaseTextures();
     
-    _currLineHeight = 0;
     _currentPage = 0;
-    _currentPageOrigX = 0;
-    _currentPageOrigY = 0;
     _letterDefinitions.clear();
     
     reinit();
@@ -181,23 +296,22 @@ void FontAtlas::addLetterDefinition(char32_t utf32Char, const FontLetterDefiniti
 
 void FontAtlas::scaleFontLetterDefinition(float scaleFactor)
 {
-    for (auto&& fontDefinition : _letterDefinitions) {
-        auto& letterDefinition = fontDefinition.second;
+    _letterDefinitions.forEach([scaleFactor](char32_t /*utf32Char*/, FontLetterDefinition& letterDefinition) {
         letterDefinition.width *= scaleFactor;
         letterDefinition.height *= scaleFactor;
         letterDefinition.offsetX *= scaleFactor;
         letterDefinition.offsetY *= scaleFactor;
         letterDefinition.xAdvance *= scaleFactor;
-    }
+    });
 }
 
 bool FontAtlas::getLetterDefinitionForChar(char32_t utf32Char, FontLetterDefinition &letterDefinition)
 {
-    auto outIterator = _letterDefinitions.find(utf32Char);
+    auto definition = _letterDefinitions.find(utf32Char);
 
-    if (outIterator != _letterDefinitions.end())
+    if (definition != nullptr)
     {
-        letterDefinition = (*outIterator).second;
+        letterDefinition = *definition;
         return letterDefinition.validDefinition;
     }
     else
@@ -299,15 +413,21 @@ void FontAtlas::findNewCharacters(const std::u32string& u32Text, std::unordered_
     }
     else
     {
+        auto frame = Director::getInstance()->getTotalFrames();
         auto length = u32Text.length();
         newChars.reserve(length);
         for (size_t i = 0; i < length; ++i)
         {
-            auto outIterator = _letterDefinitions.find(u32Text[i]);
-            if (outIterator == _letterDefinitions.end())
+            auto definition = _letterDefinitions.find(u32Text[i]);
+            if (definition == nullptr || definition->textureID < 0)
             {
                 newChars.push_back(u32Text[i]);
             }
+            else if (definition->width > 0)
+            {
+                // the glyphs of the text must not be evicted for its new glyphs
+                _pageLastUsed[definition->textureID] = frame;
+            }
         }
     }
 
@@ -356,14 +476,11 @@ bool FontAtlas::prepareLetterDefinitions(const std::u32string& utf32Text)
     int adjustForExtend = _letterEdgeExtend / 2;
     long bitmapWidth;
     long bitmapHeight;
-    int glyphHeight;
     Rect tempRect;
     FontLetterDefinition tempDef;
 
     auto scaleFactor = CC_CONTENT_SCALE_FACTOR();
-    auto  pixelFormat = _fontFreeType->getOutlineSize() > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8;
-
-    float startY = _currentPageOrigY;
+    auto frame = Director::getInstance()->getTotalFrames();
 
     for (auto&& it : codeMapOfNewChar)
     {
@@ -376,56 +493,44 @@ bool FontAtlas::prepareLetterDefinitions(const std::u32string& utf32Text)
             tempDef.offsetX = tempRect.origin.x - adjustForDistanceMap - adjustForExtend;
             tempDef.offsetY = _fontAscender + tempRect.origin.y - adjustForDistanceMap - adjustForExtend;
 
-            if (_currentPageOrigX + tempDef.width > CacheTextureWidth)
+            // one pixel apart from the other glyphs
+            int cellWidth = static_cast<int>(tempDef.width) + 1;
+            int cellHeight = static_cast<int>(bitmapHeight) + _letterPadding + _letterEdgeExtend + 1;
+            int x = 0;
+            int y = 0;
+            bool packed = cellWidth <= _pageWidth && cellHeight <= _pageHeight;
+            if (packed && !_packer.insert(cellWidth, cellHeight, &x, &y))
             {
-                _currentPageOrigY += _currLineHeight;
-                _currLineHeight = 0;
-                _currentPageOrigX = 0;
-                if (_currentPageOrigY + _lineHeight + _letterPadding + _letterEdgeExtend >= CacheTextureHeight)
-                {
-                    unsigned char *data = nullptr;
-                    if (pixelFormat == Texture2D::PixelFormat::AI88)
-                    {
-                        data = _currentPageData + CacheTextureWidth * (int)startY * 2;
-                    }
-                    else
-                    {
-                        data = _currentPageData + CacheTextureWidth * (int)startY;
-                    }
-                    _atlasTextures[_currentPage]->updateWithData(data, 0, startY,
-                        CacheTextureWidth, CacheTextureHeight - startY);
-
-                    startY = 0.0f;
-
-                    _currentPageOrigY = 0;
-                    memset(_currentPageData, 0, _currentPageDataSize);
-                    _currentPage++;
-                    auto tex = new (std::nothrow) Texture2D;
-                    if (_antialiasEnabled)
-                    {
-                        tex->setAntiAliasTexParameters();
-                    }
-                    else
-                    {
-                        tex->setAliasTexParameters();
-                    }
-                    tex->initWithData(_currentPageData, _currentPageDataSize,
-                        pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth, CacheTextureHeight));
-                    addTexture(tex, _currentPage);
-                    tex->release();
-                }
+                startNewPage();
+                packed = _packer.insert(cellWidth, cellHeight, &x, &y);
             }
-            glyphHeight = static_cast<int>(bitmapHeight) + _letterPadding + _letterEdgeExtend;
-            if (glyphHeight > _currLineHeight)
+            if (!packed)
             {
-                _currLineHeight = glyphHeight;
+                CCLOG("FontAtlas: the glyph of U+%04X doesn't fit in a %dx%d page", (unsigned int)it.first, _pageWidth, _pageHeight);
+                if (_fontFreeType->getOutlineSize() > 0)
+                {
+                    delete[] bitmap;
+                }
+                tempDef.validDefinition = false;
+                tempDef.width = 0;
+                tempDef.height = 0;
+                tempDef.U = 0;
+                tempDef.V = 0;
+                tempDef.textureID = 0;
+                _letterDefinitions[it.first] = tempDef;
+                continue;
             }
-            _fontFreeType->renderCharAt(_currentPageData, _currentPageOrigX + adjustForExtend, _currentPageOrigY + adjustForExtend, bitmap, bitmapWidth, bitmapHeight);
 
-            tempDef.U = _currentPageOrigX;
-            tempDef.V = _currentPageOrigY;
+            _fontFreeType->renderCharAt(_currentPageData, x + adjustForExtend, y + adjustForExtend, bitmap, bitmapWidth, bitmapHeight, _pageWidth);
+            _dirtyLeft = std::min(_dirtyLeft, x);
+            _dirtyTop = std::min(_dirtyTop, y);
+            _dirtyRight = std::max(_dirtyRight, x + cellWidth);
+            _dirtyBottom = std::max(_dirtyBottom, y + cellHeight);
+            _pageLastUsed[_currentPage] = frame;
+
+            tempDef.U = x;
+            tempDef.V = y;
             tempDef.textureID = _currentPage;
-            _currentPageOrigX += tempDef.width + 1;
             // take from pixels to points
             tempDef.width = tempDef.width / scaleFactor;
             tempDef.height = tempDef.height / scaleFactor;
@@ -447,24 +552,121 @@ bool FontAtlas::prepareLetterDefinitions(const std::u32string& utf32Text)
             tempDef.offsetX = 0;
             tempDef.offsetY = 0;
             tempDef.textureID = 0;
-            _currentPageOrigX += 1;
         }
 
         _letterDefinitions[it.first] = tempDef;
     }
 
-    unsigned char *data = nullptr;
-    if (pixelFormat == Texture2D::PixelFormat::AI88)
+    uploadDirtyRect();
+
+    return true;
+}
+
+void FontAtlas::startNewPage()
+{
+    uploadDirtyRect();
+    memset(_currentPageData, 0, _currentPageDataSize);
+    _packer.reset(_pageWidth, _pageHeight);
+
+    int page = findEvictablePage();
+    if (page >= 0)
+    {
+        // the page keeps its texture, the new glyphs overwrite the evicted ones
+        evictPage(page);
+        _currentPage = page;
+        return;
+    }
+
+    _currentPage = static_cast<int>(_atlasTextures.size());
+    auto pixelFormat = _fontFreeType->getOutlineSize() > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8;
+    auto tex = new (std::nothrow) Texture2D;
+    if (_antialiasEnabled)
     {
-        data = _currentPageData + CacheTextureWidth * (int)startY * 2;
+        tex->setAntiAliasTexParameters();
     }
     else
     {
-        data = _currentPageData + CacheTextureWidth * (int)startY;
+        tex->setAliasTexParameters();
     }
-    _atlasTextures[_currentPage]->updateWithData(data, 0, startY, CacheTextureWidth, _currentPageOrigY - startY + _currLineHeight);
+    tex->initWithData(_currentPageData, _currentPageDataSize,
+        pixelFormat, _pageWidth, _pageHeight, Size(_pageWidth, _pageHeight));
+    addTexture(tex, _currentPage);
+    tex->release();
+    _pageLastUsed.push_back(0);
+}
 
-    return true;
+int FontAtlas::findEvictablePage() const
+{
+    if (_maxPageCount <= 0 || static_cast<int>(_atlasTextures.size()) < _maxPageCount)
+        return -1;
+
+    auto frame = Director::getInstance()->getTotalFrames();
+    int page = -1;
+    for (size_t i = 0; i < _pageLastUsed.size(); ++i)
+    {
+        // still on screen
+        if (_pageLastUsed[i] + 1 >= frame)
+            continue;
+        if (page < 0 || _pageLastUsed[i] < _pageLastUsed[page])
+            page = static_cast<int>(i);
+    }
+
+    if (page < 0)
+    {
+        CCLOG("FontAtlas: all the %d pages of %s are on screen, adding one more", (int)_atlasTextures.size(), getFontName().c_str());
+    }
+    return page;
+}
+
+void FontAtlas::evictPage(int page)
+{
+    // the definitions stay in the table marked as evicted, findNewCharacters() renders them again on demand
+    _letterDefinitions.forEach([page](char32_t /*utf32Char*/, FontLetterDefinition& letterDefinition) {
+        if (letterDefinition.textureID == page && letterDefinition.width > 0)
+        {
+            letterDefinition.validDefinition = false;
+            letterDefinition.textureID = -1;
+        }
+    });
+    ++_generation;
+}
+
+void FontAtlas::uploadDirtyRect()
+{
+    if (_dirtyRight <= _dirtyLeft || _dirtyBottom <= _dirtyTop)
+        return;
+
+    int bytesPerPixel = _fontFreeType->getOutlineSize() > 0 ? 2 : 1;
+    int width = _dirtyRight - _dirtyLeft;
+    int height = _dirtyBottom - _dirtyTop;
+    const unsigned char* data = _currentPageData + (_dirtyTop * _pageWidth + _dirtyLeft) * bytesPerPixel;
+    if (width != _pageWidth)
+    {
+        // glTexSubImage2D needs the rows of the rectangle packed
+        int rowSize = width * bytesPerPixel;
+        _uploadBuffer.resize(rowSize * height);
+        for (int row = 0; row < height; ++row)
+        {
+            memcpy(_uploadBuffer.data() + row * rowSize, data + row * _pageWidth * bytesPerPixel, rowSize);
+        }
+        data = _uploadBuffer.data();
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    _atlasTextures[_currentPage]->updateWithData(data, _dirtyLeft, _dirtyTop, width, height);
+
+    _dirtyLeft = _pageWidth;
+    _dirtyTop = _pageHeight;
+    _dirtyRight = 0;
+    _dirtyBottom = 0;
+}
+
+void FontAtlas::markPageUsed(int page)
+{
+    if (page >= 0 && page < static_cast<int>(_pageLastUsed.size()))
+    {
+        _pageLastUsed[page] = Director::getInstance()->getTotalFrames();
+    }
 }
 
 void FontAtlas::addTexture(Texture2D *texture, int slot)
@@ -29,12 +29,16 @@
 
 /// @cond DO_NOT_SHOW
 
+#include <bitset>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/CCRef.h"
 #include "platform/CCStdC.h" // ssize_t on windows
+#include "2d/CCRuntimeAtlas.h"
 
 NS_CC_BEGIN
 
@@ -57,6 +61,70 @@ struct FontLetterDefinition
     int xAdvance;
 };
 
+/** Letter definitions of a FontAtlas, looked up by code point through a flat page table
+ * of 256 letters per page instead of a hash map. Definitions stay at the same address
+ * until the table is cleared.
+ */
+class CC_DLL FontLetterTable
+{
+public:
+    FontLetterTable() : _size(0) {}
+    FontLetterTable(const FontLetterTable& other);
+    FontLetterTable(FontLetterTable&& other);
+    FontLetterTable& operator=(const FontLetterTable& other);
+    FontLetterTable& operator=(FontLetterTable&& other);
+
+    /** Returns the definition of the letter, or nullptr if it was never added. */
+    FontLetterDefinition* find(char32_t utf32Char)
+    {
+        auto page = utf32Char >> PAGE_BITS;
+        if (page >= _pages.size() || !_pages[page] || !_pages[page]->defined[utf32Char & PAGE_MASK])
+            return nullptr;
+        return &_pages[page]->letters[utf32Char & PAGE_MASK];
+    }
+
+    /** Returns the definition of the letter, an invalid one is added if it doesn't exist yet. */
+    FontLetterDefinition& operator[](char32_t utf32Char);
+
+    /** Calls function(utf32Char, letterDefinition) for every letter in the table. */
+    template <typename Function>
+    void forEach(Function&& function)
+    {
+        for (size_t page = 0; page < _pages.size(); ++page)
+        {
+            if (!_pages[page])
+                continue;
+            for (size_t i = 0; i < PAGE_SIZE; ++i)
+            {
+                if (_pages[page]->defined[i])
+                    function(static_cast<char32_t>((page << PAGE_BITS) | i), _pages[page]->letters[i]);
+            }
+        }
+    }
+
+    bool empty() const { return _size == 0; }
+    size_t size() const { return _size; }
+    void clear();
+
+private:
+    static const size_t PAGE_BITS = 8;
+    static const size_t PAGE_SIZE = 1 << PAGE_BITS;
+    static const size_t PAGE_MASK = PAGE_SIZE - 1;
+    // pages for all the Unicode code points, up to U+10FFFF
+    static const size_t MAX_PAGES = 0x110000 >> PAGE_BITS;
+
+    struct Page
+    {
+        FontLetterDefinition letters[PAGE_SIZE];
+        std::bitset<PAGE_SIZE> defined;
+    };
+
+    std::vector<std::unique_ptr<Page>> _pages;
+    size_t _size;
+    // returned for code points beyond Unicode, never stored
+    FontLetterDefinition _invalidLetter;
+};
+
 class CC_DLL FontAtlas : public Ref
 {
 public:
@@ -64,6 +132,23 @@ public:
     static const int CacheTextureHeight;
     static const char* CMD_PURGE_FONTATLAS;
     static const char* CMD_RESET_FONTATLAS;
+
+    /** Sets the size of the texture pages of the TTF atlases created afterwards, it is clamped to
+     the maximum texture size. Larger pages keep more glyphs in one batch.
+     The default is CacheTextureWidth x CacheTextureHeight.
+     */
+    static void setDefaultPageSize(int width, int height);
+    static int getDefaultPageWidth();
+    static int getDefaultPageHeight();
+
+    /** Limits the number of texture pages of the TTF atlases created afterwards. Once it is reached,
+     the glyphs of the page drawn least recently are evicted to make room for new ones, and the labels
+     using them are laid out again. Pages drawn in the current or the previous frame are never evicted.
+     0, the default, means no limit.
+     */
+    static void setDefaultMaxPageCount(int count);
+    static int getDefaultMaxPageCount();
+
     /**
      * @js ctor
      */
@@ -89,6 +174,15 @@ public:
     Texture2D* getTexture(int slot);
     const Font* getFont() const { return _font; }
 
+    int getPageWidth() const { return _pageWidth; }
+    int getPageHeight() const { return _pageHeight; }
+
+    /** Labels call it for the pages their glyphs are drawn from, to keep them from being evicted. */
+    void markPageUsed(int page);
+
+    /** Changes every time glyphs are evicted, the labels using the atlas have to be laid out again then. */
+    unsigned int getGeneration() const { return _generation; }
+
     /** listen the event that renderer was recreated on Android/WP8
      It only has effect on Android and WP8.
      */
@@ -120,6 +214,13 @@ protected:
 
     void findNewCharacters(const std::u32string& u32Text, std::unordered_map<unsigned int, unsigned int>& charCodeMap);
 
+    // continues on an empty page, a new one or the least recently used one
+    void startNewPage();
+    int findEvictablePage() const;
+    void evictPage(int page);
+    // uploads the part of the current page changed since the last upload
+    void uploadDirtyRect();
+
     void conversionU32TOGB2312(const std::u32string& u32Text, std::unordered_map<unsigned int, unsigned int>& charCodeMap);
 
     /**
@@ -130,7 +231,7 @@ protected:
     void scaleFontLetterDefinition(float scaleFactor);
 
     std::unordered_map<ssize_t, Texture2D*> _atlasTextures;
-    std::unordered_map<char32_t, FontLetterDefinition> _letterDefinitions;
+    FontLetterTable _letterDefinitions;
     float _lineHeight;
     Font* _font;
     FontFreeType* _fontFreeType;
@@ -140,15 +241,24 @@ protected:
     int _currentPage;
     unsigned char *_currentPageData;
     int _currentPageDataSize;
-    float _currentPageOrigX;
-    float _currentPageOrigY;
+    int _pageWidth;
+    int _pageHeight;
+    int _maxPageCount;
+    SkylinePacker _packer;
+    // frame in which the glyphs of each page were used last
+    std::vector<unsigned int> _pageLastUsed;
+    unsigned int _generation;
+    int _dirtyLeft;
+    int _dirtyTop;
+    int _dirtyRight;
+    int _dirtyBottom;
+    std::vector<unsigned char> _uploadBuffer;
     int _letterPadding;
     int _letterEdgeExtend;
 
     int _fontAscender;
     EventListenerCustom* _rendererRecreatedListener;
     bool _antialiasEnabled;
-    int _currLineHeight;
 
     friend class Label;
 };
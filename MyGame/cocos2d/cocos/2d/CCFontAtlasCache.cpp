@@ -30,6 +30,7 @@
 #include "2d/CCFontFreeType.h"
 #include "2d/CCFontAtlas.h"
 #include "2d/CCFontCharMap.h"
+#include "2d/CCFontSDF.h"
 #include "2d/CCLabel.h"
 #include "platform/CCFileUtils.h"
 
@@ -60,6 +61,18 @@ FontAtlas* FontAtlasCache::getFontAtlasTTF(const _ttfConfig* config)
         useDistanceField = false;
     }
 
+    if (useDistanceField)
+    {
+        // a baked distance field font renders every font size without FreeType
+        auto bakedFilename = FontSDF::getBakedFilePath(realFontFilename);
+        if (FileUtils::getInstance()->isFileExist(bakedFilename))
+        {
+            auto atlas = getFontAtlasSDF(bakedFilename);
+            if (atlas)
+                return atlas;
+        }
+    }
+
     std::string key;
     char keyPrefix[ATLAS_MAP_KEY_PREFIX_BUFFER_SIZE];
     snprintf(keyPrefix, ATLAS_MAP_KEY_PREFIX_BUFFER_SIZE, useDistanceField ? "df %.2f %d " : "%.2f %d ", config->fontSize, config->outlineSize);
@@ -117,6 +130,33 @@ FontAtlas* FontAtlasCache::getFontAtlasFNT(const std::string& fontFileName, cons
     return nullptr;
 }
 
+FontAtlas* FontAtlasCache::getFontAtlasSDF(const std::string& sdfFileName)
+{
+    auto realFontFilename = FileUtils::getInstance()->getNewFilename(sdfFileName);
+    std::string atlasName("sdf ");
+    atlasName += realFontFilename;
+
+    auto it = _atlasMap.find(atlasName);
+    if ( it == _atlasMap.end() )
+    {
+        auto font = FontSDF::create(realFontFilename);
+
+        if(font)
+        {
+            auto tempAtlas = font->createFontAtlas();
+            if (tempAtlas)
+            {
+                _atlasMap[atlasName] = tempAtlas;
+                return _atlasMap[atlasName];
+            }
+        }
+    }
+    else
+        return it->second;
+
+    return nullptr;
+}
+
 FontAtlas* FontAtlasCache::getFontAtlasCharMap(const std::string& plistFile)
 {
     std::string atlasName = plistFile;
@@ -43,6 +43,8 @@ class CC_DLL FontAtlasCache
 public:
     static FontAtlas* getFontAtlasTTF(const _ttfConfig* config);
     static FontAtlas* getFontAtlasFNT(const std::string& fontFileName, const Vec2& imageOffset = Vec2::ZERO);
+    /** Returns the atlas of a font baked by FontSDF::bake(), it is shared by all font sizes. */
+    static FontAtlas* getFontAtlasSDF(const std::string& sdfFileName);
 
     static FontAtlas* getFontAtlasCharMap(const std::string& charMapFile, int itemWidth, int itemHeight, int startCharMap);
     static FontAtlas* getFontAtlasCharMap(Texture2D* texture, int itemWidth, int itemHeight, int startCharMap);
@@ -541,7 +541,7 @@ unsigned char * makeDistanceMap( unsigned char *img, long width, long height)
     return out;
 }
 
-void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned char* bitmap,long bitmapWidth,long bitmapHeight)
+void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned char* bitmap,long bitmapWidth,long bitmapHeight, int destWidth)
 {
     int iX = posX;
     int iY = posY;
@@ -567,7 +567,7 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
                 dest[index + 2] = out[index2 + 2];*/
 
                 //Single channel 8-bit output 
-                dest[iX + ( iY * FontAtlas::CacheTextureWidth )] = distanceMap[bitmap_y + x];
+                dest[iX + ( iY * destWidth )] = distanceMap[bitmap_y + x];
 
                 iX += 1;
             }
@@ -587,9 +587,9 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
             for (int x = 0; x < bitmapWidth; ++x)
             {
                 tempChar = bitmap[(bitmap_y + x) * 2];
-                dest[(iX + ( iY * FontAtlas::CacheTextureWidth ) ) * 2] = tempChar;
+                dest[(iX + ( iY * destWidth ) ) * 2] = tempChar;
                 tempChar = bitmap[(bitmap_y + x) * 2 + 1];
-                dest[(iX + ( iY * FontAtlas::CacheTextureWidth ) ) * 2 + 1] = tempChar;
+                dest[(iX + ( iY * destWidth ) ) * 2 + 1] = tempChar;
 
                 iX += 1;
             }
@@ -610,7 +610,7 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
                 unsigned char cTemp = bitmap[bitmap_y + x];
 
                 // the final pixel
-                dest[(iX + ( iY * FontAtlas::CacheTextureWidth ) )] = cTemp;
+                dest[(iX + ( iY * destWidth ) )] = cTemp;
 
                 iX += 1;
             }
@@ -0,0 +1,403 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "2d/CCFontSDF.h"
+
+#include <algorithm>
+#include <zlib.h>
+
+#include "2d/CCFontAtlas.h"
+#include "2d/CCFontFreeType.h"
+#include "base/CCDirector.h"
+#include "base/CCEventDispatcher.h"
+#include "base/CCEventListenerCustom.h"
+#include "base/CCEventType.h"
+#include "platform/CCFileUtils.h"
+#include "renderer/CCTexture2D.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    // Baked files are written in the byte order of the baking machine, all current targets are little endian:
+    //   FileHeader, FileGlyph[glyphCount] sorted by code point,
+    //   then for every page: uint32_t compressedSize, zlib compressed A8 pixels of pageWidth * pageHeight.
+    const char FILE_MAGIC[4] = { 'C', 'S', 'D', 'F' };
+    const uint32_t FILE_VERSION = 1;
+
+    struct FileHeader
+    {
+        char magic[4];
+        uint32_t version;
+        float fontSize;
+        int32_t lineHeight;
+        uint32_t pageWidth;
+        uint32_t pageHeight;
+        uint32_t pageCount;
+        uint32_t glyphCount;
+    };
+
+    // positions and sizes are in pixels of the baked font size
+    struct FileGlyph
+    {
+        uint32_t utf32Char;
+        float u;
+        float v;
+        float width;
+        float height;
+        float offsetX;
+        float offsetY;
+        int32_t xAdvance;
+        uint16_t page;
+        uint16_t valid;
+    };
+
+    // same as the dynamic glyphs of FontAtlas
+    const int LETTER_EDGE_EXTEND = 2;
+}
+
+const char* FontSDF::FILE_EXTENSION = ".sdf";
+
+FontSDF* FontSDF::create(const std::string& sdfFilePath)
+{
+    auto data = FileUtils::getInstance()->getDataFromFile(sdfFilePath);
+    if (data.isNull())
+    {
+        CCLOG("cocos2d: FontSDF: can't open %s", sdfFilePath.c_str());
+        return nullptr;
+    }
+
+    auto font = new (std::nothrow) FontSDF();
+    if (font && font->initWithData(data))
+    {
+        font->autorelease();
+        return font;
+    }
+
+    CCLOG("cocos2d: FontSDF: %s is not a baked font", sdfFilePath.c_str());
+    CC_SAFE_DELETE(font);
+    return nullptr;
+}
+
+FontSDF::FontSDF()
+: _glyphsOffset(0)
+, _glyphCount(0)
+, _originalFontSize(0.0f)
+, _lineHeight(0)
+, _pageWidth(0)
+, _pageHeight(0)
+, _fontAtlas(nullptr)
+, _rendererRecreatedListener(nullptr)
+{
+}
+
+FontSDF::~FontSDF()
+{
+    if (_rendererRecreatedListener)
+    {
+        Director::getInstance()->getEventDispatcher()->removeEventListener(_rendererRecreatedListener);
+    }
+}
+
+bool FontSDF::initWithData(const Data& data)
+{
+    auto bytes = data.getBytes();
+    size_t size = data.getSize();
+
+    FileHeader header;
+    if (size < sizeof(header))
+        return false;
+    memcpy(&header, bytes, sizeof(header));
+    if (memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 || header.version != FILE_VERSION
+        || header.fontSize <= 0.0f || header.pageWidth == 0 || header.pageHeight == 0)
+        return false;
+
+    size_t offset = sizeof(header);
+    _glyphsOffset = offset;
+    if ((size - offset) / sizeof(FileGlyph) < header.glyphCount)
+        return false;
+    offset += header.glyphCount * sizeof(FileGlyph);
+
+    _pageOffsets.clear();
+    for (uint32_t page = 0; page < header.pageCount; ++page)
+    {
+        uint32_t compressedSize;
+        if (size - offset < sizeof(compressedSize))
+            return false;
+        memcpy(&compressedSize, bytes + offset, sizeof(compressedSize));
+        if (size - offset - sizeof(compressedSize) < compressedSize)
+            return false;
+        _pageOffsets.push_back(offset);
+        offset += sizeof(compressedSize) + compressedSize;
+    }
+
+    _data = data;
+    _glyphCount = header.glyphCount;
+    _originalFontSize = header.fontSize;
+    _lineHeight = header.lineHeight;
+    _pageWidth = header.pageWidth;
+    _pageHeight = header.pageHeight;
+    return true;
+}
+
+bool FontSDF::uploadPages(FontAtlas* atlas)
+{
+    std::vector<unsigned char> pixels(_pageWidth * _pageHeight);
+    auto& textures = atlas->getTextures();
+    for (size_t page = 0; page < _pageOffsets.size(); ++page)
+    {
+        auto bytes = _data.getBytes() + _pageOffsets[page];
+        uint32_t compressedSize;
+        memcpy(&compressedSize, bytes, sizeof(compressedSize));
+
+        uLongf pixelsSize = pixels.size();
+        if (uncompress(pixels.data(), &pixelsSize, bytes + sizeof(compressedSize), compressedSize) != Z_OK || pixelsSize != pixels.size())
+        {
+            CCLOG("cocos2d: FontSDF: page %d is corrupted", (int)page);
+            return false;
+        }
+
+        // reuse the textures when the renderer was recreated, labels hold them
+        auto it = textures.find(page);
+        auto texture = it != textures.end() ? it->second : new (std::nothrow) Texture2D();
+        texture->initWithData(pixels.data(), pixels.size(), Texture2D::PixelFormat::A8,
+                              _pageWidth, _pageHeight, Size(_pageWidth, _pageHeight));
+        if (it == textures.end())
+        {
+            atlas->addTexture(texture, static_cast<int>(page));
+            texture->release();
+        }
+    }
+    return true;
+}
+
+FontAtlas* FontSDF::createFontAtlas()
+{
+    if (_data.isNull())
+        return nullptr;
+
+    auto atlas = new (std::nothrow) FontAtlas(*this);
+    if (!atlas)
+        return nullptr;
+
+    atlas->setLineHeight(_lineHeight);
+    if (!uploadPages(atlas))
+    {
+        atlas->release();
+        return nullptr;
+    }
+
+    auto scaleFactor = CC_CONTENT_SCALE_FACTOR();
+    auto glyphs = _data.getBytes() + _glyphsOffset;
+    for (unsigned int i = 0; i < _glyphCount; ++i)
+    {
+        FileGlyph glyph;
+        memcpy(&glyph, glyphs + i * sizeof(FileGlyph), sizeof(glyph));
+
+        FontLetterDefinition letterDefinition;
+        // take the texture rect from pixels to points like FontAtlas does, the offsets stay in pixels
+        letterDefinition.U = glyph.u / scaleFactor;
+        letterDefinition.V = glyph.v / scaleFactor;
+        letterDefinition.width = glyph.width / scaleFactor;
+        letterDefinition.height = glyph.height / scaleFactor;
+        letterDefinition.offsetX = glyph.offsetX;
+        letterDefinition.offsetY = glyph.offsetY;
+        letterDefinition.xAdvance = glyph.xAdvance;
+        letterDefinition.textureID = glyph.page;
+        letterDefinition.validDefinition = glyph.valid != 0;
+        atlas->addLetterDefinition(glyph.utf32Char, letterDefinition);
+    }
+
+    _fontAtlas = atlas;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // the textures are lost with the GL context, upload the pages again from the file
+    if (!_rendererRecreatedListener)
+    {
+        _rendererRecreatedListener = EventListenerCustom::create(EVENT_RENDERER_RECREATED, [this](EventCustom* /*event*/) {
+            uploadPages(_fontAtlas);
+        });
+        Director::getInstance()->getEventDispatcher()->addEventListenerWithFixedPriority(_rendererRecreatedListener, 1);
+    }
+#else
+    _data.clear();
+    _pageOffsets.clear();
+#endif
+
+    return atlas;
+}
+
+int* FontSDF::getHorizontalKerningForTextUTF32(const std::u32string& /*text*/, int& /*outNumLetters*/) const
+{
+    return nullptr;
+}
+
+std::string FontSDF::getBakedFilePath(const std::string& fontFilePath)
+{
+    auto dot = fontFilePath.find_last_of('.');
+    auto slash = fontFilePath.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        return fontFilePath + FILE_EXTENSION;
+    return fontFilePath.substr(0, dot) + FILE_EXTENSION;
+}
+
+bool FontSDF::bake(const std::string& fontFilePath, float fontSize, const std::string& charset, const std::string& outputFilePath,
+                   std::string* errorMessage)
+{
+    auto fail = [errorMessage](const std::string& message) {
+        CCLOG("cocos2d: FontSDF::bake: %s", message.c_str());
+        if (errorMessage)
+            *errorMessage = message;
+        return false;
+    };
+
+    std::u32string chars;
+    if (!StringUtils::UTF8ToUTF32(charset, chars))
+        return fail("the charset isn't valid UTF-8");
+    std::sort(chars.begin(), chars.end());
+    chars.erase(std::unique(chars.begin(), chars.end()), chars.end());
+
+    auto font = FontFreeType::create(fontFilePath, fontSize, GlyphCollection::DYNAMIC, nullptr, true);
+    if (!font)
+        return fail("can't load " + fontFilePath);
+    if (font->getEncoding() != FT_ENCODING_UNICODE)
+        return fail(fontFilePath + " isn't a Unicode font");
+
+    // FontFreeType renders the distance fields with the stride of the FontAtlas pages
+    const int pageWidth = FontAtlas::getDefaultPageWidth();
+    const int pageHeight = FontAtlas::getDefaultPageHeight();
+    const int padding = 2 * FontFreeType::DistanceMapSpread;
+    const int ascender = font->getFontAscender();
+
+    std::vector<FileGlyph> glyphs;
+    glyphs.reserve(chars.size());
+    std::vector<unsigned char> pixels(pageWidth * pageHeight);
+    std::vector<std::vector<Bytef>> pages;
+    auto addPage = [&]() {
+        uLongf compressedSize = compressBound(pixels.size());
+        std::vector<Bytef> compressed(compressedSize);
+        compress2(compressed.data(), &compressedSize, pixels.data(), pixels.size(), Z_BEST_COMPRESSION);
+        compressed.resize(compressedSize);
+        pages.push_back(std::move(compressed));
+        std::fill(pixels.begin(), pixels.end(), 0);
+    };
+
+    int originX = 0;
+    int originY = 0;
+    int rowHeight = 0;
+    for (auto utf32Char : chars)
+    {
+        FileGlyph glyph;
+        memset(&glyph, 0, sizeof(glyph));
+        glyph.utf32Char = utf32Char;
+
+        long bitmapWidth;
+        long bitmapHeight;
+        Rect rect;
+        int xAdvance = 0;
+        auto bitmap = font->getGlyphBitmap(utf32Char, bitmapWidth, bitmapHeight, rect, xAdvance);
+        glyph.xAdvance = xAdvance;
+        if (bitmap && bitmapWidth > 0 && bitmapHeight > 0)
+        {
+            glyph.width = rect.size.width + padding + LETTER_EDGE_EXTEND;
+            glyph.height = rect.size.height + padding + LETTER_EDGE_EXTEND;
+            glyph.offsetX = rect.origin.x - padding / 2 - LETTER_EDGE_EXTEND / 2;
+            glyph.offsetY = ascender + rect.origin.y - padding / 2 - LETTER_EDGE_EXTEND / 2;
+            int cellWidth = static_cast<int>(glyph.width);
+            int cellHeight = static_cast<int>(bitmapHeight) + padding + LETTER_EDGE_EXTEND;
+
+            if (originX + cellWidth > pageWidth)
+            {
+                originX = 0;
+                originY += rowHeight;
+                rowHeight = 0;
+            }
+            if (originY + cellHeight > pageHeight)
+            {
+                addPage();
+                originX = 0;
+                originY = 0;
+                rowHeight = 0;
+            }
+
+            font->renderCharAt(pixels.data(), originX + LETTER_EDGE_EXTEND / 2, originY + LETTER_EDGE_EXTEND / 2, bitmap, bitmapWidth, bitmapHeight, pageWidth);
+            glyph.u = originX;
+            glyph.v = originY;
+            glyph.page = static_cast<uint16_t>(pages.size());
+            glyph.valid = 1;
+
+            originX += cellWidth + 1;
+            rowHeight = std::max(rowHeight, cellHeight);
+        }
+        else
+        {
+            glyph.valid = xAdvance != 0 ? 1 : 0;
+        }
+        glyphs.push_back(glyph);
+    }
+    addPage();
+
+    FileHeader header;
+    memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.version = FILE_VERSION;
+    header.fontSize = fontSize * CC_CONTENT_SCALE_FACTOR();
+    header.lineHeight = font->getFontMaxHeight();
+    header.pageWidth = pageWidth;
+    header.pageHeight = pageHeight;
+    header.pageCount = static_cast<uint32_t>(pages.size());
+    header.glyphCount = static_cast<uint32_t>(glyphs.size());
+
+    size_t size = sizeof(header) + glyphs.size() * sizeof(FileGlyph);
+    for (auto&& page : pages)
+    {
+        size += sizeof(uint32_t) + page.size();
+    }
+
+    auto bytes = static_cast<unsigned char*>(malloc(size));
+    auto dst = bytes;
+    memcpy(dst, &header, sizeof(header));
+    dst += sizeof(header);
+    if (!glyphs.empty())
+    {
+        memcpy(dst, glyphs.data(), glyphs.size() * sizeof(FileGlyph));
+        dst += glyphs.size() * sizeof(FileGlyph);
+    }
+    for (auto&& page : pages)
+    {
+        uint32_t compressedSize = static_cast<uint32_t>(page.size());
+        memcpy(dst, &compressedSize, sizeof(compressedSize));
+        dst += sizeof(compressedSize);
+        memcpy(dst, page.data(), page.size());
+        dst += page.size();
+    }
+
+    Data data;
+    data.fastSet(bytes, size);
+    if (!FileUtils::getInstance()->writeDataToFile(data, outputFilePath))
+        return fail("can't write " + outputFilePath);
+
+    CCLOG("cocos2d: FontSDF::bake: %d glyphs in %d pages written to %s", (int)glyphs.size(), (int)pages.size(), outputFilePath.c_str());
+    return true;
+}
+
+NS_CC_END
@@ -0,0 +1,98 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef _CCFontSDF_h_
+#define _CCFontSDF_h_
+
+/// @cond DO_NOT_SHOW
+
+#include <vector>
+#include "2d/CCFont.h"
+#include "base/CCData.h"
+
+NS_CC_BEGIN
+
+class EventListenerCustom;
+
+/** A TTF font baked offline into signed distance field pages.
+ *
+ * FontSDF::bake() rasterizes a charset with FreeType into a compact binary file (the pages are
+ * zlib compressed), usually at build time by tools/sdf-font/bake_sdf_fonts.py, which runs the
+ * bake_sdf_font tool built from tools/sdf-font. Loading that file creates the
+ * FontAtlas without any FreeType work, and labels scale its glyphs to any font size. When a
+ * label asks for a distance field TTF font and "<font>.sdf" exists next to it, FontAtlasCache
+ * uses the baked font instead.
+ */
+class CC_DLL FontSDF : public Font
+{
+public:
+    static const char* FILE_EXTENSION;
+
+    static FontSDF* create(const std::string& sdfFilePath);
+
+    /** Bakes the glyphs of the UTF-8 charset, rasterized at fontSize, into outputFilePath.
+     Characters missing from the charset are not rendered by labels using the baked font.
+     @param errorMessage If not null, receives why the baking failed, as CCLOG is compiled out in release builds.
+     */
+    static bool bake(const std::string& fontFilePath, float fontSize, const std::string& charset, const std::string& outputFilePath,
+                     std::string* errorMessage = nullptr);
+
+    /** Returns the path of the baked font for a TTF font, e.g. "fonts/arial.sdf" for "fonts/arial.ttf". */
+    static std::string getBakedFilePath(const std::string& fontFilePath);
+
+    /** The size in pixels the glyphs were rasterized at. */
+    float getOriginalFontSize() const { return _originalFontSize; }
+
+    virtual int* getHorizontalKerningForTextUTF32(const std::u32string& text, int &outNumLetters) const override;
+    virtual FontAtlas* createFontAtlas() override;
+    virtual int getFontMaxHeight() const override { return _lineHeight; }
+
+protected:
+    FontSDF();
+    /**
+     * @js NA
+     * @lua NA
+     */
+    virtual ~FontSDF();
+
+    bool initWithData(const Data& data);
+    bool uploadPages(FontAtlas* atlas);
+
+private:
+    Data _data;
+    std::vector<size_t> _pageOffsets;
+    size_t _glyphsOffset;
+    unsigned int _glyphCount;
+    float _originalFontSize;
+    int _lineHeight;
+    int _pageWidth;
+    int _pageHeight;
+    FontAtlas* _fontAtlas;
+    EventListenerCustom* _rendererRecreatedListener;
+};
+
+NS_CC_END
+
+/// @endcond
+#endif /* defined(_CCFontSDF_h_) */
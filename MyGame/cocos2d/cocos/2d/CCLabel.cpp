@@ -38,6 +38,7 @@
 #include "base/ccUTF8.h"
 #include "platform/CCFileUtils.h"
 #include "renderer/CCRenderer.h"
+#include "renderer/CCGLProgramCache.h"
 #include "renderer/ccGLStateCache.h"
 #include "base/CCDirector.h"
 #include "base/CCEventListenerCustom.h"
@@ -473,6 +474,7 @@ void Label::reset()
     _currentLabelType = LabelType::STRING_TEXTURE;
     _currLabelEffect = LabelEffect::NORMAL;
     _contentDirty = false;
+    _fontAtlasGeneration = 0;
     _numberOfLines = 0;
     _lengthOfString = 0;
     _utf32Text.clear();
@@ -560,7 +562,7 @@ void Label::updateShaderProgram()
         if (_useDistanceField)
             setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL));
         else if (_useA8Shader)
-            setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_LABEL_NORMAL));
+            setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_LABEL_BATCHED));
         else if (_shadowEnabled)
             setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR, _getTexture(this)));
         else
@@ -568,9 +570,8 @@ void Label::updateShaderProgram()
 
         break;
     case cocos2d::LabelEffect::OUTLINE: 
-        setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_LABEL_OUTLINE));
-        _uniformEffectColor = glGetUniformLocation(getGLProgram()->getProgram(), "u_effectColor");
-        _uniformEffectType = glGetUniformLocation(getGLProgram()->getProgram(), "u_effectType");
+        // the outline is drawn in the same pass as the text, see drawGlyphBatches()
+        setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_LABEL_BATCHED));
         break;
     case cocos2d::LabelEffect::GLOW:
         if (_useDistanceField)
@@ -821,6 +822,7 @@ bool Label::alignText()
     bool ret = true;
     do {
         _fontAtlas->prepareLetterDefinitions(_utf32Text);
+        _fontAtlasGeneration = _fontAtlas->getGeneration();
         auto& textures = _fontAtlas->getTextures();
         auto size = textures.size();
         if (size > static_cast<size_t>(_batchNodes.size()))
@@ -1597,6 +1599,114 @@ void Label::onDraw(const Mat4& transform, bool /*transformUpdated*/)
     }
 }
 
+namespace
+{
+    enum class GlyphPass
+    {
+        SHADOW,
+        OUTLINE,
+        TEXT,
+    };
+
+    // Copies the glyph quads of one atlas texture with the color of the pass multiplied in.
+    // Outline glyphs mirror u to (-1 - u), shadows of outlined glyphs mirror both u and v,
+    // see ccShader_Label_batched.frag.
+    V3F_C4B_T2F_Quad* fillGlyphQuads(V3F_C4B_T2F_Quad* dst, const V3F_C4B_T2F_Quad* src, ssize_t count,
+                                     const Color4F& color, bool mirrorU, bool mirrorV, const Mat4* offset)
+    {
+        for (ssize_t i = 0; i < count; ++i, ++dst)
+        {
+            *dst = src[i];
+            for (auto vertex : {&dst->tl, &dst->bl, &dst->tr, &dst->br})
+            {
+                vertex->colors.r = (GLubyte)(vertex->colors.r * color.r);
+                vertex->colors.g = (GLubyte)(vertex->colors.g * color.g);
+                vertex->colors.b = (GLubyte)(vertex->colors.b * color.b);
+                vertex->colors.a = (GLubyte)(vertex->colors.a * color.a);
+                if (mirrorU)
+                    vertex->texCoords.u = -1.0f - vertex->texCoords.u;
+                if (mirrorV)
+                    vertex->texCoords.v = -1.0f - vertex->texCoords.v;
+                if (offset)
+                    offset->transformPoint(&vertex->vertices);
+            }
+        }
+        return dst;
+    }
+}
+
+void Label::drawGlyphBatches(Renderer* renderer, const Mat4& transform, uint32_t flags)
+{
+    for (auto&& it : _letters)
+    {
+        it.second->updateTransform();
+    }
+
+    // The text color and the effects are baked into the glyph vertices, so every label using
+    // the same font atlas texture shares the material of its QuadCommand and the renderer
+    // batches them into one draw call. Shadow, outline and text of a label go into a single
+    // command, unless its glyphs span several atlas textures: then every pass of every texture
+    // gets its own command to keep the passes in order.
+    const bool outline = _currLabelEffect == LabelEffect::OUTLINE;
+    ssize_t glyphCount = 0;
+    for (auto&& batchNode : _batchNodes)
+    {
+        glyphCount += batchNode->getTextureAtlas()->getTotalQuads();
+    }
+    _glyphQuads.resize(glyphCount * ((_shadowEnabled ? 1 : 0) + (outline ? 1 : 0) + 1));
+
+    auto glProgramState = getGLProgramState();
+    const bool singleTexture = _batchNodes.size() == 1;
+    size_t commandCount = 0;
+    auto addCommand = [&](Texture2D* texture, V3F_C4B_T2F_Quad* begin, V3F_C4B_T2F_Quad* end) {
+        if (begin == end)
+            return;
+        if (commandCount == _glyphCommands.size())
+            _glyphCommands.emplace_back(new QuadCommand());
+        auto command = _glyphCommands[commandCount++].get();
+        command->init(_globalZOrder, texture, glProgramState, _blendFunc, begin, end - begin, transform, flags);
+        renderer->addCommand(command);
+    };
+
+    auto begin = _glyphQuads.data();
+    auto end = begin;
+    for (auto pass : {GlyphPass::SHADOW, GlyphPass::OUTLINE, GlyphPass::TEXT})
+    {
+        if ((pass == GlyphPass::SHADOW && !_shadowEnabled) || (pass == GlyphPass::OUTLINE && !outline))
+            continue;
+
+        for (auto&& batchNode : _batchNodes)
+        {
+            auto textureAtlas = batchNode->getTextureAtlas();
+            auto quads = textureAtlas->getQuads();
+            auto count = textureAtlas->getTotalQuads();
+            switch (pass)
+            {
+            case GlyphPass::SHADOW:
+                end = fillGlyphQuads(end, quads, count, _boldEnabled ? _textColorF : _shadowColor4F, outline, outline, &_shadowGlyphTransform);
+                break;
+            case GlyphPass::OUTLINE:
+                end = fillGlyphQuads(end, quads, count, _effectColorF, true, false, nullptr);
+                break;
+            case GlyphPass::TEXT:
+                end = fillGlyphQuads(end, quads, count, _textColorF, false, false, nullptr);
+                break;
+            }
+
+            if (!singleTexture)
+            {
+                addCommand(textureAtlas->getTexture(), begin, end);
+                begin = end;
+            }
+        }
+    }
+
+    if (singleTexture)
+    {
+        addCommand(_batchNodes.at(0)->getTextureAtlas()->getTexture(), begin, end);
+    }
+}
+
 void Label::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
     if (_batchNodes.empty() || _lengthOfString <= 0)
@@ -1619,7 +1729,23 @@ void Label::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
     if (_insideBounds)
 #endif
     {
-        if (!_shadowEnabled && (_currentLabelType == LabelType::BMFONT || _currentLabelType == LabelType::CHARMAP))
+        if (_currentLabelType == LabelType::TTF)
+        {
+            // keeps the pages of the visible glyphs from being evicted
+            for (ssize_t i = 0, count = _batchNodes.size(); i < count; ++i)
+            {
+                if (_batchNodes.at(i)->getTextureAtlas()->getTotalQuads() > 0)
+                {
+                    _fontAtlas->markPageUsed(static_cast<int>(i));
+                }
+            }
+        }
+
+        if (_currentLabelType == LabelType::TTF && getGLProgram() == GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_LABEL_BATCHED))
+        {
+            drawGlyphBatches(renderer, transform, flags);
+        }
+        else if (!_shadowEnabled && (_currentLabelType == LabelType::BMFONT || _currentLabelType == LabelType::CHARMAP))
         {
             for (auto&& it : _letters)
             {
@@ -1649,6 +1775,12 @@ void Label::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t pare
         return;
     }
     
+    // glyphs of this label may have been evicted from the font atlas
+    if (_fontAtlas && _fontAtlas->getGeneration() != _fontAtlasGeneration)
+    {
+        _contentDirty = true;
+    }
+
     if (_systemFontDirty || _contentDirty)
     {
         updateContent();
@@ -1663,6 +1795,7 @@ void Label::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t pare
         _transformDirty = _inverseDirty = true;
 
         _shadowTransform = transform(parentTransform);
+        _shadowGlyphTransform = _modelViewTransform.getInversed() * _shadowTransform;
 
         _position.x -= _shadowOffset.width;
         _position.y -= _shadowOffset.height;
@@ -1763,7 +1896,7 @@ Sprite* Label::getLetter(int letterIndex)
             break;
         }
 
-        auto contentDirty = _contentDirty;
+        auto contentDirty = _contentDirty || (_fontAtlas && _fontAtlas->getGeneration() != _fontAtlasGeneration);
         if (contentDirty)
         {
             updateContent();
@@ -2219,7 +2352,7 @@ Label::Overflow Label::getOverflow()const
 
 void Label::updateLetterSpriteScale(Sprite* sprite)
 {
-    if (_currentLabelType == LabelType::BMFONT && _bmFontSize > 0)
+    if ((_currentLabelType == LabelType::BMFONT && _bmFontSize > 0) || (_currentLabelType == LabelType::TTF && _useDistanceField))
     {
         sprite->setScale(_bmfontScale);
     }
@@ -655,6 +655,7 @@ protected:
 
     void onDraw(const Mat4& transform, bool transformUpdated);
     void onDrawShadow(GLProgram* glProgram, const Color4F& shadowColor);
+    void drawGlyphBatches(Renderer* renderer, const Mat4& transform, uint32_t flags);
     void drawSelf(bool visibleByCamera, Renderer* renderer, uint32_t flags);
 
     bool multilineTextWrapByChar();
@@ -712,6 +713,7 @@ protected:
     Sprite* _shadowNode;
 
     FontAtlas* _fontAtlas;
+    unsigned int _fontAtlasGeneration;
     Vector<SpriteBatchNode*> _batchNodes;
     std::vector<LetterInfo> _lettersInfo;
 
@@ -748,6 +750,11 @@ protected:
     QuadCommand _quadCommand;
     CustomCommand _customCommand;
     Mat4  _shadowTransform;
+    // the shadow offset in the label's own space, used for the batched glyphs
+    Mat4  _shadowGlyphTransform;
+    // shadow, outline and text glyphs of TTF labels, drawn by one QuadCommand per atlas texture
+    std::vector<V3F_C4B_T2F_Quad> _glyphQuads;
+    std::vector<std::unique_ptr<QuadCommand>> _glyphCommands;
     GLint _uniformEffectColor;
     GLint _uniformEffectType; // 0: None, 1: Outline, 2: Shadow; Only used when outline is enabled.
     GLint _uniformTextColor;
@@ -30,6 +30,7 @@
 #include "base/CCDirector.h"
 #include "2d/CCFontAtlas.h"
 #include "2d/CCFontFNT.h"
+#include "2d/CCFontSDF.h"
 
 NS_CC_BEGIN
 
@@ -142,6 +143,10 @@ void Label::updateBMFontScale()
         FontFNT *bmFont = (FontFNT*)font;
         float originalFontSize = bmFont->getOriginalFontSize();
         _bmfontScale = _bmFontSize * CC_CONTENT_SCALE_FACTOR() / originalFontSize;
+    }else if(_currentLabelType == LabelType::TTF && _useDistanceField && dynamic_cast<const FontSDF*>(font)){
+        // one baked atlas serves all the font sizes
+        auto sdfFont = static_cast<const FontSDF*>(font);
+        _bmfontScale = _fontConfig.fontSize * CC_CONTENT_SCALE_FACTOR() / sdfFont->getOriginalFontSize();
     }else{
         _bmfontScale = 1.0f;
     }
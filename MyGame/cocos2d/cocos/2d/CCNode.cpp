@@ -41,9 +41,12 @@ THE SOFTWARE.
 #include "2d/CCActionManager.h"
 #include "2d/CCScene.h"
 #include "2d/CCComponent.h"
+#include "2d/CCTransformHierarchy.h"
+#include "3d/CCAABB.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramState.h"
 #include "renderer/CCMaterial.h"
+#include "renderer/CCRenderer.h"
 #include "math/TransformUtils.h"
 
 
@@ -59,6 +62,7 @@ NS_CC_BEGIN
 // FIXME:: Yes, nodes might have a sort problem once every 30 days if the game runs at 60 FPS and each frame sprites are reordered.
 std::uint32_t Node::s_globalOrderOfArrival = 0;
 int Node::__attachedNodeCount = 0;
+std::uint64_t Node::s_transformStamp = 0;
 
 // MARK: Constructor, Destructor, Init
 
@@ -96,10 +100,14 @@ Node::Node()
 , _userData(nullptr)
 , _userObject(nullptr)
 , _glProgramState(nullptr)
+, _hitTestIndexSlot(-1)
+, _transformStamp(0)
+, _transformIndex(-1)
 , _running(false)
 , _visible(true)
 , _ignoreAnchorPointForPosition(false)
 , _reorderChildDirty(false)
+, _renderCacheDirty(true)
 , _isTransitionFinished(false)
 #if CC_ENABLE_SCRIPT_BINDING
 , _updateScriptHandler(0)
@@ -251,6 +259,7 @@ void Node::setSkewX(float skewX)
     
     _skewX = skewX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    updateTransformStamp();
 }
 
 float Node::getSkewY() const
@@ -265,6 +274,7 @@ void Node::setSkewY(float skewY)
     
     _skewY = skewY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    updateTransformStamp();
 }
 
 void Node::setLocalZOrder(std::int32_t z)
@@ -277,8 +287,6 @@ void Node::setLocalZOrder(std::int32_t z)
     {
         _parent->reorderChild(this, z);
     }
-
-    _eventDispatcher->setDirtyForNode(this);
 }
 
 /// zOrder setter : private method
@@ -298,6 +306,7 @@ void Node::setGlobalZOrder(float globalZOrder)
     if (_globalZOrder != globalZOrder)
     {
         _globalZOrder = globalZOrder;
+        _renderCacheDirty = true;
         _eventDispatcher->setDirtyForNode(this);
     }
 }
@@ -317,6 +326,7 @@ void Node::setRotation(float rotation)
     
     _rotationZ_X = _rotationZ_Y = rotation;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    updateTransformStamp();
     
     updateRotationQuat();
 }
@@ -334,6 +344,7 @@ void Node::setRotation3D(const Vec3& rotation)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    updateTransformStamp();
 
     _rotationX = rotation.x;
     _rotationY = rotation.y;
@@ -385,6 +396,7 @@ void Node::setRotationQuat(const Quaternion& quat)
     _rotationQuat = quat;
     updateRotation3D();
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    updateTransformStamp();
 }
 
 Quaternion Node::getRotationQuat() const
@@ -399,6 +411,7 @@ void Node::setRotationSkewX(float rotationX)
     
     _rotationZ_X = rotationX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    updateTransformStamp();
     
     updateRotationQuat();
 }
@@ -415,6 +428,7 @@ void Node::setRotationSkewY(float rotationY)
     
     _rotationZ_Y = rotationY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    updateTransformStamp();
     
     updateRotationQuat();
 }
@@ -434,6 +448,7 @@ void Node::setScale(float scale)
     
     _scaleX = _scaleY = _scaleZ = scale;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    updateTransformStamp();
 }
 
 /// scaleX getter
@@ -451,6 +466,7 @@ void Node::setScale(float scaleX,float scaleY)
     _scaleX = scaleX;
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    updateTransformStamp();
 }
 
 /// scaleX setter
@@ -461,6 +477,7 @@ void Node::setScaleX(float scaleX)
     
     _scaleX = scaleX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    updateTransformStamp();
 }
 
 /// scaleY getter
@@ -477,6 +494,7 @@ void Node::setScaleZ(float scaleZ)
     
     _scaleZ = scaleZ;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    updateTransformStamp();
 }
 
 /// scaleY getter
@@ -493,6 +511,7 @@ void Node::setScaleY(float scaleY)
     
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    updateTransformStamp();
 }
 
 
@@ -523,6 +542,7 @@ void Node::setPosition(float x, float y)
     _position.y = y;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    updateTransformStamp();
     _usingNormalizedPosition = false;
 }
 
@@ -568,6 +588,7 @@ void Node::setPositionZ(float positionZ)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    updateTransformStamp();
 
     _positionZ = positionZ;
 }
@@ -588,6 +609,7 @@ void Node::setPositionNormalized(const Vec2& position)
     _usingNormalizedPosition = true;
     _normalizedPositionDirty = true;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    updateTransformStamp();
 }
 
 ssize_t Node::getChildrenCount() const
@@ -607,8 +629,12 @@ void Node::setVisible(bool visible)
     if(visible != _visible)
     {
         _visible = visible;
+        _renderCacheDirty = true;
         if(_visible)
+        {
             _transformUpdated = _transformDirty = _inverseDirty = true;
+            updateTransformStamp();
+        }
     }
 }
 
@@ -630,6 +656,7 @@ void Node::setAnchorPoint(const Vec2& point)
         _anchorPoint = point;
         _anchorPointInPoints.set(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        updateTransformStamp();
     }
 }
 
@@ -647,6 +674,7 @@ void Node::setContentSize(const Size & size)
 
         _anchorPointInPoints.set(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
         _transformUpdated = _transformDirty = _inverseDirty = _contentSizeDirty = true;
+        updateTransformStamp();
     }
 }
 
@@ -661,6 +689,9 @@ void Node::setParent(Node * parent)
 {
     _parent = parent;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    updateTransformStamp();
+    _eventDispatcher->setDirtyForNode(this);
+    TransformHierarchy::markStructureDirty();
 }
 
 /// isRelativeAnchorPoint getter
@@ -676,6 +707,7 @@ void Node::setIgnoreAnchorPointForPosition(bool newValue)
     {
         _ignoreAnchorPointForPosition = newValue;
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        updateTransformStamp();
     }
 }
 
@@ -741,6 +773,8 @@ void Node::setGLProgramState(cocos2d::GLProgramState* glProgramState)
 
         if (_glProgramState)
             _glProgramState->setNodeBinding(this);
+
+        _renderCacheDirty = true;
     }
 }
 
@@ -782,6 +816,15 @@ Rect Node::getBoundingBox() const
     return RectApplyAffineTransform(rect, getNodeToParentAffineTransform());
 }
 
+bool Node::getCullingBounds(AABB* bounds) const
+{
+    if (_contentSize.width <= 0 || _contentSize.height <= 0)
+        return false;
+
+    bounds->set(Vec3::ZERO, Vec3(_contentSize.width, _contentSize.height, 0));
+    return true;
+}
+
 // MARK: Children logic
 
 // lazy allocs
@@ -1120,6 +1163,8 @@ void Node::removeAllChildrenWithCleanup(bool cleanup)
 
 void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
 {
+    _renderCacheDirty = true;
+
     // IMPORTANT:
     //  -1st do onExit
     //  -2nd cleanup
@@ -1162,16 +1207,42 @@ void Node::insertChild(Node* child, int z)
 #endif // CC_ENABLE_GC_FOR_NATIVE_OBJECTS
     _transformUpdated = true;
     _reorderChildDirty = true;
-    _children.pushBack(child);
+    // the child gets the latest order of arrival right after, so it goes after the siblings with the same Z order
+    auto it = std::upper_bound(_children.begin(), _children.end(), z, [](int localZOrder, const Node* node) {
+        return localZOrder < node->_localZOrder;
+    });
+    _children.insert(it - _children.begin(), child);
     child->_setLocalZOrder(z);
 }
 
+void Node::repositionChild(Node* child)
+{
+    auto first = _children.begin();
+    auto last = _children.end();
+    auto it = std::find(first, last, child);
+    if (it == last)
+        return;
+
+    // rotate rather than erase and insert, which would release and retain the child
+    auto pos = std::upper_bound(first, it, child, isNodeOrderLess);
+    if (pos != it)
+    {
+        std::rotate(pos, it, it + 1);
+    }
+    else
+    {
+        std::rotate(it, it + 1, std::upper_bound(it + 1, last, child, isNodeOrderLess));
+    }
+}
+
 void Node::reorderChild(Node *child, int zOrder)
 {
     CCASSERT( child != nullptr, "Child must be non-nil");
     _reorderChildDirty = true;
     child->updateOrderOfArrival();
     child->_setLocalZOrder(zOrder);
+    repositionChild(child);
+    _eventDispatcher->setDirtyForNode(child);
 }
 
 void Node::sortAllChildren()
@@ -1180,7 +1251,6 @@ void Node::sortAllChildren()
     {
         sortNodes(_children);
         _reorderChildDirty = false;
-        _eventDispatcher->setDirtyForNode(this);
     }
 }
 
@@ -1205,6 +1275,38 @@ void Node::visit()
 
 uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFlags)
 {
+    // the scene computed the flags and the model view transform of the node before visiting
+    auto hierarchy = TransformHierarchy::getVisiting();
+    const int hierarchyIndex = hierarchy ? hierarchy->indexOf(this, parentTransform) : -1;
+    if (hierarchyIndex >= 0)
+    {
+        if (!isVisitableByVisitingCamera())
+            return parentFlags;
+
+        // what changed since the node was last visited, it may have been culled meanwhile,
+        // and what its parent passes down, like a RetainedBatchNode recording it
+        uint32_t flags = hierarchy->_pendingFlags[hierarchyIndex] | parentFlags;
+        hierarchy->_pendingFlags[hierarchyIndex] = 0;
+        if (hierarchy->isChangedSinceUpdate(hierarchyIndex))
+        {
+            // it or its parent moved while visited, like a Label laying out a new string or the children of a
+            // ParallaxNode, so the update missed it: compute it as usual and keep it for its descendants
+            flags |= FLAGS_TRANSFORM_DIRTY | (_contentSizeDirty ? FLAGS_CONTENT_SIZE_DIRTY : 0);
+            _modelViewTransform = this->transform(parentTransform);
+            hierarchy->setVisitedTransform(hierarchyIndex, _modelViewTransform);
+        }
+        else if (flags & FLAGS_DIRTY_MASK)
+        {
+            _modelViewTransform = hierarchy->_worldTransforms[hierarchyIndex];
+        }
+
+        _transformUpdated = false;
+        _contentSizeDirty = false;
+        _renderCacheDirty = false;
+
+        return flags;
+    }
+
     if(_usingNormalizedPosition)
     {
         CCASSERT(_parent, "setPositionNormalized() doesn't work with orphan nodes");
@@ -1233,6 +1335,7 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
     
     _transformUpdated = false;
     _contentSizeDirty = false;
+    _renderCacheDirty = false;
 
     return flags;
 }
@@ -1256,9 +1359,17 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
 
     // IMPORTANT:
     // To ease the migration to v3.0, we still support the Mat4 stack,
-    // but it is deprecated and your code should not rely on it
-    _director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    _director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    // but it is deprecated and your code should not rely on it.
+    // Scenes keeping their transforms in a TransformHierarchy don't maintain it.
+    auto hierarchy = TransformHierarchy::getVisiting();
+    const bool useMatrixStack = hierarchy == nullptr;
+    // skip the children the visiting camera sees nothing of, unless the subtree is being recorded
+    const TransformHierarchy* culling = (hierarchy && !renderer->isCapturingCommands()) ? hierarchy : nullptr;
+    if (useMatrixStack)
+    {
+        _director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+        _director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    }
     
     bool visibleByCamera = isVisitableByVisitingCamera();
 
@@ -1273,7 +1384,10 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
             auto node = _children.at(i);
 
             if (node && node->_localZOrder < 0)
-                node->visit(renderer, _modelViewTransform, flags);
+            {
+                if (!culling || !culling->isCulled(node))
+                    node->visit(renderer, _modelViewTransform, flags);
+            }
             else
                 break;
         }
@@ -1282,14 +1396,18 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
             this->draw(renderer, _modelViewTransform, flags);
 
         for(auto it=_children.cbegin()+i, itCend = _children.cend(); it != itCend; ++it)
-            (*it)->visit(renderer, _modelViewTransform, flags);
+        {
+            if (!culling || !culling->isCulled(*it))
+                (*it)->visit(renderer, _modelViewTransform, flags);
+        }
     }
     else if (visibleByCamera)
     {
         this->draw(renderer, _modelViewTransform, flags);
     }
 
-    _director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    if (useMatrixStack)
+        _director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
     
     // FIX ME: Why need to set _orderOfArrival to 0??
     // Please refer to https://github.com/cocos2d/cocos2d-x/pull/6920
@@ -1808,6 +1926,7 @@ void Node::setNodeToParentTransform(const Mat4& transform)
     _transform = transform;
     _transformDirty = false;
     _transformUpdated = true;
+    updateTransformStamp();
 
     if (_additionalTransform)
         // _additionalTransform[1] has a copy of lastest transform
@@ -1841,6 +1960,7 @@ void Node::setAdditionalTransform(const Mat4* additionalTransform)
         _additionalTransform[0] = *additionalTransform;
     }
     _transformUpdated = _additionalTransformDirty = _inverseDirty = true;
+    updateTransformStamp();
 }
 
 void Node::setAdditionalTransform(const Mat4& additionalTransform)
@@ -2012,6 +2132,7 @@ void Node::setOpacity(GLubyte opacity)
 void Node::updateDisplayedOpacity(GLubyte parentOpacity)
 {
     _displayedOpacity = _realOpacity * parentOpacity/255.0;
+    _renderCacheDirty = true;
     updateColor();
     
     if (_cascadeOpacityEnabled)
@@ -2099,6 +2220,7 @@ void Node::updateDisplayedColor(const Color3B& parentColor)
     _displayedColor.r = _realColor.r * parentColor.r/255.0;
     _displayedColor.g = _realColor.g * parentColor.g/255.0;
     _displayedColor.b = _realColor.b * parentColor.b/255.0;
+    _renderCacheDirty = true;
     updateColor();
     
     if (_cascadeColorEnabled)
@@ -2202,7 +2324,11 @@ bool isScreenPointInRect(const Vec2 &pt, const Camera* camera, const Mat4& w2l,
 // MARK: Camera
 void Node::setCameraMask(unsigned short mask, bool applyChildren)
 {
-    _cameraMask = mask;
+    if (_cameraMask != mask)
+    {
+        _cameraMask = mask;
+        _renderCacheDirty = true;
+    }
     if (applyChildren)
     {
         for (const auto& child : _children)
@@ -63,6 +63,7 @@ class GLProgramState;
 class Material;
 class Camera;
 class PhysicsBody;
+class AABB;
 
 /**
  * @addtogroup _2d
@@ -946,14 +947,20 @@ public:
     static void sortNodes(cocos2d::Vector<_T*>& nodes)
     {
         static_assert(std::is_base_of<Node, _T>::value, "Node::sortNodes: Only accept derived of Node!");
+        // children are kept in order when they are added or reordered, so they rarely need to be sorted
+        if (!std::is_sorted(std::begin(nodes), std::end(nodes), isNodeOrderLess))
+        {
+            std::sort(std::begin(nodes), std::end(nodes), isNodeOrderLess);
+        }
+    }
+
+    /** Whether n1 is drawn before n2 when they are siblings: lower local Z order first, then earlier order of arrival. */
+    static bool isNodeOrderLess(const Node* n1, const Node* n2)
+    {
 #if CC_64BITS
-        std::sort(std::begin(nodes), std::end(nodes), [](_T* n1, _T* n2) {
-            return (n1->_localZOrder$Arrival < n2->_localZOrder$Arrival);
-        });
+        return (n1->_localZOrder$Arrival < n2->_localZOrder$Arrival);
 #else
-        std::sort(std::begin(nodes), std::end(nodes), [](_T* n1, _T* n2) {
-            return (n1->_localZOrder == n2->_localZOrder && n1->_orderOfArrival < n2->_orderOfArrival) || n1->_localZOrder < n2->_localZOrder;
-        });
+        return (n1->_localZOrder == n2->_localZOrder && n1->_orderOfArrival < n2->_orderOfArrival) || n1->_localZOrder < n2->_localZOrder;
 #endif
     }
 
@@ -1196,6 +1203,15 @@ public:
      */
     virtual Rect getBoundingBox() const;
 
+    /**
+     * Gets the box the node draws in, in its own coordinate system, used to cull the nodes a camera doesn't see
+     * (see TransformHierarchy::setCullingEnabled()). By default the content rect of the node.
+     *
+     * @param bounds The box to fill.
+     * @return False if the node has no content size or draws where it can't tell, it is never culled then.
+     */
+    virtual bool getCullingBounds(AABB* bounds) const;
+
     /** @deprecated Use getBoundingBox instead */
     CC_DEPRECATED_ATTRIBUTE virtual Rect boundingBox() const { return getBoundingBox(); }
 
@@ -1871,6 +1887,9 @@ protected:
     /// helper that reorder a child
     void insertChild(Node* child, int z);
 
+    /// Moves a child whose order changed to its place among its siblings, which are still sorted.
+    void repositionChild(Node* child);
+
     /// Removes a child, call child->onExit(), do cleanup, remove it from children array.
     void detachChild(Node *child, ssize_t index, bool doCleanup);
 
@@ -1897,6 +1916,10 @@ protected:
     // update Rotation3D from quaternion
     void updateRotation3D();
     
+    /// Stamps a change of the node to parent transform or content size, the hit test index compares the stamps of
+    /// the ancestors of its nodes when queried, so bounds are right even for nodes that aren't visited.
+    void updateTransformStamp() { _transformStamp = ++s_transformStamp; }
+    
 private:
     void addChildHelper(Node* child, int localZOrder, int tag, const std::string &name, bool setTag);
     
@@ -1982,6 +2005,12 @@ protected:
 
     EventDispatcher* _eventDispatcher;  ///< event dispatcher used to dispatch all kinds of events
 
+    int _hitTestIndexSlot;          ///< slot of the node in the touch hit test index of the event dispatcher, -1 if not indexed
+    std::uint64_t _transformStamp;  ///< s_transformStamp of the last change of the transform or content size of the node
+    static std::uint64_t s_transformStamp;
+
+    int _transformIndex;            ///< index of the node in the TransformHierarchy of its scene, -1 if not in one
+
     bool _running;                  ///< is running
 
     bool _visible;                  ///< is this node visible
@@ -1990,6 +2019,7 @@ protected:
                                           ///< Used by Layer and Scene.
 
     bool _reorderChildDirty;          ///< children order dirty flag
+    bool _renderCacheDirty;           ///< whether what the node draws changed in a way its transform and content size flags don't tell, used by RetainedBatchNode
     bool _isTransitionFinished;       ///< flag to indicate whether the transition was finished
 
 #if CC_ENABLE_SCRIPT_BINDING
@@ -2036,6 +2066,10 @@ public:
 
     static int __attachedNodeCount;
     
+    friend class EventDispatcher;
+    friend class RetainedBatchNode;
+    friend class TransformHierarchy;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Node);
 };
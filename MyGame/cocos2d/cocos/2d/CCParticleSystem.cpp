@@ -47,6 +47,12 @@ THE SOFTWARE.
 
 #include <string>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #include "2d/CCParticleBatchNode.h"
 #include "renderer/CCTextureAtlas.h"
 #include "base/base64.h"
@@ -56,6 +62,7 @@ THE SOFTWARE.
 #include "base/ccUTF8.h"
 #include "renderer/CCTextureCache.h"
 #include "platform/CCFileUtils.h"
+#include "base/CCJobSystem.h"
 
 using namespace std;
 
@@ -96,6 +103,60 @@ inline void normalize_point(float x, float y, particle_point* out)
     out->y = y * n;
 }
 
+// Four floats at a time, the particle data being stored property by property
+#if CC_USE_PARTICLE_SIMD && defined(__SSE2__)
+#define CC_PARTICLE_SIMD 1
+typedef __m128 float4;
+static inline float4 load4(const float* p) { return _mm_loadu_ps(p); }
+static inline void store4(float* p, float4 v) { _mm_storeu_ps(p, v); }
+static inline float4 set4(float f) { return _mm_set1_ps(f); }
+static inline float4 add4(float4 a, float4 b) { return _mm_add_ps(a, b); }
+static inline float4 sub4(float4 a, float4 b) { return _mm_sub_ps(a, b); }
+static inline float4 mul4(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+static inline float4 max4(float4 a, float4 b) { return _mm_max_ps(a, b); }
+// 1 / sqrt(v) where v > 0, 0 elsewhere
+static inline float4 invLength4(float4 v)
+{
+    float4 inv = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(v));
+    return _mm_and_ps(_mm_cmpgt_ps(v, _mm_setzero_ps()), inv);
+}
+#elif CC_USE_PARTICLE_SIMD && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#define CC_PARTICLE_SIMD 1
+typedef float32x4_t float4;
+static inline float4 load4(const float* p) { return vld1q_f32(p); }
+static inline void store4(float* p, float4 v) { vst1q_f32(p, v); }
+static inline float4 set4(float f) { return vdupq_n_f32(f); }
+static inline float4 add4(float4 a, float4 b) { return vaddq_f32(a, b); }
+static inline float4 sub4(float4 a, float4 b) { return vsubq_f32(a, b); }
+static inline float4 mul4(float4 a, float4 b) { return vmulq_f32(a, b); }
+static inline float4 max4(float4 a, float4 b) { return vmaxq_f32(a, b); }
+// 1 / sqrt(v) where v > 0, 0 elsewhere, the estimate is refined twice
+static inline float4 invLength4(float4 v)
+{
+    float4 inv = vrsqrteq_f32(v);
+    inv = vmulq_f32(inv, vrsqrtsq_f32(vmulq_f32(v, inv), inv));
+    inv = vmulq_f32(inv, vrsqrtsq_f32(vmulq_f32(v, inv), inv));
+    return vreinterpretq_f32_u32(vandq_u32(vcgtq_f32(v, vdupq_n_f32(0.0f)), vreinterpretq_u32_f32(inv)));
+}
+#endif
+
+// values[i] += deltas[i] * dt for i in [begin, end)
+static void addScaled(float* values, const float* deltas, float dt, int begin, int end)
+{
+    int i = begin;
+#if CC_PARTICLE_SIMD
+    const float4 dt4 = set4(dt);
+    for (; i + 4 <= end; i += 4)
+    {
+        store4(values + i, add4(load4(values + i), mul4(load4(deltas + i), dt4)));
+    }
+#endif
+    for (; i < end; ++i)
+    {
+        values[i] += deltas[i] * dt;
+    }
+}
+
 /**
  A more effect random number getter function, get from ejoy2d.
  */
@@ -188,6 +249,7 @@ void ParticleData::release()
 
 Vector<ParticleSystem*> ParticleSystem::__allInstances;
 float ParticleSystem::__totalParticleCountFactor = 1.0f;
+bool ParticleSystem::__parallelUpdateEnabled = false;
 
 ParticleSystem::ParticleSystem()
 : _isBlendAdditive(false)
@@ -278,6 +340,16 @@ void ParticleSystem::setTotalParticleCountFactor(float factor)
     __totalParticleCountFactor = factor;
 }
 
+void ParticleSystem::setParallelUpdateEnabled(bool enabled)
+{
+    __parallelUpdateEnabled = enabled;
+}
+
+bool ParticleSystem::isParallelUpdateEnabled()
+{
+    return __parallelUpdateEnabled;
+}
+
 bool ParticleSystem::init()
 {
     return initWithTotalParticles(150);
@@ -861,6 +933,11 @@ bool ParticleSystem::isFull()
 }
 
 // ParticleSystem - MainLoop
+bool ParticleSystem::getCullingBounds(AABB* /*bounds*/) const
+{
+    return false;
+}
+
 void ParticleSystem::update(float dt)
 {
     CC_PROFILER_START_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
@@ -926,116 +1003,169 @@ void ParticleSystem::update(float dt)
             }
         }
         
-        if (_emitterMode == Mode::GRAVITY)
+        forEachParticleRange(_particleCount, [this, dt](int begin, int end) {
+            updateParticleRange(begin, end, dt);
+        });
+        
+        updateParticleQuads();
+        _transformSystemDirty = false;
+    }
+
+    // only update gl buffer when visible
+    if (_visible && ! _batchNode)
+    {
+        postStep();
+    }
+
+    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
+}
+
+void ParticleSystem::updateParticleRange(int begin, int end, float dt)
+{
+    if (_emitterMode == Mode::GRAVITY)
+    {
+        int i = begin;
+#if CC_PARTICLE_SIMD
+        const float4 dt4 = set4(dt);
+        const float4 moveScale = set4(dt * _yCoordFlipped);
+        const float4 gravityX = set4(modeA.gravity.x);
+        const float4 gravityY = set4(modeA.gravity.y);
+        for (; i + 4 <= end; i += 4)
         {
-            for (int i = 0 ; i < _particleCount; ++i)
-            {
-                particle_point tmp, radial = {0.0f, 0.0f}, tangential;
-                
-                // radial acceleration
-                if (_particleData.posx[i] || _particleData.posy[i])
-                {
-                    normalize_point(_particleData.posx[i], _particleData.posy[i], &radial);
-                }
-                tangential = radial;
-                radial.x *= _particleData.modeA.radialAccel[i];
-                radial.y *= _particleData.modeA.radialAccel[i];
-                
-                // tangential acceleration
-                std::swap(tangential.x, tangential.y);
-                tangential.x *= - _particleData.modeA.tangentialAccel[i];
-                tangential.y *= _particleData.modeA.tangentialAccel[i];
-                
-                // (gravity + radial + tangential) * dt
-                tmp.x = radial.x + tangential.x + modeA.gravity.x;
-                tmp.y = radial.y + tangential.y + modeA.gravity.y;
-                tmp.x *= dt;
-                tmp.y *= dt;
-                
-                _particleData.modeA.dirX[i] += tmp.x;
-                _particleData.modeA.dirY[i] += tmp.y;
-                
-                // this is cocos2d-x v3.0
-                // if (_configName.length()>0 && _yCoordFlipped != -1)
-                
-                // this is cocos2d-x v3.0
-                tmp.x = _particleData.modeA.dirX[i] * dt * _yCoordFlipped;
-                tmp.y = _particleData.modeA.dirY[i] * dt * _yCoordFlipped;
-                _particleData.posx[i] += tmp.x;
-                _particleData.posy[i] += tmp.y;
-            }
+            float4 x = load4(_particleData.posx + i);
+            float4 y = load4(_particleData.posy + i);
+
+            // unit vector from the emitter, zero at the emitter
+            float4 inv = invLength4(add4(mul4(x, x), mul4(y, y)));
+            float4 unitX = mul4(x, inv);
+            float4 unitY = mul4(y, inv);
+
+            // (gravity + radial + tangential) * dt
+            float4 radialAccel = load4(_particleData.modeA.radialAccel + i);
+            float4 tangentialAccel = load4(_particleData.modeA.tangentialAccel + i);
+            float4 accelX = add4(sub4(mul4(unitX, radialAccel), mul4(unitY, tangentialAccel)), gravityX);
+            float4 accelY = add4(add4(mul4(unitY, radialAccel), mul4(unitX, tangentialAccel)), gravityY);
+
+            float4 dirX = add4(load4(_particleData.modeA.dirX + i), mul4(accelX, dt4));
+            float4 dirY = add4(load4(_particleData.modeA.dirY + i), mul4(accelY, dt4));
+            store4(_particleData.modeA.dirX + i, dirX);
+            store4(_particleData.modeA.dirY + i, dirY);
+
+            store4(_particleData.posx + i, add4(x, mul4(dirX, moveScale)));
+            store4(_particleData.posy + i, add4(y, mul4(dirY, moveScale)));
         }
-        else
+#endif
+        for (; i < end; ++i)
         {
-            //Why use so many for-loop separately instead of putting them together?
-            //When the processor needs to read from or write to a location in memory,
-            //it first checks whether a copy of that data is in the cache.
-            //And every property's memory of the particle system is continuous,
-            //for the purpose of improving cache hit rate, we should process only one property in one for-loop AFAP.
-            //It was proved to be effective especially for low-end machine. 
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.modeB.angle[i] += _particleData.modeB.degreesPerSecond[i] * dt;
-            }
+            particle_point tmp, radial = {0.0f, 0.0f}, tangential;
             
-            for (int i = 0; i < _particleCount; ++i)
+            // radial acceleration
+            if (_particleData.posx[i] || _particleData.posy[i])
             {
-                _particleData.modeB.radius[i] += _particleData.modeB.deltaRadius[i] * dt;
+                normalize_point(_particleData.posx[i], _particleData.posy[i], &radial);
             }
+            tangential = radial;
+            radial.x *= _particleData.modeA.radialAccel[i];
+            radial.y *= _particleData.modeA.radialAccel[i];
             
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.posx[i] = - cosf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i];
-            }
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.posy[i] = - sinf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i] * _yCoordFlipped;
-            }
-        }
-        
-        //color r,g,b,a
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorR[i] += _particleData.deltaColorR[i] * dt;
+            // tangential acceleration
+            std::swap(tangential.x, tangential.y);
+            tangential.x *= - _particleData.modeA.tangentialAccel[i];
+            tangential.y *= _particleData.modeA.tangentialAccel[i];
+            
+            // (gravity + radial + tangential) * dt
+            tmp.x = radial.x + tangential.x + modeA.gravity.x;
+            tmp.y = radial.y + tangential.y + modeA.gravity.y;
+            tmp.x *= dt;
+            tmp.y *= dt;
+            
+            _particleData.modeA.dirX[i] += tmp.x;
+            _particleData.modeA.dirY[i] += tmp.y;
+            
+            // this is cocos2d-x v3.0
+            // if (_configName.length()>0 && _yCoordFlipped != -1)
+            
+            // this is cocos2d-x v3.0
+            tmp.x = _particleData.modeA.dirX[i] * dt * _yCoordFlipped;
+            tmp.y = _particleData.modeA.dirY[i] * dt * _yCoordFlipped;
+            _particleData.posx[i] += tmp.x;
+            _particleData.posy[i] += tmp.y;
         }
+    }
+    else
+    {
+        //Why use so many for-loop separately instead of putting them together?
+        //When the processor needs to read from or write to a location in memory,
+        //it first checks whether a copy of that data is in the cache.
+        //And every property's memory of the particle system is continuous,
+        //for the purpose of improving cache hit rate, we should process only one property in one for-loop AFAP.
+        //It was proved to be effective especially for low-end machine. 
+        addScaled(_particleData.modeB.angle, _particleData.modeB.degreesPerSecond, dt, begin, end);
+        addScaled(_particleData.modeB.radius, _particleData.modeB.deltaRadius, dt, begin, end);
         
-        for (int i = 0 ; i < _particleCount; ++i)
+        for (int i = begin; i < end; ++i)
         {
-            _particleData.colorG[i] += _particleData.deltaColorG[i] * dt;
+            _particleData.posx[i] = - cosf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i];
         }
-        
-        for (int i = 0 ; i < _particleCount; ++i)
+        for (int i = begin; i < end; ++i)
         {
-            _particleData.colorB[i] += _particleData.deltaColorB[i] * dt;
+            _particleData.posy[i] = - sinf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i] * _yCoordFlipped;
         }
-        
-        for (int i = 0 ; i < _particleCount; ++i)
+    }
+    
+    //color r,g,b,a
+    addScaled(_particleData.colorR, _particleData.deltaColorR, dt, begin, end);
+    addScaled(_particleData.colorG, _particleData.deltaColorG, dt, begin, end);
+    addScaled(_particleData.colorB, _particleData.deltaColorB, dt, begin, end);
+    addScaled(_particleData.colorA, _particleData.deltaColorA, dt, begin, end);
+    //size
+    {
+        int i = begin;
+#if CC_PARTICLE_SIMD
+        const float4 dt4 = set4(dt);
+        const float4 zero = set4(0.0f);
+        for (; i + 4 <= end; i += 4)
         {
-            _particleData.colorA[i] += _particleData.deltaColorA[i] * dt;
+            float4 size = add4(load4(_particleData.size + i), mul4(load4(_particleData.deltaSize + i), dt4));
+            store4(_particleData.size + i, max4(size, zero));
         }
-        //size
-        for (int i = 0 ; i < _particleCount; ++i)
+#endif
+        for (; i < end; ++i)
         {
             _particleData.size[i] += (_particleData.deltaSize[i] * dt);
             _particleData.size[i] = MAX(0, _particleData.size[i]);
         }
-        //angle
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.rotation[i] += _particleData.deltaRotation[i] * dt;
-        }
-        
-        updateParticleQuads();
-        _transformSystemDirty = false;
     }
+    //angle
+    addScaled(_particleData.rotation, _particleData.deltaRotation, dt, begin, end);
+}
 
-    // only update gl buffer when visible
-    if (_visible && ! _batchNode)
+void ParticleSystem::forEachParticleRange(int count, const std::function<void(int, int)>& func)
+{
+    if (count <= 0)
+        return;
+
+    auto jobSystem = JobSystem::getInstance();
+    const int threadCount = static_cast<int>(std::min(4u, jobSystem->getWorkerCount()));
+    if (!__parallelUpdateEnabled || count < PARALLEL_UPDATE_MIN_PARTICLES || threadCount < 2)
     {
-        postStep();
+        func(0, count);
+        return;
     }
 
-    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
+    // ranges of a multiple of 4 particles, only the last one has a scalar tail
+    const int rangeSize = (count / threadCount + 3) & ~3;
+    std::vector<JobSystem::JobHandle> workers;
+    for (int begin = rangeSize; begin < count; begin += rangeSize)
+    {
+        int end = std::min(begin + rangeSize, count);
+        workers.push_back(jobSystem->schedule(std::bind(func, begin, end), nullptr, JobSystem::Priority::HIGH));
+    }
+
+    // the first range is updated by this thread
+    func(0, std::min(rangeSize, count));
+    for (auto& worker : workers)
+        jobSystem->wait(worker);
 }
 
 void ParticleSystem::updateWithNoTime(void)
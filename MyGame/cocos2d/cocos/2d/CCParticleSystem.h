@@ -255,6 +255,19 @@ public:
     /** Gets all ParticleSystem references
      */
     static Vector<ParticleSystem*>& getAllParticleSystems();
+
+    /** The minimum number of living particles for a system to be updated in several threads. */
+    static const int PARALLEL_UPDATE_MIN_PARTICLES = 1024;
+
+    /**
+     * Enables or disables the parallel update of the particles.
+     * When enabled, the particles and quads of the systems with at least PARALLEL_UPDATE_MIN_PARTICLES
+     * living particles are updated in ranges by the worker threads of the JobSystem. Disabled by default.
+     */
+    static void setParallelUpdateEnabled(bool enabled);
+
+    /** Whether or not the particles of large systems are updated in several threads. */
+    static bool isParallelUpdateEnabled();
 public:
     void addParticles(int count);
     
@@ -750,6 +763,8 @@ public:
     virtual void onEnter() override;
     virtual void onExit() override;
     virtual void update(float dt) override;
+    /** Particles are emitted anywhere, whatever the content size, so a particle system is never culled. */
+    virtual bool getCullingBounds(AABB* bounds) const override;
     virtual Texture2D* getTexture() const override;
     virtual void setTexture(Texture2D *texture) override;
     /**
@@ -823,6 +838,15 @@ CC_CONSTRUCTOR_ACCESS:
 
 protected:
     virtual void updateBlendFunc();
+
+    /** Moves the living particles in [begin, end) and updates their color, size and rotation, may run in a worker thread. */
+    void updateParticleRange(int begin, int end, float dt);
+
+    /**
+     * Calls func with consecutive ranges covering [0, count), in the worker threads when the parallel update
+     * is enabled and count is large enough. Returns once all the ranges are done.
+     */
+    void forEachParticleRange(int count, const std::function<void(int, int)>& func);
     
 private:
     friend class EngineDataManager;
@@ -921,6 +945,8 @@ protected:
     int _particleCount;
     /** The factor affects the total particle count, its value should be 0.0f ~ 1.0f, default 1.0f*/
     static float __totalParticleCountFactor;
+    /** Whether or not the large systems are updated in several threads */
+    static bool __parallelUpdateEnabled;
     
     /** How many seconds the emitter will run. -1 means 'forever' */
     float _duration;
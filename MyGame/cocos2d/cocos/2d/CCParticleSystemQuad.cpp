@@ -32,11 +32,18 @@ THE SOFTWARE.
 
 #include <algorithm>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #include "2d/CCSpriteFrame.h"
 #include "2d/CCParticleBatchNode.h"
 #include "renderer/CCTextureAtlas.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCRenderer.h"
+#include "renderer/CCGLProgramCache.h"
 #include "base/CCDirector.h"
 #include "base/CCEventType.h"
 #include "base/CCConfiguration.h"
@@ -44,14 +51,26 @@ THE SOFTWARE.
 #include "base/CCEventDispatcher.h"
 #include "base/ccUTF8.h"
 
+// glVertexAttribDivisorARB() and glDrawArraysInstancedARB() are only declared by the desktop OpenGL headers
+#if defined(GL_VERTEX_ATTRIB_ARRAY_DIVISOR_ARB)
+#define CC_PARTICLE_INSTANCING_SUPPORTED 1
+#else
+#define CC_PARTICLE_INSTANCING_SUPPORTED 0
+#endif
+
 NS_CC_BEGIN
 
 ParticleSystemQuad::ParticleSystemQuad()
 :_quads(nullptr)
 ,_indices(nullptr)
 ,_VAOname(0)
+,_instancingEnabled(false)
+,_instancingVAO(0)
+,_instancingProgramState(nullptr)
+,_texRect(0.0f, 0.0f, 1.0f, 1.0f)
 {
     memset(_buffersVBO, 0, sizeof(_buffersVBO));
+    memset(_instancingVBO, 0, sizeof(_instancingVBO));
 }
 
 ParticleSystemQuad::~ParticleSystemQuad()
@@ -67,6 +86,8 @@ ParticleSystemQuad::~ParticleSystemQuad()
             GL::bindVAO(0);
         }
     }
+    releaseInstancing();
+    CC_SAFE_RELEASE(_instancingProgramState);
 }
 
 // implementation ParticleSystemQuad
@@ -176,6 +197,7 @@ void ParticleSystemQuad::initTexCoordsWithRect(const Rect& pointRect)
 
     // Important. Texture in cocos2d are inverted, so the Y component should be inverted
     std::swap(top, bottom);
+    _texRect.set(left, bottom, right, top);
 
     V3F_C4B_T2F_Quad *quads = nullptr;
     unsigned int start = 0, end = 0;
@@ -271,9 +293,14 @@ inline void updatePosWithParticle(V3F_C4B_T2F_Quad *quad, const Vec2& newPositio
     GLfloat x = newPosition.x;
     GLfloat y = newPosition.y;
     
-    GLfloat r = (GLfloat)-CC_DEGREES_TO_RADIANS(rotation);
-    GLfloat cr = cosf(r);
-    GLfloat sr = sinf(r);
+    GLfloat cr = 1.0f;
+    GLfloat sr = 0.0f;
+    if (rotation != 0.0f)
+    {
+        GLfloat r = (GLfloat)-CC_DEGREES_TO_RADIANS(rotation);
+        cr = cosf(r);
+        sr = sinf(r);
+    }
     GLfloat ax = x1 * cr - y1 * sr + x;
     GLfloat ay = x1 * sr + y1 * cr + y;
     GLfloat bx = x2 * cr - y1 * sr + x;
@@ -300,6 +327,99 @@ inline void updatePosWithParticle(V3F_C4B_T2F_Quad *quad, const Vec2& newPositio
     quad->tr.vertices.y = cy;
 }
 
+inline void setQuadColor(V3F_C4B_T2F_Quad *quad, const Color4B& color)
+{
+    quad->bl.colors = color;
+    quad->br.colors = color;
+    quad->tl.colors = color;
+    quad->tr.colors = color;
+}
+
+// truncated and clamped to [0, 255] like the vector lanes, so that every particle gets the same color
+static inline GLubyte toColorByte(float value)
+{
+    return !(value > 0.0f) ? 0 : (value >= 255.0f ? 255 : static_cast<GLubyte>(value));
+}
+
+// Converts the colors of the particles in [begin, end) to bytes, four particles at a time when possible
+template <typename StoreColor>
+static void convertParticleColors(const ParticleData& particleData, bool opacityModifyRGB, int begin, int end, const StoreColor& storeColor)
+{
+    const float* r = particleData.colorR;
+    const float* g = particleData.colorG;
+    const float* b = particleData.colorB;
+    const float* a = particleData.colorA;
+    int i = begin;
+#if CC_USE_PARTICLE_SIMD && defined(__SSE2__)
+    const __m128 scale = _mm_set1_ps(255.0f);
+    for (; i + 4 <= end; i += 4)
+    {
+        __m128 alpha = _mm_mul_ps(_mm_loadu_ps(a + i), scale);
+        __m128 factor = opacityModifyRGB ? alpha : scale;
+        __m128i red = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(r + i), factor));
+        __m128i green = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(g + i), factor));
+        __m128i blue = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(b + i), factor));
+        // r0..r3 b0..b3 g0..g3 a0..a3, clamped to [0, 255]
+        __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(red, blue), _mm_packs_epi32(green, _mm_cvttps_epi32(alpha)));
+        // r0 g0 r1 g1 .. b0 a0 b1 a1 .., then r0 g0 b0 a0 r1 g1 b1 a1 ..
+        bytes = _mm_unpacklo_epi8(bytes, _mm_srli_si128(bytes, 8));
+        bytes = _mm_unpacklo_epi16(bytes, _mm_srli_si128(bytes, 8));
+        Color4B colors[4];
+        _mm_storeu_si128((__m128i*) colors, bytes);
+        for (int k = 0; k < 4; ++k)
+        {
+            storeColor(i + k, colors[k]);
+        }
+    }
+#elif CC_USE_PARTICLE_SIMD && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+    const float32x4_t scale = vdupq_n_f32(255.0f);
+    for (; i + 4 <= end; i += 4)
+    {
+        float32x4_t alpha = vmulq_f32(vld1q_f32(a + i), scale);
+        float32x4_t factor = opacityModifyRGB ? alpha : scale;
+        uint16x4_t red = vqmovun_s32(vcvtq_s32_f32(vmulq_f32(vld1q_f32(r + i), factor)));
+        uint16x4_t green = vqmovun_s32(vcvtq_s32_f32(vmulq_f32(vld1q_f32(g + i), factor)));
+        uint16x4_t blue = vqmovun_s32(vcvtq_s32_f32(vmulq_f32(vld1q_f32(b + i), factor)));
+        uint16x4_t opacity = vqmovun_s32(vcvtq_s32_f32(alpha));
+        // r0..r3 g0..g3 and b0..b3 a0..a3, clamped to [0, 255]
+        uint8x8_t redGreen = vqmovn_u16(vcombine_u16(red, green));
+        uint8x8_t blueAlpha = vqmovn_u16(vcombine_u16(blue, opacity));
+        // r0 b0 r1 b1 .. and g0 a0 g1 a1 .., then r0 g0 b0 a0 r1 g1 b1 a1 ..
+        uint8x8x2_t pairs = vzip_u8(redGreen, blueAlpha);
+        uint8x8x2_t pixels = vzip_u8(pairs.val[0], pairs.val[1]);
+        Color4B colors[4];
+        vst1_u8((uint8_t*) colors, pixels.val[0]);
+        vst1_u8((uint8_t*) colors + 8, pixels.val[1]);
+        for (int k = 0; k < 4; ++k)
+        {
+            storeColor(i + k, colors[k]);
+        }
+    }
+#endif
+    if (opacityModifyRGB)
+    {
+        for (; i < end; ++i)
+        {
+            GLubyte colorR = toColorByte(r[i] * a[i] * 255);
+            GLubyte colorG = toColorByte(g[i] * a[i] * 255);
+            GLubyte colorB = toColorByte(b[i] * a[i] * 255);
+            GLubyte colorA = toColorByte(a[i] * 255);
+            storeColor(i, Color4B(colorR, colorG, colorB, colorA));
+        }
+    }
+    else
+    {
+        for (; i < end; ++i)
+        {
+            GLubyte colorR = toColorByte(r[i] * 255);
+            GLubyte colorG = toColorByte(g[i] * 255);
+            GLubyte colorB = toColorByte(b[i] * 255);
+            GLubyte colorA = toColorByte(a[i] * 255);
+            storeColor(i, Color4B(colorR, colorG, colorB, colorA));
+        }
+    }
+}
+
 void ParticleSystemQuad::updateParticleQuads()
 {
     if (_particleCount <= 0) {
@@ -329,112 +449,118 @@ void ParticleSystemQuad::updateParticleQuads()
         startQuad = &(_quads[0]);
     }
     
+    // the offset of a free particle is (current - start) mapped to the node space,
+    // the translation of the world to node transform cancels out so only its linear part is applied
+    Mat4 worldToNodeTM;
     if( _positionType == PositionType::FREE )
     {
-        Vec3 p1(currentPosition.x, currentPosition.y, 0);
-        Mat4 worldToNodeTM = getWorldToNodeTransform();
-        worldToNodeTM.transformPoint(&p1);
-        Vec3 p2;
-        Vec2 newPos;
-        float* startX = _particleData.startPosX;
-        float* startY = _particleData.startPosY;
-        float* x = _particleData.posx;
-        float* y = _particleData.posy;
-        float* s = _particleData.size;
-        float* r = _particleData.rotation;
-        V3F_C4B_T2F_Quad* quadStart = startQuad;
-        for (int i = 0 ; i < _particleCount; ++i, ++startX, ++startY, ++x, ++y, ++quadStart, ++s, ++r)
-        {
-            p2.set(*startX, *startY, 0);
-            worldToNodeTM.transformPoint(&p2);
-            newPos.set(*x,*y);
-            p2 = p1 - p2;
-            newPos.x -= p2.x - pos.x;
-            newPos.y -= p2.y - pos.y;
-            updatePosWithParticle(quadStart, newPos, *s, *r);
-        }
+        worldToNodeTM = getWorldToNodeTransform();
     }
-    else if( _positionType == PositionType::RELATIVE )
+
+    const PositionType positionType = _positionType;
+    const bool opacityModifyRGB = _opacityModifyRGB;
+
+    if (isUsingInstancing())
     {
-        Vec2 newPos;
-        float* startX = _particleData.startPosX;
-        float* startY = _particleData.startPosY;
-        float* x = _particleData.posx;
-        float* y = _particleData.posy;
-        float* s = _particleData.size;
-        float* r = _particleData.rotation;
-        V3F_C4B_T2F_Quad* quadStart = startQuad;
-        for (int i = 0 ; i < _particleCount; ++i, ++startX, ++startY, ++x, ++y, ++quadStart, ++s, ++r)
+        if (_instances.size() < static_cast<size_t>(_particleCount))
         {
-            newPos.set(*x, *y);
-            newPos.x = *x - (currentPosition.x - *startX);
-            newPos.y = *y - (currentPosition.y - *startY);
-            newPos += pos;
-            updatePosWithParticle(quadStart, newPos, *s, *r);
+            _instances.resize(_totalParticles);
         }
+        ParticleInstance* instances = _instances.data();
+        forEachParticleRange(_particleCount, [&](int begin, int end) {
+            const float* startX = _particleData.startPosX;
+            const float* startY = _particleData.startPosY;
+            const float* x = _particleData.posx;
+            const float* y = _particleData.posy;
+            const float* m = worldToNodeTM.m;
+            for (int i = begin; i < end; ++i)
+            {
+                ParticleInstance& instance = instances[i];
+                if( positionType == PositionType::FREE )
+                {
+                    float dx = currentPosition.x - startX[i];
+                    float dy = currentPosition.y - startY[i];
+                    instance.x = x[i] - (m[0] * dx + m[4] * dy) + pos.x;
+                    instance.y = y[i] - (m[1] * dx + m[5] * dy) + pos.y;
+                }
+                else if( positionType == PositionType::RELATIVE )
+                {
+                    instance.x = x[i] - (currentPosition.x - startX[i]) + pos.x;
+                    instance.y = y[i] - (currentPosition.y - startY[i]) + pos.y;
+                }
+                else
+                {
+                    instance.x = x[i] + pos.x;
+                    instance.y = y[i] + pos.y;
+                }
+                instance.size = _particleData.size[i];
+                instance.rotation = -CC_DEGREES_TO_RADIANS(_particleData.rotation[i]);
+            }
+            convertParticleColors(_particleData, opacityModifyRGB, begin, end, [instances](int i, const Color4B& color) {
+                instances[i].color = color;
+            });
+        });
+        return;
     }
-    else
-    {
+
+    forEachParticleRange(_particleCount, [&](int begin, int end) {
+        const float* startX = _particleData.startPosX;
+        const float* startY = _particleData.startPosY;
+        const float* x = _particleData.posx;
+        const float* y = _particleData.posy;
+        const float* s = _particleData.size;
+        const float* r = _particleData.rotation;
         Vec2 newPos;
-        float* startX = _particleData.startPosX;
-        float* startY = _particleData.startPosY;
-        float* x = _particleData.posx;
-        float* y = _particleData.posy;
-        float* s = _particleData.size;
-        float* r = _particleData.rotation;
-        V3F_C4B_T2F_Quad* quadStart = startQuad;
-        for (int i = 0 ; i < _particleCount; ++i, ++startX, ++startY, ++x, ++y, ++quadStart, ++s, ++r)
+        if( positionType == PositionType::FREE )
         {
-            newPos.set(*x + pos.x, *y + pos.y);
-            updatePosWithParticle(quadStart, newPos, *s, *r);
+            const float* m = worldToNodeTM.m;
+            for (int i = begin; i < end; ++i)
+            {
+                float dx = currentPosition.x - startX[i];
+                float dy = currentPosition.y - startY[i];
+                newPos.x = x[i] - (m[0] * dx + m[4] * dy) + pos.x;
+                newPos.y = y[i] - (m[1] * dx + m[5] * dy) + pos.y;
+                updatePosWithParticle(startQuad + i, newPos, s[i], r[i]);
+            }
         }
-    }
-    
-    //set color
-    if(_opacityModifyRGB)
-    {
-        V3F_C4B_T2F_Quad* quad = startQuad;
-        float* r = _particleData.colorR;
-        float* g = _particleData.colorG;
-        float* b = _particleData.colorB;
-        float* a = _particleData.colorA;
-        
-        for (int i = 0; i < _particleCount; ++i,++quad,++r,++g,++b,++a)
+        else if( positionType == PositionType::RELATIVE )
         {
-            GLubyte colorR = *r * *a * 255;
-            GLubyte colorG = *g * *a * 255;
-            GLubyte colorB = *b * *a * 255;
-            GLubyte colorA = *a * 255;
-            quad->bl.colors.set(colorR, colorG, colorB, colorA);
-            quad->br.colors.set(colorR, colorG, colorB, colorA);
-            quad->tl.colors.set(colorR, colorG, colorB, colorA);
-            quad->tr.colors.set(colorR, colorG, colorB, colorA);
+            for (int i = begin; i < end; ++i)
+            {
+                newPos.x = x[i] - (currentPosition.x - startX[i]) + pos.x;
+                newPos.y = y[i] - (currentPosition.y - startY[i]) + pos.y;
+                updatePosWithParticle(startQuad + i, newPos, s[i], r[i]);
+            }
         }
-    }
-    else
-    {
-        V3F_C4B_T2F_Quad* quad = startQuad;
-        float* r = _particleData.colorR;
-        float* g = _particleData.colorG;
-        float* b = _particleData.colorB;
-        float* a = _particleData.colorA;
-        
-        for (int i = 0; i < _particleCount; ++i,++quad,++r,++g,++b,++a)
+        else
         {
-            GLubyte colorR = *r * 255;
-            GLubyte colorG = *g * 255;
-            GLubyte colorB = *b * 255;
-            GLubyte colorA = *a * 255;
-            quad->bl.colors.set(colorR, colorG, colorB, colorA);
-            quad->br.colors.set(colorR, colorG, colorB, colorA);
-            quad->tl.colors.set(colorR, colorG, colorB, colorA);
-            quad->tr.colors.set(colorR, colorG, colorB, colorA);
+            for (int i = begin; i < end; ++i)
+            {
+                newPos.set(x[i] + pos.x, y[i] + pos.y);
+                updatePosWithParticle(startQuad + i, newPos, s[i], r[i]);
+            }
         }
-    }
+        
+        //set color
+        convertParticleColors(_particleData, opacityModifyRGB, begin, end, [startQuad](int i, const Color4B& color) {
+            setQuadColor(startQuad + i, color);
+        });
+    });
 }
 
 void ParticleSystemQuad::postStep()
 {
+    if (isUsingInstancing())
+    {
+        // orphans the buffer of the previous frame
+        glBindBuffer(GL_ARRAY_BUFFER, _instancingVBO[1]);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(ParticleInstance) * _particleCount, _instances.data(), GL_STREAM_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        CHECK_GL_ERROR_DEBUG();
+        return;
+    }
+
     glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
     
     // Option 1: Sub Data
@@ -457,6 +583,14 @@ void ParticleSystemQuad::postStep()
 // overriding draw method
 void ParticleSystemQuad::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
+    if (_particleCount > 0 && isUsingInstancing())
+    {
+        _instancingCommand.init(_globalZOrder, transform, flags);
+        _instancingCommand.func = CC_CALLBACK_0(ParticleSystemQuad::onDrawInstanced, this, transform, flags);
+        renderer->addCommand(&_instancingCommand);
+        return;
+    }
+
     //quad command
     if(_particleCount > 0)
     {
@@ -465,6 +599,106 @@ void ParticleSystemQuad::draw(Renderer *renderer, const Mat4 &transform, uint32_
     }
 }
 
+void ParticleSystemQuad::onDrawInstanced(const Mat4& transform, uint32_t /*flags*/)
+{
+#if CC_PARTICLE_INSTANCING_SUPPORTED
+    _instancingProgramState->setUniformVec4("u_texRect", _texRect);
+    _instancingProgramState->apply(transform);
+    GL::bindTexture2D(_texture);
+    GL::blendFunc(_blendFunc.src, _blendFunc.dst);
+
+    GL::bindVAO(_instancingVAO);
+    glDrawArraysInstancedARB(GL_TRIANGLE_STRIP, 0, 4, _particleCount);
+    GL::bindVAO(0);
+
+    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, _particleCount * 4);
+    CHECK_GL_ERROR_DEBUG();
+#endif
+}
+
+bool ParticleSystemQuad::isInstancingSupported()
+{
+#if CC_PARTICLE_INSTANCING_SUPPORTED
+    auto conf = Configuration::getInstance();
+    return conf->supportsInstancedArrays() && conf->supportsShareableVAO();
+#else
+    return false;
+#endif
+}
+
+void ParticleSystemQuad::setInstancingEnabled(bool enabled)
+{
+    _instancingEnabled = enabled;
+    if (enabled && _instancingVAO == 0 && isInstancingSupported())
+    {
+        setupInstancing();
+    }
+}
+
+bool ParticleSystemQuad::isUsingInstancing() const
+{
+    return _instancingEnabled && _instancingVAO != 0 && !_batchNode;
+}
+
+void ParticleSystemQuad::setupInstancing()
+{
+#if CC_PARTICLE_INSTANCING_SUPPORTED
+    releaseInstancing();
+
+    auto glProgram = GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_PARTICLE_INSTANCED);
+    GLint particleAttrib = glProgram->getAttribLocation("a_particle");
+    if (particleAttrib < 0)
+    {
+        CCLOG("cocos2d: Particle system: the instanced particle shader is not available");
+        return;
+    }
+    if (!_instancingProgramState)
+    {
+        _instancingProgramState = GLProgramState::create(glProgram);
+        CC_SAFE_RETAIN(_instancingProgramState);
+    }
+
+    glGenVertexArrays(1, &_instancingVAO);
+    GL::bindVAO(_instancingVAO);
+
+    glGenBuffers(2, &_instancingVBO[0]);
+
+    // the corners of the quad, as a triangle strip
+    static const GLfloat corners[] = { -0.5f, -0.5f, 0.5f, -0.5f, -0.5f, 0.5f, 0.5f, 0.5f };
+    glBindBuffer(GL_ARRAY_BUFFER, _instancingVBO[0]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    // position, size and rotation, then color, once per particle
+    glBindBuffer(GL_ARRAY_BUFFER, _instancingVBO[1]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(ParticleInstance) * _totalParticles, nullptr, GL_STREAM_DRAW);
+    glEnableVertexAttribArray(particleAttrib);
+    glVertexAttribPointer(particleAttrib, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (GLvoid*) offsetof(ParticleInstance, x));
+    glVertexAttribDivisorARB(particleAttrib, 1);
+    glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_COLOR);
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ParticleInstance), (GLvoid*) offsetof(ParticleInstance, color));
+    glVertexAttribDivisorARB(GLProgram::VERTEX_ATTRIB_COLOR, 1);
+
+    GL::bindVAO(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    CHECK_GL_ERROR_DEBUG();
+#endif
+}
+
+void ParticleSystemQuad::releaseInstancing()
+{
+    if (_instancingVAO)
+    {
+        glDeleteBuffers(2, &_instancingVBO[0]);
+        glDeleteVertexArrays(1, &_instancingVAO);
+        GL::bindVAO(0);
+        memset(_instancingVBO, 0, sizeof(_instancingVBO));
+        _instancingVAO = 0;
+    }
+}
+
 void ParticleSystemQuad::setTotalParticles(int tp)
 {
     // If we are setting the total number of particles to a number higher
@@ -614,6 +848,13 @@ void ParticleSystemQuad::listenRendererRecreated(EventCustom* /*event*/)
     {
         setupVBO();
     }
+
+    if (_instancingVAO)
+    {
+        memset(_instancingVBO, 0, sizeof(_instancingVBO));
+        _instancingVAO = 0;
+        setupInstancing();
+    }
 }
 
 bool ParticleSystemQuad::allocMemory()
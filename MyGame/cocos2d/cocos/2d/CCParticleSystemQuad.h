@@ -31,6 +31,7 @@ THE SOFTWARE.
 
 #include "2d/CCParticleSystem.h"
 #include "renderer/CCQuadCommand.h"
+#include "renderer/CCCustomCommand.h"
 
 NS_CC_BEGIN
 
@@ -53,6 +54,7 @@ Special features and Limitations:
 - The particles can be rotated.
 - It supports subrects.
 - It supports batched rendering since 1.1.
+- It can draw the particles as instances of a quad when the GL context supports instanced drawing.
 @since v0.8
 @js NA
 */
@@ -85,6 +87,24 @@ public:
      */
     static ParticleSystemQuad * create(ValueMap &dictionary);
 
+    /** Whether or not the GL context can draw the particles as instances of a quad.
+     *
+     * @return True if glVertexAttribDivisor(), glDrawArraysInstanced() and VAOs are available.
+     */
+    static bool isInstancingSupported();
+
+    /** Draws each particle as an instance of a quad expanded in the vertex shader.
+     * Only the position, size, rotation and color of the particles are uploaded, instead of four vertices.
+     * The particles are drawn as quads when instancing is not supported or the system is batched.
+     * The instanced particles use their own GL program and are not batched with other nodes.
+     *
+     * @param enabled Whether or not to draw the particles as instances.
+     */
+    void setInstancingEnabled(bool enabled);
+
+    /** Whether or not the particles are drawn as instances when it is supported. */
+    bool isInstancingEnabled() const { return _instancingEnabled; }
+
     /** Sets a new SpriteFrame as particle.
     WARNING: this method is experimental. Use setTextureWithRect instead.
      *
@@ -179,12 +199,36 @@ protected:
     void setupVBO();
     bool allocMemory();
 
+    /** Whether or not the particles are drawn as instances this frame */
+    bool isUsingInstancing() const;
+    void setupInstancing();
+    void releaseInstancing();
+    void onDrawInstanced(const Mat4& transform, uint32_t flags);
+
+    /** The per instance record of a particle */
+    struct ParticleInstance
+    {
+        GLfloat x;
+        GLfloat y;
+        GLfloat size;
+        GLfloat rotation;   // in radians
+        Color4B color;
+    };
+
     V3F_C4B_T2F_Quad    *_quads;        // quads to be rendered
     GLushort            *_indices;      // indices
     GLuint              _VAOname;
     GLuint              _buffersVBO[2]; //0: vertex  1: indices
 
     QuadCommand _quadCommand;           // quad command
+
+    bool                _instancingEnabled;
+    std::vector<ParticleInstance> _instances;
+    GLuint              _instancingVAO;
+    GLuint              _instancingVBO[2]; //0: quad corners  1: instances
+    GLProgramState*     _instancingProgramState;
+    Vec4                _texRect;       // left, bottom, right, top texture coordinates
+    CustomCommand       _instancingCommand;
     
 
 
@@ -31,6 +31,8 @@
 
 #include "base/CCDirector.h"
 #include "2d/CCScene.h"
+#include "2d/CCTransformHierarchy.h"
+#include "renderer/CCRenderer.h"
 
 NS_CC_BEGIN
 
@@ -288,6 +290,10 @@ void ProtectedNode::visit(Renderer* renderer, const Mat4 &parentTransform, uint3
     int i = 0;      // used by _children
     int j = 0;      // used by _protectedChildren
     
+    // skip the children the visiting camera sees nothing of, unless the subtree is being recorded
+    auto hierarchy = TransformHierarchy::getVisiting();
+    const TransformHierarchy* culling = (hierarchy && !renderer->isCapturingCommands()) ? hierarchy : nullptr;
+    
     sortAllChildren();
     sortAllProtectedChildren();
     
@@ -299,7 +305,10 @@ void ProtectedNode::visit(Renderer* renderer, const Mat4 &parentTransform, uint3
         auto node = _children.at(i);
         
         if ( node && node->getLocalZOrder() < 0 )
-            node->visit(renderer, _modelViewTransform, flags);
+        {
+            if (!culling || !culling->isCulled(node))
+                node->visit(renderer, _modelViewTransform, flags);
+        }
         else
             break;
     }
@@ -327,7 +336,10 @@ void ProtectedNode::visit(Renderer* renderer, const Mat4 &parentTransform, uint3
         (*it)->visit(renderer, _modelViewTransform, flags);
 
     for(auto it=_children.cbegin()+i, itCend = _children.cend(); it != itCend; ++it)
-        (*it)->visit(renderer, _modelViewTransform, flags);
+    {
+        if (!culling || !culling->isCulled(*it))
+            (*it)->visit(renderer, _modelViewTransform, flags);
+    }
     
     // FIX ME: Why need to set _orderOfArrival to 0??
     // Please refer to https://github.com/cocos2d/cocos2d-x/pull/6920
@@ -0,0 +1,290 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "2d/CCRetainedBatchNode.h"
+#include "renderer/CCRenderer.h"
+#include "renderer/CCTrianglesCommand.h"
+#include "renderer/CCGLProgram.h"
+#include "renderer/CCGLProgramCache.h"
+#include "renderer/CCGLProgramState.h"
+#include "renderer/ccGLStateCache.h"
+#include "base/CCConfiguration.h"
+#include "base/CCDirector.h"
+#include "base/CCEventDispatcher.h"
+#include "base/CCEventListenerCustom.h"
+#include "base/CCEventType.h"
+
+NS_CC_BEGIN
+
+RetainedBatchNode* RetainedBatchNode::create()
+{
+    RetainedBatchNode* ret = new (std::nothrow) RetainedBatchNode();
+    if (ret && ret->init())
+    {
+        ret->autorelease();
+    }
+    else
+    {
+        CC_SAFE_DELETE(ret);
+    }
+    return ret;
+}
+
+RetainedBatchNode::RetainedBatchNode()
+: _cacheState(CacheState::DIRTY)
+, _buffersDirty(false)
+, _cullingStale(false)
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+, _rendererRecreatedListener(nullptr)
+#endif
+{
+    _buffersVBO[0] = _buffersVBO[1] = 0;
+}
+
+RetainedBatchNode::~RetainedBatchNode()
+{
+    glDeleteBuffers(2, _buffersVBO);
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    _eventDispatcher->removeEventListener(_rendererRecreatedListener);
+#endif
+}
+
+bool RetainedBatchNode::init()
+{
+    if (!Node::init())
+        return false;
+
+    setupBuffers();
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // the buffers are gone with the GL context on Android, record the subtree again in new ones
+    _rendererRecreatedListener = EventListenerCustom::create(EVENT_RENDERER_RECREATED, [this](EventCustom* /*event*/){
+        setupBuffers();
+        invalidateCache();
+    });
+    _eventDispatcher->addEventListenerWithFixedPriority(_rendererRecreatedListener, -1);
+#endif
+
+    return true;
+}
+
+void RetainedBatchNode::setupBuffers()
+{
+    glGenBuffers(2, _buffersVBO);
+    CHECK_GL_ERROR_DEBUG();
+}
+
+void RetainedBatchNode::invalidateCache()
+{
+    _cacheState = CacheState::DIRTY;
+}
+
+bool RetainedBatchNode::isSubtreeDirty(const Node* node) const
+{
+    if (node->_renderCacheDirty || node->_reorderChildDirty)
+        return true;
+
+    for (const auto& child : node->_children)
+    {
+        // hidden nodes aren't visited, so only their visibility and children can have changed
+        if (!child->_visible)
+        {
+            if (child->_renderCacheDirty || child->_reorderChildDirty)
+                return true;
+            continue;
+        }
+
+        if (child->_transformUpdated || child->_contentSizeDirty || isSubtreeDirty(child))
+            return true;
+    }
+    return false;
+}
+
+bool RetainedBatchNode::canRecordSubtree(const Node* node) const
+{
+    for (const auto& child : node->_children)
+    {
+        if (!child->_visible)
+            continue;
+
+        // the recording is drawn for the cameras of this node only
+        if (child->_cameraMask != _cameraMask || !canRecordSubtree(child))
+            return false;
+    }
+    return true;
+}
+
+bool RetainedBatchNode::recordCommands()
+{
+    _vertices.clear();
+    _indices.clear();
+    _drawRanges.clear();
+
+    auto defaultProgram = GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP);
+    const Mat4 worldToNode = _modelViewTransform.getInversed();
+
+    for (auto command : _capturedCommands)
+    {
+        if (command->getType() != RenderCommand::Type::TRIANGLES_COMMAND || command->is3D() || command->getGlobalOrder() != _globalZOrder)
+            return false;
+
+        auto trianglesCommand = static_cast<TrianglesCommand*>(command);
+        auto glProgramState = trianglesCommand->getGLProgramState();
+        if (glProgramState->getGLProgram() != defaultProgram || glProgramState->getUniformCount() != 0)
+            return false;
+
+        const auto& triangles = trianglesCommand->getTriangles();
+        const size_t vertexBase = _vertices.size();
+        if (vertexBase + triangles.vertCount > USHRT_MAX + 1)
+            return false;
+
+        // keep the vertices in the space of this node, so that moving it doesn't drop the recording
+        _vertices.insert(_vertices.end(), triangles.verts, triangles.verts + triangles.vertCount);
+        const Mat4 commandToNode = worldToNode * trianglesCommand->getModelView();
+        commandToNode.transformPoints(&_vertices[vertexBase].vertices, &_vertices[vertexBase].vertices, triangles.vertCount, sizeof(V3F_C4B_T2F));
+
+        const GLsizei indexOffset = static_cast<GLsizei>(_indices.size());
+        for (int i = 0; i < triangles.indexCount; ++i)
+        {
+            _indices.push_back(static_cast<unsigned short>(vertexBase + triangles.indices[i]));
+        }
+
+        const GLuint textureID = trianglesCommand->getTextureID();
+        const BlendFunc blendFunc = trianglesCommand->getBlendType();
+        if (!_drawRanges.empty() && _drawRanges.back().textureID == textureID && _drawRanges.back().blendFunc == blendFunc)
+        {
+            _drawRanges.back().indexCount += triangles.indexCount;
+        }
+        else
+        {
+            _drawRanges.push_back({ textureID, blendFunc, indexOffset, static_cast<GLsizei>(triangles.indexCount) });
+        }
+    }
+
+    _buffersDirty = true;
+    return true;
+}
+
+void RetainedBatchNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags)
+{
+    if (!_visible)
+        return;
+
+    const bool subtreeDirty = isSubtreeDirty(this);
+    if (subtreeDirty)
+    {
+        _cacheState = CacheState::DIRTY;
+    }
+
+    if (_cacheState == CacheState::UNSUPPORTED || subtreeDirty)
+    {
+        // the recording visit left the nodes that cull themselves marked as seen, let them check again
+        Node::visit(renderer, parentTransform, _cullingStale ? (parentFlags | FLAGS_TRANSFORM_DIRTY) : parentFlags);
+        _cullingStale = false;
+        return;
+    }
+
+    if (_cacheState == CacheState::DIRTY)
+    {
+        // unchanged for a frame, record it while it is visited. The recording is drawn wherever this node and
+        // the camera move, so the nodes that cull themselves, like Sprite, must check their visibility again,
+        // which the renderer doesn't fail while capturing
+        _capturedCommands.clear();
+        renderer->beginCommandCapture(&_capturedCommands);
+        Node::visit(renderer, parentTransform, parentFlags | FLAGS_TRANSFORM_DIRTY);
+        renderer->endCommandCapture();
+        _cullingStale = true;
+
+        if (canRecordSubtree(this) && recordCommands())
+        {
+            _cacheState = CacheState::CACHED;
+        }
+        else
+        {
+            // queue what was captured as if it never was
+            _cacheState = CacheState::UNSUPPORTED;
+            for (auto command : _capturedCommands)
+            {
+                renderer->addCommand(command);
+            }
+            return;
+        }
+    }
+    else
+    {
+        processParentFlags(parentTransform, parentFlags);
+    }
+
+    if (_drawRanges.empty() || !isVisitableByVisitingCamera())
+        return;
+
+    _customCommand.init(_globalZOrder, _modelViewTransform, 0);
+    _customCommand.func = CC_CALLBACK_0(RetainedBatchNode::onDraw, this, _modelViewTransform, 0);
+    renderer->addCommand(&_customCommand);
+}
+
+void RetainedBatchNode::onDraw(const Mat4& transform, uint32_t /*flags*/)
+{
+    auto glProgram = GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR);
+    glProgram->use();
+    glProgram->setUniformsForBuiltins(transform);
+
+    if (Configuration::getInstance()->supportsShareableVAO())
+    {
+        GL::bindVAO(0);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+    if (_buffersDirty)
+    {
+        glBufferData(GL_ARRAY_BUFFER, sizeof(V3F_C4B_T2F) * _vertices.size(), _vertices.data(), GL_STATIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned short) * _indices.size(), _indices.data(), GL_STATIC_DRAW);
+        _buffersDirty = false;
+    }
+
+    GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
+    // vertex
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid *)offsetof(V3F_C4B_T2F, vertices));
+    // color
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid *)offsetof(V3F_C4B_T2F, colors));
+    // texcoord
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid *)offsetof(V3F_C4B_T2F, texCoords));
+
+    for (const auto& range : _drawRanges)
+    {
+        GL::bindTexture2D(range.textureID);
+        GL::blendFunc(range.blendFunc.src, range.blendFunc.dst);
+        glDrawElements(GL_TRIANGLES, range.indexCount, GL_UNSIGNED_SHORT, (GLvoid *)(range.indexOffset * sizeof(unsigned short)));
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(_drawRanges.size(), _indices.size());
+    CHECK_GL_ERROR_DEBUG();
+}
+
+NS_CC_END
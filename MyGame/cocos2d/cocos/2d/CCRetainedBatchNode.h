@@ -0,0 +1,130 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCRETAINED_BATCH_NODE_H__
+#define __CCRETAINED_BATCH_NODE_H__
+
+#include <vector>
+#include "2d/CCNode.h"
+#include "renderer/CCCustomCommand.h"
+
+NS_CC_BEGIN
+
+class RenderCommand;
+class EventListenerCustom;
+
+/**
+ *  @addtogroup _2d
+ *  @{
+ */
+
+/**
+ * @brief RetainedBatchNode draws a subtree that doesn't change from vertices recorded once.
+ *
+ * Once nothing below the node changed for a frame, it records the sprites of its subtree in its own
+ * space, uploads them to a GL buffer and from then on draws that buffer, one draw call per run of
+ * sprites sharing a texture and a blend function, instead of visiting its children.
+ * Moving, rotating or scaling the node itself keeps the recording.
+ *
+ * A change below the node (transform, content size, color, opacity, visibility, texture, sprite frame,
+ * blend function, children or their order) drops the recording: the subtree is visited as usual until
+ * it stays unchanged for a frame, then it is recorded again. So only use it for parts of the scene that
+ * rarely change.
+ *
+ * Only the commands of sprites (TrianglesCommand) drawn with the default position-texture-color program,
+ * with the same global Z order and camera mask as the node, can be recorded. A subtree drawing anything
+ * else is visited as usual.
+ * @since v3.17
+ */
+class CC_DLL RetainedBatchNode : public Node
+{
+public:
+    /** Creates a RetainedBatchNode.
+     *
+     * @return An autorelease RetainedBatchNode.
+     */
+    static RetainedBatchNode* create();
+
+    /** Drops the recorded subtree, it is recorded again once it stays unchanged for a frame. */
+    void invalidateCache();
+
+    /** Whether the subtree is drawn from the recorded buffer. */
+    bool isCached() const { return _cacheState == CacheState::CACHED; }
+
+    // Overrides
+    virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+
+CC_CONSTRUCTOR_ACCESS:
+    RetainedBatchNode();
+    virtual ~RetainedBatchNode();
+
+    virtual bool init() override;
+
+protected:
+    enum class CacheState
+    {
+        DIRTY,          ///< the subtree changed, it is recorded the next frame it doesn't
+        UNSUPPORTED,    ///< the subtree draws something that can't be recorded
+        CACHED,         ///< the subtree is drawn from the recorded buffer
+    };
+
+    /** A run of recorded triangles with the same texture and blend function */
+    struct DrawRange
+    {
+        GLuint textureID;
+        BlendFunc blendFunc;
+        GLsizei indexOffset;
+        GLsizei indexCount;
+    };
+
+    bool isSubtreeDirty(const Node* node) const;
+    bool canRecordSubtree(const Node* node) const;
+    bool recordCommands();
+    void setupBuffers();
+    void onDraw(const Mat4& transform, uint32_t flags);
+
+    CacheState _cacheState;
+    std::vector<RenderCommand*> _capturedCommands;
+    std::vector<V3F_C4B_T2F> _vertices;
+    std::vector<unsigned short> _indices;
+    std::vector<DrawRange> _drawRanges;
+    GLuint _buffersVBO[2]; //0: vertex  1: indices
+    bool _buffersDirty;
+    bool _cullingStale;     ///< whether the last visit was recorded, which doesn't cull
+    CustomCommand _customCommand;
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    EventListenerCustom* _rendererRecreatedListener;
+#endif
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(RetainedBatchNode);
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif // __CCRETAINED_BATCH_NODE_H__
@@ -0,0 +1,449 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "2d/CCRuntimeAtlas.h"
+
+#include <algorithm>
+
+#include "2d/CCSpriteFrame.h"
+#include "2d/CCSpriteFrameCache.h"
+#include "base/CCConfiguration.h"
+#include "base/CCDirector.h"
+#include "base/ccMacros.h"
+#include "base/ccUTF8.h"
+#include "platform/CCFileUtils.h"
+#include "platform/CCImage.h"
+#include "renderer/CCTexture2D.h"
+#include "renderer/CCTextureCache.h"
+
+#include "zlib.h"
+
+NS_CC_BEGIN
+
+// SkylinePacker
+
+SkylinePacker::SkylinePacker(int width, int height)
+{
+    reset(width, height);
+}
+
+void SkylinePacker::reset(int width, int height)
+{
+    _width = width;
+    _height = height;
+    _usedHeight = 0;
+    _usedArea = 0;
+    _skyline.clear();
+    _skyline.push_back({0, 0, width});
+}
+
+float SkylinePacker::getOccupancy() const
+{
+    return _width > 0 && _height > 0 ? (float) _usedArea / ((long) _width * _height) : 0.0f;
+}
+
+int SkylinePacker::fit(size_t index, int width, int height) const
+{
+    const int x = _skyline[index].x;
+    if (x + width > _width)
+        return -1;
+
+    // the rectangle lies on the highest segment below it
+    int y = _skyline[index].y;
+    int widthLeft = width;
+    while (widthLeft > 0)
+    {
+        y = std::max(y, _skyline[index].y);
+        if (y + height > _height)
+            return -1;
+        widthLeft -= _skyline[index].width;
+        ++index;
+    }
+    return y;
+}
+
+bool SkylinePacker::insert(int width, int height, int* x, int* y)
+{
+    int bestIndex = -1;
+    int bestBottom = 0;
+    int bestWidth = 0;
+    for (size_t i = 0; i < _skyline.size(); ++i)
+    {
+        const int top = fit(i, width, height);
+        if (top < 0)
+            continue;
+
+        // lowest bottom first, then the narrowest segment to waste less room
+        const int bottom = top + height;
+        if (bestIndex < 0 || bottom < bestBottom || (bottom == bestBottom && _skyline[i].width < bestWidth))
+        {
+            bestIndex = (int) i;
+            bestBottom = bottom;
+            bestWidth = _skyline[i].width;
+        }
+    }
+
+    if (bestIndex < 0)
+        return false;
+
+    *x = _skyline[bestIndex].x;
+    *y = bestBottom - height;
+    addSegment(bestIndex, *x, *y, width, height);
+
+    _usedHeight = std::max(_usedHeight, bestBottom);
+    _usedArea += (long) width * height;
+    return true;
+}
+
+void SkylinePacker::addSegment(size_t index, int x, int y, int width, int height)
+{
+    _skyline.insert(_skyline.begin() + index, {x, y + height, width});
+
+    // the segments under the new one are shortened or removed
+    for (size_t i = index + 1; i < _skyline.size(); )
+    {
+        const Segment& prev = _skyline[i - 1];
+        const int overlap = prev.x + prev.width - _skyline[i].x;
+        if (overlap <= 0)
+            break;
+
+        _skyline[i].x += overlap;
+        _skyline[i].width -= overlap;
+        if (_skyline[i].width > 0)
+            break;
+        _skyline.erase(_skyline.begin() + i);
+    }
+
+    // merge the neighbouring segments at the same height
+    for (size_t i = 1; i < _skyline.size(); )
+    {
+        if (_skyline[i - 1].y == _skyline[i].y)
+        {
+            _skyline[i - 1].width += _skyline[i].width;
+            _skyline.erase(_skyline.begin() + i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+// RuntimeAtlas
+
+RuntimeAtlas* RuntimeAtlas::create(const std::string& name, int pageSize)
+{
+    RuntimeAtlas* ret = new (std::nothrow) RuntimeAtlas();
+    if (ret && ret->init(name, pageSize))
+    {
+        ret->autorelease();
+        return ret;
+    }
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+}
+
+RuntimeAtlas::RuntimeAtlas()
+: _pageSize(DEFAULT_PAGE_SIZE)
+{
+}
+
+RuntimeAtlas::~RuntimeAtlas()
+{
+    clearEntries();
+}
+
+bool RuntimeAtlas::init(const std::string& name, int pageSize)
+{
+    CCASSERT(!name.empty(), "RuntimeAtlas: the name must not be empty");
+    CCASSERT(pageSize > 0, "RuntimeAtlas: invalid page size");
+
+    _name = name;
+    _pageSize = pageSize;
+
+    const int maxTextureSize = Configuration::getInstance()->getMaxTextureSize();
+    if (maxTextureSize > 0)
+        _pageSize = std::min(_pageSize, maxTextureSize);
+
+    return true;
+}
+
+void RuntimeAtlas::addImage(const std::string& filename)
+{
+    CCASSERT(_pages.empty(), "RuntimeAtlas: images must be added before build()");
+    _entries.push_back({filename, nullptr, -1, 0, 0});
+}
+
+std::string RuntimeAtlas::getSavedPath(const std::string& suffix) const
+{
+    return FileUtils::getInstance()->getWritablePath() + _name + suffix;
+}
+
+std::string RuntimeAtlas::computeSignature() const
+{
+    auto fileUtils = FileUtils::getInstance();
+    std::string signature = StringUtils::format("%d,%d", _pageSize, PADDING);
+    for (const auto& entry : _entries)
+    {
+        // the size alone doesn't tell an image replaced by another of the same size, the checksum of the content does
+        Data data = fileUtils->getDataFromFile(entry.filename);
+        const uLong checksum = data.isNull() ? 0 : crc32(crc32(0L, Z_NULL, 0), data.getBytes(), (uInt)data.getSize());
+        signature += StringUtils::format(";%s:%ld:%08lx", entry.filename.c_str(), (long)data.getSize(), (unsigned long)checksum);
+    }
+    return signature;
+}
+
+bool RuntimeAtlas::build()
+{
+    CCASSERT(_pages.empty(), "RuntimeAtlas: already built");
+    if (_entries.empty())
+        return false;
+
+    const std::string signature = computeSignature();
+    const bool built = loadSavedPages(signature) || packImages(signature);
+    clearEntries();
+    return built;
+}
+
+bool RuntimeAtlas::loadSavedPages(const std::string& signature)
+{
+    auto fileUtils = FileUtils::getInstance();
+    const std::string indexPath = getSavedPath(".plist");
+    if (!fileUtils->isFileExist(indexPath))
+        return false;
+
+    ValueMap index = fileUtils->getValueMapFromFile(indexPath);
+    if (index["signature"].asString() != signature)
+        return false;
+
+    const int pageCount = index["pages"].asInt();
+    for (int page = 0; page < pageCount; ++page)
+    {
+        const std::string plistPath = getSavedPath(StringUtils::format("_%d.plist", page));
+        const std::string texturePath = getSavedPath(StringUtils::format("_%d.png", page));
+        if (!fileUtils->isFileExist(plistPath) || !fileUtils->isFileExist(texturePath))
+        {
+            _pages.clear();
+            return false;
+        }
+
+        Texture2D* texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
+        if (!texture)
+        {
+            _pages.clear();
+            return false;
+        }
+        SpriteFrameCache::getInstance()->addSpriteFramesWithFile(plistPath, texture);
+        _pages.push_back(texture);
+    }
+    return !_pages.empty();
+}
+
+bool RuntimeAtlas::packImages(const std::string& signature)
+{
+    auto fileUtils = FileUtils::getInstance();
+    std::vector<Entry*> packed;
+    for (auto& entry : _entries)
+    {
+        Image* image = new (std::nothrow) Image();
+        if (!image || !image->initWithImageFile(fileUtils->fullPathForFilename(entry.filename)))
+        {
+            CCLOG("cocos2d: RuntimeAtlas: can't load '%s'", entry.filename.c_str());
+            CC_SAFE_RELEASE(image);
+            continue;
+        }
+
+        const auto format = image->getRenderFormat();
+        if ((format != Texture2D::PixelFormat::RGBA8888 && format != Texture2D::PixelFormat::RGB888)
+            || image->getWidth() + PADDING > _pageSize || image->getHeight() + PADDING > _pageSize)
+        {
+            CCLOG("cocos2d: RuntimeAtlas: '%s' can't be packed", entry.filename.c_str());
+            image->release();
+            continue;
+        }
+
+        entry.image = image;
+        packed.push_back(&entry);
+    }
+
+    if (packed.empty())
+        return false;
+
+    // the tallest images first keep the skyline flat
+    std::stable_sort(packed.begin(), packed.end(), [](const Entry* a, const Entry* b) {
+        return a->image->getHeight() > b->image->getHeight();
+    });
+
+    std::vector<SkylinePacker> packers;
+    for (auto entry : packed)
+    {
+        const int width = entry->image->getWidth() + PADDING;
+        const int height = entry->image->getHeight() + PADDING;
+        for (size_t page = 0; page < packers.size() && entry->page < 0; ++page)
+        {
+            if (packers[page].insert(width, height, &entry->x, &entry->y))
+                entry->page = (int) page;
+        }
+
+        if (entry->page < 0)
+        {
+            packers.emplace_back(_pageSize, _pageSize);
+            packers.back().insert(width, height, &entry->x, &entry->y);
+            entry->page = (int) packers.size() - 1;
+        }
+    }
+
+    auto textureCache = Director::getInstance()->getTextureCache();
+    auto spriteFrameCache = SpriteFrameCache::getInstance();
+    bool saved = true;
+    for (int page = 0; page < (int) packers.size(); ++page)
+    {
+        // the pages are as high as their content, premultiplied as the textures of PNG files
+        const int pageWidth = packers[page].getWidth();
+        const int pageHeight = packers[page].getUsedHeight();
+        std::vector<unsigned char> pixels(pageWidth * pageHeight * 4, 0);
+
+        std::vector<Entry*> pageEntries;
+        for (auto entry : packed)
+        {
+            if (entry->page != page)
+                continue;
+            pageEntries.push_back(entry);
+
+            Image* image = entry->image;
+            const bool hasAlpha = image->getRenderFormat() == Texture2D::PixelFormat::RGBA8888;
+            const bool premultiply = hasAlpha && !image->hasPremultipliedAlpha();
+            const int bytesPerPixel = hasAlpha ? 4 : 3;
+            const unsigned char* src = image->getData();
+            for (int row = 0; row < image->getHeight(); ++row)
+            {
+                unsigned char* dst = &pixels[((entry->y + row) * pageWidth + entry->x) * 4];
+                for (int col = 0; col < image->getWidth(); ++col, src += bytesPerPixel, dst += 4)
+                {
+                    const unsigned char alpha = hasAlpha ? src[3] : 255;
+                    dst[0] = premultiply ? (unsigned char) (src[0] * alpha / 255) : src[0];
+                    dst[1] = premultiply ? (unsigned char) (src[1] * alpha / 255) : src[1];
+                    dst[2] = premultiply ? (unsigned char) (src[2] * alpha / 255) : src[2];
+                    dst[3] = alpha;
+                }
+            }
+        }
+
+        Image* pageImage = new (std::nothrow) Image();
+        if (!pageImage || !pageImage->initWithRawData(pixels.data(), pixels.size(), pageWidth, pageHeight, 8, true))
+        {
+            CC_SAFE_RELEASE(pageImage);
+            return false;
+        }
+
+        const std::string texturePath = getSavedPath(StringUtils::format("_%d.png", page));
+        saved = saved && savePage(page, pixels, pageWidth, pageHeight, pageEntries);
+
+        // a previous build may have left a texture with the same key
+        textureCache->removeTextureForKey(texturePath);
+        Texture2D* texture = textureCache->addImage(pageImage, texturePath);
+        pageImage->release();
+        if (!texture)
+            return false;
+        _pages.push_back(texture);
+
+        for (auto entry : pageEntries)
+        {
+            const Rect rect(entry->x, entry->y, entry->image->getWidth(), entry->image->getHeight());
+            spriteFrameCache->addSpriteFrame(SpriteFrame::createWithTexture(texture, CC_RECT_PIXELS_TO_POINTS(rect)), entry->filename);
+        }
+    }
+
+    // the index is written last, so pages saved partially are never loaded
+    if (saved)
+    {
+        ValueMap index;
+        index["signature"] = signature;
+        index["pages"] = (int) _pages.size();
+        fileUtils->writeValueMapToFile(index, getSavedPath(".plist"));
+    }
+    return true;
+}
+
+bool RuntimeAtlas::savePage(int page, const std::vector<unsigned char>& pixels, int width, int height, const std::vector<Entry*>& entries) const
+{
+    // PNG files have straight alpha, they are premultiplied again when loaded
+    std::vector<unsigned char> straight(pixels);
+    for (size_t i = 0; i < straight.size(); i += 4)
+    {
+        const unsigned char alpha = straight[i + 3];
+        if (alpha != 0 && alpha != 255)
+        {
+            straight[i + 0] = (unsigned char) std::min(255, straight[i + 0] * 255 / alpha);
+            straight[i + 1] = (unsigned char) std::min(255, straight[i + 1] * 255 / alpha);
+            straight[i + 2] = (unsigned char) std::min(255, straight[i + 2] * 255 / alpha);
+        }
+    }
+
+    Image image;
+    const std::string textureFilename = _name + StringUtils::format("_%d.png", page);
+    if (!image.initWithRawData(straight.data(), straight.size(), width, height, 8, false)
+        || !image.saveToFile(getSavedPath(StringUtils::format("_%d.png", page)), false))
+    {
+        CCLOG("cocos2d: RuntimeAtlas: can't save '%s'", textureFilename.c_str());
+        return false;
+    }
+
+    // same as the format 0 of the plist files of SpriteFrameCache
+    ValueMap frames;
+    for (auto entry : entries)
+    {
+        ValueMap frame;
+        frame["x"] = entry->x;
+        frame["y"] = entry->y;
+        frame["width"] = entry->image->getWidth();
+        frame["height"] = entry->image->getHeight();
+        frame["offsetX"] = 0;
+        frame["offsetY"] = 0;
+        frame["originalWidth"] = entry->image->getWidth();
+        frame["originalHeight"] = entry->image->getHeight();
+        frames[entry->filename] = frame;
+    }
+
+    ValueMap metadata;
+    metadata["format"] = 0;
+    metadata["textureFileName"] = textureFilename;
+    metadata["size"] = StringUtils::format("{%d,%d}", width, height);
+
+    ValueMap plist;
+    plist["frames"] = frames;
+    plist["metadata"] = metadata;
+    return FileUtils::getInstance()->writeValueMapToFile(plist, getSavedPath(StringUtils::format("_%d.plist", page)));
+}
+
+void RuntimeAtlas::clearEntries()
+{
+    for (auto& entry : _entries)
+    {
+        CC_SAFE_RELEASE_NULL(entry.image);
+    }
+    _entries.clear();
+}
+
+NS_CC_END
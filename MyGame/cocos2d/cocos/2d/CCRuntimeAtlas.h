@@ -0,0 +1,170 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCRUNTIME_ATLAS_H__
+#define __CCRUNTIME_ATLAS_H__
+
+#include <string>
+#include <vector>
+
+#include "base/CCRef.h"
+#include "math/CCGeometry.h"
+
+NS_CC_BEGIN
+
+class Image;
+class Texture2D;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @class SkylinePacker
+ * @brief Packs rectangles in a fixed size area, with the skyline bottom-left heuristic.
+ *
+ * The skyline is the top edge of the packed rectangles, a new rectangle is put at the lowest
+ * place of the skyline where it fits. Coordinates are in pixels, y going down.
+ */
+class CC_DLL SkylinePacker
+{
+public:
+    /** Creates a packer for an area of width x height. */
+    SkylinePacker(int width, int height);
+
+    /** Removes all the rectangles, and changes the size of the area. */
+    void reset(int width, int height);
+
+    /**
+     * Finds room for a rectangle of width x height.
+     * @return false if the rectangle doesn't fit anymore, x and y are not changed then.
+     */
+    bool insert(int width, int height, int* x, int* y);
+
+    /** Width of the area. */
+    int getWidth() const { return _width; }
+    /** Height of the area. */
+    int getHeight() const { return _height; }
+    /** The lowest y below all the packed rectangles. */
+    int getUsedHeight() const { return _usedHeight; }
+    /** Ratio of the area covered by the packed rectangles, between 0 and 1. */
+    float getOccupancy() const;
+
+protected:
+    // a horizontal segment of the skyline
+    struct Segment
+    {
+        int x;
+        int y;
+        int width;
+    };
+
+    // y of a width x height rectangle put at the segment index, -1 if it doesn't fit
+    int fit(size_t index, int width, int height) const;
+    void addSegment(size_t index, int x, int y, int width, int height);
+
+    std::vector<Segment> _skyline;
+    int _width;
+    int _height;
+    int _usedHeight;
+    long _usedArea;
+};
+
+/** @class RuntimeAtlas
+ * @brief Packs loose image files into shared texture pages at runtime.
+ *
+ * Every image added to the atlas becomes a SpriteFrame of the SpriteFrameCache named after its file,
+ * so sprites created with `Sprite::createWithSpriteFrameName(filename)` share a few textures and
+ * are batched by the Renderer.
+ *
+ * The packed pages are saved to the writable path with a plist for each one. They are loaded instead
+ * of packing the images again when the same files, with the same contents, are added to the atlas.
+ *
+ * Only RGBA8888 and RGB888 images are packed, other ones are left to be loaded as usual.
+ */
+class CC_DLL RuntimeAtlas : public Ref
+{
+public:
+    /** The default width and height of the pages, limited by the max texture size. */
+    static const int DEFAULT_PAGE_SIZE = 2048;
+    /** Transparent pixels around each image, so filtering doesn't bleed the neighbouring ones. */
+    static const int PADDING = 2;
+
+    /**
+     * Creates an atlas.
+     * @param name Prefix of the files saved to the writable path.
+     * @param pageSize The width and height of the pages.
+     */
+    static RuntimeAtlas* create(const std::string& name, int pageSize = DEFAULT_PAGE_SIZE);
+
+    /** Adds an image file to pack, it must be done before build(). */
+    void addImage(const std::string& filename);
+
+    /**
+     * Packs the added images, or loads the pages saved by a previous launch, and adds the
+     * sprite frames to the SpriteFrameCache.
+     * @return false if no page could be made.
+     */
+    bool build();
+
+    /** The textures of the pages, once built. */
+    const std::vector<Texture2D*>& getPages() const { return _pages; }
+
+CC_CONSTRUCTOR_ACCESS:
+    RuntimeAtlas();
+    virtual ~RuntimeAtlas();
+
+    bool init(const std::string& name, int pageSize);
+
+protected:
+    // an image to pack, and where it goes
+    struct Entry
+    {
+        std::string filename;
+        Image* image;
+        int page;
+        int x;
+        int y;
+    };
+
+    // identifies the added files, the saved pages are only used when it is unchanged
+    std::string computeSignature() const;
+    bool loadSavedPages(const std::string& signature);
+    bool packImages(const std::string& signature);
+    bool savePage(int page, const std::vector<unsigned char>& pixels, int width, int height, const std::vector<Entry*>& entries) const;
+    std::string getSavedPath(const std::string& suffix) const;
+    void clearEntries();
+
+    std::string _name;
+    int _pageSize;
+    std::vector<Entry> _entries;
+    std::vector<Texture2D*> _pages;
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif // __CCRUNTIME_ATLAS_H__
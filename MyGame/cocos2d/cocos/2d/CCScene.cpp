@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "2d/CCScene.h"
 #include "base/CCDirector.h"
 #include "2d/CCCamera.h"
+#include "2d/CCTransformHierarchy.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/ccUTF8.h"
@@ -52,6 +53,7 @@ THE SOFTWARE.
 NS_CC_BEGIN
 
 Scene::Scene()
+: _transformHierarchy(nullptr)
 {
 #if CC_USE_3D_PHYSICS && CC_ENABLE_BULLET_INTEGRATION
     _physics3DWorld = nullptr;
@@ -103,6 +105,7 @@ Scene::~Scene()
 #endif
     Director::getInstance()->getEventDispatcher()->removeEventListener(_event);
     CC_SAFE_RELEASE(_event);
+    CC_SAFE_DELETE(_transformHierarchy);
     
 #if CC_USE_PHYSICS
     delete _physicsWorld;
@@ -210,6 +213,12 @@ void Scene::render(Renderer* renderer, const Mat4* eyeTransforms, const Mat4* ey
     Camera* defaultCamera = nullptr;
     const auto& transform = getNodeToParentTransform();
 
+    if (_transformHierarchy)
+    {
+        _transformHierarchy->update(transform);
+    }
+    TransformHierarchy::s_visitingHierarchy = _transformHierarchy;
+
     for (const auto& camera : getCameras())
     {
         if (!camera->isVisible())
@@ -237,6 +246,12 @@ void Scene::render(Renderer* renderer, const Mat4* eyeTransforms, const Mat4* ey
             director->loadProjectionMatrix(Camera::_visitingCamera->getViewProjectionMatrix(), i);
         }
 
+        // find what the camera sees once, the eyes of a multi view camera see different parts
+        if (_transformHierarchy)
+        {
+            _transformHierarchy->cull(multiViewCount == 1 ? camera : nullptr);
+        }
+
         camera->apply();
         //clear background with max depth
         camera->clearBackground();
@@ -260,6 +275,8 @@ void Scene::render(Renderer* renderer, const Mat4* eyeTransforms, const Mat4* ey
 //        camera->setNodeToParentTransform(eyeCopy);
     }
 
+    TransformHierarchy::s_visitingHierarchy = nullptr;
+
 #if CC_USE_3D_PHYSICS && CC_ENABLE_BULLET_INTEGRATION
     if (_physics3DWorld && _physics3DWorld->isDebugDrawEnabled())
     {
@@ -291,6 +308,18 @@ void Scene::render(Renderer* renderer, const Mat4* eyeTransforms, const Mat4* ey
 //    experimental::FrameBuffer::applyDefaultFBO();
 }
 
+void Scene::setTransformHierarchyEnabled(bool enabled)
+{
+    if (enabled && !_transformHierarchy)
+    {
+        _transformHierarchy = new (std::nothrow) TransformHierarchy(this);
+    }
+    else if (!enabled)
+    {
+        CC_SAFE_DELETE(_transformHierarchy);
+    }
+}
+
 void Scene::removeAllChildren()
 {
     if (_defaultCamera)
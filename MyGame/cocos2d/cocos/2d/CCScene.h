@@ -39,6 +39,7 @@ class BaseLight;
 class Renderer;
 class EventListenerCustom;
 class EventCustom;
+class TransformHierarchy;
 #if CC_USE_PHYSICS
 class PhysicsWorld;
 #endif
@@ -123,6 +124,21 @@ public:
      */
     virtual void render(Renderer* renderer, const Mat4* eyeTransforms, const Mat4* eyeProjections, unsigned int multiViewCount);
 
+    /** Enables keeping the world transforms of the scene in a TransformHierarchy.
+     * The transforms of the nodes that changed are then updated in one linear pass before the scene
+     * is visited, and the deprecated model view matrix stack of the Director isn't maintained while
+     * visiting, so don't enable it for scenes with nodes reading that stack.
+     *
+     * @param enabled Whether to use a TransformHierarchy, disabled by default.
+     */
+    void setTransformHierarchyEnabled(bool enabled);
+
+    /** Gets the TransformHierarchy of the scene.
+     *
+     * @return The TransformHierarchy of the scene, nullptr if it isn't enabled.
+     */
+    TransformHierarchy* getTransformHierarchy() const { return _transformHierarchy; }
+
     /** override function */
     virtual void removeAllChildren() override;
     
@@ -160,6 +176,8 @@ protected:
     EventListenerCustom*       _event;
 
     std::vector<BaseLight *> _lights;
+
+    TransformHierarchy* _transformHierarchy;
     
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Scene);
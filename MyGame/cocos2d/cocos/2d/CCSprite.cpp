@@ -373,6 +373,8 @@ void Sprite::setTexture(const std::string &filename)
 
 void Sprite::setTexture(Texture2D *texture)
 {
+    _renderCacheDirty = true;
+
     if(_glProgramState == nullptr)
     {
         setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP, texture));
@@ -435,6 +437,8 @@ void Sprite::setTextureRect(const Rect& rect, bool rotated, const Size& untrimme
 
 void Sprite::updatePoly()
 {
+    _renderCacheDirty = true;
+
     // There are 3 cases:
     //
     // A) a non 9-sliced, non stretched
@@ -1471,6 +1475,7 @@ void Sprite::flipX() {
             auto& v = _polyInfo.triangles.verts[i].vertices;
             v.x = _contentSize.width -v.x;
         }
+        _renderCacheDirty = true;
     }
     else
     {
@@ -1490,6 +1495,7 @@ void Sprite::flipY() {
             auto& v = _polyInfo.triangles.verts[i].vertices;
             v.y = _contentSize.height -v.y;
         }
+        _renderCacheDirty = true;
     }
     else
     {
@@ -1504,6 +1510,8 @@ void Sprite::flipY() {
 
 void Sprite::updateColor(void)
 {
+    _renderCacheDirty = true;
+
     Color4B color4( _displayedColor.r, _displayedColor.g, _displayedColor.b, _displayedOpacity );
 
     // special opacity for premultiplied textures
@@ -1730,6 +1738,7 @@ void Sprite::setPolygonInfo(const PolygonInfo& info)
 {
     _polyInfo = info;
     _renderMode = RenderMode::POLYGON;
+    _renderCacheDirty = true;
 }
 
 NS_CC_END
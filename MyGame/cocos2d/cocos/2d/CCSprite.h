@@ -493,7 +493,7 @@ public:
     *In lua: local setBlendFunc(local src, local dst).
     *@endcode
     */
-    void setBlendFunc(const BlendFunc &blendFunc) override { _blendFunc = blendFunc; }
+    void setBlendFunc(const BlendFunc &blendFunc) override { _blendFunc = blendFunc; _renderCacheDirty = true; }
     /**
     * @js  NA
     * @lua NA
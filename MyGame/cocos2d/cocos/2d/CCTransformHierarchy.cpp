@@ -0,0 +1,474 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "2d/CCTransformHierarchy.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+#include "2d/CCNode.h"
+#include "2d/CCCamera.h"
+#include "base/ccMacros.h"
+#include "base/CCJobSystem.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    // bounds are enlarged by this much, so that nodes moving a little don't change the culling tree
+    const float CULLING_BOUNDS_MARGIN = 16.0f;
+    // smaller scenes are updated faster by one thread than by waking workers
+    const size_t PARALLEL_UPDATE_MIN_NODES = 4096;
+    // more subtrees than workers, so that uneven subtrees still share the work
+    const size_t SUBTREES_PER_WORKER = 4;
+}
+
+TransformHierarchy* TransformHierarchy::s_visitingHierarchy = nullptr;
+unsigned int TransformHierarchy::s_structureVersion = 0;
+
+TransformHierarchy::TransformHierarchy(Node* root)
+: _root(root)
+, _headCount(0)
+, _updateStamp(0)
+, _structureVersion(s_structureVersion - 1)
+, _parallelUpdateEnabled(false)
+, _cullingEnabled(false)
+, _cullingActive(false)
+, _proxiesDirty(false)
+, _unboundedDirty(false)
+, _cullingTree(CULLING_BOUNDS_MARGIN)
+, _seenStamp(0)
+{
+}
+
+TransformHierarchy::~TransformHierarchy()
+{
+    if (s_visitingHierarchy == this)
+        s_visitingHierarchy = nullptr;
+}
+
+void TransformHierarchy::setParallelUpdateEnabled(bool enabled)
+{
+    if (_parallelUpdateEnabled == enabled)
+        return;
+
+    // the arrays are ordered by subtree for the workers
+    _parallelUpdateEnabled = enabled;
+    _structureVersion = s_structureVersion - 1;
+}
+
+void TransformHierarchy::setCullingEnabled(bool enabled)
+{
+    if (_cullingEnabled == enabled)
+        return;
+
+    _cullingEnabled = enabled;
+    _cullingActive = false;
+    _cullingTree.clear();
+    _proxyIds.assign(_nodes.size(), -1);
+    _proxiesDirty = _unboundedDirty = enabled;
+}
+
+void TransformHierarchy::rebuild()
+{
+    // breadth first, to know the size of every subtree
+    std::vector<Node*> nodes(1, _root);
+    std::vector<int> parents(1, -1);
+    std::vector<int> firstChildren;
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        firstChildren.push_back(static_cast<int>(nodes.size()));
+        for (const auto& child : nodes[i]->_children)
+        {
+            nodes.push_back(child);
+            parents.push_back(static_cast<int>(i));
+        }
+    }
+    const size_t count = nodes.size();
+
+    // for a parallel update, the roots of the biggest subtrees are replaced by their children until there are
+    // enough subtrees for the workers. Those roots are updated first, the subtrees are then independent
+    std::vector<bool> inHead(count, !_parallelUpdateEnabled);
+    std::vector<int> subtreeRoots;
+    if (_parallelUpdateEnabled)
+    {
+        std::vector<int> subtreeSizes(count, 1);
+        for (size_t i = count - 1; i > 0; --i)
+            subtreeSizes[parents[i]] += subtreeSizes[i];
+
+        inHead[0] = true;
+        for (int i = firstChildren[0]; i < firstChildren[0] + static_cast<int>(_root->_children.size()); ++i)
+            subtreeRoots.push_back(i);
+
+        const size_t subtreeCount = JobSystem::getInstance()->getWorkerCount() * SUBTREES_PER_WORKER;
+        while (subtreeRoots.size() < subtreeCount)
+        {
+            auto biggest = std::max_element(subtreeRoots.begin(), subtreeRoots.end(), [&subtreeSizes](int a, int b) {
+                return subtreeSizes[a] < subtreeSizes[b];
+            });
+            if (biggest == subtreeRoots.end() || subtreeSizes[*biggest] * subtreeCount <= count || nodes[*biggest]->_children.empty())
+                break;
+
+            const int index = *biggest;
+            subtreeRoots.erase(biggest);
+            inHead[index] = true;
+            for (int i = firstChildren[index]; i < firstChildren[index] + static_cast<int>(nodes[index]->_children.size()); ++i)
+                subtreeRoots.push_back(i);
+        }
+    }
+
+    // the head first, then every subtree breadth first in its own range, so a parent is always before its children
+    _nodes.clear();
+    _parentIndices.clear();
+    _subtreeRanges.clear();
+    std::vector<int> newIndices(count, -1);
+    auto append = [this, &nodes, &parents, &newIndices](int i) {
+        newIndices[i] = static_cast<int>(_nodes.size());
+        nodes[i]->_transformIndex = newIndices[i];
+        _nodes.push_back(nodes[i]);
+        _parentIndices.push_back(parents[i] >= 0 ? newIndices[parents[i]] : -1);
+    };
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (inHead[i])
+            append(static_cast<int>(i));
+    }
+    _headCount = _nodes.size();
+
+    std::vector<int> queue;
+    for (const int subtreeRoot : subtreeRoots)
+    {
+        const size_t begin = _nodes.size();
+        queue.assign(1, subtreeRoot);
+        for (size_t q = 0; q < queue.size(); ++q)
+        {
+            const int index = queue[q];
+            append(index);
+            for (int i = firstChildren[index]; i < firstChildren[index] + static_cast<int>(nodes[index]->_children.size()); ++i)
+                queue.push_back(i);
+        }
+        _subtreeRanges.push_back(std::make_pair(begin, _nodes.size()));
+    }
+    _subtreeDirtyIndices.resize(_subtreeRanges.size());
+
+    // everything is computed again the next update, the model view of a node that wasn't visited may be outdated
+    _flags.assign(count, 0);
+    _pendingFlags.assign(count, 0);
+    _skipped.assign(count, false);
+    _localValid.assign(count, false);
+    _localTransforms.resize(count);
+    _contentSizes.resize(count);
+    _worldTransforms.resize(count);
+    _visitedStamps.assign(count, 0);
+
+    _cullingTree.clear();
+    _proxyIds.assign(count, -1);
+    _seenStamps.assign(count, 0);
+    _proxiesDirty = _unboundedDirty = _cullingEnabled;
+
+    _structureVersion = s_structureVersion;
+}
+
+void TransformHierarchy::update(const Mat4& parentTransform)
+{
+    if (_structureVersion != s_structureVersion)
+        rebuild();
+
+    _dirtyIndices.clear();
+    if (++_updateStamp == 0)
+    {
+        _visitedStamps.assign(_nodes.size(), 0);
+        _updateStamp = 1;
+    }
+
+    const size_t count = _nodes.size();
+    updateRange(0, _headCount, parentTransform, _dirtyIndices);
+
+    auto jobSystem = (_parallelUpdateEnabled && count >= PARALLEL_UPDATE_MIN_NODES) ? JobSystem::getInstance() : nullptr;
+    const unsigned int threadCount = jobSystem ? std::min(jobSystem->getWorkerCount(), (unsigned int)_subtreeRanges.size()) : 1;
+    if (threadCount < 2)
+    {
+        updateRange(_headCount, count, parentTransform, _dirtyIndices);
+    }
+    else
+    {
+        // the subtrees are grouped in jobs of about the same number of nodes
+        const size_t nodesPerJob = (count - _headCount) / threadCount + 1;
+        auto updateSubtrees = [this, &parentTransform](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                _subtreeDirtyIndices[i].clear();
+                updateRange(_subtreeRanges[i].first, _subtreeRanges[i].second, parentTransform, _subtreeDirtyIndices[i]);
+            }
+        };
+
+        std::vector<JobSystem::JobHandle> workers;
+        const size_t subtreeCount = _subtreeRanges.size();
+        size_t firstJobEnd = 0;
+        size_t begin = 0;
+        while (begin < subtreeCount)
+        {
+            size_t end = begin;
+            size_t nodeCount = 0;
+            while (end < subtreeCount && nodeCount < nodesPerJob)
+            {
+                nodeCount += _subtreeRanges[end].second - _subtreeRanges[end].first;
+                ++end;
+            }
+
+            // the first job is done by this thread
+            if (begin == 0)
+                firstJobEnd = end;
+            else
+                workers.push_back(jobSystem->schedule(std::bind(updateSubtrees, begin, end), nullptr, JobSystem::Priority::HIGH));
+            begin = end;
+        }
+
+        updateSubtrees(0, firstJobEnd);
+        for (auto& worker : workers)
+            jobSystem->wait(worker);
+
+        for (const auto& dirtyIndices : _subtreeDirtyIndices)
+            _dirtyIndices.insert(_dirtyIndices.end(), dirtyIndices.begin(), dirtyIndices.end());
+    }
+
+    if (_cullingEnabled)
+    {
+        if (_proxiesDirty)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (!_skipped[i])
+                    updateCullingProxy(static_cast<int>(i));
+            }
+            _proxiesDirty = false;
+        }
+        else
+        {
+            for (const int i : _dirtyIndices)
+                updateCullingProxy(i);
+        }
+
+        if (_unboundedDirty)
+        {
+            _unboundedIndices.clear();
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (_proxyIds[i] < 0)
+                    _unboundedIndices.push_back(static_cast<int>(i));
+            }
+            _unboundedDirty = false;
+        }
+    }
+}
+
+void TransformHierarchy::updateRange(size_t begin, size_t end, const Mat4& parentTransform, std::vector<int>& dirtyIndices)
+{
+    const size_t firstDirty = dirtyIndices.size();
+
+    // first pass, parents before children: the flags of the nodes and the node to parent transforms of the dirty ones
+    for (size_t i = begin; i < end; ++i)
+    {
+        Node* node = _nodes[i];
+        const int parentIndex = _parentIndices[i];
+        if (!node->_visible || (parentIndex >= 0 && _skipped[parentIndex]))
+        {
+            // its parent may move while it is hidden
+            _skipped[i] = true;
+            _localValid[i] = false;
+            continue;
+        }
+        _skipped[i] = false;
+
+        uint32_t flags = parentIndex >= 0 ? _flags[parentIndex] : 0;
+
+        if (node->_usingNormalizedPosition)
+        {
+            CCASSERT(node->_parent, "setPositionNormalized() doesn't work with orphan nodes");
+            if ((flags & Node::FLAGS_CONTENT_SIZE_DIRTY) || node->_normalizedPositionDirty)
+            {
+                auto& s = node->_parent->getContentSize();
+                node->_position.x = node->_normalizedPosition.x * s.width;
+                node->_position.y = node->_normalizedPosition.y * s.height;
+                node->_transformUpdated = node->_transformDirty = node->_inverseDirty = true;
+                node->_normalizedPositionDirty = false;
+            }
+        }
+
+        if (!_localValid[i])
+        {
+            flags |= Node::FLAGS_TRANSFORM_DIRTY | (node->_contentSizeDirty ? Node::FLAGS_CONTENT_SIZE_DIRTY : 0);
+        }
+        else if (node->_transformUpdated || node->_contentSizeDirty)
+        {
+            // a node keeps its flags until it is visited, which a culled one isn't, so only count what changed
+            const Mat4& localTransform = node->getNodeToParentTransform();
+            if (!node->_contentSize.equals(_contentSizes[i]) || memcmp(localTransform.m, _localTransforms[i].m, sizeof(localTransform.m)) != 0)
+            {
+                flags |= (node->_transformUpdated ? Node::FLAGS_TRANSFORM_DIRTY : 0);
+                flags |= (node->_contentSizeDirty ? Node::FLAGS_CONTENT_SIZE_DIRTY : 0);
+            }
+        }
+        _flags[i] = flags;
+        _pendingFlags[i] |= flags;
+
+        if (flags & Node::FLAGS_DIRTY_MASK)
+        {
+            _localTransforms[i] = node->getNodeToParentTransform();
+            _contentSizes[i] = node->_contentSize;
+            _localValid[i] = true;
+            dirtyIndices.push_back(static_cast<int>(i));
+        }
+    }
+
+    // second pass over the dirty entries only, the world transform of a parent is always computed before its children's
+    for (size_t d = firstDirty; d < dirtyIndices.size(); ++d)
+    {
+        const int i = dirtyIndices[d];
+        const int parentIndex = _parentIndices[i];
+        Mat4::multiply(parentIndex >= 0 ? _worldTransforms[parentIndex] : parentTransform, _localTransforms[i], &_worldTransforms[i]);
+    }
+}
+
+void TransformHierarchy::updateCullingProxy(int index)
+{
+    AABB bounds;
+    if (_nodes[index]->getCullingBounds(&bounds))
+    {
+        bounds.transform(_worldTransforms[index]);
+        if (_proxyIds[index] < 0)
+        {
+            _proxyIds[index] = _cullingTree.createProxy(bounds, index);
+            _unboundedDirty = true;
+        }
+        else
+        {
+            _cullingTree.moveProxy(_proxyIds[index], bounds);
+        }
+    }
+    else if (_proxyIds[index] >= 0)
+    {
+        _cullingTree.destroyProxy(_proxyIds[index]);
+        _proxyIds[index] = -1;
+        _unboundedDirty = true;
+    }
+}
+
+void TransformHierarchy::cull(const Camera* camera)
+{
+    _cullingActive = _cullingEnabled && camera && _structureVersion == s_structureVersion;
+    if (!_cullingActive)
+        return;
+
+    if (++_seenStamp == 0)
+    {
+        _seenStamps.assign(_nodes.size(), 0);
+        _seenStamp = 1;
+    }
+
+    _cullingTree.query([camera](const AABB& aabb) {
+        return camera->isVisibleInFrustum(&aabb);
+    }, [this](int index) {
+        markSeen(index);
+    });
+
+    for (const int index : _unboundedIndices)
+    {
+        markSeen(index);
+    }
+}
+
+void TransformHierarchy::markSeen(int index)
+{
+    if (_skipped[index])
+        return;
+
+    // its ancestors are visited to reach it
+    while (index >= 0 && _seenStamps[index] != _seenStamp)
+    {
+        _seenStamps[index] = _seenStamp;
+        index = _parentIndices[index];
+    }
+}
+
+bool TransformHierarchy::isCulled(const Node* node) const
+{
+    if (!_cullingActive || _structureVersion != s_structureVersion)
+        return false;
+
+    const int index = node->_transformIndex;
+    if (index < 0 || index >= static_cast<int>(_nodes.size()) || _nodes[index] != node)
+        return false;
+
+    return _seenStamps[index] != _seenStamp;
+}
+
+int TransformHierarchy::indexOf(const Node* node, const Mat4& parentTransform) const
+{
+    // nodes were added or removed while visiting
+    if (_structureVersion != s_structureVersion)
+        return -1;
+
+    const int index = node->_transformIndex;
+    if (index < 0 || index >= static_cast<int>(_nodes.size()) || _nodes[index] != node || _skipped[index])
+        return -1;
+
+    // a node visited with another transform than the model view of its parent computes its own
+    if (index > 0 && &parentTransform != &node->_parent->_modelViewTransform)
+        return -1;
+
+    return index;
+}
+
+bool TransformHierarchy::isChangedSinceUpdate(int index) const
+{
+    // the update computed the node to parent transform of every node it took, which clears _transformDirty
+    const int parentIndex = _parentIndices[index];
+    return _nodes[index]->_transformDirty || (parentIndex >= 0 && _visitedStamps[parentIndex] == _updateStamp);
+}
+
+void TransformHierarchy::setVisitedTransform(int index, const Mat4& worldTransform)
+{
+    Node* node = _nodes[index];
+    _localTransforms[index] = node->getNodeToParentTransform();
+    _contentSizes[index] = node->_contentSize;
+    _localValid[index] = true;
+    _worldTransforms[index] = worldTransform;
+    _visitedStamps[index] = _updateStamp;
+
+    // the children visited after it compute theirs too, the others, culled or hidden, are taken again by the next update
+    for (const auto& child : node->_children)
+    {
+        const int childIndex = child->_transformIndex;
+        if (childIndex >= 0 && childIndex < static_cast<int>(_nodes.size()) && _nodes[childIndex] == child)
+            _localValid[childIndex] = false;
+    }
+
+    if (_cullingEnabled && !_proxiesDirty)
+        updateCullingProxy(index);
+}
+
+NS_CC_END
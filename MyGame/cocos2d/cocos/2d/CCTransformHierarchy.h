@@ -0,0 +1,172 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCTRANSFORM_HIERARCHY_H__
+#define __CCTRANSFORM_HIERARCHY_H__
+
+#include <utility>
+#include <vector>
+#include "math/CCMath.h"
+#include "math/CCGeometry.h"
+#include "platform/CCPlatformMacros.h"
+#include "3d/CCDynamicAABBTree.h"
+
+NS_CC_BEGIN
+
+class Node;
+class Camera;
+
+/**
+ *  @addtogroup _2d
+ *  @{
+ */
+
+/**
+ * @brief TransformHierarchy keeps the world transforms of a scene in arrays where parents come before their children.
+ *
+ * It is created by Scene::setTransformHierarchyEnabled(). Before the scene is visited, update()
+ * walks the arrays once, parents before children, collects the node to parent transforms of the
+ * nodes whose transform or content size changed (or whose parent's did), then multiplies them with
+ * their parent's world transform in a second linear pass over the dirty entries only.
+ * While the scene is visited, Node::processParentFlags() takes the flags and the model view transform
+ * of a node from the arrays instead of computing them, and Node::visit() no longer maintains the
+ * deprecated model view matrix stack of the Director.
+ *
+ * The arrays are rebuilt the first frame after a node was added to or removed from any parent.
+ * With the parallel update enabled, they are ordered by subtree instead: the roots of the biggest subtrees
+ * come first, then each subtree in its own range, and the ranges of large scenes are updated by JobSystem jobs.
+ * Hidden subtrees are skipped the same way Node::visit() skips them.
+ *
+ * With culling enabled, the world bounds of the nodes (see Node::getCullingBounds()) are kept in a
+ * DynamicAABBTree, updated with the transforms. Each camera queries it once before visiting the scene,
+ * and Node::visit() skips the children the camera sees no part of, with their whole subtree.
+ * @since v3.17
+ */
+class CC_DLL TransformHierarchy
+{
+public:
+    /** Creates the hierarchy of a root node, usually a Scene. */
+    explicit TransformHierarchy(Node* root);
+    ~TransformHierarchy();
+
+    /** Updates the world transforms of the dirty nodes, rebuilding the arrays first if nodes were added or removed.
+     *
+     * @param parentTransform The transform the root is visited with.
+     */
+    void update(const Mat4& parentTransform);
+
+    /** Gets the number of nodes in the arrays. */
+    size_t getNodeCount() const { return _nodes.size(); }
+
+    /** Gets the number of world transforms computed by the last update(). */
+    size_t getUpdatedCount() const { return _dirtyIndices.size(); }
+
+    /** Enables updating the independent subtrees of the scene on the JobSystem workers, disabled by default.
+     * Scenes with less than a few thousand nodes are still updated by the cocos2d thread.
+     * @note Node::getNodeToParentTransform() is then called by the workers, it must not change other nodes.
+     */
+    void setParallelUpdateEnabled(bool enabled);
+
+    /** Whether the update is done by the JobSystem workers for large scenes. */
+    bool isParallelUpdateEnabled() const { return _parallelUpdateEnabled; }
+
+    /** Enables skipping the subtrees a camera doesn't see while visiting, disabled by default.
+     * A node is culled with its bounds, see Node::getCullingBounds(), its parent is visited as long as one of
+     * its children is seen. Nodes without bounds are never culled.
+     * @note Nodes drawn to a RenderTexture by its auto draw are culled against the camera of the scene too.
+     */
+    void setCullingEnabled(bool enabled);
+
+    /** Whether culling is enabled. */
+    bool isCullingEnabled() const { return _cullingEnabled; }
+
+    /** Whether the camera being visited sees no part of a node and its subtree. */
+    bool isCulled(const Node* node) const;
+
+    /** Gets the hierarchy of the scene being visited, nullptr if the scene doesn't use one. */
+    static TransformHierarchy* getVisiting() { return s_visitingHierarchy; }
+
+    /** Tells all hierarchies that the parent of a node changed, called by Node::setParent(). */
+    static void markStructureDirty() { ++s_structureVersion; }
+
+protected:
+    friend class Node;
+    friend class Scene;
+
+    void rebuild();
+    void updateRange(size_t begin, size_t end, const Mat4& parentTransform, std::vector<int>& dirtyIndices);
+
+    /** Finds the nodes a camera sees, all are seen if camera is nullptr. */
+    void cull(const Camera* camera);
+    void updateCullingProxy(int index);
+    void markSeen(int index);
+
+    /** Gets the index of a node visited with parentTransform, -1 if its transform isn't in the arrays. */
+    int indexOf(const Node* node, const Mat4& parentTransform) const;
+
+    /** Whether the node or its parent moved since the last update(), while the scene is visited. */
+    bool isChangedSinceUpdate(int index) const;
+
+    /** Takes the model view transform a node computed while visited, its descendants compute theirs again. */
+    void setVisitedTransform(int index, const Mat4& worldTransform);
+
+    Node* _root;
+    std::vector<Node*> _nodes;                  ///< nodes in breadth first order per subtree, a parent is always before its children
+    std::vector<int> _parentIndices;            ///< index of the parent of each node, -1 for the root
+    std::vector<uint32_t> _flags;               ///< flags of the nodes in the last update
+    std::vector<uint32_t> _pendingFlags;        ///< flags of the nodes since they were last visited
+    std::vector<unsigned char> _skipped;        ///< whether a node is in a hidden subtree, bytes so that workers can write them
+    std::vector<unsigned char> _localValid;       ///< whether the local transform and content size of a node were taken since it was shown
+    std::vector<Mat4> _localTransforms;         ///< node to parent transforms
+    std::vector<Size> _contentSizes;            ///< content sizes the local transforms were taken with
+    std::vector<Mat4> _worldTransforms;         ///< model view transforms
+    std::vector<int> _dirtyIndices;             ///< indices whose world transform changed in the last update
+    size_t _headCount;                          ///< nodes updated before the subtrees
+    std::vector<std::pair<size_t, size_t>> _subtreeRanges;      ///< ranges of the subtrees updated independently
+    std::vector<std::vector<int>> _subtreeDirtyIndices;
+    std::vector<unsigned int> _visitedStamps;   ///< _updateStamp for the nodes that computed their transform while visited
+    unsigned int _updateStamp;
+    unsigned int _structureVersion;
+
+    bool _parallelUpdateEnabled;
+    bool _cullingEnabled;
+    bool _cullingActive;                        ///< whether the camera being visited culls
+    bool _proxiesDirty;                         ///< whether the bounds of all the nodes need to be updated
+    bool _unboundedDirty;
+    DynamicAABBTree _cullingTree;
+    std::vector<int> _proxyIds;                 ///< proxy of each node in the tree, -1 if it has no bounds
+    std::vector<int> _unboundedIndices;         ///< nodes without bounds, always seen
+    std::vector<unsigned int> _seenStamps;      ///< _seenStamp for the nodes the current camera sees
+    unsigned int _seenStamp;
+
+    static TransformHierarchy* s_visitingHierarchy;
+    static unsigned int s_structureVersion;
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif // __CCTRANSFORM_HIERARCHY_H__
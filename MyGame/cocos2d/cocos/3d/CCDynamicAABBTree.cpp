@@ -0,0 +1,362 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "3d/CCDynamicAABBTree.h"
+
+#include <algorithm>
+
+NS_CC_BEGIN
+
+namespace
+{
+    // half the perimeter rather than the surface, so that flat boxes of 2D nodes still have a cost
+    float getCost(const AABB& aabb)
+    {
+        return (aabb._max.x - aabb._min.x) + (aabb._max.y - aabb._min.y) + (aabb._max.z - aabb._min.z);
+    }
+
+    AABB combine(const AABB& a, const AABB& b)
+    {
+        AABB ret(a);
+        ret.merge(b);
+        return ret;
+    }
+
+    bool contains(const AABB& outer, const AABB& inner)
+    {
+        return outer._min.x <= inner._min.x && outer._min.y <= inner._min.y && outer._min.z <= inner._min.z
+            && inner._max.x <= outer._max.x && inner._max.y <= outer._max.y && inner._max.z <= outer._max.z;
+    }
+}
+
+DynamicAABBTree::DynamicAABBTree(float margin)
+: _root(NULL_NODE)
+, _freeList(NULL_NODE)
+, _proxyCount(0)
+, _margin(margin)
+{
+}
+
+void DynamicAABBTree::clear()
+{
+    _nodes.clear();
+    _root = NULL_NODE;
+    _freeList = NULL_NODE;
+    _proxyCount = 0;
+}
+
+int DynamicAABBTree::allocateNode()
+{
+    if (_freeList == NULL_NODE)
+    {
+        _nodes.push_back(TreeNode());
+        _nodes.back().parent = NULL_NODE;
+        _freeList = static_cast<int>(_nodes.size()) - 1;
+    }
+
+    const int nodeId = _freeList;
+    TreeNode& node = _nodes[nodeId];
+    _freeList = node.parent;
+    node.userData = -1;
+    node.parent = NULL_NODE;
+    node.child1 = NULL_NODE;
+    node.child2 = NULL_NODE;
+    node.height = 0;
+    return nodeId;
+}
+
+void DynamicAABBTree::freeNode(int nodeId)
+{
+    _nodes[nodeId].parent = _freeList;
+    _nodes[nodeId].height = -1;
+    _freeList = nodeId;
+}
+
+int DynamicAABBTree::createProxy(const AABB& aabb, int userData)
+{
+    const int proxyId = allocateNode();
+    const Vec3 margin(_margin, _margin, _margin);
+    _nodes[proxyId].aabb.set(aabb._min - margin, aabb._max + margin);
+    _nodes[proxyId].userData = userData;
+
+    insertLeaf(proxyId);
+    ++_proxyCount;
+    return proxyId;
+}
+
+void DynamicAABBTree::destroyProxy(int proxyId)
+{
+    CCASSERT(proxyId >= 0 && proxyId < static_cast<int>(_nodes.size()) && _nodes[proxyId].isLeaf(), "Invalid proxy id");
+
+    removeLeaf(proxyId);
+    freeNode(proxyId);
+    --_proxyCount;
+}
+
+bool DynamicAABBTree::moveProxy(int proxyId, const AABB& aabb)
+{
+    CCASSERT(proxyId >= 0 && proxyId < static_cast<int>(_nodes.size()) && _nodes[proxyId].isLeaf(), "Invalid proxy id");
+
+    if (contains(_nodes[proxyId].aabb, aabb))
+        return false;
+
+    removeLeaf(proxyId);
+    const Vec3 margin(_margin, _margin, _margin);
+    _nodes[proxyId].aabb.set(aabb._min - margin, aabb._max + margin);
+    insertLeaf(proxyId);
+    return true;
+}
+
+void DynamicAABBTree::insertLeaf(int leaf)
+{
+    if (_root == NULL_NODE)
+    {
+        _root = leaf;
+        _nodes[_root].parent = NULL_NODE;
+        return;
+    }
+
+    // find the sibling that makes the tree grow the least
+    const AABB leafAABB = _nodes[leaf].aabb;
+    int index = _root;
+    while (!_nodes[index].isLeaf())
+    {
+        const TreeNode& node = _nodes[index];
+        const float cost = getCost(node.aabb);
+        const float combinedCost = getCost(combine(node.aabb, leafAABB));
+
+        // cost of creating a new parent for this node and the leaf
+        const float parentCost = 2.0f * combinedCost;
+        // cost of pushing the leaf further down the tree
+        const float inheritanceCost = 2.0f * (combinedCost - cost);
+
+        const TreeNode& child1 = _nodes[node.child1];
+        float cost1 = getCost(combine(leafAABB, child1.aabb)) + inheritanceCost;
+        if (!child1.isLeaf())
+            cost1 -= getCost(child1.aabb);
+
+        const TreeNode& child2 = _nodes[node.child2];
+        float cost2 = getCost(combine(leafAABB, child2.aabb)) + inheritanceCost;
+        if (!child2.isLeaf())
+            cost2 -= getCost(child2.aabb);
+
+        if (parentCost < cost1 && parentCost < cost2)
+            break;
+
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    // create a new parent for the sibling and the leaf
+    const int sibling = index;
+    const int oldParent = _nodes[sibling].parent;
+    const int newParent = allocateNode();
+    _nodes[newParent].parent = oldParent;
+    _nodes[newParent].aabb = combine(leafAABB, _nodes[sibling].aabb);
+    _nodes[newParent].height = _nodes[sibling].height + 1;
+    _nodes[newParent].child1 = sibling;
+    _nodes[newParent].child2 = leaf;
+    _nodes[sibling].parent = newParent;
+    _nodes[leaf].parent = newParent;
+
+    if (oldParent != NULL_NODE)
+    {
+        if (_nodes[oldParent].child1 == sibling)
+            _nodes[oldParent].child1 = newParent;
+        else
+            _nodes[oldParent].child2 = newParent;
+    }
+    else
+    {
+        _root = newParent;
+    }
+
+    // walk back up, fixing the heights and boxes
+    index = _nodes[leaf].parent;
+    while (index != NULL_NODE)
+    {
+        index = balance(index);
+
+        TreeNode& node = _nodes[index];
+        node.height = 1 + std::max(_nodes[node.child1].height, _nodes[node.child2].height);
+        node.aabb = combine(_nodes[node.child1].aabb, _nodes[node.child2].aabb);
+
+        index = node.parent;
+    }
+}
+
+void DynamicAABBTree::removeLeaf(int leaf)
+{
+    if (leaf == _root)
+    {
+        _root = NULL_NODE;
+        return;
+    }
+
+    const int parent = _nodes[leaf].parent;
+    const int grandParent = _nodes[parent].parent;
+    const int sibling = _nodes[parent].child1 == leaf ? _nodes[parent].child2 : _nodes[parent].child1;
+
+    if (grandParent == NULL_NODE)
+    {
+        _root = sibling;
+        _nodes[sibling].parent = NULL_NODE;
+        freeNode(parent);
+        return;
+    }
+
+    // replace the parent with the sibling
+    if (_nodes[grandParent].child1 == parent)
+        _nodes[grandParent].child1 = sibling;
+    else
+        _nodes[grandParent].child2 = sibling;
+    _nodes[sibling].parent = grandParent;
+    freeNode(parent);
+
+    int index = grandParent;
+    while (index != NULL_NODE)
+    {
+        index = balance(index);
+
+        TreeNode& node = _nodes[index];
+        node.height = 1 + std::max(_nodes[node.child1].height, _nodes[node.child2].height);
+        node.aabb = combine(_nodes[node.child1].aabb, _nodes[node.child2].aabb);
+
+        index = node.parent;
+    }
+}
+
+// rotates the higher child of A up if A is unbalanced, returns the new root of the subtree
+int DynamicAABBTree::balance(int iA)
+{
+    TreeNode* A = &_nodes[iA];
+    if (A->isLeaf() || A->height < 2)
+        return iA;
+
+    const int iB = A->child1;
+    const int iC = A->child2;
+    TreeNode* B = &_nodes[iB];
+    TreeNode* C = &_nodes[iC];
+
+    const int heightDiff = C->height - B->height;
+
+    // rotate C up
+    if (heightDiff > 1)
+    {
+        const int iF = C->child1;
+        const int iG = C->child2;
+        TreeNode* F = &_nodes[iF];
+        TreeNode* G = &_nodes[iG];
+
+        // swap A and C
+        C->child1 = iA;
+        C->parent = A->parent;
+        A->parent = iC;
+
+        if (C->parent != NULL_NODE)
+        {
+            if (_nodes[C->parent].child1 == iA)
+                _nodes[C->parent].child1 = iC;
+            else
+                _nodes[C->parent].child2 = iC;
+        }
+        else
+        {
+            _root = iC;
+        }
+
+        if (F->height > G->height)
+        {
+            C->child2 = iF;
+            A->child2 = iG;
+            G->parent = iA;
+            A->aabb = combine(B->aabb, G->aabb);
+            C->aabb = combine(A->aabb, F->aabb);
+            A->height = 1 + std::max(B->height, G->height);
+            C->height = 1 + std::max(A->height, F->height);
+        }
+        else
+        {
+            C->child2 = iG;
+            A->child2 = iF;
+            F->parent = iA;
+            A->aabb = combine(B->aabb, F->aabb);
+            C->aabb = combine(A->aabb, G->aabb);
+            A->height = 1 + std::max(B->height, F->height);
+            C->height = 1 + std::max(A->height, G->height);
+        }
+        return iC;
+    }
+
+    // rotate B up
+    if (heightDiff < -1)
+    {
+        const int iD = B->child1;
+        const int iE = B->child2;
+        TreeNode* D = &_nodes[iD];
+        TreeNode* E = &_nodes[iE];
+
+        // swap A and B
+        B->child1 = iA;
+        B->parent = A->parent;
+        A->parent = iB;
+
+        if (B->parent != NULL_NODE)
+        {
+            if (_nodes[B->parent].child1 == iA)
+                _nodes[B->parent].child1 = iB;
+            else
+                _nodes[B->parent].child2 = iB;
+        }
+        else
+        {
+            _root = iB;
+        }
+
+        if (D->height > E->height)
+        {
+            B->child2 = iD;
+            A->child1 = iE;
+            E->parent = iA;
+            A->aabb = combine(C->aabb, E->aabb);
+            B->aabb = combine(A->aabb, D->aabb);
+            A->height = 1 + std::max(C->height, E->height);
+            B->height = 1 + std::max(A->height, D->height);
+        }
+        else
+        {
+            B->child2 = iE;
+            A->child1 = iD;
+            D->parent = iA;
+            A->aabb = combine(C->aabb, D->aabb);
+            B->aabb = combine(A->aabb, E->aabb);
+            A->height = 1 + std::max(C->height, D->height);
+            B->height = 1 + std::max(A->height, E->height);
+        }
+        return iB;
+    }
+
+    return iA;
+}
+
+NS_CC_END
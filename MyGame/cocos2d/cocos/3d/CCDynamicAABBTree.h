@@ -0,0 +1,163 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CC_DYNAMIC_AABB_TREE_H_
+#define __CC_DYNAMIC_AABB_TREE_H_
+
+#include <vector>
+#include "base/ccMacros.h"
+#include "3d/CCAABB.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup _3d
+ * @{
+ */
+
+/**
+ * A dynamic AABB tree: a bounding volume hierarchy of boxes that move.
+ * Each box (proxy) is stored enlarged by a margin, so moving it a little doesn't change the tree,
+ * and the tree is kept balanced with rotations when boxes are inserted or removed.
+ * It is used to find the boxes a camera frustum sees without testing all of them.
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL DynamicAABBTree
+{
+public:
+    /**
+     * Constructor.
+     * @param margin By how much boxes are enlarged on each side.
+     */
+    explicit DynamicAABBTree(float margin = 0.0f);
+
+    /**
+     * Adds a box.
+     * @param aabb The box.
+     * @param userData A value returned to the callback of query().
+     * @return The id of the proxy.
+     */
+    int createProxy(const AABB& aabb, int userData);
+
+    /**
+     * Removes a box.
+     */
+    void destroyProxy(int proxyId);
+
+    /**
+     * Moves a box.
+     * @return false if the enlarged box still contains the new one, the tree wasn't changed then.
+     */
+    bool moveProxy(int proxyId, const AABB& aabb);
+
+    /**
+     * Gets the user data of a proxy.
+     */
+    int getUserData(int proxyId) const { return _nodes[proxyId].userData; }
+
+    /**
+     * Gets the enlarged box of a proxy.
+     */
+    const AABB& getFatAABB(int proxyId) const { return _nodes[proxyId].aabb; }
+
+    /**
+     * Removes all the boxes.
+     */
+    void clear();
+
+    /**
+     * Gets the number of boxes.
+     */
+    int getProxyCount() const { return _proxyCount; }
+
+    /**
+     * Calls callback(userData) for every box that overlaps a volume.
+     * @param overlaps Tells whether a box overlaps the volume, bool overlaps(const AABB&). It is called
+     * for the boxes bounding subtrees too, a subtree whose box doesn't overlap is skipped.
+     * @param callback Called with the user data of the boxes that overlap.
+     */
+    template<typename Overlaps, typename Callback>
+    void query(const Overlaps& overlaps, const Callback& callback) const
+    {
+        if (_root == NULL_NODE)
+            return;
+
+        _queryStack.clear();
+        _queryStack.push_back(_root);
+        while (!_queryStack.empty())
+        {
+            const TreeNode& node = _nodes[_queryStack.back()];
+            _queryStack.pop_back();
+
+            if (!overlaps(node.aabb))
+                continue;
+
+            if (node.isLeaf())
+            {
+                callback(node.userData);
+            }
+            else
+            {
+                _queryStack.push_back(node.child1);
+                _queryStack.push_back(node.child2);
+            }
+        }
+    }
+
+protected:
+    static const int NULL_NODE = -1;
+
+    struct TreeNode
+    {
+        AABB aabb;
+        int userData;
+        int parent;         ///< parent, or next free node when in the free list
+        int child1;
+        int child2;
+        int height;         ///< 0 for a leaf, -1 for a free node
+
+        bool isLeaf() const { return child1 == NULL_NODE; }
+    };
+
+    int allocateNode();
+    void freeNode(int nodeId);
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+    int balance(int nodeId);
+
+    std::vector<TreeNode> _nodes;
+    int _root;
+    int _freeList;
+    int _proxyCount;
+    float _margin;
+    mutable std::vector<int> _queryStack;
+};
+
+// end of 3d group
+/// @}
+
+NS_CC_END
+
+#endif // __CC_DYNAMIC_AABB_TREE_H_
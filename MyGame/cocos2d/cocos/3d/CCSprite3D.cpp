@@ -872,6 +872,17 @@ Action* Sprite3D::runAction(Action *action)
     return Node::runAction(action);
 }
 
+bool Sprite3D::getCullingBounds(AABB* bounds) const
+{
+    bounds->reset();
+    for (const auto& it : _meshes)
+    {
+        if (it->isVisible())
+            bounds->merge(it->getAABB());
+    }
+    return !bounds->isEmpty();
+}
+
 Rect Sprite3D::getBoundingBox() const
 {
     AABB aabb = getAABB();
@@ -166,6 +166,9 @@ public:
      */
     virtual Rect getBoundingBox() const override;
 
+    /** Gets the box of the visible meshes in the sprite's coordinate system, used for culling. */
+    virtual bool getCullingBounds(AABB* bounds) const override;
+
     // set which face is going to cull, GL_BACK, GL_FRONT, GL_FRONT_AND_BACK, default GL_BACK
     void setCullFace(GLenum cullFace);
     // set cull face enable or not
@@ -47,6 +47,7 @@ cocos2d.cpp \
 2d/CCFontAtlasCache.cpp \
 2d/CCFontCharMap.cpp \
 2d/CCFontFNT.cpp \
+2d/CCFontSDF.cpp \
 2d/CCFontFreeType.cpp \
 2d/CCGLBufferedNode.cpp \
 2d/CCGrabber.cpp \
@@ -63,6 +64,7 @@ cocos2d.cpp \
 2d/CCMotionStreak.cpp \
 2d/CCNode.cpp \
 2d/CCNodeGrid.cpp \
+2d/CCRetainedBatchNode.cpp \
 2d/CCParallaxNode.cpp \
 2d/CCParticleBatchNode.cpp \
 2d/CCParticleExamples.cpp \
@@ -71,6 +73,7 @@ cocos2d.cpp \
 2d/CCProgressTimer.cpp \
 2d/CCProtectedNode.cpp \
 2d/CCRenderTexture.cpp \
+2d/CCRuntimeAtlas.cpp \
 2d/CCScene.cpp \
 2d/CCSprite.cpp \
 2d/CCSpriteBatchNode.cpp \
@@ -85,9 +88,11 @@ cocos2d.cpp \
 2d/CCTransition.cpp \
 2d/CCTransitionPageTurn.cpp \
 2d/CCTransitionProgress.cpp \
+2d/CCTransformHierarchy.cpp \
 2d/CCTweenFunction.cpp \
 2d/CCAutoPolygon.cpp \
 3d/CCFrustum.cpp \
+3d/CCDynamicAABBTree.cpp \
 3d/CCPlane.cpp \
 platform/CCDataManager.cpp \
 platform/CCFileUtils.cpp \
@@ -108,6 +113,7 @@ math/Vec4.cpp \
 base/CCNinePatchImageParser.cpp \
 base/CCStencilStateManager.cpp \
 base/CCAsyncTaskPool.cpp \
+base/CCJobSystem.cpp \
 base/CCAutoreleasePool.cpp \
 base/CCConfiguration.cpp \
 base/CCConsole.cpp \
@@ -139,6 +145,7 @@ base/CCProfiling.cpp \
 base/CCProperties.cpp \
 base/CCRef.cpp \
 base/CCScheduler.cpp \
+base/CCFunctionQueue.cpp \
 base/CCScriptSupport.cpp \
 base/CCTouch.cpp \
 base/CCUserDefault-android.cpp \
@@ -147,6 +154,7 @@ base/CCValue.cpp \
 base/ObjectFactory.cpp \
 base/TGAlib.cpp \
 base/ZipUtils.cpp \
+base/CCAssetPack.cpp \
 base/allocator/CCAllocatorDiagnostics.cpp \
 base/allocator/CCAllocatorGlobal.cpp \
 base/allocator/CCAllocatorGlobalNewDelete.cpp \
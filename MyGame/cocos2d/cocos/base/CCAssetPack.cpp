@@ -0,0 +1,281 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "base/CCAssetPack.h"
+
+#include <string.h>
+#include "zlib.h"
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#include <windows.h>
+#elif (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+NS_CC_BEGIN
+
+static_assert(sizeof(AssetPack::Header) == 48, "AssetPack::Header must match the pack layout");
+static_assert(sizeof(AssetPack::Entry) == 40, "AssetPack::Entry must match the pack layout");
+
+AssetPack* AssetPack::open(const std::string& fullPath)
+{
+    auto pack = new (std::nothrow) AssetPack();
+    if (pack == nullptr)
+        return nullptr;
+
+    pack->_path = fullPath;
+    if (!pack->mapFile(fullPath))
+    {
+        // Not on the file system (e.g. inside the apk), or the platform can't map files
+        if (FileUtils::getInstance()->getContents(fullPath, &pack->_data) != FileUtils::Status::OK)
+        {
+            CCLOG("AssetPack: can't open %s", fullPath.c_str());
+            delete pack;
+            return nullptr;
+        }
+        pack->_bytes = pack->_data.getBytes();
+        pack->_size = pack->_data.getSize();
+    }
+
+    if (!pack->validate())
+    {
+        CCLOG("AssetPack: %s isn't a valid asset pack", fullPath.c_str());
+        delete pack;
+        return nullptr;
+    }
+
+    pack->_header = reinterpret_cast<const Header*>(pack->_bytes);
+    pack->_entries = reinterpret_cast<const Entry*>(pack->_bytes + pack->_header->entriesOffset);
+    pack->_buckets = reinterpret_cast<const uint32_t*>(pack->_bytes + pack->_header->bucketsOffset);
+    pack->_names = reinterpret_cast<const char*>(pack->_bytes + pack->_header->namesOffset);
+    return pack;
+}
+
+AssetPack::AssetPack()
+: _bytes(nullptr)
+, _size(0)
+, _header(nullptr)
+, _entries(nullptr)
+, _buckets(nullptr)
+, _names(nullptr)
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+, _fileHandle(INVALID_HANDLE_VALUE)
+, _mappingHandle(nullptr)
+#endif
+, _mapped(false)
+{
+}
+
+AssetPack::~AssetPack()
+{
+    if (!_mapped)
+        return;
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    UnmapViewOfFile(_bytes);
+    CloseHandle(_mappingHandle);
+    CloseHandle(_fileHandle);
+#elif (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+    munmap(const_cast<unsigned char*>(_bytes), (size_t)_size);
+#endif
+}
+
+bool AssetPack::mapFile(const std::string& fullPath)
+{
+    if (!FileUtils::getInstance()->isAbsolutePath(fullPath))
+        return false;
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    int length = MultiByteToWideChar(CP_UTF8, 0, fullPath.c_str(), -1, nullptr, 0);
+    std::wstring widePath(length, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, fullPath.c_str(), -1, &widePath[0], length);
+
+    HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* bytes = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (bytes == nullptr)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    _fileHandle = file;
+    _mappingHandle = mapping;
+    _bytes = static_cast<const unsigned char*>(bytes);
+    _size = (uint64_t)size.QuadPart;
+    _mapped = true;
+    return true;
+#elif (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+    int fd = ::open(fullPath.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat statBuf;
+    if (fstat(fd, &statBuf) != 0 || !(statBuf.st_mode & S_IFREG) || statBuf.st_size == 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    void* bytes = mmap(nullptr, (size_t)statBuf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (bytes == MAP_FAILED)
+        return false;
+
+    _bytes = static_cast<const unsigned char*>(bytes);
+    _size = (uint64_t)statBuf.st_size;
+    _mapped = true;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool AssetPack::validate() const
+{
+    if (_size < sizeof(Header))
+        return false;
+
+    auto header = reinterpret_cast<const Header*>(_bytes);
+    if (header->magic != MAGIC || header->version != VERSION)
+        return false;
+
+    auto isInPack = [this](uint64_t offset, uint64_t size) {
+        return offset <= _size && size <= _size - offset;
+    };
+
+    // the tables are read in place, so they have to be aligned
+    if (header->entriesOffset % alignof(Entry) != 0 || header->bucketsOffset % alignof(uint32_t) != 0)
+        return false;
+    if (header->bucketCount == 0 || (header->bucketCount & (header->bucketCount - 1)) != 0 || header->bucketCount < header->entryCount)
+        return false;
+    if (!isInPack(header->entriesOffset, (uint64_t)header->entryCount * sizeof(Entry))
+        || !isInPack(header->bucketsOffset, (uint64_t)header->bucketCount * sizeof(uint32_t))
+        || !isInPack(header->namesOffset, header->namesSize))
+        return false;
+
+    auto entries = reinterpret_cast<const Entry*>(_bytes + header->entriesOffset);
+    for (uint32_t i = 0; i < header->entryCount; ++i)
+    {
+        const Entry& entry = entries[i];
+        if ((uint64_t)entry.nameOffset + entry.nameLength > header->namesSize || !isInPack(entry.offset, entry.storedSize))
+            return false;
+        if (entry.compression == Compression::NONE)
+        {
+            if (entry.storedSize != entry.size)
+                return false;
+        }
+        else if (entry.compression != Compression::ZLIB)
+        {
+            return false;
+        }
+    }
+
+    auto buckets = reinterpret_cast<const uint32_t*>(_bytes + header->bucketsOffset);
+    for (uint32_t i = 0; i < header->bucketCount; ++i)
+    {
+        if (buckets[i] > header->entryCount)
+            return false;
+    }
+
+    return true;
+}
+
+const AssetPack::Entry* AssetPack::findEntry(const char* name, size_t length) const
+{
+    const uint32_t hash = (uint32_t)crc32(0L, reinterpret_cast<const Bytef*>(name), (uInt)length);
+    const uint32_t mask = _header->bucketCount - 1;
+
+    // linear probing, the directory always has empty buckets left
+    for (uint32_t i = hash & mask, probes = 0; probes < _header->bucketCount; i = (i + 1) & mask, ++probes)
+    {
+        uint32_t index = _buckets[i];
+        if (index == 0)
+            return nullptr;
+
+        const Entry* entry = &_entries[index - 1];
+        if (entry->nameHash == hash && entry->nameLength == length && memcmp(_names + entry->nameOffset, name, length) == 0)
+            return entry;
+    }
+    return nullptr;
+}
+
+const char* AssetPack::getEntryName(const Entry* entry) const
+{
+    return _names + entry->nameOffset;
+}
+
+const unsigned char* AssetPack::getEntryBytes(const Entry* entry) const
+{
+    if (entry->compression != Compression::NONE)
+        return nullptr;
+    return _bytes + entry->offset;
+}
+
+bool AssetPack::getEntryData(const Entry* entry, ResizableBuffer* buffer) const
+{
+    buffer->resize((size_t)entry->size);
+    if (entry->size == 0)
+        return true;
+
+    if (entry->compression == Compression::NONE)
+    {
+        memcpy(buffer->buffer(), _bytes + entry->offset, (size_t)entry->size);
+        CC_ASSET_COPY_RECORD((ssize_t)entry->size);
+        return true;
+    }
+
+    uLongf size = (uLongf)entry->size;
+    int err = uncompress(static_cast<Bytef*>(buffer->buffer()), &size, _bytes + entry->offset, (uLong)entry->storedSize);
+    if (err != Z_OK || size != entry->size)
+    {
+        CCLOG("AssetPack: can't inflate %.*s in %s, error %d", (int)entry->nameLength, getEntryName(entry), _path.c_str(), err);
+        buffer->resize(0);
+        return false;
+    }
+    return true;
+}
+
+NS_CC_END
@@ -0,0 +1,161 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __BASE_CCASSETPACK_H__
+#define __BASE_CCASSETPACK_H__
+
+#include <stdint.h>
+#include <string>
+
+#include "platform/CCPlatformMacros.h"
+#include "platform/CCFileUtils.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+
+NS_CC_BEGIN
+
+/**
+ * @class AssetPack
+ * @brief A read only archive of resource files, mapped into memory once.
+ *
+ * Packs are built from a resource directory by tools/asset-pack/build_asset_pack.py. The file starts
+ * with an AssetPack::Header, followed by the entry table, a hashed directory over the entry names and the
+ * entry names. Every entry is stored at an aligned offset, either as is or compressed with zlib.
+ * Looking up an entry hashes its name once and probes the directory, it doesn't depend on the number
+ * of entries. Uncompressed entries can be read in place with getEntryBytes().
+ *
+ * Packs are usually mounted with FileUtils::addAssetPack() rather than used directly.
+ * @since v3.17
+ */
+class CC_DLL AssetPack
+{
+public:
+    /** "CCPK" */
+    static const uint32_t MAGIC = 0x4b504343;
+    static const uint32_t VERSION = 1;
+
+    enum class Compression : uint32_t
+    {
+        NONE = 0,
+        ZLIB = 1,
+    };
+
+    /** Header of a pack file, all the values are little endian. */
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t bucketCount;       ///< power of two, each bucket holds an entry index + 1, 0 if empty
+        uint64_t entriesOffset;
+        uint64_t bucketsOffset;
+        uint64_t namesOffset;
+        uint64_t namesSize;
+    };
+
+    struct Entry
+    {
+        uint32_t nameHash;          ///< crc32 of the name
+        uint32_t nameOffset;        ///< offset of the name in the name table
+        uint32_t nameLength;
+        Compression compression;
+        uint64_t offset;            ///< offset of the data in the pack
+        uint64_t storedSize;        ///< size of the data in the pack
+        uint64_t size;              ///< size of the file
+    };
+
+    /**
+     * Opens a pack. The file is memory mapped when it is on the file system and the platform
+     * supports it, otherwise it is read into memory.
+     *
+     * @param fullPath The full path of the pack.
+     * @return The pack, or nullptr if the file is missing or isn't a valid pack.
+     */
+    static AssetPack* open(const std::string& fullPath);
+
+    ~AssetPack();
+
+    /** The full path the pack was opened from. */
+    const std::string& getPath() const { return _path; }
+
+    /** The number of files in the pack. */
+    uint32_t getEntryCount() const { return _header->entryCount; }
+
+    /**
+     * Finds the entry of a file.
+     *
+     * @param name The name of the file relative to the directory the pack was built from, with '/' separators.
+     * @return The entry, or nullptr if the pack doesn't contain the file.
+     */
+    const Entry* findEntry(const char* name, size_t length) const;
+    const Entry* findEntry(const std::string& name) const { return findEntry(name.c_str(), name.size()); }
+
+    /** The name of an entry, it isn't null terminated. */
+    const char* getEntryName(const Entry* entry) const;
+
+    /** The bytes of an uncompressed entry inside the mapped pack, nullptr for compressed entries. */
+    const unsigned char* getEntryBytes(const Entry* entry) const;
+
+    /**
+     * Copies or decompresses the content of an entry into a buffer.
+     *
+     * @return True if successful.
+     */
+    bool getEntryData(const Entry* entry, ResizableBuffer* buffer) const;
+
+protected:
+    AssetPack();
+
+    bool mapFile(const std::string& fullPath);
+    bool validate() const;
+
+    std::string _path;
+    const unsigned char* _bytes;
+    uint64_t _size;
+    const Header* _header;
+    const Entry* _entries;
+    const uint32_t* _buckets;
+    const char* _names;
+
+    /** Content of the pack when it couldn't be mapped */
+    Data _data;
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    void* _fileHandle;
+    void* _mappingHandle;
+#endif
+    bool _mapped;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(AssetPack);
+};
+
+NS_CC_END
+
+// end of base group
+/// @}
+
+#endif // __BASE_CCASSETPACK_H__
@@ -47,10 +47,19 @@ void AsyncTaskPool::destroyInstance()
 
 AsyncTaskPool::AsyncTaskPool()
 {
+    for (auto& generation : _generations)
+    {
+        generation = std::make_shared<Generation>(0);
+    }
 }
 
 AsyncTaskPool::~AsyncTaskPool()
 {
+    // the tasks not started yet are dropped, as are the callbacks
+    for (int i = 0; i < int(TaskType::TASK_MAX_TYPE); ++i)
+    {
+        stopTasks((TaskType)i);
+    }
 }
 
 NS_CC_END
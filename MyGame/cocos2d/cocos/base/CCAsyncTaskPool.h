@@ -29,6 +29,8 @@ THE SOFTWARE.
 #include "platform/CCPlatformMacros.h"
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
+#include "base/CCJobSystem.h"
+#include <atomic>
 #include <vector>
 #include <queue>
 #include <memory>
@@ -49,6 +51,8 @@ NS_CC_BEGIN
 /**
  * @class AsyncTaskPool
  * @brief This class allows to perform background operations without having to manipulate threads.
+ * The tasks are performed by the JobSystem workers. Tasks of the same type run one after the other,
+ * in the order they were enqueued, and so are their callbacks; tasks of different types run concurrently.
  * @js NA
  */
 class CC_DLL AsyncTaskPool
@@ -87,7 +91,7 @@ public:
     /**
      * Enqueue a asynchronous task.
      *
-     * @param type task type is io task, network task or others, each type of task has a thread to deal with it.
+     * @param type task type is io task, network task or others, network tasks have a lower priority.
      * @param callback callback when the task is finished. The callback is called in the main thread instead of task thread.
      * @param callbackParam parameter used by the callback.
      * @param task: task can be lambda function to be performed off thread.
@@ -98,7 +102,7 @@ public:
     /**
     * Enqueue a asynchronous task.
     *
-    * @param type task type is io task, network task or others, each type of task has a thread to deal with it.
+    * @param type task type is io task, network task or others, network tasks have a lower priority.
     * @param task: task can be lambda function to be performed off thread.
     * @lua NA
     */
@@ -110,117 +114,44 @@ CC_CONSTRUCTOR_ACCESS:
     
 protected:
     
-    // thread tasks internally used
-    class ThreadTasks {
-        struct AsyncTaskCallBack
-        {
-            TaskCallBack          callback;
-            void*                 callbackParam;
-        };
-    public:
-        ThreadTasks()
-        : _stop(false)
-        {
-            _thread = std::thread(
-                                  [this]
-                                  {
-                                      for(;;)
-                                      {
-                                          std::function<void()> task;
-                                          AsyncTaskCallBack callback;
-                                          {
-                                              std::unique_lock<std::mutex> lock(this->_queueMutex);
-                                              this->_condition.wait(lock,
-                                                                    [this]{ return this->_stop || !this->_tasks.empty(); });
-                                              if(this->_stop && this->_tasks.empty())
-                                                  return;
-                                              task = std::move(this->_tasks.front());
-                                              callback = std::move(this->_taskCallBacks.front());
-                                              this->_tasks.pop();
-                                              this->_taskCallBacks.pop();
-                                          }
-                                          
-                                          task();
-                                          Director::getInstance()->getScheduler()->performFunctionInCocosThread(std::bind(callback.callback, callback.callbackParam));
-                                      }
-                                  }
-                                  );
-        }
-        ~ThreadTasks()
-        {
-            {
-                std::unique_lock<std::mutex> lock(_queueMutex);
-                _stop = true;
-                
-                while(_tasks.size())
-                    _tasks.pop();
-                while (_taskCallBacks.size())
-                    _taskCallBacks.pop();
-            }
-            _condition.notify_all();
-            _thread.join();
-        }
-        void clear()
-        {
-            std::unique_lock<std::mutex> lock(_queueMutex);
-            while(_tasks.size())
-                _tasks.pop();
-            while (_taskCallBacks.size())
-                _taskCallBacks.pop();
-        }
-
-        void enqueue(TaskCallBack callback, void* callbackParam, std::function<void()> task)
-        {
-            AsyncTaskCallBack taskCallBack;
-            taskCallBack.callback = std::move(callback);
-            taskCallBack.callbackParam = callbackParam;
-
-            {
-                std::unique_lock<std::mutex> lock(_queueMutex);
-                
-                // don't allow enqueueing after stopping the pool
-                if(_stop)
-                {
-                    CC_ASSERT(0 && "already stop");
-                    return;
-                }
-                
-                _tasks.push(std::move(task));
-                _taskCallBacks.push(std::move(taskCallBack));
-            }
-            _condition.notify_one();
-        }
-    private:
-        
-        // need to keep track of thread so we can join them
-        std::thread _thread;
-        // the task queue
-        std::queue< std::function<void()> > _tasks;
-        std::queue<AsyncTaskCallBack> _taskCallBacks;
-        
-        // synchronization
-        std::mutex _queueMutex;
-        std::condition_variable _condition;
-        bool _stop;
-    };
+    // Tasks run as JobSystem jobs. Stopping a type of task bumps its generation, tasks and
+    // callbacks of older generations are then skipped. It is shared with the jobs, which
+    // may outlive the pool.
+    typedef std::atomic<unsigned int> Generation;
+    std::shared_ptr<Generation> _generations[int(TaskType::TASK_MAX_TYPE)];
     
-    //tasks
-    ThreadTasks _threadTasks[int(TaskType::TASK_MAX_TYPE)];
+    // Each task depends on the previous task of its type, so that a type is performed in order.
+    std::mutex _lastTaskMutex;
+    JobSystem::JobHandle _lastTasks[int(TaskType::TASK_MAX_TYPE)];
     
     static AsyncTaskPool* s_asyncTaskPool;
 };
 
 inline void AsyncTaskPool::stopTasks(TaskType type)
 {
-    auto& threadTask = _threadTasks[(int)type];
-    threadTask.clear();
+    _generations[(int)type]->fetch_add(1);
 }
 
 inline void AsyncTaskPool::enqueue(AsyncTaskPool::TaskType type, TaskCallBack callback, void* callbackParam, std::function<void()> task)
 {
-    auto& threadTask = _threadTasks[(int)type];
+    auto generation = _generations[(int)type];
+    const unsigned int current = generation->load();
+    // network tasks mostly wait, they come after the others
+    const auto priority = (type == TaskType::TASK_NETWORK) ? JobSystem::Priority::LOW : JobSystem::Priority::NORMAL;
     
-    threadTask.enqueue(std::move(callback), callbackParam, std::move(task));
+    std::lock_guard<std::mutex> lock(_lastTaskMutex);
+    auto& lastTask = _lastTasks[(int)type];
+    lastTask = JobSystem::getInstance()->schedule([generation, current, task]() {
+        if (generation->load() == current)
+        {
+            task();
+        }
+    }, [generation, current, callback, callbackParam]() {
+        if (generation->load() == current && callback)
+        {
+            callback(callbackParam);
+        }
+    }, priority, std::vector<JobSystem::JobHandle>(1, lastTask));
 }
 
 inline void AsyncTaskPool::enqueue(AsyncTaskPool::TaskType type, std::function<void()> task)
@@ -51,6 +51,9 @@ Configuration::Configuration()
 , _supportsDiscardFramebuffer(false)
 , _supportsShareableVAO(false)
 , _supportsOESMapBuffer(false)
+, _supportsMapBufferRange(false)
+, _supportsFenceSync(false)
+, _supportsInstancedArrays(false)
 , _supportsOESDepth24(false)
 , _supportsOESPackedDepthStencil(false)
 , _maxSamplesAllowed(0)
@@ -161,6 +164,15 @@ void Configuration::gatherGPUInfo()
     _supportsOESMapBuffer = checkForGLExtension("GL_OES_mapbuffer");
     _valueDict["gl.supports_OES_map_buffer"] = Value(_supportsOESMapBuffer);
 
+    _supportsMapBufferRange = checkForGLExtension("GL_ARB_map_buffer_range") || checkForGLExtension("GL_EXT_map_buffer_range");
+    _valueDict["gl.supports_map_buffer_range"] = Value(_supportsMapBufferRange);
+
+    _supportsFenceSync = checkForGLExtension("GL_ARB_sync");
+    _valueDict["gl.supports_fence_sync"] = Value(_supportsFenceSync);
+
+    _supportsInstancedArrays = checkForGLExtension("GL_ARB_instanced_arrays") && checkForGLExtension("GL_ARB_draw_instanced");
+    _valueDict["gl.supports_instanced_arrays"] = Value(_supportsInstancedArrays);
+
     _supportsOESDepth24 = checkForGLExtension("GL_OES_depth24");
     _valueDict["gl.supports_OES_depth24"] = Value(_supportsOESDepth24);
 
@@ -295,6 +307,21 @@ bool Configuration::supportsMapBuffer() const
 #endif
 }
 
+bool Configuration::supportsMapBufferRange() const
+{
+    return _supportsMapBufferRange;
+}
+
+bool Configuration::supportsFenceSync() const
+{
+    return _supportsFenceSync;
+}
+
+bool Configuration::supportsInstancedArrays() const
+{
+    return _supportsInstancedArrays;
+}
+
 bool Configuration::supportsOESDepth24() const
 {
     return _supportsOESDepth24;
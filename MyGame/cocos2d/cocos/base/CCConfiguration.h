@@ -171,6 +171,30 @@ public:
      */
     bool supportsMapBuffer() const;
 
+    /** Whether or not glMapBufferRange() is supported.
+     *
+     * It checks for the extensions `GL_ARB_map_buffer_range` or `GL_EXT_map_buffer_range`.
+     *
+     * @return Whether or not `glMapBufferRange()` is supported.
+     */
+    bool supportsMapBufferRange() const;
+
+    /** Whether or not fence sync objects (glFenceSync(), glClientWaitSync()) are supported.
+     *
+     * It checks for the extension `GL_ARB_sync`.
+     *
+     * @return Whether or not fence sync objects are supported.
+     */
+    bool supportsFenceSync() const;
+
+    /** Whether or not instanced drawing (glVertexAttribDivisor(), glDrawArraysInstanced()) is supported.
+     *
+     * It checks for the extensions `GL_ARB_instanced_arrays` and `GL_ARB_draw_instanced`.
+     *
+     * @return Whether or not instanced drawing is supported.
+     */
+    bool supportsInstancedArrays() const;
+
     
     /** Max support directional light in shader, for Sprite3D.
      *
@@ -268,6 +292,9 @@ protected:
     bool            _supportsDiscardFramebuffer;
     bool            _supportsShareableVAO;
     bool            _supportsOESMapBuffer;
+    bool            _supportsMapBufferRange;
+    bool            _supportsFenceSync;
+    bool            _supportsInstancedArrays;
     bool            _supportsOESDepth24;
     bool            _supportsOESPackedDepthStencil;
     
@@ -86,6 +86,7 @@ void Data::move(Data& other)
     
     _bytes = other._bytes;
     _size = other._size;
+    _owner = std::move(other._owner);
 
     other._bytes = nullptr;
     other._size = 0;
@@ -113,11 +114,14 @@ ssize_t Data::copy(const unsigned char* bytes, const ssize_t size)
 
     if (size <= 0) return 0;
 
-    if (bytes != _bytes)
+    if (bytes != _bytes || _owner)
     {
+        // the viewed bytes have to stay alive until they are copied
+        std::shared_ptr<void> owner = _owner;
         clear();
         _bytes = (unsigned char*)malloc(sizeof(unsigned char) * size);
         memcpy(_bytes, bytes, size);
+        CC_ASSET_COPY_RECORD(size);
     }
 
     _size = size;
@@ -130,17 +134,35 @@ void Data::fastSet(unsigned char* bytes, const ssize_t size)
     //CCASSERT(bytes, "bytes should not be nullptr");
     _bytes = bytes;
     _size = size;
+    _owner.reset();
+}
+
+void Data::setView(unsigned char* bytes, const ssize_t size, std::shared_ptr<void> owner)
+{
+    CCASSERT(size >= 0, "setView size should be non-negative");
+    CCASSERT(owner, "owner should not be nullptr");
+    clear();
+    _bytes = bytes;
+    _size = size;
+    _owner = std::move(owner);
 }
 
 void Data::clear()
 {
-    if(_bytes) free(_bytes);
+    if(_bytes && !_owner) free(_bytes);
     _bytes = nullptr;
     _size = 0;
+    _owner.reset();
 }
 
 unsigned char* Data::takeBuffer(ssize_t* size)
 {
+    if (_owner)
+    {
+        // the caller frees the buffer, so a view gives away a copy
+        copy(_bytes, _size);
+    }
+
     auto buffer = getBytes();
     if (size)
         *size = getSize();
@@ -148,4 +170,31 @@ unsigned char* Data::takeBuffer(ssize_t* size)
     return buffer;
 }
 
+#if CC_ENABLE_ASSET_COPY_STATS
+
+static thread_local int64_t s_assetBytesCopied = 0;
+
+AssetCopyScope::AssetCopyScope(const std::string& assetName)
+: _assetName(assetName)
+, _bytesCopiedBefore(s_assetBytesCopied)
+{
+}
+
+AssetCopyScope::~AssetCopyScope()
+{
+    CCLOG("cocos2d: %s: %lld bytes copied while loading", _assetName.c_str(), (long long)(s_assetBytesCopied - _bytesCopiedBefore));
+}
+
+void AssetCopyScope::record(ssize_t size)
+{
+    s_assetBytesCopied += size;
+}
+
+int64_t AssetCopyScope::getBytesCopied()
+{
+    return s_assetBytesCopied;
+}
+
+#endif // CC_ENABLE_ASSET_COPY_STATS
+
 NS_CC_END
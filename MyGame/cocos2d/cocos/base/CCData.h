@@ -30,6 +30,7 @@
 #include "platform/CCPlatformMacros.h"
 #include <stdint.h> // for ssize_t on android
 #include <string>   // for ssize_t on linux
+#include <memory>
 #include "platform/CCStdC.h" // for ssize_t on window
 
 /**
@@ -143,14 +144,65 @@ public:
      * @return the internal data buffer, free it after use.
      */
     unsigned char* takeBuffer(ssize_t* size);
+
+    /**
+     * Makes the data a read-only view of bytes it doesn't own, no bytes are copied.
+     * The view keeps owner alive until it is cleared, so the bytes stay valid as long as the data.
+     * Copying a view copies the bytes, moving it keeps the view.
+     *
+     * @param bytes The viewed bytes, they must not be modified through the data.
+     * @param size The size of the viewed bytes.
+     * @param owner The object the bytes belong to.
+     * @since v3.17
+     */
+    void setView(unsigned char* bytes, const ssize_t size, std::shared_ptr<void> owner);
+
+    /**
+     * Whether the data is a view of bytes it doesn't own.
+     * @since v3.17
+     */
+    bool isView() const { return _owner != nullptr; }
+
 private:
     void move(Data& other);
 
 private:
     unsigned char* _bytes;
     ssize_t _size;
+    // keeps the bytes of a view alive, null if the data owns its bytes
+    std::shared_ptr<void> _owner;
 };
 
+#if CC_ENABLE_ASSET_COPY_STATS
+/**
+ * Counts the bytes copied while an asset is loaded on the current thread and logs them when the scope ends.
+ * Use it through CC_ASSET_COPY_SCOPE() and CC_ASSET_COPY_RECORD(), which do nothing unless
+ * CC_ENABLE_ASSET_COPY_STATS is enabled.
+ */
+class CC_DLL AssetCopyScope
+{
+public:
+    explicit AssetCopyScope(const std::string& assetName);
+    ~AssetCopyScope();
+
+    /** Records size bytes copied on the current thread. */
+    static void record(ssize_t size);
+
+    /** The bytes copied on the current thread since it started. */
+    static int64_t getBytesCopied();
+
+private:
+    std::string _assetName;
+    int64_t _bytesCopiedBefore;
+};
+
+#define CC_ASSET_COPY_SCOPE(__assetname__) cocos2d::AssetCopyScope __assetCopyScope(__assetname__)
+#define CC_ASSET_COPY_RECORD(__size__) cocos2d::AssetCopyScope::record(__size__)
+#else
+#define CC_ASSET_COPY_SCOPE(__assetname__)
+#define CC_ASSET_COPY_RECORD(__size__)
+#endif // CC_ENABLE_ASSET_COPY_STATS
+
 
 NS_CC_END
 
@@ -61,6 +61,7 @@ THE SOFTWARE.
 #include "base/CCAutoreleasePool.h"
 #include "base/CCConfiguration.h"
 #include "base/CCAsyncTaskPool.h"
+#include "base/CCJobSystem.h"
 #include "base/ObjectFactory.h"
 #include "platform/CCApplication.h"
 
@@ -1112,6 +1113,9 @@ void Director::reset()
     RenderState::finalize();
     
     destroyTextureCache();
+
+    // after the texture cache and the async task pool, which wait for their jobs or drop them
+    JobSystem::destroyInstance();
 }
 
 void Director::purgeDirector()
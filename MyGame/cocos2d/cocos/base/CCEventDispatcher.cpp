@@ -36,6 +36,7 @@
 #include "base/CCEventListenerController.h"
 #endif
 #include "2d/CCScene.h"
+#include "2d/CCProtectedNode.h"
 #include "base/CCDirector.h"
 #include "base/CCEventType.h"
 #include "2d/CCCamera.h"
@@ -198,9 +199,195 @@ void EventDispatcher::EventListenerVector::clear()
     clearFixedListeners();
 }
 
+// Cell size of the touch hit test grid, in world units
+static const float HIT_TEST_CELL_SIZE = 128.0f;
+// Nodes covering more cells than this (backgrounds, full screen layers) are always hit test candidates
+static const int HIT_TEST_MAX_CELLS_PER_NODE = 64;
+// Absorbs the rounding differences between the world bounds and convertToNodeSpace()
+static const float HIT_TEST_BOUNDS_MARGIN = 1.0f;
+
+static inline long long hitTestCellKey(int x, int y)
+{
+    return ((long long)x << 32) | (unsigned int)y;
+}
+
+static inline int hitTestCellCoord(float value)
+{
+    return (int)std::floor(value / HIT_TEST_CELL_SIZE);
+}
+
+EventDispatcher::HitTestGrid::HitTestGrid()
+: _queryStamp(0)
+, _count(0)
+{
+}
+
+int EventDispatcher::HitTestGrid::addNode(Node* node, int slot)
+{
+    if (slot >= 0)
+    {
+        CCASSERT(_entries[slot].node == node, "Invalid hit test slot!");
+        ++_entries[slot].referenceCount;
+        return slot;
+    }
+    
+    if (_freeSlots.empty())
+    {
+        slot = static_cast<int>(_entries.size());
+        _entries.push_back(Entry());
+    }
+    else
+    {
+        slot = _freeSlots.back();
+        _freeSlots.pop_back();
+    }
+    
+    auto& entry = _entries[slot];
+    entry.node = node;
+    entry.referenceCount = 1;
+    entry.inCells = false;
+    entry.unbounded = false;
+    entry.dirty = true;
+    entry.transformStamp = 0;
+    entry.queryStamp = 0;
+    ++_count;
+    
+    return slot;
+}
+
+bool EventDispatcher::HitTestGrid::removeNode(int slot)
+{
+    auto& entry = _entries[slot];
+    if (--entry.referenceCount > 0)
+        return false;
+    
+    removeFromCells(entry, slot);
+    entry.node = nullptr;
+    entry.inCells = false;
+    entry.dirty = false;
+    _freeSlots.push_back(slot);
+    --_count;
+    return true;
+}
+
+void EventDispatcher::HitTestGrid::query(const Vec2& point)
+{
+    // the bounds are validated lazily, only when a touch begins, so moving nodes costs nothing more per frame
+    const int entryCount = static_cast<int>(_entries.size());
+    for (int slot = 0; slot < entryCount; ++slot)
+    {
+        auto& entry = _entries[slot];
+        if (entry.node != nullptr && (entry.dirty || isTransformChanged(entry)))
+        {
+            updateBounds(entry, slot);
+        }
+    }
+    
+    ++_queryStamp;
+    
+    auto found = _cells.find(hitTestCellKey(hitTestCellCoord(point.x), hitTestCellCoord(point.y)));
+    if (found == _cells.end())
+        return;
+    
+    for (auto slot : found->second)
+    {
+        auto& entry = _entries[slot];
+        if (entry.bounds.containsPoint(point))
+        {
+            entry.queryStamp = _queryStamp;
+        }
+    }
+}
+
+bool EventDispatcher::HitTestGrid::isCandidate(int slot) const
+{
+    const auto& entry = _entries[slot];
+    return entry.unbounded || entry.queryStamp == _queryStamp;
+}
+
+bool EventDispatcher::HitTestGrid::isTransformChanged(const Entry& entry) const
+{
+    // the node or one of its ancestors moved, was resized or reparented since the bounds were computed
+    for (auto node = entry.node; node != nullptr; node = node->_parent)
+    {
+        if (node->_transformStamp > entry.transformStamp)
+            return true;
+    }
+    return false;
+}
+
+void EventDispatcher::HitTestGrid::updateBounds(Entry& entry, int slot)
+{
+    entry.dirty = false;
+    entry.transformStamp = Node::s_transformStamp;
+    removeFromCells(entry, slot);
+    entry.inCells = false;
+    
+    // Only 2D transforms are indexed. With 3D rotations the node's content rect doesn't
+    // map to a rect in the touch plane, so those nodes are always tested.
+    const Mat4 transform = entry.node->getNodeToWorldTransform();
+    const float* m = transform.m;
+    entry.unbounded = !(m[2] == 0 && m[3] == 0 && m[6] == 0 && m[7] == 0 && m[8] == 0 && m[9] == 0 && m[11] == 0 && m[15] == 1);
+    if (entry.unbounded)
+        return;
+    
+    const Size& size = entry.node->getContentSize();
+    entry.bounds = RectApplyTransform(Rect(0, 0, size.width, size.height), transform);
+    entry.bounds.origin.x -= HIT_TEST_BOUNDS_MARGIN;
+    entry.bounds.origin.y -= HIT_TEST_BOUNDS_MARGIN;
+    entry.bounds.size.width += HIT_TEST_BOUNDS_MARGIN * 2;
+    entry.bounds.size.height += HIT_TEST_BOUNDS_MARGIN * 2;
+    
+    entry.minCellX = hitTestCellCoord(entry.bounds.getMinX());
+    entry.minCellY = hitTestCellCoord(entry.bounds.getMinY());
+    entry.maxCellX = hitTestCellCoord(entry.bounds.getMaxX());
+    entry.maxCellY = hitTestCellCoord(entry.bounds.getMaxY());
+    
+    long long cellCount = (long long)(entry.maxCellX - entry.minCellX + 1) * (entry.maxCellY - entry.minCellY + 1);
+    if (cellCount > HIT_TEST_MAX_CELLS_PER_NODE)
+    {
+        entry.unbounded = true;
+        return;
+    }
+    
+    for (int y = entry.minCellY; y <= entry.maxCellY; ++y)
+    {
+        for (int x = entry.minCellX; x <= entry.maxCellX; ++x)
+        {
+            _cells[hitTestCellKey(x, y)].push_back(slot);
+        }
+    }
+    entry.inCells = true;
+}
+
+void EventDispatcher::HitTestGrid::removeFromCells(const Entry& entry, int slot)
+{
+    if (!entry.inCells)
+        return;
+    
+    for (int y = entry.minCellY; y <= entry.maxCellY; ++y)
+    {
+        for (int x = entry.minCellX; x <= entry.maxCellX; ++x)
+        {
+            auto found = _cells.find(hitTestCellKey(x, y));
+            if (found == _cells.end())
+                continue;
+            
+            auto& slots = found->second;
+            auto iter = std::find(slots.begin(), slots.end(), slot);
+            if (iter != slots.end())
+            {
+                *iter = slots.back();
+                slots.pop_back();
+            }
+        }
+    }
+}
+
 
 EventDispatcher::EventDispatcher()
-: _inDispatch(0)
+: _sceneGraphOrderRoot(nullptr)
+, _inDispatch(0)
 , _isEnabled(false)
 , _nodePriorityIndex(0)
 {
@@ -358,7 +545,12 @@ void EventDispatcher::removeEventListenersForTarget(Node* target, bool recursive
     // Ensure the node is removed from these immediately also.
     // Don't want any dangling pointers or the possibility of dealing with deleted objects..
     _nodePriorityMap.erase(target);
+    _nodeOrderKeys.erase(target);
     _dirtyNodes.erase(target);
+    for (auto& pending : _pendingSceneGraphOrder)
+    {
+        pending.second.nodes.erase(target);
+    }
 
     auto listenerIter = _nodeListenersMap.find(target);
     if (listenerIter != _nodeListenersMap.end())
@@ -418,10 +610,30 @@ void EventDispatcher::associateNodeAndEventListener(Node* node, EventListener* l
     }
     
     listeners->push_back(listener);
+    
+    // Computes the node's position in the draw order before the next dispatch
+    _dirtyNodes.insert(node);
+    
+    if (listener->getType() == EventListener::Type::TOUCH_ONE_BY_ONE
+        && static_cast<EventListenerTouchOneByOne*>(listener)->_hitTestByContentBounds)
+    {
+        node->_hitTestIndexSlot = _hitTestGrid.addNode(node, node->_hitTestIndexSlot);
+    }
 }
 
 void EventDispatcher::dissociateNodeAndEventListener(Node* node, EventListener* listener)
 {
+    if (listener->getType() == EventListener::Type::TOUCH_ONE_BY_ONE
+        && static_cast<EventListenerTouchOneByOne*>(listener)->_hitTestByContentBounds
+        && node->_hitTestIndexSlot >= 0)
+    {
+        if (_hitTestGrid.removeNode(node->_hitTestIndexSlot))
+        {
+            node->_hitTestIndexSlot = -1;
+        }
+    }
+    
+
     std::vector<EventListener*>* listeners = nullptr;
     auto found = _nodeListenersMap.find(node);
     if (found != _nodeListenersMap.end())
@@ -436,6 +648,7 @@ void EventDispatcher::dissociateNodeAndEventListener(Node* node, EventListener*
         if (listeners->empty())
         {
             _nodeListenersMap.erase(found);
+            _nodeOrderKeys.erase(node);
             delete listeners;
         }
     }
@@ -681,6 +894,7 @@ void EventDispatcher::removeEventListener(EventListener* listener)
         if (iter->second->empty())
         {
             _priorityDirtyFlagMap.erase(listener->getListenerID());
+            _pendingSceneGraphOrder.erase(listener->getListenerID());
             auto list = iter->second;
             iter = _listenerMap.erase(iter);
             CC_SAFE_DELETE(list);
@@ -976,9 +1190,17 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
     {
         auto mutableTouchesIter = mutableTouches.begin();
         
+        // Listeners hit testing by content bounds can only claim touches that begin over their node
+        bool useHitTestGrid = event->getEventCode() == EventTouch::EventCode::BEGAN && !_hitTestGrid.empty();
+        
         for (auto& touches : originalTouches)
         {
             bool isSwallowed = false;
+            
+            if (useHitTestGrid)
+            {
+                _hitTestGrid.query(touches->getLocation());
+            }
 
             auto onTouchEvent = [&](EventListener* l) -> bool { // Return true to break
                 EventListenerTouchOneByOne* listener = static_cast<EventListenerTouchOneByOne*>(l);
@@ -986,6 +1208,11 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
                 // Skip if the listener was removed.
                 if (!listener->_isRegistered)
                     return false;
+                
+                // Skip if the touch began outside of the listener's node.
+                if (useHitTestGrid && listener->_hitTestByContentBounds && listener->_node && listener->_node->_hitTestIndexSlot >= 0
+                    && !_hitTestGrid.isCandidate(listener->_node->_hitTestIndexSlot))
+                    return false;
              
                 event->setCurrentTarget(listener->_node);
                 
@@ -1232,6 +1459,7 @@ void EventDispatcher::updateListeners(Event* event)
         if (iter->second->empty())
         {
             _priorityDirtyFlagMap.erase(iter->first);
+            _pendingSceneGraphOrder.erase(iter->first);
             delete iter->second;
             iter = _listenerMap.erase(iter);
         }
@@ -1258,6 +1486,25 @@ void EventDispatcher::updateListeners(Event* event)
 
 void EventDispatcher::updateDirtyFlagForSceneGraph()
 {
+    // Every node changes its position when the running scene is replaced
+    auto runningScene = Director::getInstance()->getRunningScene();
+    if (runningScene != _sceneGraphOrderRoot)
+    {
+        _sceneGraphOrderRoot = runningScene;
+        for (const auto& e : _nodeListenersMap)
+        {
+            updateNodeOrderKey(e.first);
+        }
+        for (const auto& e : _listenerMap)
+        {
+            if (e.second->getSceneGraphPriorityListeners())
+            {
+                setDirty(e.first, DirtyFlag::SCENE_GRAPH_PRIORITY);
+                _pendingSceneGraphOrder[e.first].full = true;
+            }
+        }
+    }
+    
     if (!_dirtyNodes.empty())
     {
         for (auto& node : _dirtyNodes)
@@ -1265,9 +1512,11 @@ void EventDispatcher::updateDirtyFlagForSceneGraph()
             auto iter = _nodeListenersMap.find(node);
             if (iter != _nodeListenersMap.end())
             {
+                updateNodeOrderKey(node);
                 for (auto& l : *iter->second)
                 {
                     setDirty(l->getListenerID(), DirtyFlag::SCENE_GRAPH_PRIORITY);
+                    _pendingSceneGraphOrder[l->getListenerID()].nodes.insert(node);
                 }
             }
         }
@@ -1276,6 +1525,66 @@ void EventDispatcher::updateDirtyFlagForSceneGraph()
     }
 }
 
+void EventDispatcher::updateNodeOrderKey(Node* node)
+{
+    auto& key = _nodeOrderKeys[node];
+    key.inScene = false;
+    key.globalZOrder = node->getGlobalZOrder();
+    key.path.clear();
+    
+    Node* current = node;
+    for (Node* parent = node->getParent(); parent != nullptr; parent = parent->getParent())
+    {
+        // visitTarget() doesn't walk into protected children
+        if (dynamic_cast<ProtectedNode*>(parent) && parent->getChildren().getIndex(current) == -1)
+        {
+            return;
+        }
+        
+        // the same order as Node::sortNodes(): local Z order in the high 32 bits, order of arrival in the low ones
+        key.path.push_back((std::int64_t)current->_localZOrder * 0x100000000LL + current->_orderOfArrival);
+        current = parent;
+    }
+    
+    std::reverse(key.path.begin(), key.path.end());
+    key.inScene = (current != nullptr && current == _sceneGraphOrderRoot);
+}
+
+const EventDispatcher::NodeOrderKey& EventDispatcher::getNodeOrderKey(Node* node) const
+{
+    static const NodeOrderKey s_outOfScene = { false, 0.0f, std::vector<std::int64_t>() };
+    
+    auto found = _nodeOrderKeys.find(node);
+    return found != _nodeOrderKeys.end() ? found->second : s_outOfScene;
+}
+
+bool EventDispatcher::isDrawnBefore(const NodeOrderKey& a, const NodeOrderKey& b)
+{
+    // Nodes that aren't in the scene have the lowest priority, in no particular order
+    if (a.inScene != b.inScene)
+        return !a.inScene;
+    if (!a.inScene)
+        return false;
+    
+    if (a.globalZOrder != b.globalZOrder)
+        return a.globalZOrder < b.globalZOrder;
+    
+    size_t depth = std::min(a.path.size(), b.path.size());
+    for (size_t i = 0; i < depth; ++i)
+    {
+        if (a.path[i] != b.path[i])
+            return a.path[i] < b.path[i];
+    }
+    
+    // One node is an ancestor of the other: the children with a negative local Z order are drawn before their parent
+    if (a.path.size() < b.path.size())
+        return b.path[depth] >= 0;
+    if (b.path.size() < a.path.size())
+        return a.path[depth] < 0;
+    
+    return false;
+}
+
 void EventDispatcher::sortEventListeners(const EventListener::ListenerID& listenerID)
 {
     DirtyFlag dirtyFlag = DirtyFlag::NONE;
@@ -1322,22 +1631,73 @@ void EventDispatcher::sortEventListenersOfSceneGraphPriority(const EventListener
     if (sceneGraphListeners == nullptr)
         return;
 
-    // Reset priority index
+    // Listeners are kept from the highest priority (drawn last) to the lowest one
+    auto isHigherPriority = [this](const EventListener* l1, const EventListener* l2) {
+        return isDrawnBefore(getNodeOrderKey(l2->getAssociatedNode()), getNodeOrderKey(l1->getAssociatedNode()));
+    };
+    
+    auto pendingIter = _pendingSceneGraphOrder.find(listenerID);
+    if (pendingIter == _pendingSceneGraphOrder.end()
+        || pendingIter->second.full
+        || pendingIter->second.nodes.size() * 4 > sceneGraphListeners->size())
+    {
+        std::stable_sort(sceneGraphListeners->begin(), sceneGraphListeners->end(), isHigherPriority);
+    }
+    else
+    {
+        // Only the listeners of the nodes that moved are out of place, take them out and
+        // insert them back. Listeners removed while dispatching have no node any more.
+        const auto& pendingNodes = pendingIter->second.nodes;
+        std::vector<EventListener*> movedListeners;
+        size_t count = 0;
+        for (auto l : *sceneGraphListeners)
+        {
+            if (l->getAssociatedNode() == nullptr || pendingNodes.find(l->getAssociatedNode()) != pendingNodes.end())
+            {
+                movedListeners.push_back(l);
+            }
+            else
+            {
+                (*sceneGraphListeners)[count++] = l;
+            }
+        }
+        sceneGraphListeners->resize(count);
+        
+        for (auto l : movedListeners)
+        {
+            auto position = std::upper_bound(sceneGraphListeners->begin(), sceneGraphListeners->end(), l, isHigherPriority);
+            sceneGraphListeners->insert(position, l);
+        }
+    }
+    
+    if (pendingIter != _pendingSceneGraphOrder.end())
+    {
+        _pendingSceneGraphOrder.erase(pendingIter);
+    }
+    
+#if CC_EVENT_DISPATCHER_DEBUG_VERIFY_PRIORITY && COCOS2D_DEBUG > 0
     _nodePriorityIndex = 0;
     _nodePriorityMap.clear();
-
+    
     visitTarget(rootNode, true);
     
-    // After sort: priority < 0, > 0
-    std::stable_sort(sceneGraphListeners->begin(), sceneGraphListeners->end(), [this](const EventListener* l1, const EventListener* l2) {
-        return _nodePriorityMap[l1->getAssociatedNode()] > _nodePriorityMap[l2->getAssociatedNode()];
-    });
+    for (size_t i = 1, size = sceneGraphListeners->size(); i < size; ++i)
+    {
+        CCASSERT(_nodePriorityMap[(*sceneGraphListeners)[i - 1]->getAssociatedNode()] >= _nodePriorityMap[(*sceneGraphListeners)[i]->getAssociatedNode()],
+                 "The scene graph priority order of the listeners is out of date!");
+    }
+    
+    _nodePriorityMap.clear();
+#else
+    CC_UNUSED_PARAM(rootNode);
+#endif
     
 #if DUMP_LISTENER_ITEM_PRIORITY_INFO
     log("-----------------------------------");
     for (auto& l : *sceneGraphListeners)
     {
-        log("listener priority: node ([%s]%p), priority (%d)", typeid(*l->_node).name(), l->_node, _nodePriorityMap[l->_node]);
+        const auto& key = getNodeOrderKey(l->_node);
+        log("listener priority: node ([%s]%p), global Z (%f), depth (%d)", typeid(*l->_node).name(), l->_node, key.globalZOrder, (int)key.path.size());
     }
 #endif
 }
@@ -1431,6 +1791,7 @@ void EventDispatcher::removeEventListenersForListenerID(const EventListener::Lis
         // Remove the dirty flag according the 'listenerID'.
         // No need to check whether the dispatcher is dispatching event.
         _priorityDirtyFlagMap.erase(listenerID);
+        _pendingSceneGraphOrder.erase(listenerID);
         
         if (!_inDispatch)
         {
@@ -26,9 +26,11 @@
 #ifndef __CC_EVENT_DISPATCHER_H__
 #define __CC_EVENT_DISPATCHER_H__
 
+#include <cstdint>
 #include <functional>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <set>
 
@@ -36,6 +38,7 @@
 #include "base/CCEventListener.h"
 #include "base/CCEvent.h"
 #include "platform/CCStdC.h"
+#include "math/CCGeometry.h"
 
 /**
  * @addtogroup base
@@ -207,10 +210,12 @@ public:
 
 protected:
     friend class Node;
+    friend class RetainedBatchNode;
     
     /** Sets the dirty flag for a node. */
     void setDirtyForNode(Node* node);
     
+    
     /**
      *  The vector to store event listeners with scene graph based priority and fixed priority.
      */
@@ -237,6 +242,53 @@ protected:
         ssize_t _gt0Index;
     };
     
+    /**
+     *  Uniform grid over the world bounds of the nodes whose touch listeners only claim touches
+     *  inside their content rect, see EventListenerTouchOneByOne::setHitTestByContentBounds().
+     *  Bounds are refreshed lazily, the next time a touch begins after the node's transform changed.
+     */
+    class HitTestGrid
+    {
+    public:
+        HitTestGrid();
+        
+        bool empty() const { return _count == 0; }
+        
+        /** Adds a node to the grid, or adds a reference to it if it's already in. Returns the slot of the node. */
+        int addNode(Node* node, int slot);
+        /** Removes a reference to the node in the slot, returns true when the node left the grid. */
+        bool removeNode(int slot);
+        
+        /** Updates the outdated bounds, then marks the nodes whose bounds contain the point as candidates. */
+        void query(const Vec2& point);
+        /** Whether the node in the slot was a candidate of the last query. */
+        bool isCandidate(int slot) const;
+        
+    private:
+        struct Entry
+        {
+            Node* node;
+            int referenceCount;
+            Rect bounds;
+            int minCellX, minCellY, maxCellX, maxCellY;
+            bool inCells;
+            bool unbounded;
+            bool dirty;
+            std::uint64_t transformStamp;   ///< Node::s_transformStamp when the bounds were computed
+            unsigned int queryStamp;
+        };
+        
+        bool isTransformChanged(const Entry& entry) const;
+        void updateBounds(Entry& entry, int slot);
+        void removeFromCells(const Entry& entry, int slot);
+        
+        std::vector<Entry> _entries;
+        std::vector<int> _freeSlots;
+        std::unordered_map<long long, std::vector<int>> _cells;
+        unsigned int _queryStamp;
+        int _count;
+    };
+    
     /** Adds an event listener with item
      *  @note if it is dispatching event, the added operation will be delayed to the end of current dispatch
      *  @see forceAddEventListener
@@ -309,8 +361,33 @@ protected:
     /** Sets the dirty flag for a specified listener ID */
     void setDirty(const EventListener::ListenerID& listenerID, DirtyFlag flag);
     
-    /** Walks though scene graph to get the draw order for each node, it's called before sorting event listener with scene graph priority */
+    /** Walks though scene graph to get the draw order for each node, it's only used to verify the incrementally maintained order */
     void visitTarget(Node* node, bool isRootNode);
+    
+    /** Position of a node with scene graph priority listeners in the draw order of the running scene */
+    struct NodeOrderKey
+    {
+        bool inScene;                       ///< false if visitTarget() wouldn't reach the node from the running scene
+        float globalZOrder;
+        std::vector<std::int64_t> path;     ///< local Z order and order of arrival of each node, from the scene down to the node
+    };
+    
+    /** Nodes whose listeners have to be moved the next time a listener ID is sorted */
+    struct PendingSceneGraphOrder
+    {
+        PendingSceneGraphOrder() : full(false) {}
+        bool full;                          ///< whether all the listeners have to be sorted again
+        std::unordered_set<Node*> nodes;
+    };
+    
+    /** Recomputes the position of a node in the draw order */
+    void updateNodeOrderKey(Node* node);
+    
+    /** Gets the position of a node in the draw order, nodes without listeners are out of the scene */
+    const NodeOrderKey& getNodeOrderKey(Node* node) const;
+    
+    /** Whether the first node is drawn before the second one, so it has a lower scene graph priority */
+    static bool isDrawnBefore(const NodeOrderKey& a, const NodeOrderKey& b);
 
     /** Remove all listeners in _toRemoveListeners list and cleanup */
     void cleanToRemovedListeners();
@@ -324,9 +401,18 @@ protected:
     /** The map of node and event listeners */
     std::unordered_map<Node*, std::vector<EventListener*>*> _nodeListenersMap;
     
-    /** The map of node and its event priority */
+    /** The map of node and its event priority, only filled when verifying the incremental order */
     std::unordered_map<Node*, int> _nodePriorityMap;
     
+    /** The map of node and its position in the draw order */
+    std::unordered_map<Node*, NodeOrderKey> _nodeOrderKeys;
+    
+    /** key: listener ID, value: nodes whose listeners moved since the ID was sorted */
+    std::unordered_map<EventListener::ListenerID, PendingSceneGraphOrder> _pendingSceneGraphOrder;
+    
+    /** The scene the node order keys were computed for */
+    Node* _sceneGraphOrderRoot;
+    
     /** key: Global Z Order, value: Sorted Nodes */
     std::unordered_map<float, std::vector<Node*>> _globalZOrderNodeMap;
     
@@ -339,6 +425,9 @@ protected:
     /** The nodes were associated with scene graph based priority listeners */
     std::set<Node*> _dirtyNodes;
     
+    /** Spatial index of the nodes whose touch listeners hit test by content bounds */
+    HitTestGrid _hitTestGrid;
+    
     /** Whether the dispatcher is dispatching event */
     int _inDispatch;
     
@@ -40,6 +40,7 @@ EventListenerTouchOneByOne::EventListenerTouchOneByOne()
 , onTouchEnded(nullptr)
 , onTouchCancelled(nullptr)
 , _needSwallow(false)
+, _hitTestByContentBounds(false)
 {
 }
 
@@ -68,6 +69,17 @@ bool EventListenerTouchOneByOne::isSwallowTouches()
     return _needSwallow;
 }
 
+void EventListenerTouchOneByOne::setHitTestByContentBounds(bool enabled)
+{
+    CCASSERT(!isRegistered(), "The hit test mode can't be changed after the listener is added!");
+    _hitTestByContentBounds = enabled;
+}
+
+bool EventListenerTouchOneByOne::isHitTestByContentBounds() const
+{
+    return _hitTestByContentBounds;
+}
+
 EventListenerTouchOneByOne* EventListenerTouchOneByOne::create()
 {
     auto ret = new (std::nothrow) EventListenerTouchOneByOne();
@@ -109,6 +121,7 @@ EventListenerTouchOneByOne* EventListenerTouchOneByOne::clone()
         
         ret->_claimedTouches = _claimedTouches;
         ret->_needSwallow = _needSwallow;
+        ret->_hitTestByContentBounds = _hitTestByContentBounds;
     }
     else
     {
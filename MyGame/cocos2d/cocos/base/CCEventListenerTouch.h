@@ -69,6 +69,20 @@ public:
      */
     bool isSwallowTouches();
     
+    /** Declares that onTouchBegan only claims touches inside the content rect of the associated node.
+     * The dispatcher then keeps the node's world bounds in a spatial index and skips the listener
+     * for touches that begin elsewhere. Only affects listeners with scene graph priority, and has to
+     * be set before the listener is added to the dispatcher.
+     *
+     * @param enabled True if the touches are tested against the node's content rect.
+     */
+    void setHitTestByContentBounds(bool enabled);
+    /** Whether onTouchBegan only claims touches inside the content rect of the associated node.
+     *
+     * @return True if the touches are tested against the node's content rect.
+     */
+    bool isHitTestByContentBounds() const;
+    
     /// Overrides
     virtual EventListenerTouchOneByOne* clone() override;
     virtual bool checkAvailable() override;
@@ -91,6 +105,7 @@ CC_CONSTRUCTOR_ACCESS:
 private:
     std::vector<Touch*> _claimedTouches;
     bool _needSwallow;
+    bool _hitTestByContentBounds;
     
     friend class EventDispatcher;
 };
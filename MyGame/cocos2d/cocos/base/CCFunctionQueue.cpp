@@ -0,0 +1,213 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "base/CCFunctionQueue.h"
+#include <chrono>
+
+NS_CC_BEGIN
+
+FunctionQueue::FunctionQueue()
+: _cells(new Cell[CAPACITY])
+, _enqueuePosition(0)
+, _dequeuePosition(0)
+, _discardPosition(0)
+, _isOverflowing(false)
+, _overflowGeneration(0)
+, _pendingIndex(0)
+, _pendingGeneration(0)
+, _clearGeneration(0)
+{
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY should be a power of 2");
+
+    for (size_t i = 0; i < CAPACITY; ++i)
+    {
+        _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+FunctionQueue::~FunctionQueue()
+{
+    // the producers are done by now
+    for (size_t position = _dequeuePosition; ; ++position)
+    {
+        Cell* cell = &_cells[position & (CAPACITY - 1)];
+        if (cell->sequence.load(std::memory_order_acquire) != position + 1)
+        {
+            break;
+        }
+        cell->destroy(&cell->storage);
+    }
+
+    delete [] _cells;
+}
+
+FunctionQueue::Cell* FunctionQueue::claimCell(size_t* position)
+{
+    size_t pos = _enqueuePosition.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Cell* cell = &_cells[pos & (CAPACITY - 1)];
+        const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const ptrdiff_t diff = (ptrdiff_t)sequence - (ptrdiff_t)pos;
+
+        if (diff == 0)
+        {
+            if (_enqueuePosition.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                *position = pos;
+                return cell;
+            }
+        }
+        else if (diff < 0)
+        {
+            // full, the consumer did not release the cell of the previous lap yet
+            return nullptr;
+        }
+        else
+        {
+            pos = _enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void FunctionQueue::pushOverflow(Function function)
+{
+    std::lock_guard<std::mutex> lock(_overflowMutex);
+    _overflow.push_back(std::move(function));
+    // keeps the following functions out of the ring until the overflow is performed, to keep the order
+    _isOverflowing.store(true, std::memory_order_release);
+}
+
+bool FunctionQueue::isDiscarded(size_t position) const
+{
+    return (ptrdiff_t)(position - _discardPosition.load(std::memory_order_relaxed)) < 0;
+}
+
+void FunctionQueue::clear()
+{
+    _discardPosition.store(_enqueuePosition.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(_overflowMutex);
+    _overflow.clear();
+    ++_overflowGeneration;
+    _clearGeneration.store(_overflowGeneration, std::memory_order_release);
+}
+
+template <typename OutOfTime>
+void FunctionQueue::performRing(size_t end, const OutOfTime& isOutOfTime, size_t* count)
+{
+    while (_dequeuePosition != end && ! isOutOfTime())
+    {
+        Cell* cell = &_cells[_dequeuePosition & (CAPACITY - 1)];
+        if (cell->sequence.load(std::memory_order_acquire) != _dequeuePosition + 1)
+        {
+            // not published yet
+            break;
+        }
+
+        // performed in place, the cell is given back to the producers afterwards
+        const size_t position = _dequeuePosition++;
+        if (! isDiscarded(position))
+        {
+            cell->invoke(&cell->storage);
+            ++*count;
+        }
+        cell->destroy(&cell->storage);
+        cell->sequence.store(position + CAPACITY, std::memory_order_release);
+    }
+}
+
+size_t FunctionQueue::perform(float timeBudget)
+{
+    typedef std::chrono::steady_clock Clock;
+    const auto start = Clock::now();
+    size_t count = 0;
+
+    auto isOutOfTime = [&]() {
+        return timeBudget > 0 && count > 0
+            && std::chrono::duration<float>(Clock::now() - start).count() >= timeBudget;
+    };
+
+    // the ring, functions posted while performing are left for the next call
+    const size_t end = _enqueuePosition.load(std::memory_order_relaxed);
+    performRing(end, isOutOfTime, &count);
+
+    if (isOutOfTime() || ! _isOverflowing.load(std::memory_order_acquire))
+    {
+        return count;
+    }
+
+    // the overflow, once the ring is empty. The functions a producer posted in the ring before the overflow
+    // may come after end, performing the overflow first would break its order. Producers don't claim cells
+    // while the queue is overflowing, but some may have claimed one just before, so they are waited for
+    performRing(_enqueuePosition.load(std::memory_order_acquire), isOutOfTime, &count);
+    if (_dequeuePosition != _enqueuePosition.load(std::memory_order_acquire) || isOutOfTime())
+    {
+        return count;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_overflowMutex);
+        if (_pendingGeneration != _overflowGeneration)
+        {
+            _pending.clear();
+            _pendingIndex = 0;
+            _pendingGeneration = _overflowGeneration;
+        }
+        for (auto& function : _overflow)
+        {
+            _pending.push_back(std::move(function));
+        }
+        _overflow.clear();
+    }
+
+    while (_pendingIndex < _pending.size() && ! isOutOfTime())
+    {
+        if (_clearGeneration.load(std::memory_order_acquire) != _pendingGeneration)
+        {
+            break;
+        }
+
+        Function function = std::move(_pending[_pendingIndex++]);
+        function();
+        ++count;
+    }
+
+    if (_pendingIndex == _pending.size() || _clearGeneration.load(std::memory_order_acquire) != _pendingGeneration)
+    {
+        _pending.clear();
+        _pendingIndex = 0;
+
+        std::lock_guard<std::mutex> lock(_overflowMutex);
+        _pendingGeneration = _overflowGeneration;
+        if (_overflow.empty())
+        {
+            _isOverflowing.store(false, std::memory_order_release);
+        }
+    }
+
+    return count;
+}
+
+NS_CC_END
@@ -0,0 +1,164 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCFUNCTION_QUEUE_H__
+#define __CCFUNCTION_QUEUE_H__
+
+#include "platform/CCPlatformMacros.h"
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+NS_CC_BEGIN
+
+/**
+ * @cond
+ */
+
+/**
+ * A queue of functions posted from any thread and performed by a single consumer thread.
+ * The functions are stored in place in the cells of a fixed ring, so posting neither locks
+ * nor allocates when they fit FUNCTION_STORAGE_SIZE bytes. Once the ring is full, functions
+ * go to a locked overflow list until the consumer caught up with them.
+ * @js NA
+ */
+class CC_DLL FunctionQueue
+{
+public:
+    static const size_t CAPACITY = 1024;
+    // at least a std::function, which is 64 bytes with MSVC x64, so that larger callables can be stored boxed in one
+    static const size_t FUNCTION_STORAGE_SIZE = sizeof(std::function<void()>) > 48 ? sizeof(std::function<void()>) : 48;
+
+    FunctionQueue();
+    ~FunctionQueue();
+
+    /** Posts a function, thread safe. */
+    template <typename F>
+    void push(F&& function);
+
+    /**
+     * Performs the functions in posting order, on the consumer thread. The functions
+     * posted meanwhile are left for the next call, unless they are in the ring before an overflow.
+     * @param timeBudget Seconds after which the remaining functions are left for the next call, 0 means no limit.
+     * At least one function is performed.
+     * @return The number of functions performed.
+     */
+    size_t perform(float timeBudget);
+
+    /** Discards the functions posted so far, thread safe. */
+    void clear();
+
+private:
+    typedef std::function<void()> Function;
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        void (*invoke)(void* storage);
+        void (*destroy)(void* storage);
+        typename std::aligned_storage<FUNCTION_STORAGE_SIZE, alignof(std::max_align_t)>::type storage;
+    };
+
+    template <typename F>
+    static void invokeFunction(void* storage) { (*static_cast<F*>(storage))(); }
+    template <typename F>
+    static void destroyFunction(void* storage) { static_cast<F*>(storage)->~F(); }
+
+    template <typename F>
+    static void emplace(Cell* cell, F&& function, std::true_type /*fits*/);
+    template <typename F>
+    static void emplace(Cell* cell, F&& function, std::false_type /*fits*/);
+
+    Cell* claimCell(size_t* position);
+    template <typename OutOfTime>
+    void performRing(size_t end, const OutOfTime& isOutOfTime, size_t* count);
+    void pushOverflow(Function function);
+    bool isDiscarded(size_t position) const;
+
+    Cell* _cells;
+    std::atomic<size_t> _enqueuePosition;
+    size_t _dequeuePosition;
+    std::atomic<size_t> _discardPosition;
+
+    std::atomic<bool> _isOverflowing;
+    std::mutex _overflowMutex;
+    std::vector<Function> _overflow;
+    unsigned int _overflowGeneration;       // bumped by clear(), guarded by _overflowMutex
+    // overflow functions taken by the consumer, left over from a call run out of time
+    std::vector<Function> _pending;
+    size_t _pendingIndex;
+    unsigned int _pendingGeneration;
+    std::atomic<unsigned int> _clearGeneration;
+};
+
+template <typename F>
+void FunctionQueue::push(F&& function)
+{
+    typedef typename std::decay<F>::type Callable;
+
+    if (! _isOverflowing.load(std::memory_order_acquire))
+    {
+        size_t position;
+        Cell* cell = claimCell(&position);
+        if (cell)
+        {
+            emplace(cell, std::forward<F>(function), std::integral_constant<bool,
+                    sizeof(Callable) <= FUNCTION_STORAGE_SIZE && alignof(Callable) <= alignof(std::max_align_t)>());
+            cell->sequence.store(position + 1, std::memory_order_release);
+            return;
+        }
+    }
+
+    pushOverflow(Function(std::forward<F>(function)));
+}
+
+template <typename F>
+void FunctionQueue::emplace(Cell* cell, F&& function, std::true_type)
+{
+    typedef typename std::decay<F>::type Callable;
+    new (&cell->storage) Callable(std::forward<F>(function));
+    cell->invoke = &invokeFunction<Callable>;
+    cell->destroy = &destroyFunction<Callable>;
+}
+
+template <typename F>
+void FunctionQueue::emplace(Cell* cell, F&& function, std::false_type)
+{
+    // too large to be stored in place
+    static_assert(sizeof(Function) <= FUNCTION_STORAGE_SIZE, "std::function should fit the cell storage");
+    emplace(cell, Function(std::forward<F>(function)), std::true_type());
+}
+
+/**
+ * @endcond
+ */
+
+NS_CC_END
+
+#endif // __CCFUNCTION_QUEUE_H__
@@ -0,0 +1,331 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "base/CCJobSystem.h"
+#include "base/CCDirector.h"
+#include "base/CCScheduler.h"
+
+NS_CC_BEGIN
+
+class JobSystem::Job
+{
+public:
+    enum State
+    {
+        QUEUED,
+        RUNNING,
+        CANCELLED,
+    };
+
+    Job()
+    : priority(Priority::NORMAL)
+    , pendingCount(0)
+    , state(QUEUED)
+    , finished(false)
+    {}
+
+    std::function<void()> task;
+    std::function<void()> completion;
+    Priority priority;
+    // unfinished dependencies, plus one while the job is being scheduled
+    std::atomic<int> pendingCount;
+    std::atomic<int> state;
+
+    std::mutex mutex;
+    std::vector<JobHandle> continuations;
+    bool finished;
+};
+
+JobSystem* JobSystem::s_jobSystem = nullptr;
+
+JobSystem* JobSystem::getInstance()
+{
+    if (s_jobSystem == nullptr)
+    {
+        s_jobSystem = new (std::nothrow) JobSystem();
+    }
+    return s_jobSystem;
+}
+
+void JobSystem::destroyInstance()
+{
+    delete s_jobSystem;
+    s_jobSystem = nullptr;
+}
+
+JobSystem::JobSystem()
+: _queuedJobCount(0)
+, _waiterCount(0)
+, _stop(false)
+{
+    unsigned int workerCount = std::thread::hardware_concurrency();
+    if (workerCount < 2)
+    {
+        workerCount = 2;
+    }
+
+    for (unsigned int i = 0; i <= workerCount; ++i)
+    {
+        _queues.push_back(std::unique_ptr<JobQueue>(new (std::nothrow) JobQueue()));
+    }
+
+    for (unsigned int i = 0; i < workerCount; ++i)
+    {
+        _workers.push_back(std::thread(&JobSystem::workerLoop, this, (int)i));
+    }
+
+    // only read once a job was submitted, after the constructor returned
+    for (auto& worker : _workers)
+    {
+        _workerIds.push_back(worker.get_id());
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _stop = true;
+    }
+    _sleepCondition.notify_all();
+
+    for (auto& worker : _workers)
+    {
+        worker.join();
+    }
+}
+
+JobSystem::JobHandle JobSystem::schedule(std::function<void()> task, std::function<void()> completion,
+                                         Priority priority, const std::vector<JobHandle>& dependencies)
+{
+    auto job = std::make_shared<Job>();
+    job->task = std::move(task);
+    job->completion = std::move(completion);
+    job->priority = priority;
+    job->pendingCount.store(1 + (int)dependencies.size());
+
+    for (const auto& dependency : dependencies)
+    {
+        bool finished = true;
+        if (dependency)
+        {
+            std::lock_guard<std::mutex> lock(dependency->mutex);
+            finished = dependency->finished;
+            if (!finished)
+            {
+                dependency->continuations.push_back(job);
+            }
+        }
+
+        if (finished)
+        {
+            job->pendingCount.fetch_sub(1);
+        }
+    }
+
+    if (job->pendingCount.fetch_sub(1) == 1)
+    {
+        submit(job);
+    }
+    return job;
+}
+
+JobSystem::JobHandle JobSystem::then(const JobHandle& job, std::function<void()> task, std::function<void()> completion, Priority priority)
+{
+    return schedule(std::move(task), std::move(completion), priority, std::vector<JobHandle>(1, job));
+}
+
+bool JobSystem::cancel(const JobHandle& job)
+{
+    int expected = Job::QUEUED;
+    return job && job->state.compare_exchange_strong(expected, Job::CANCELLED);
+}
+
+bool JobSystem::isFinished(const JobHandle& job) const
+{
+    std::lock_guard<std::mutex> lock(job->mutex);
+    return job->finished;
+}
+
+void JobSystem::wait(const JobHandle& job)
+{
+    const int workerIndex = getCurrentWorkerIndex();
+
+    while (!isFinished(job))
+    {
+        // only helps with jobs as urgent as the waited one, so that a wait
+        // in the cocos2d thread isn't stalled by a long background job
+        JobHandle other = takeJob(workerIndex, job->priority);
+        if (other)
+        {
+            run(other);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        ++_waiterCount;
+        _finishCondition.wait_for(lock, std::chrono::milliseconds(1));
+        --_waiterCount;
+    }
+}
+
+int JobSystem::getCurrentWorkerIndex() const
+{
+    const auto id = std::this_thread::get_id();
+    for (size_t i = 0; i < _workerIds.size(); ++i)
+    {
+        if (_workerIds[i] == id)
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+void JobSystem::submit(const JobHandle& job)
+{
+    // a worker keeps the jobs it submits, the other threads share the last queue
+    const int workerIndex = getCurrentWorkerIndex();
+    JobQueue* queue = workerIndex >= 0 ? _queues[workerIndex].get() : _queues.back().get();
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->jobs[(int)job->priority].push_back(job);
+    }
+    _queuedJobCount.fetch_add(1);
+
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+    }
+    _sleepCondition.notify_one();
+}
+
+JobSystem::JobHandle JobSystem::takeJob(int workerIndex, Priority lowestPriority)
+{
+    const int queueCount = (int)_queues.size();
+
+    for (int priority = 0; priority <= (int)lowestPriority; ++priority)
+    {
+        // the newest job of its own queue, which data is likely still in the cache
+        if (workerIndex >= 0)
+        {
+            JobQueue* queue = _queues[workerIndex].get();
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            auto& jobs = queue->jobs[priority];
+            if (!jobs.empty())
+            {
+                JobHandle job = std::move(jobs.back());
+                jobs.pop_back();
+                _queuedJobCount.fetch_sub(1);
+                return job;
+            }
+        }
+
+        // otherwise steal the oldest job of another queue
+        for (int i = 0; i < queueCount; ++i)
+        {
+            const int index = (workerIndex + 1 + i) % queueCount;
+            if (index == workerIndex)
+            {
+                continue;
+            }
+
+            JobQueue* queue = _queues[index].get();
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            auto& jobs = queue->jobs[priority];
+            if (!jobs.empty())
+            {
+                JobHandle job = std::move(jobs.front());
+                jobs.pop_front();
+                _queuedJobCount.fetch_sub(1);
+                return job;
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+void JobSystem::run(const JobHandle& job)
+{
+    int expected = Job::QUEUED;
+    if (job->state.compare_exchange_strong(expected, Job::RUNNING))
+    {
+        job->task();
+
+        if (job->completion)
+        {
+            Director::getInstance()->getScheduler()->performFunctionInCocosThread(std::move(job->completion));
+        }
+    }
+
+    finish(job);
+}
+
+void JobSystem::finish(const JobHandle& job)
+{
+    std::vector<JobHandle> continuations;
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        job->finished = true;
+        job->task = nullptr;
+        job->completion = nullptr;
+        continuations.swap(job->continuations);
+    }
+
+    for (const auto& continuation : continuations)
+    {
+        if (continuation->pendingCount.fetch_sub(1) == 1)
+        {
+            submit(continuation);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_sleepMutex);
+    if (_waiterCount > 0)
+    {
+        _finishCondition.notify_all();
+    }
+}
+
+void JobSystem::workerLoop(int workerIndex)
+{
+    for (;;)
+    {
+        JobHandle job = takeJob(workerIndex, Priority::LOW);
+        if (job)
+        {
+            run(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _sleepCondition.wait(lock, [this]() { return _stop || _queuedJobCount.load() > 0; });
+        if (_stop)
+        {
+            return;
+        }
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,151 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCJOB_SYSTEM_H__
+#define __CCJOB_SYSTEM_H__
+
+#include "platform/CCPlatformMacros.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @addtogroup base
+ * @{
+ */
+NS_CC_BEGIN
+
+/**
+ * @class JobSystem
+ * @brief Runs jobs on a pool of worker threads sized to the hardware core count.
+ *
+ * Every worker has its own queues and steals jobs from the other workers once they are empty,
+ * jobs of higher priority are always taken first. A job may depend on other jobs, it is queued
+ * once they are all finished, and may have a completion function called in the cocos2d thread.
+ * @js NA
+ */
+class CC_DLL JobSystem
+{
+public:
+    enum class Priority
+    {
+        HIGH,
+        NORMAL,
+        LOW,
+    };
+
+    class Job;
+    typedef std::shared_ptr<Job> JobHandle;
+
+    /**
+     * Returns the shared instance of the job system.
+     */
+    static JobSystem* getInstance();
+
+    /**
+     * Destroys the job system, the jobs not started yet are dropped.
+     */
+    static void destroyInstance();
+
+    /** Returns the number of worker threads. */
+    unsigned int getWorkerCount() const { return (unsigned int)_workers.size(); }
+
+    /**
+     * Schedules a job.
+     *
+     * @param task The function performed by a worker thread.
+     * @param completion The function called in the cocos2d thread once the task is performed, may be nullptr.
+     * @param priority Jobs of higher priority are taken first.
+     * @param dependencies The jobs to be finished before the task is performed.
+     * @return The job, to be waited for or to be depended on.
+     */
+    JobHandle schedule(std::function<void()> task, std::function<void()> completion = nullptr,
+                       Priority priority = Priority::NORMAL, const std::vector<JobHandle>& dependencies = std::vector<JobHandle>());
+
+    /**
+     * Schedules a job performed once the given one is finished.
+     */
+    JobHandle then(const JobHandle& job, std::function<void()> task, std::function<void()> completion = nullptr,
+                   Priority priority = Priority::NORMAL);
+
+    /**
+     * Cancels a job not started yet, its task and completion are not called.
+     * The jobs depending on it still run once it is finished.
+     * @return false if the job was already started.
+     */
+    bool cancel(const JobHandle& job);
+
+    /** Returns true once the task of the job was performed or skipped. */
+    bool isFinished(const JobHandle& job) const;
+
+    /**
+     * Waits until the job is finished, performing other jobs meanwhile.
+     * Its completion function is not called yet when this returns.
+     */
+    void wait(const JobHandle& job);
+
+CC_CONSTRUCTOR_ACCESS:
+    JobSystem();
+    ~JobSystem();
+
+protected:
+    static const int PRIORITY_COUNT = 3;
+
+    struct JobQueue
+    {
+        std::mutex mutex;
+        std::deque<JobHandle> jobs[PRIORITY_COUNT];
+    };
+
+    void submit(const JobHandle& job);
+    JobHandle takeJob(int workerIndex, Priority lowestPriority);
+    void run(const JobHandle& job);
+    void finish(const JobHandle& job);
+    void workerLoop(int workerIndex);
+    int getCurrentWorkerIndex() const;
+
+    std::vector<std::thread> _workers;
+    std::vector<std::thread::id> _workerIds;
+    // one queue per worker, and a last one for the jobs submitted from other threads
+    std::vector<std::unique_ptr<JobQueue>> _queues;
+    std::atomic<int> _queuedJobCount;
+
+    std::mutex _sleepMutex;
+    std::condition_variable _sleepCondition;
+    std::condition_variable _finishCondition;
+    int _waiterCount;
+    bool _stop;
+
+    static JobSystem* s_jobSystem;
+};
+
+NS_CC_END
+// end group
+/// @}
+#endif // __CCJOB_SYSTEM_H__
@@ -30,9 +30,12 @@ THE SOFTWARE.
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
 #include "base/utlist.h"
-#include "base/ccCArray.h"
 #include "base/CCScriptSupport.h"
 
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
 NS_CC_BEGIN
 
 // data structures
@@ -60,10 +63,9 @@ typedef struct _hashUpdateEntry
 // Hash Element used for "selectors with interval"
 typedef struct _hashSelectorEntry
 {
-    ccArray             *timers;
+    std::vector<Timer*> timers;     // retained, in scheduling order
+    std::unordered_map<std::string, TimerTargetCallback*> callbackTimers; // callback timers by key
     void                *target;
-    int                 timerIndex;
-    Timer               *currentTimer;
     bool                paused;
     UT_hash_handle      hh;
 } tHashTimerEntry;
@@ -80,6 +82,15 @@ Timer::Timer()
 , _delay(0.0f)
 , _interval(0.0f)
 , _aborted(false)
+, _dueTime(0.0)
+, _lastTime(0.0)
+, _sequence(0)
+, _prevTimer(nullptr)
+, _nextTimer(nullptr)
+, _timerList(nullptr)
+, _isStarted(false)
+, _isPaused(false)
+, _isDue(false)
 {
 }
 
@@ -257,15 +268,18 @@ Scheduler::Scheduler(void)
 , _updatesPosList(nullptr)
 , _hashForUpdates(nullptr)
 , _hashForTimers(nullptr)
-, _currentTarget(nullptr)
-, _currentTargetSalvaged(false)
+, _nearTimers(nullptr)
+, _startingTimers(nullptr)
+, _time(0.0)
+, _wheelTick(0)
+, _timerSequence(0)
 , _updateHashLocked(false)
 #if CC_ENABLE_SCRIPT_BINDING
 , _scriptHandlerEntries(20)
 #endif
+, _performFunctionTimeBudget(0.0f)
 {
-    // I don't expect to have more than 30 functions to all per frame
-    _functionsToPerform.reserve(30);
+    memset(_timerWheel, 0, sizeof(_timerWheel));
 }
 
 Scheduler::~Scheduler(void)
@@ -275,27 +289,18 @@ Scheduler::~Scheduler(void)
 
 void Scheduler::removeHashElement(_hashSelectorEntry *element)
 {
-    ccArrayFree(element->timers);
     HASH_DEL(_hashForTimers, element);
-    free(element);
+    delete element;
 }
 
-void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, bool paused, const std::string& key)
+tHashTimerEntry* Scheduler::timerEntryForTarget(void *target, bool paused)
 {
-    this->schedule(callback, target, interval, CC_REPEAT_FOREVER, 0.0f, paused, key);
-}
-
-void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, unsigned int repeat, float delay, bool paused, const std::string& key)
-{
-    CCASSERT(target, "Argument target must be non-nullptr");
-    CCASSERT(!key.empty(), "key should not be empty!");
-
     tHashTimerEntry *element = nullptr;
     HASH_FIND_PTR(_hashForTimers, &target, element);
 
     if (! element)
     {
-        element = (tHashTimerEntry *)calloc(sizeof(*element), 1);
+        element = new (std::nothrow) tHashTimerEntry();
         element->target = target;
 
         HASH_ADD_PTR(_hashForTimers, target, element);
@@ -308,30 +313,351 @@ void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float in
         CCASSERT(element->paused == paused, "element's paused should be paused!");
     }
 
-    if (element->timers == nullptr)
+    return element;
+}
+
+void Scheduler::addTimer(tHashTimerEntry *element, Timer *timer)
+{
+    // the element takes over the reference of the new timer
+    element->timers.push_back(timer);
+    timer->_sequence = ++_timerSequence;
+
+    if (element->paused)
+    {
+        timer->_isPaused = true;
+    }
+    else
     {
-        element->timers = ccArrayNew(10);
+        linkTimer(&_startingTimers, timer);
     }
-    else 
+}
+
+void Scheduler::removeTimer(tHashTimerEntry *element, Timer *timer)
+{
+    // a timer being triggered is retained by _dueTimers, it is skipped once aborted
+    timer->setAborted();
+    unlinkTimer(timer);
+
+    auto callbackTimer = dynamic_cast<TimerTargetCallback*>(timer);
+    if (callbackTimer)
     {
-        for (int i = 0; i < element->timers->num; ++i)
+        auto iter = element->callbackTimers.find(callbackTimer->getKey());
+        if (iter != element->callbackTimers.end() && iter->second == callbackTimer)
         {
-            TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(element->timers->arr[i]);
+            element->callbackTimers.erase(iter);
+        }
+    }
+
+    element->timers.erase(std::find(element->timers.begin(), element->timers.end(), timer));
+    timer->release();
 
-            if (timer && !timer->isExhausted() && key == timer->getKey())
+    if (element->timers.empty())
+    {
+        removeHashElement(element);
+    }
+}
+
+void Scheduler::restartTimer(Timer *timer)
+{
+    // counts from the next update again, as a newly scheduled timer
+    unlinkTimer(timer);
+    timer->_isStarted = false;
+
+    if (! timer->_isPaused)
+    {
+        linkTimer(&_startingTimers, timer);
+    }
+}
+
+void Scheduler::pauseTimers(tHashTimerEntry *element)
+{
+    for (auto timer : element->timers)
+    {
+        if (timer->_isPaused)
+        {
+            continue;
+        }
+
+        timer->_isPaused = true;
+        unlinkTimer(timer);
+
+        if (timer->_isStarted)
+        {
+            timer->_dueTime -= _time;
+            timer->_lastTime -= _time;
+        }
+    }
+}
+
+void Scheduler::resumeTimers(tHashTimerEntry *element)
+{
+    for (auto timer : element->timers)
+    {
+        if (! timer->_isPaused)
+        {
+            continue;
+        }
+
+        timer->_isPaused = false;
+
+        if (! timer->_isStarted)
+        {
+            linkTimer(&_startingTimers, timer);
+        }
+        else
+        {
+            timer->_dueTime += _time;
+            timer->_lastTime += _time;
+
+            // a timer still waiting in _dueTimers is triggered by the current update
+            if (! timer->_isDue)
             {
-                CCLOG("CCScheduler#schedule. Reiniting timer with interval %.4f, repeat %u, delay %.4f", interval, repeat, delay);
-                timer->setupTimerWithInterval(interval, repeat, delay);
-                return;
+                insertTimer(timer);
+            }
+        }
+    }
+}
+
+void Scheduler::linkTimer(Timer **list, Timer *timer)
+{
+    CCASSERT(timer->_timerList == nullptr, "The timer is already linked in a list");
+
+    timer->_prevTimer = nullptr;
+    timer->_nextTimer = *list;
+    if (*list)
+    {
+        (*list)->_prevTimer = timer;
+    }
+    *list = timer;
+    timer->_timerList = list;
+}
+
+void Scheduler::unlinkTimer(Timer *timer)
+{
+    if (timer->_timerList == nullptr)
+    {
+        return;
+    }
+
+    if (timer->_prevTimer)
+    {
+        timer->_prevTimer->_nextTimer = timer->_nextTimer;
+    }
+    else
+    {
+        *timer->_timerList = timer->_nextTimer;
+    }
+    if (timer->_nextTimer)
+    {
+        timer->_nextTimer->_prevTimer = timer->_prevTimer;
+    }
+
+    timer->_prevTimer = nullptr;
+    timer->_nextTimer = nullptr;
+    timer->_timerList = nullptr;
+}
+
+void Scheduler::insertTimer(Timer *timer)
+{
+    long long dueTick = (long long)std::floor(timer->_dueTime * TIMER_WHEEL_TICKS_PER_SECOND);
+    const long long delta = dueTick - _wheelTick;
+
+    if (delta < 0)
+    {
+        linkTimer(&_nearTimers, timer);
+        return;
+    }
+
+    int level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1 && delta >= (1LL << (TIMER_WHEEL_BITS * (level + 1))))
+    {
+        ++level;
+    }
+
+    // out of the range of the wheel: park it on the farthest slot, it is checked
+    // against its real due time once it cascades down to the near timers
+    const long long range = 1LL << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS);
+    if (delta >= range)
+    {
+        dueTick = _wheelTick + range - 1;
+    }
+
+    const int index = (int)((dueTick >> (TIMER_WHEEL_BITS * level)) & (TIMER_WHEEL_SLOTS - 1));
+    linkTimer(&_timerWheel[level][index], timer);
+}
+
+void Scheduler::cascadeTimers(int level, int index)
+{
+    Timer *timer = _timerWheel[level][index];
+    _timerWheel[level][index] = nullptr;
+
+    while (timer)
+    {
+        Timer *next = timer->_nextTimer;
+        timer->_prevTimer = nullptr;
+        timer->_nextTimer = nullptr;
+        timer->_timerList = nullptr;
+        insertTimer(timer);
+        timer = next;
+    }
+}
+
+void Scheduler::advanceTimers()
+{
+    // move the slots of the ticks passed since the last update to the near timers
+    const long long tick = (long long)std::floor(_time * TIMER_WHEEL_TICKS_PER_SECOND);
+    while (_wheelTick <= tick)
+    {
+        const int index = (int)(_wheelTick & (TIMER_WHEEL_SLOTS - 1));
+        if (index == 0)
+        {
+            for (int level = 1; level < TIMER_WHEEL_LEVELS; ++level)
+            {
+                const int levelIndex = (int)((_wheelTick >> (TIMER_WHEEL_BITS * level)) & (TIMER_WHEEL_SLOTS - 1));
+                cascadeTimers(level, levelIndex);
+                if (levelIndex != 0)
+                {
+                    break;
+                }
             }
         }
-        ccArrayEnsureExtraCapacity(element->timers, 1);
+
+        while (Timer *timer = _timerWheel[0][index])
+        {
+            unlinkTimer(timer);
+            linkTimer(&_nearTimers, timer);
+        }
+
+        ++_wheelTick;
+    }
+
+    for (Timer *timer = _nearTimers; timer != nullptr; )
+    {
+        Timer *next = timer->_nextTimer;
+
+        if (timer->_dueTime <= _time)
+        {
+            unlinkTimer(timer);
+            timer->_isDue = true;
+            timer->retain();
+            _dueTimers.push_back(timer);
+        }
+        else if ((long long)std::floor(timer->_dueTime * TIMER_WHEEL_TICKS_PER_SECOND) >= _wheelTick)
+        {
+            // parked out of the range of the wheel
+            unlinkTimer(timer);
+            insertTimer(timer);
+        }
+
+        timer = next;
+    }
+
+    std::sort(_dueTimers.begin(), _dueTimers.end(), [](const Timer *a, const Timer *b) {
+        return a->_dueTime < b->_dueTime || (a->_dueTime == b->_dueTime && a->_sequence < b->_sequence);
+    });
+
+    // timers scheduled since the last update start counting from now
+    while (Timer *timer = _startingTimers)
+    {
+        unlinkTimer(timer);
+        timer->_isStarted = true;
+        timer->_lastTime = _time;
+        timer->_dueTime = _time + (timer->_useDelay ? timer->_delay : std::max(timer->_interval, 0.0f));
+        insertTimer(timer);
+    }
+}
+
+void Scheduler::fireTimer(Timer *timer)
+{
+    // the callback may unschedule, pause or reschedule the timer, which stops the loop
+    while (! timer->isAborted() && ! timer->_isPaused && timer->_timerList == nullptr && timer->_dueTime <= _time)
+    {
+        float dt;
+        if (timer->_useDelay)
+        {
+            dt = timer->_delay;
+            timer->_useDelay = false;
+        }
+        else if (timer->_interval > 0)
+        {
+            dt = timer->_interval;
+        }
+        else
+        {
+            // if _interval == 0, should trigger once every frame
+            dt = (float)(_time - timer->_lastTime);
+        }
+
+        const double dueTime = timer->_dueTime;
+        timer->_lastTime = _time;
+        timer->_timesExecuted += 1; // important to increment before call trigger
+        timer->trigger(dt);
+
+        if (timer->isAborted() || timer->_isPaused || timer->_timerList != nullptr)
+        {
+            break;
+        }
+
+        if (timer->isExhausted())
+        {
+            timer->cancel();
+            break;
+        }
+
+        timer->_dueTime = dueTime + std::max(timer->_interval, 0.0f);
+        if (timer->_interval <= 0)
+        {
+            break;
+        }
+    }
+
+    timer->_isDue = false;
+
+    if (! timer->isAborted() && ! timer->_isPaused && timer->_timerList == nullptr)
+    {
+        insertTimer(timer);
+    }
+}
+
+void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, bool paused, const std::string& key)
+{
+    this->schedule(callback, target, interval, CC_REPEAT_FOREVER, 0.0f, paused, key);
+}
+
+void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, unsigned int repeat, float delay, bool paused, const std::string& key)
+{
+    CCASSERT(target, "Argument target must be non-nullptr");
+    CCASSERT(!key.empty(), "key should not be empty!");
+
+    tHashTimerEntry *element = timerEntryForTarget(target, paused);
+
+    TimerTargetCallback *replacedTimer = nullptr;
+    auto iter = element->callbackTimers.find(key);
+    if (iter != element->callbackTimers.end())
+    {
+        TimerTargetCallback *timer = iter->second;
+        if (!timer->isExhausted())
+        {
+            CCLOG("CCScheduler#schedule. Reiniting timer with interval %.4f, repeat %u, delay %.4f", interval, repeat, delay);
+            timer->setupTimerWithInterval(interval, repeat, delay);
+            restartTimer(timer);
+            return;
+        }
+
+        // scheduled again from the last trigger of the timer
+        replacedTimer = timer;
     }
 
     TimerTargetCallback *timer = new (std::nothrow) TimerTargetCallback();
     timer->initWithCallback(this, callback, target, key, interval, repeat, delay);
-    ccArrayAppendObject(element->timers, timer);
-    timer->release();
+    element->callbackTimers[key] = timer;
+    addTimer(element, timer);
+
+    if (replacedTimer)
+    {
+        // removed here, as it would not be told from the new timer when cancelled
+        removeTimer(element, replacedTimer);
+    }
 }
 
 void Scheduler::unschedule(const std::string &key, void *target)
@@ -350,40 +676,10 @@ void Scheduler::unschedule(const std::string &key, void *target)
 
     if (element)
     {
-        for (int i = 0; i < element->timers->num; ++i)
+        auto iter = element->callbackTimers.find(key);
+        if (iter != element->callbackTimers.end())
         {
-            TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(element->timers->arr[i]);
-
-            if (timer && key == timer->getKey())
-            {
-                if (timer == element->currentTimer && (! timer->isAborted()))
-                {
-                    timer->retain();
-                    timer->setAborted();
-                }
-
-                ccArrayRemoveObjectAtIndex(element->timers, i, true);
-
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
-                {
-                    element->timerIndex--;
-                }
-
-                if (element->timers->num == 0)
-                {
-                    if (_currentTarget == element)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        removeHashElement(element);
-                    }
-                }
-
-                return;
-            }
+            removeTimer(element, iter->second);
         }
     }
 }
@@ -516,22 +812,8 @@ bool Scheduler::isScheduled(const std::string& key, const void *target) const
         return false;
     }
     
-    if (element->timers == nullptr)
-    {
-        return false;
-    }
-    
-    for (int i = 0; i < element->timers->num; ++i)
-    {
-        TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(element->timers->arr[i]);
-        
-        if (timer && !timer->isExhausted() && key == timer->getKey())
-        {
-            return true;
-        }
-    }
-    
-    return false;
+    auto iter = element->callbackTimers.find(key);
+    return iter != element->callbackTimers.end() && !iter->second->isExhausted();
 }
 
 void Scheduler::removeUpdateFromHash(struct _listEntry *entry)
@@ -636,22 +918,15 @@ void Scheduler::unscheduleAllForTarget(void *target)
 
     if (element)
     {
-        if (ccArrayContainsObject(element->timers, element->currentTimer)
-            && (! element->currentTimer->isAborted()))
+        for (auto timer : element->timers)
         {
-            element->currentTimer->retain();
-            element->currentTimer->setAborted();
+            // timers being triggered are retained by _dueTimers, they are skipped once aborted
+            timer->setAborted();
+            unlinkTimer(timer);
+            timer->release();
         }
-        ccArrayRemoveAllObjects(element->timers);
 
-        if (_currentTarget == element)
-        {
-            _currentTargetSalvaged = true;
-        }
-        else
-        {
-            removeHashElement(element);
-        }
+        removeHashElement(element);
     }
 
     // update selector
@@ -688,9 +963,10 @@ void Scheduler::resumeTarget(void *target)
     // custom selectors
     tHashTimerEntry *element = nullptr;
     HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element)
+    if (element && element->paused)
     {
         element->paused = false;
+        resumeTimers(element);
     }
 
     // update selector
@@ -710,9 +986,10 @@ void Scheduler::pauseTarget(void *target)
     // custom selectors
     tHashTimerEntry *element = nullptr;
     HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element)
+    if (element && !element->paused)
     {
         element->paused = true;
+        pauseTimers(element);
     }
 
     // update selector
@@ -761,7 +1038,11 @@ std::set<void*> Scheduler::pauseAllTargetsWithMinPriority(int minPriority)
     for(tHashTimerEntry *element = _hashForTimers; element != nullptr;
         element = (tHashTimerEntry*)element->hh.next)
     {
-        element->paused = true;
+        if (!element->paused)
+        {
+            element->paused = true;
+            pauseTimers(element);
+        }
         idsWithSelectors.insert(element->target);
     }
 
@@ -809,13 +1090,11 @@ void Scheduler::resumeTargets(const std::set<void*>& targetsToResume)
 
 void Scheduler::performFunctionInCocosThread(std::function<void ()> function)
 {
-    std::lock_guard<std::mutex> lock(_performMutex);
-    _functionsToPerform.push_back(std::move(function));
+    _functionsToPerform.push(std::move(function));
 }
 
 void Scheduler::removeAllFunctionsToBePerformedInCocosThread()
 {
-    std::unique_lock<std::mutex> lock(_performMutex);
     _functionsToPerform.clear();
 }
 
@@ -863,46 +1142,17 @@ void Scheduler::update(float dt)
         }
     }
 
-    // Iterate over all the custom selectors
-    for (tHashTimerEntry *elt = _hashForTimers; elt != nullptr; )
-    {
-        _currentTarget = elt;
-        _currentTargetSalvaged = false;
+    // Trigger the custom selectors that are due
+    _time += dt;
+    advanceTimers();
 
-        if (! _currentTarget->paused)
-        {
-            // The 'timers' array may change while inside this loop
-            for (elt->timerIndex = 0; elt->timerIndex < elt->timers->num; ++(elt->timerIndex))
-            {
-                elt->currentTimer = (Timer*)(elt->timers->arr[elt->timerIndex]);
-                CCASSERT
-                  ( !elt->currentTimer->isAborted(),
-                    "An aborted timer should not be updated" );
-
-                elt->currentTimer->update(dt);
-
-                if (elt->currentTimer->isAborted())
-                {
-                    // The currentTimer told the remove itself. To prevent the timer from
-                    // accidentally deallocating itself before finishing its step, we retained
-                    // it. Now that step is done, it's safe to release it.
-                    elt->currentTimer->release();
-                }
-
-                elt->currentTimer = nullptr;
-            }
-        }
-
-        // elt, at this moment, is still valid
-        // so it is safe to ask this here (issue #490)
-        elt = (tHashTimerEntry *)elt->hh.next;
-
-        // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
-        if (_currentTargetSalvaged && _currentTarget->timers->num == 0)
-        {
-            removeHashElement(_currentTarget);
-        }
+    for (auto timer : _dueTimers)
+    {
+        // The timers are retained while triggered, a callback may unschedule any of them
+        fireTimer(timer);
+        timer->release();
     }
+    _dueTimers.clear();
  
     // delete all updates that are removed in update
     for (auto &e : _updateDeleteVector)
@@ -911,7 +1161,6 @@ void Scheduler::update(float dt)
     _updateDeleteVector.clear();
 
     _updateHashLocked = false;
-    _currentTarget = nullptr;
 
 #if CC_ENABLE_SCRIPT_BINDING
     //
@@ -939,66 +1188,33 @@ void Scheduler::update(float dt)
     // Functions allocated from another thread
     //
 
-    // Testing size is faster than locking / unlocking.
-    // And almost never there will be functions scheduled to be called.
-    if( !_functionsToPerform.empty() ) {
-        _performMutex.lock();
-        // fixed #4123: Save the callback functions, they must be invoked after '_performMutex.unlock()', otherwise if new functions are added in callback, it will cause thread deadlock.
-        auto temp = std::move(_functionsToPerform);
-        _performMutex.unlock();
-        
-        for (const auto &function : temp) {
-            function();
-        }
-    }
+    // Functions added while performing them are performed in the next frame, as are the ones
+    // left once the time budget is spent.
+    _functionsToPerform.perform(_performFunctionTimeBudget);
 }
 
 void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, unsigned int repeat, float delay, bool paused)
 {
     CCASSERT(target, "Argument target must be non-nullptr");
     
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
+    tHashTimerEntry *element = timerEntryForTarget(target, paused);
     
-    if (! element)
+    for (auto t : element->timers)
     {
-        element = (tHashTimerEntry *)calloc(sizeof(*element), 1);
-        element->target = target;
-        
-        HASH_ADD_PTR(_hashForTimers, target, element);
+        TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(t);
         
-        // Is this the 1st element ? Then set the pause level to all the selectors of this target
-        element->paused = paused;
-    }
-    else
-    {
-        CCASSERT(element->paused == paused, "element's paused should be paused.");
-    }
-    
-    if (element->timers == nullptr)
-    {
-        element->timers = ccArrayNew(10);
-    }
-    else
-    {
-        for (int i = 0; i < element->timers->num; ++i)
+        if (timer && !timer->isExhausted() && selector == timer->getSelector())
         {
-            TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(element->timers->arr[i]);
-            
-            if (timer && !timer->isExhausted() && selector == timer->getSelector())
-            {
-                CCLOG("CCScheduler#schedule. Reiniting timer with interval %.4f, repeat %u, delay %.4f", interval, repeat, delay);
-                timer->setupTimerWithInterval(interval, repeat, delay);
-                return;
-            }
+            CCLOG("CCScheduler#schedule. Reiniting timer with interval %.4f, repeat %u, delay %.4f", interval, repeat, delay);
+            timer->setupTimerWithInterval(interval, repeat, delay);
+            restartTimer(timer);
+            return;
         }
-        ccArrayEnsureExtraCapacity(element->timers, 1);
     }
     
     TimerTargetSelector *timer = new (std::nothrow) TimerTargetSelector();
     timer->initWithSelector(this, selector, target, interval, repeat, delay);
-    ccArrayAppendObject(element->timers, timer);
-    timer->release();
+    addTimer(element, timer);
 }
 
 void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, bool paused)
@@ -1019,14 +1235,9 @@ bool Scheduler::isScheduled(SEL_SCHEDULE selector, const Ref *target) const
         return false;
     }
     
-    if (element->timers == nullptr)
-    {
-        return false;
-    }
-
-    for (int i = 0; i < element->timers->num; ++i)
+    for (auto t : element->timers)
     {
-        TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(element->timers->arr[i]);
+        TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(t);
         
         if (timer && !timer->isExhausted() && selector == timer->getSelector())
         {
@@ -1050,38 +1261,13 @@ void Scheduler::unschedule(SEL_SCHEDULE selector, Ref *target)
     
     if (element)
     {
-        for (int i = 0; i < element->timers->num; ++i)
+        for (auto t : element->timers)
         {
-            TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(element->timers->arr[i]);
+            TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(t);
             
             if (timer && selector == timer->getSelector())
             {
-                if (timer == element->currentTimer && !timer->isAborted())
-                {
-                    timer->retain();
-                    timer->setAborted();
-                }
-                
-                ccArrayRemoveObjectAtIndex(element->timers, i, true);
-                
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
-                {
-                    element->timerIndex--;
-                }
-                
-                if (element->timers->num == 0)
-                {
-                    if (_currentTarget == element)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        removeHashElement(element);
-                    }
-                }
-                
+                removeTimer(element, timer);
                 return;
             }
         }
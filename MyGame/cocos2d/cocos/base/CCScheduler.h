@@ -35,6 +35,7 @@ THE SOFTWARE.
 
 #include "base/CCRef.h"
 #include "base/CCVector.h"
+#include "base/CCFunctionQueue.h"
 #include "base/uthash.h"
 
 NS_CC_BEGIN
@@ -72,6 +73,20 @@ protected:
     float _delay;
     float _interval;
     bool _aborted;
+
+    friend class Scheduler;
+
+    // State of the timer on the timing wheel of the Scheduler. While the target is
+    // paused _dueTime and _lastTime are kept relative to the time it was paused at.
+    double _dueTime;                // scheduler time of the next trigger
+    double _lastTime;               // scheduler time of the previous trigger, used when _interval is 0
+    unsigned long long _sequence;   // scheduling order, triggers due at the same time follow it
+    Timer* _prevTimer;
+    Timer* _nextTimer;
+    Timer** _timerList;             // list of the Scheduler the timer is linked in, nullptr if none
+    bool _isStarted;
+    bool _isPaused;
+    bool _isDue;
 };
 
 
@@ -428,6 +443,30 @@ public:
      @js NA
      */
     void performFunctionInCocosThread(std::function<void()> function);
+
+    /** Calls a function on the cocos2d thread, without allocating when the function object
+     is small enough (FunctionQueue::FUNCTION_STORAGE_SIZE bytes), such as most lambdas.
+     This function is thread safe and lock free.
+     @param function The function to be run in cocos2d thread.
+     @js NA
+     */
+    template <typename F>
+    void performFunctionInCocosThread(F&& function)
+    {
+        _functionsToPerform.push(std::forward<F>(function));
+    }
+
+    /** Sets the time in seconds the functions posted with performFunctionInCocosThread may take per frame.
+     The functions left once it is spent are performed in the next frames, at least one is performed per frame.
+     0, the default, means no limit.
+     @js NA
+     */
+    void setPerformFunctionTimeBudget(float seconds) { _performFunctionTimeBudget = seconds; }
+
+    /** Gets the time in seconds the functions posted with performFunctionInCocosThread may take per frame.
+     @js NA
+     */
+    float getPerformFunctionTimeBudget() const { return _performFunctionTimeBudget; }
     
     /**
      * Remove all pending functions queued to be performed with Scheduler::performFunctionInCocosThread
@@ -508,6 +547,21 @@ protected:
     void schedulePerFrame(const ccSchedulerFunc& callback, void *target, int priority, bool paused);
     
     void removeHashElement(struct _hashSelectorEntry *element);
+    struct _hashSelectorEntry* timerEntryForTarget(void *target, bool paused);
+    void addTimer(struct _hashSelectorEntry *element, Timer *timer);
+    void removeTimer(struct _hashSelectorEntry *element, Timer *timer);
+    void restartTimer(Timer *timer);
+    void pauseTimers(struct _hashSelectorEntry *element);
+    void resumeTimers(struct _hashSelectorEntry *element);
+
+    // timing wheel specific
+
+    void linkTimer(Timer **list, Timer *timer);
+    void unlinkTimer(Timer *timer);
+    void insertTimer(Timer *timer);
+    void cascadeTimers(int level, int index);
+    void advanceTimers();
+    void fireTimer(Timer *timer);
     void removeUpdateFromHash(struct _listEntry *entry);
 
     // update specific
@@ -529,8 +583,21 @@ protected:
 
     // Used for "selectors with interval"
     struct _hashSelectorEntry *_hashForTimers;
-    struct _hashSelectorEntry *_currentTarget;
-    bool _currentTargetSalvaged;
+
+    // The timers of the non paused targets are kept on a hierarchical timing wheel, so that
+    // a tick only touches the timers that are due. A slot of level n holds the timers due in
+    // a span of TIMER_WHEEL_SLOTS^n ticks, they are moved to the lower level when it comes up.
+    static const int TIMER_WHEEL_LEVELS = 4;
+    static const int TIMER_WHEEL_BITS = 6;
+    static const int TIMER_WHEEL_SLOTS = 1 << TIMER_WHEEL_BITS;
+    static const int TIMER_WHEEL_TICKS_PER_SECOND = 64;
+    Timer *_timerWheel[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    Timer *_nearTimers;         // due in a tick already passed, checked every update
+    Timer *_startingTimers;     // scheduled since the last update, they start counting at the next one
+    std::vector<Timer*> _dueTimers;
+    double _time;               // sum of the scaled delta times
+    long long _wheelTick;       // next tick of the wheel to process
+    unsigned long long _timerSequence;
     // If true unschedule will not remove anything from a hash. Elements will only be marked for deletion.
     bool _updateHashLocked;
     
@@ -539,8 +606,8 @@ protected:
 #endif
     
     // Used for "perform Function"
-    std::vector<std::function<void()>> _functionsToPerform;
-    std::mutex _performMutex;
+    FunctionQueue _functionsToPerform;
+    float _performFunctionTimeBudget;
 };
 
 // end of base group
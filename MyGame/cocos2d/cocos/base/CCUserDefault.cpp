@@ -29,6 +29,12 @@ THE SOFTWARE.
 #include "tinyxml2.h"
 #include "base/base64.h"
 #include "base/ccUtils.h"
+#include "base/ccConfig.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_IOS && CC_TARGET_PLATFORM != CC_PLATFORM_MAC && CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID)
 
@@ -41,119 +47,311 @@ using namespace std;
 
 NS_CC_BEGIN
 
+// milliseconds between a change and the write of the file, so that the changes made meanwhile are written at once
+static const int WRITE_DELAY_MS = 500;
+
+#if CC_USERDEFAULT_BINARY_FILE
+#define BINARY_FILE_NAME "UserDefault.bin"
+
+// magic, version, size of the xml file written with it, number of values, then the values
+static const char BINARY_FILE_MAGIC[4] = {'C', 'C', 'U', 'D'};
+static const uint32_t BINARY_FILE_VERSION = 1;
+#endif
+
 /**
- * define the functions here because we don't want to
- * export xmlNodePtr and other types in "CCUserDefault.h"
+ * The values of the xml file, loaded once and kept in memory.
+ * Changes are written by a background thread shortly after they are made, or right away by flush().
+ * Files are written to a temporary file first, then renamed over the previous one.
  */
+class UserDefaultStore
+{
+public:
+    UserDefaultStore();
+
+    bool getValue(const char* key, std::string* value);
+    void setValue(const char* key, const char* value);
+    void deleteValue(const char* key);
+    // writes the pending changes on this thread
+    void flush();
+    // stops the background thread, and writes the pending changes
+    void stop();
+
+private:
+    typedef std::unordered_map<std::string, std::string> Values;
+
+    void load();
+    bool loadXML(const std::string& path);
+    void writeXML(const Values& values, const std::string& path) const;
+#if CC_USERDEFAULT_BINARY_FILE
+    bool loadBinary(const std::string& path, const std::string& xmlPath);
+    void writeBinary(const Values& values, const std::string& path, const std::string& xmlPath) const;
+#endif
+    void changed();
+    void writerLoop();
+
+    // guards everything but the files
+    std::mutex _mutex;
+    // one write of the files at a time, taken before _mutex
+    std::mutex _fileMutex;
+    std::condition_variable _condition;
+    Values _values;
+    bool _isDirty;
+    bool _isStopping;
+    std::thread _writer;
+};
+
+UserDefaultStore::UserDefaultStore()
+: _isDirty(false)
+, _isStopping(false)
+{
+    load();
+}
+
+void UserDefaultStore::load()
+{
+    const std::string& xmlPath = UserDefault::getXMLFilePath();
+#if CC_USERDEFAULT_BINARY_FILE
+    const std::string binaryPath = FileUtils::getInstance()->getWritablePath() + BINARY_FILE_NAME;
+    if (loadBinary(binaryPath, xmlPath))
+        return;
+#endif
+    loadXML(xmlPath);
+}
 
-static tinyxml2::XMLElement* getXMLNodeForKey(const char* pKey, tinyxml2::XMLElement** rootNode, tinyxml2::XMLDocument **doc)
+bool UserDefaultStore::loadXML(const std::string& path)
 {
-    tinyxml2::XMLElement* curNode = nullptr;
+    std::string xmlBuffer = FileUtils::getInstance()->getStringFromFile(path);
+    if (xmlBuffer.empty())
+        return false;
 
-    // check the key value
-    if (! pKey)
+    tinyxml2::XMLDocument xmlDoc;
+    xmlDoc.Parse(xmlBuffer.c_str(), xmlBuffer.size());
+    tinyxml2::XMLElement* rootNode = xmlDoc.RootElement();
+    if (!rootNode)
+        return false;
+
+    // nodes without content have no value
+    for (auto node = rootNode->FirstChildElement(); node; node = node->NextSiblingElement())
     {
-        return nullptr;
+        if (node->FirstChild())
+            _values.emplace(node->Value(), node->FirstChild()->Value());
     }
+    return true;
+}
 
-    do 
+void UserDefaultStore::writeXML(const Values& values, const std::string& path) const
+{
+    tinyxml2::XMLDocument xmlDoc;
+    xmlDoc.LinkEndChild(xmlDoc.NewDeclaration(nullptr));
+    tinyxml2::XMLElement* rootNode = xmlDoc.NewElement(USERDEFAULT_ROOT_NAME);
+    xmlDoc.LinkEndChild(rootNode);
+    for (const auto& value : values)
     {
-        tinyxml2::XMLDocument* xmlDoc = new (std::nothrow) tinyxml2::XMLDocument();
-        *doc = xmlDoc;
-        *rootNode = nullptr;
+        tinyxml2::XMLElement* node = xmlDoc.NewElement(value.first.c_str());
+        node->LinkEndChild(xmlDoc.NewText(value.second.c_str()));
+        rootNode->LinkEndChild(node);
+    }
 
-        std::string xmlBuffer = FileUtils::getInstance()->getStringFromFile(UserDefault::getInstance()->getXMLFilePath());
+    auto fileUtils = FileUtils::getInstance();
+    const std::string tmpPath = path + ".tmp";
+    if (tinyxml2::XML_SUCCESS != xmlDoc.SaveFile(fileUtils->getSuitableFOpen(tmpPath).c_str()) || !fileUtils->renameFile(tmpPath, path))
+    {
+        CCLOG("UserDefault: can't write %s", path.c_str());
+    }
+}
 
-        if (!xmlBuffer.empty())
-        {
-            xmlDoc->Parse(xmlBuffer.c_str(), xmlBuffer.size());
+#if CC_USERDEFAULT_BINARY_FILE
+static bool readBinaryUInt32(const unsigned char*& cursor, const unsigned char* end, uint32_t* value)
+{
+    if (end - cursor < (ptrdiff_t) sizeof(uint32_t))
+        return false;
+    memcpy(value, cursor, sizeof(uint32_t));
+    cursor += sizeof(uint32_t);
+    return true;
+}
 
-            // get root node
-            *rootNode = xmlDoc->RootElement();
-        }
+static bool readBinaryString(const unsigned char*& cursor, const unsigned char* end, std::string* value)
+{
+    uint32_t size = 0;
+    if (!readBinaryUInt32(cursor, end, &size) || end - cursor < (ptrdiff_t) size)
+        return false;
+    value->assign((const char*) cursor, size);
+    cursor += size;
+    return true;
+}
 
-        if (nullptr == *rootNode)
-        {
-            // try to insert xml declaration
-            if (!xmlDoc->FirstChild())
-            {
-                tinyxml2::XMLDeclaration *xmlDeclaration = xmlDoc->NewDeclaration(nullptr);
-                if (nullptr != xmlDeclaration)
-                {
-                    xmlDoc->LinkEndChild(xmlDeclaration);
-                }
-            }
-
-            // create root element
-            tinyxml2::XMLElement *rootEle = xmlDoc->NewElement(USERDEFAULT_ROOT_NAME);
-            if (nullptr == rootEle)
-                break;
-
-            xmlDoc->LinkEndChild(rootEle);
-            *rootNode = rootEle;
-        }
+static void appendBinaryUInt32(std::string& buffer, uint32_t value)
+{
+    buffer.append((const char*) &value, sizeof(value));
+}
 
-        // find the node
-        curNode = (*rootNode)->FirstChildElement();
-        while (nullptr != curNode)
-        {
-            const char* nodeName = curNode->Value();
-            if (!strcmp(nodeName, pKey))
-            {
-                break;
-            }
+bool UserDefaultStore::loadBinary(const std::string& path, const std::string& xmlPath)
+{
+    auto fileUtils = FileUtils::getInstance();
+    if (!fileUtils->isFileExist(path))
+        return false;
 
-            curNode = curNode->NextSiblingElement();
-        }
-    } while (0);
+    Data data = fileUtils->getDataFromFile(path);
+    const unsigned char* cursor = data.getBytes();
+    const unsigned char* end = cursor + data.getSize();
+    if (data.getSize() < (ssize_t) sizeof(BINARY_FILE_MAGIC) || memcmp(cursor, BINARY_FILE_MAGIC, sizeof(BINARY_FILE_MAGIC)) != 0)
+        return false;
+    cursor += sizeof(BINARY_FILE_MAGIC);
+
+    // the xml file is the reference, it may have been written without the binary one
+    uint32_t version = 0;
+    uint32_t xmlSize = 0;
+    uint32_t count = 0;
+    if (!readBinaryUInt32(cursor, end, &version) || version != BINARY_FILE_VERSION
+        || !readBinaryUInt32(cursor, end, &xmlSize) || (long) xmlSize != fileUtils->getFileSize(xmlPath)
+        || !readBinaryUInt32(cursor, end, &count))
+        return false;
 
-    return curNode;
+    Values values;
+    values.reserve(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        std::string key;
+        std::string value;
+        if (!readBinaryString(cursor, end, &key) || !readBinaryString(cursor, end, &value))
+            return false;
+        values.emplace(std::move(key), std::move(value));
+    }
+
+    _values.swap(values);
+    return true;
 }
 
-static void setValueForKey(const char* pKey, const char* pValue)
+void UserDefaultStore::writeBinary(const Values& values, const std::string& path, const std::string& xmlPath) const
 {
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    // check the params
-    if (! pKey || ! pValue)
+    auto fileUtils = FileUtils::getInstance();
+    std::string buffer(BINARY_FILE_MAGIC, sizeof(BINARY_FILE_MAGIC));
+    appendBinaryUInt32(buffer, BINARY_FILE_VERSION);
+    appendBinaryUInt32(buffer, (uint32_t) fileUtils->getFileSize(xmlPath));
+    appendBinaryUInt32(buffer, (uint32_t) values.size());
+    for (const auto& value : values)
     {
-        return;
+        appendBinaryUInt32(buffer, (uint32_t) value.first.size());
+        buffer += value.first;
+        appendBinaryUInt32(buffer, (uint32_t) value.second.size());
+        buffer += value.second;
     }
-    // find the node
-    node = getXMLNodeForKey(pKey, &rootNode, &doc);
-    // if node exist, change the content
-    if (node)
+
+    const std::string tmpPath = path + ".tmp";
+    if (!fileUtils->writeStringToFile(buffer, tmpPath) || !fileUtils->renameFile(tmpPath, path))
     {
-        if (node->FirstChild())
-        {
-            node->FirstChild()->SetValue(pValue);
-        }
-        else
-        {
-            tinyxml2::XMLText* content = doc->NewText(pValue);
-            node->LinkEndChild(content);
-        }
+        CCLOG("UserDefault: can't write %s", path.c_str());
     }
+}
+#endif
+
+bool UserDefaultStore::getValue(const char* key, std::string* value)
+{
+    if (!key)
+        return false;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _values.find(key);
+    if (it == _values.end())
+        return false;
+
+    *value = it->second;
+    return true;
+}
+
+void UserDefaultStore::setValue(const char* key, const char* value)
+{
+    if (!key || !value)
+        return;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _values.find(key);
+    if (it == _values.end())
+        _values.emplace(key, value);
+    else if (it->second != value)
+        it->second = value;
     else
+        return;
+
+    changed();
+}
+
+void UserDefaultStore::deleteValue(const char* key)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_values.erase(key) > 0)
+        changed();
+}
+
+void UserDefaultStore::changed()
+{
+    // _mutex is locked
+    _isDirty = true;
+    if (!_writer.joinable() && !_isStopping)
+        _writer = std::thread(&UserDefaultStore::writerLoop, this);
+    _condition.notify_one();
+}
+
+void UserDefaultStore::flush()
+{
+    std::lock_guard<std::mutex> fileLock(_fileMutex);
+    Values values;
     {
-        if (rootNode)
-        {
-            tinyxml2::XMLElement* tmpNode = doc->NewElement(pKey);//new tinyxml2::XMLElement(pKey);
-            rootNode->LinkEndChild(tmpNode);
-            tinyxml2::XMLText* content = doc->NewText(pValue);//new tinyxml2::XMLText(pValue);
-            tmpNode->LinkEndChild(content);
-        }    
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_isDirty)
+            return;
+        values = _values;
+        _isDirty = false;
+    }
+
+    const std::string& xmlPath = UserDefault::getXMLFilePath();
+    writeXML(values, xmlPath);
+#if CC_USERDEFAULT_BINARY_FILE
+    writeBinary(values, FileUtils::getInstance()->getWritablePath() + BINARY_FILE_NAME, xmlPath);
+#endif
+}
+
+void UserDefaultStore::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isStopping = true;
     }
+    _condition.notify_one();
+    if (_writer.joinable())
+        _writer.join();
 
-    // save file and free doc
-    if (doc)
+    flush();
+}
+
+void UserDefaultStore::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_isStopping)
     {
-        doc->SaveFile(FileUtils::getInstance()->getSuitableFOpen(UserDefault::getInstance()->getXMLFilePath()).c_str());
-        delete doc;
+        _condition.wait(lock, [this]() { return _isDirty || _isStopping; });
+
+        // let the changes made meanwhile join this write
+        if (_condition.wait_for(lock, std::chrono::milliseconds(WRITE_DELAY_MS), [this]() { return _isStopping; }))
+            break;
+
+        lock.unlock();
+        flush();
+        lock.lock();
     }
 }
 
+static UserDefaultStore* s_store = nullptr;
+
+// created on first use, UserDefault::destroyInstance() stops it, which joins the writer thread and
+// writes the pending values, then deletes it
+static UserDefaultStore* getStore()
+{
+    if (!s_store)
+        s_store = new (std::nothrow) UserDefaultStore();
+    return s_store;
+}
+
 /**
  * implements of UserDefault
  */
@@ -177,27 +375,13 @@ bool UserDefault::getBoolForKey(const char* pKey)
 
 bool UserDefault::getBoolForKey(const char* pKey, bool defaultValue)
 {
-    const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
+    std::string value;
+    if (getStore()->getValue(pKey, &value))
     {
-        value = (const char*)(node->FirstChild()->Value());
+        return value == "true";
     }
 
-    bool ret = defaultValue;
-
-    if (value)
-    {
-        ret = (! strcmp(value, "true"));
-    }
-
-    if (doc) delete doc;
-
-    return ret;
+    return defaultValue;
 }
 
 int UserDefault::getIntegerForKey(const char* pKey)
@@ -207,31 +391,13 @@ int UserDefault::getIntegerForKey(const char* pKey)
 
 int UserDefault::getIntegerForKey(const char* pKey, int defaultValue)
 {
-    const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        value = (const char*)(node->FirstChild()->Value());
-    }
-
-    int ret = defaultValue;
-
-    if (value)
-    {
-        ret = atoi(value);
-    }
-
-    if(doc)
+    std::string value;
+    if (getStore()->getValue(pKey, &value))
     {
-        delete doc;
+        return atoi(value.c_str());
     }
 
-
-    return ret;
+    return defaultValue;
 }
 
 float UserDefault::getFloatForKey(const char* pKey)
@@ -253,27 +419,13 @@ double  UserDefault::getDoubleForKey(const char* pKey)
 
 double UserDefault::getDoubleForKey(const char* pKey, double defaultValue)
 {
-    const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        value = (const char*)(node->FirstChild()->Value());
-    }
-
-    double ret = defaultValue;
-
-    if (value)
+    std::string value;
+    if (getStore()->getValue(pKey, &value))
     {
-        ret = utils::atof(value);
+        return utils::atof(value.c_str());
     }
 
-    if (doc) delete doc;
-
-    return ret;
+    return defaultValue;
 }
 
 std::string UserDefault::getStringForKey(const char* pKey)
@@ -283,27 +435,13 @@ std::string UserDefault::getStringForKey(const char* pKey)
 
 string UserDefault::getStringForKey(const char* pKey, const std::string & defaultValue)
 {
-    const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        value = (const char*)(node->FirstChild()->Value());
-    }
-
-    string ret = defaultValue;
-
-    if (value)
+    std::string value;
+    if (getStore()->getValue(pKey, &value))
     {
-        ret = string(value);
+        return value;
     }
 
-    if (doc) delete doc;
-
-    return ret;
+    return defaultValue;
 }
 
 Data UserDefault::getDataForKey(const char* pKey)
@@ -313,32 +451,20 @@ Data UserDefault::getDataForKey(const char* pKey)
 
 Data UserDefault::getDataForKey(const char* pKey, const Data& defaultValue)
 {
-    const char* encodedData = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        encodedData = (const char*)(node->FirstChild()->Value());
-    }
-    
+    std::string encodedData;
     Data ret = defaultValue;
-    
-    if (encodedData)
+
+    if (getStore()->getValue(pKey, &encodedData))
     {
         unsigned char * decodedData = nullptr;
-        int decodedDataLen = base64Decode((unsigned char*)encodedData, (unsigned int)strlen(encodedData), &decodedData);
-        
+        int decodedDataLen = base64Decode((unsigned char*)encodedData.c_str(), (unsigned int)encodedData.size(), &decodedData);
+
         if (decodedData) {
             ret.fastSet(decodedData, decodedDataLen);
         }
     }
-    
-    if (doc) delete doc;
-    
-    return ret;    
+
+    return ret;
 }
 
 
@@ -369,7 +495,7 @@ void UserDefault::setIntegerForKey(const char* pKey, int value)
     memset(tmp, 0, 50);
     sprintf(tmp, "%d", value);
 
-    setValueForKey(pKey, tmp);
+    getStore()->setValue(pKey, tmp);
 }
 
 void UserDefault::setFloatForKey(const char* pKey, float value)
@@ -390,7 +516,7 @@ void UserDefault::setDoubleForKey(const char* pKey, double value)
     memset(tmp, 0, 50);
     sprintf(tmp, "%f", value);
 
-    setValueForKey(pKey, tmp);
+    getStore()->setValue(pKey, tmp);
 }
 
 void UserDefault::setStringForKey(const char* pKey, const std::string & value)
@@ -401,7 +527,7 @@ void UserDefault::setStringForKey(const char* pKey, const std::string & value)
         return;
     }
 
-    setValueForKey(pKey, value.c_str());
+    getStore()->setValue(pKey, value.c_str());
 }
 
 void UserDefault::setDataForKey(const char* pKey, const Data& value) {
@@ -415,7 +541,7 @@ void UserDefault::setDataForKey(const char* pKey, const Data& value) {
     
     base64Encode(value.getBytes(), static_cast<unsigned int>(value.getSize()), &encodedData);
         
-    setValueForKey(pKey, encodedData);
+    getStore()->setValue(pKey, encodedData);
     
     if (encodedData)
         free(encodedData);
@@ -442,6 +568,11 @@ UserDefault* UserDefault::getInstance()
 
 void UserDefault::destroyInstance()
 {
+    if (s_store)
+    {
+        s_store->stop();
+        CC_SAFE_DELETE(s_store);
+    }
     CC_SAFE_DELETE(_userDefault);
 }
 
@@ -517,14 +648,11 @@ const string& UserDefault::getXMLFilePath()
 
 void UserDefault::flush()
 {
+    getStore()->flush();
 }
 
 void UserDefault::deleteValueForKey(const char* key)
 {
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-
     // check the params
     if (!key)
     {
@@ -532,25 +660,7 @@ void UserDefault::deleteValueForKey(const char* key)
         return;
     }
 
-    // find the node
-    node = getXMLNodeForKey(key, &rootNode, &doc);
-
-    // if node not exist, don't need to delete
-    if (!node)
-    {
-        CC_SAFE_DELETE(doc);
-        return;
-    }
-
-    // save file and free doc
-    if (doc)
-    {
-        doc->DeleteNode(node);
-        doc->SaveFile(FileUtils::getInstance()->getSuitableFOpen(UserDefault::getInstance()->getXMLFilePath()).c_str());
-        delete doc;
-    }
-
-    flush();
+    getStore()->deleteValue(key);
 }
 
 NS_CC_END
@@ -47,6 +47,8 @@ NS_CC_BEGIN
  *
  * @warning: On windows, linux, use XML to store data, which means there are some limitations of
  * the key string, for example, `/` is not valid.
+ * The XML file is read once and its values kept in memory. Changes are written back by a background
+ * thread shortly after they are made, call flush() to write them right away.
  */
 class CC_DLL UserDefault
 {
@@ -237,6 +237,25 @@ THE SOFTWARE.
 #define CC_NODE_DEBUG_VERIFY_EVENT_LISTENERS 0
 #endif
 
+/** @def CC_EVENT_DISPATCHER_DEBUG_VERIFY_PRIORITY
+ * If enabled (in conjunction with assertion macros) the event dispatcher cross-checks the incrementally maintained
+ * scene graph priority order of the listeners against a full walk of the scene graph every time it is updated.
+ * It is slow, use it only to track down listener ordering problems.
+ * Note: the verification will always be disabled in builds where assertions are disabled regardless of this setting.
+ */
+#ifndef CC_EVENT_DISPATCHER_DEBUG_VERIFY_PRIORITY
+#define CC_EVENT_DISPATCHER_DEBUG_VERIFY_PRIORITY 0
+#endif
+
+/** @def CC_ENABLE_ASSET_COPY_STATS
+ * If enabled, the bytes copied while loading an image, a sprite sheet or a Cocos Studio file are counted and
+ * logged once the asset is loaded. Useful to check that assets are loaded without needless copies.
+ * To enable set it to a value different than 0. Disabled by default.
+ */
+#ifndef CC_ENABLE_ASSET_COPY_STATS
+#define CC_ENABLE_ASSET_COPY_STATS 0
+#endif
+
 /** @def CC_ENABLE_PROFILERS
  * If enabled, will activate various profilers within cocos2d. This statistical data will be output to the console
  * once per second showing average time (in milliseconds) required to execute the specific routine(s).
@@ -247,6 +266,16 @@ THE SOFTWARE.
 #define CC_ENABLE_PROFILERS 0
 #endif
 
+/** @def CC_USERDEFAULT_BINARY_FILE
+ * If enabled, UserDefault also saves its values in a compact binary file next to UserDefault.xml, and loads
+ * them from it at launch instead of parsing the xml file. The xml file is still written, for compatibility.
+ * Only used where UserDefault is backed by an xml file (not on iOS, Mac and Android).
+ * To enable set it to a value different than 0. Disabled by default.
+ */
+#ifndef CC_USERDEFAULT_BINARY_FILE
+#define CC_USERDEFAULT_BINARY_FILE 0
+#endif
+
 /** Enable Lua engine debug log. */
 #ifndef CC_LUA_ENGINE_DEBUG
 #define CC_LUA_ENGINE_DEBUG 0
@@ -417,6 +446,15 @@ THE SOFTWARE.
 #define CC_STRIP_FPS 0
 #endif
 
+/** @def CC_USE_PARTICLE_SIMD
+ * If enabled, the particles are integrated and their colors converted four at a time
+ * with SSE2 or NEON when the target supports it.
+ * Disable it to measure the scalar loops.
+ */
+#ifndef CC_USE_PARTICLE_SIMD
+#define CC_USE_PARTICLE_SIMD 1
+#endif
+
 #define CC_LABEL_MAX_LENGTH ((1<<16)/4)
 
 #endif // __CCCONFIG_H__
@@ -40,6 +40,7 @@ THE SOFTWARE.
 
 // base
 #include "base/CCAsyncTaskPool.h"
+#include "base/CCJobSystem.h"
 #include "base/CCAutoreleasePool.h"
 #include "base/CCConfiguration.h"
 #include "base/CCConsole.h"
@@ -58,6 +59,7 @@ THE SOFTWARE.
 #include "base/CCValue.h"
 #include "base/CCVector.h"
 #include "base/ZipUtils.h"
+#include "base/CCAssetPack.h"
 #include "base/base64.h"
 #include "base/ccConfig.h"
 #include "base/ccMacros.h"
@@ -118,6 +120,7 @@ THE SOFTWARE.
 #include "2d/CCDrawNode.h"
 #include "2d/CCDrawingPrimitives.h"
 #include "2d/CCFontFNT.h"
+#include "2d/CCFontSDF.h"
 #include "2d/CCLabel.h"
 #include "2d/CCLabelAtlas.h"
 #include "2d/CCLabelBMFont.h"
@@ -128,6 +131,8 @@ THE SOFTWARE.
 #include "2d/CCMotionStreak.h"
 #include "2d/CCNode.h"
 #include "2d/CCNodeGrid.h"
+#include "2d/CCRetainedBatchNode.h"
+#include "2d/CCTransformHierarchy.h"
 #include "2d/CCParticleBatchNode.h"
 #include "2d/CCParticleExamples.h"
 #include "2d/CCParticleSystem.h"
@@ -244,6 +249,7 @@ THE SOFTWARE.
 #include "2d/CCSpriteBatchNode.h"
 #include "2d/CCSpriteFrame.h"
 #include "2d/CCSpriteFrameCache.h"
+#include "2d/CCRuntimeAtlas.h"
 
 // text_input_node
 #include "2d/CCTextFieldTTF.h"
@@ -272,6 +278,7 @@ THE SOFTWARE.
 #include "3d/CCAttachNode.h"
 #include "3d/CCBillBoard.h"
 #include "3d/CCFrustum.h"
+#include "3d/CCDynamicAABBTree.h"
 #include "3d/CCMesh.h"
 #include "3d/CCMeshSkin.h"
 #include "3d/CCMotionStreak3D.h"
@@ -446,7 +446,7 @@ ActionTimeline* ActionTimelineCache::loadAnimationActionWithFlatBuffersFile(cons
     
     CC_ASSERT(FileUtils::getInstance()->isFileExist(fullPath));
     
-    Data buf = FileUtils::getInstance()->getDataFromFile(fullPath);
+    Data buf = FileUtils::getInstance()->getDataViewFromFile(fullPath);
     action = createActionWithDataBuffer(buf);
     _animationActions.insert(fileName, action);
 
@@ -896,6 +896,16 @@ void Mat4::subtract(const Mat4& m1, const Mat4& m2, Mat4* dst)
 #endif
 }
 
+void Mat4::transformPoints(const Vec3* src, Vec3* dst, size_t count, size_t stride) const
+{
+    GP_ASSERT(src && dst);
+#ifdef __SSE__
+    MathUtil::transformPoints(col, (const float*)src, (float*)dst, count, stride);
+#else
+    MathUtil::transformPoints(m, (const float*)src, (float*)dst, count, stride);
+#endif
+}
+
 void Mat4::transformVector(Vec3* vector) const
 {
     GP_ASSERT(vector);
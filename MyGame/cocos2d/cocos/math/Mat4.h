@@ -773,6 +773,22 @@ public:
      */
     inline void transformPoint(const Vec3& point, Vec3* dst) const { GP_ASSERT(dst); transformVector(point.x, point.y, point.z, 1.0f, dst); }
 
+    /**
+     * Transforms an array of points by this matrix, treating the
+     * fourth (w) coordinate as one.
+     *
+     * The points may be interleaved with other data, in which case stride is
+     * the distance in bytes between two consecutive points. Only the x, y and z
+     * coordinates are written, so the data following each point is preserved.
+     * src and dst may point to the same array.
+     *
+     * @param src The first point to transform.
+     * @param dst The first point to store the result in.
+     * @param count The number of points to transform.
+     * @param stride The distance in bytes between two consecutive points.
+     */
+    void transformPoints(const Vec3* src, Vec3* dst, size_t count, size_t stride = sizeof(Vec3)) const;
+
     /**
      * Transforms the specified vector by this matrix by
      * treating the fourth (w) coordinate as zero.
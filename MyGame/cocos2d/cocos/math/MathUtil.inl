@@ -41,6 +41,8 @@ public:
     
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
+    inline static void transformPoints(const float* m, const float* src, float* dst, size_t count, size_t stride);
+    
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
 };
 
@@ -204,6 +206,23 @@ inline void MathUtilC::transformVec4(const float* m, const float* v, float* dst)
     dst[3] = w;
 }
 
+inline void MathUtilC::transformPoints(const float* m, const float* src, float* dst, size_t count, size_t stride)
+{
+    // Only x, y and z are written, so whatever follows a point inside its stride is left untouched.
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float* v = (const float*)((const char*)src + i * stride);
+        float* d = (float*)((char*)dst + i * stride);
+        float x = v[0] * m[0] + v[1] * m[4] + v[2] * m[8] + m[12];
+        float y = v[0] * m[1] + v[1] * m[5] + v[2] * m[9] + m[13];
+        float z = v[0] * m[2] + v[1] * m[6] + v[2] * m[10] + m[14];
+        
+        d[0] = x;
+        d[1] = y;
+        d[2] = z;
+    }
+}
+
 inline void MathUtilC::crossVec3(const float* v1, const float* v2, float* dst)
 {
     float x = (v1[1] * v2[2]) - (v1[2] * v2[1]);
@@ -17,6 +17,8 @@
 
  This file was modified to fit the cocos2d-x project
  */
+#include <arm_neon.h>
+
 NS_CC_MATH_BEGIN
 
 class MathUtilNeon
@@ -40,6 +42,8 @@ public:
     
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
+    inline static void transformPoints(const float* m, const float* src, float* dst, size_t count, size_t stride);
+    
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
 };
 
@@ -243,6 +247,27 @@ inline void MathUtilNeon::transformVec4(const float* m, const float* v, float* d
      );
 }
 
+inline void MathUtilNeon::transformPoints(const float* m, const float* src, float* dst, size_t count, size_t stride)
+{
+    const float32x4_t col0 = vld1q_f32(m);
+    const float32x4_t col1 = vld1q_f32(m + 4);
+    const float32x4_t col2 = vld1q_f32(m + 8);
+    const float32x4_t col3 = vld1q_f32(m + 12);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float* v = (const float*)((const char*)src + i * stride);
+        float* d = (float*)((char*)dst + i * stride);
+
+        float32x4_t r = vmlaq_n_f32(col3, col0, v[0]);  // M[m12-m15] + M[m0-m3] * V[x]
+        r = vmlaq_n_f32(r, col1, v[1]);                   // + M[m4-m7] * V[y]
+        r = vmlaq_n_f32(r, col2, v[2]);                   // + M[m8-m11] * V[z]
+
+        vst1_f32(d, vget_low_f32(r));                     // DST[x, y]
+        vst1q_lane_f32(d + 2, r, 2);                      // DST[z]
+    }
+}
+
 inline void MathUtilNeon::crossVec3(const float* v1, const float* v2, float* dst) __attribute__((optnone))
 {
     asm volatile(
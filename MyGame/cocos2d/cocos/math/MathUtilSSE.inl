@@ -151,6 +151,29 @@ void MathUtil::transformVec4(const __m128 m[4], const __m128& v, __m128& dst)
                      );
 }
 
+void MathUtil::transformPoints(const __m128 m[4], const float* src, float* dst, size_t count, size_t stride)
+{
+    const __m128 col0 = m[0];
+    const __m128 col1 = m[1];
+    const __m128 col2 = m[2];
+    const __m128 col3 = m[3];
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float* v = (const float*)((const char*)src + i * stride);
+        float* d = (float*)((char*)dst + i * stride);
+
+        __m128 r = _mm_add_ps(
+                              _mm_add_ps(_mm_mul_ps(col0, _mm_set1_ps(v[0])), _mm_mul_ps(col1, _mm_set1_ps(v[1]))),
+                              _mm_add_ps(_mm_mul_ps(col2, _mm_set1_ps(v[2])), col3)
+                              );
+
+        // Store x, y and z only, w would overwrite whatever follows the point.
+        _mm_storel_pi((__m64*)d, r);
+        _mm_store_ss(d + 2, _mm_movehl_ps(r, r));
+    }
+}
+
 #endif
 
 
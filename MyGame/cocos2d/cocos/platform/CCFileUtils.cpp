@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "base/CCData.h"
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
+#include "base/CCAssetPack.h"
 #include "platform/CCSAXParser.h"
 //#include "base/ccUtils.h"
 
@@ -627,6 +628,125 @@ void FileUtils::purgeCachedEntries()
     _fullPathCacheDir.clear();
 }
 
+bool FileUtils::addAssetPack(const std::string& filename, const std::string& mountPoint)
+{
+    std::string fullPath = fullPathForFilename(filename);
+    if (fullPath.empty())
+    {
+        CCLOG("cocos2d: can't find asset pack %s", filename.c_str());
+        return false;
+    }
+
+    std::shared_ptr<AssetPack> pack(AssetPack::open(fullPath));
+    if (!pack)
+        return false;
+
+    std::string mount = mountPoint;
+    if (mount.empty())
+    {
+        size_t pos = fullPath.find_last_of('/');
+        mount = (pos != std::string::npos) ? fullPath.substr(0, pos + 1) : "";
+    }
+    else
+    {
+        if (!isAbsolutePath(mount))
+            mount = _defaultResRootPath + mount;
+        if (mount.back() != '/')
+            mount += '/';
+    }
+
+    DECLARE_GUARD;
+    removeAssetPack(filename);
+    _assetPacks.insert(_assetPacks.begin(), MountedAssetPack{ filename, mount, pack });
+    // The files of the pack may shadow the ones that were found on disk
+    _fullPathCache.clear();
+    return true;
+}
+
+void FileUtils::removeAssetPack(const std::string& filename)
+{
+    DECLARE_GUARD;
+    for (auto iter = _assetPacks.begin(); iter != _assetPacks.end(); ++iter)
+    {
+        if (iter->filename == filename)
+        {
+            _assetPacks.erase(iter);
+            _fullPathCache.clear();
+            return;
+        }
+    }
+}
+
+/** Finds the entry of a full path in the mounted packs, the pack is returned in pack */
+template <typename MountedPacks>
+static const AssetPack::Entry* findAssetPackEntry(const MountedPacks& packs, const std::string& fullPath, std::shared_ptr<AssetPack>* pack)
+{
+    for (const auto& mounted : packs)
+    {
+        const std::string& mount = mounted.mountPoint;
+        if (fullPath.size() <= mount.size() || fullPath.compare(0, mount.size(), mount) != 0)
+            continue;
+
+        const AssetPack::Entry* entry = mounted.pack->findEntry(fullPath.c_str() + mount.size(), fullPath.size() - mount.size());
+        if (entry)
+        {
+            if (pack)
+                *pack = mounted.pack;
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+bool FileUtils::isFileExistInAssetPacks(const std::string& fullPath) const
+{
+    DECLARE_GUARD;
+    if (_assetPacks.empty())
+        return false;
+
+    return findAssetPackEntry(_assetPacks, fullPath, nullptr) != nullptr;
+}
+
+FileUtils::Status FileUtils::getContentsFromAssetPacks(const std::string& fullPath, ResizableBuffer* buffer) const
+{
+    DECLARE_GUARD;
+    if (_assetPacks.empty())
+        return Status::NotExists;
+
+    std::shared_ptr<AssetPack> pack;
+    const AssetPack::Entry* entry = findAssetPackEntry(_assetPacks, fullPath, &pack);
+    if (!entry)
+        return Status::NotExists;
+
+    return pack->getEntryData(entry, buffer) ? Status::OK : Status::ReadFailed;
+}
+
+long FileUtils::getFileSizeInAssetPacks(const std::string& fullPath) const
+{
+    DECLARE_GUARD;
+    if (_assetPacks.empty())
+        return -1;
+
+    const AssetPack::Entry* entry = findAssetPackEntry(_assetPacks, fullPath, nullptr);
+    return entry ? (long)entry->size : -1;
+}
+
+bool FileUtils::getDataViewFromAssetPacks(const std::string& fullPath, Data* data) const
+{
+    DECLARE_GUARD;
+    if (_assetPacks.empty())
+        return false;
+
+    std::shared_ptr<AssetPack> pack;
+    const AssetPack::Entry* entry = findAssetPackEntry(_assetPacks, fullPath, &pack);
+    const unsigned char* bytes = entry ? pack->getEntryBytes(entry) : nullptr;
+    if (!bytes || entry->size == 0)
+        return false;
+
+    data->setView(const_cast<unsigned char*>(bytes), (ssize_t)entry->size, pack);
+    return true;
+}
+
 std::string FileUtils::getStringFromFile(const std::string& filename) const
 {
     std::string s;
@@ -651,6 +771,19 @@ Data FileUtils::getDataFromFile(const std::string& filename) const
     return d;
 }
 
+Data FileUtils::getDataViewFromFile(const std::string& filename) const
+{
+    if (filename.empty())
+        return Data::Null;
+
+    std::string fullPath = fullPathForFilename(filename);
+    Data d;
+    if (!fullPath.empty() && getDataViewFromAssetPacks(fullPath, &d))
+        return d;
+
+    return getDataFromFile(fullPath.empty() ? filename : fullPath);
+}
+
 void FileUtils::getDataFromFile(const std::string& filename, std::function<void(Data)> callback) const
 {
     auto fullPath = fullPathForFilename(filename);
@@ -670,6 +803,10 @@ FileUtils::Status FileUtils::getContents(const std::string& filename, ResizableB
     if (fullPath.empty())
         return Status::NotExists;
 
+    Status packStatus = fs->getContentsFromAssetPacks(fullPath, buffer);
+    if (packStatus != Status::NotExists)
+        return packStatus;
+
     std::string suitableFullPath = fs->getSuitableFOpen(fullPath);
 
     struct stat statBuf;
@@ -1121,7 +1258,7 @@ std::string FileUtils::getFullPathForFilenameWithinDirectory(const std::string&
     }
     ret += filename;
     // if the file doesn't exist, return an empty string
-    if (!isFileExistInternal(ret)) {
+    if (!isFileExistInAssetPacks(ret) && !isFileExistInternal(ret)) {
         ret = "";
     }
     return ret;
@@ -1131,7 +1268,7 @@ bool FileUtils::isFileExist(const std::string& filename) const
 {
     if (isAbsolutePath(filename))
     {
-        return isFileExistInternal(filename);
+        return isFileExistInAssetPacks(filename) || isFileExistInternal(filename);
     }
     else
     {
@@ -1498,6 +1635,10 @@ long FileUtils::getFileSize(const std::string &filepath) const
             return 0;
     }
 
+    long packSize = getFileSizeInAssetPacks(fullpath);
+    if (packSize >= 0)
+        return packSize;
+
     struct stat info;
     // Get data associated with "crt_stat.c":
     int result = stat(fullpath.c_str(), &info);
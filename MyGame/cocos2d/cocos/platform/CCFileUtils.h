@@ -42,6 +42,8 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
+class AssetPack;
+
 /**
  * @addtogroup platform
  * @{
@@ -105,6 +107,9 @@ class ResizableBufferAdapter<Data> : public ResizableBuffer {
 public:
     explicit ResizableBufferAdapter(BufferType* buffer) : _buffer(buffer) {}
     virtual void resize(size_t size) override {
+        // a view doesn't own its bytes, the contents are read into a buffer of its own
+        if (_buffer->isView())
+            _buffer->clear();
         size_t oldSize = static_cast<size_t>(_buffer->getSize());
         if (oldSize != size) {
             auto old = _buffer->getBytes();
@@ -184,6 +189,15 @@ public:
      *  @return A data object.
      */
     virtual Data getDataFromFile(const std::string& filename) const;
+
+    /**
+     *  Creates binary data from a file without copying the contents when it can: a file stored uncompressed
+     *  in a mounted asset pack is returned as a view of the pack. Other files are read like getDataFromFile() does.
+     *  The bytes of the returned data must not be modified, copy the data to get bytes of its own.
+     *  @return A data object.
+     *  @since v3.17
+     */
+    virtual Data getDataViewFromFile(const std::string& filename) const;
     
 
     /**
@@ -847,6 +861,27 @@ public:
     /** Returns the full path cache. */
     const std::unordered_map<std::string, std::string> getFullPathCache() const { return _fullPathCache; }
 
+    /**
+     *  Mounts an asset pack built by tools/asset-pack/build_asset_pack.py.
+     *  The files of the pack then exist under the mount point, and getContents() reads them from the pack,
+     *  which is mapped into memory once, instead of opening them one by one.
+     *  Packs are looked up before the file system, the last mounted pack first.
+     *
+     *  @param filename The pack file, it could be a relative or an absolute path.
+     *  @param mountPoint The directory the files of the pack appear in. The directory of the pack file if it is empty.
+     *  @return True if the pack was mounted.
+     *  @since v3.17
+     */
+    virtual bool addAssetPack(const std::string& filename, const std::string& mountPoint = "");
+
+    /**
+     *  Unmounts an asset pack mounted by addAssetPack().
+     *
+     *  @param filename The pack file, as passed to addAssetPack().
+     *  @since v3.17
+     */
+    virtual void removeAssetPack(const std::string& filename);
+
     /**
      *  Gets the new filename from the filename lookup dictionary.
      *  It is possible to have a override names.
@@ -915,6 +950,24 @@ protected:
      */
     virtual std::string fullPathForDirectory(const std::string &dirname) const;
 
+    /** Whether a file with an absolute (or platform full) path is in one of the mounted asset packs. */
+    bool isFileExistInAssetPacks(const std::string& fullPath) const;
+
+    /**
+     *  Reads a file with a full path from the mounted asset packs.
+     *  @return Status::NotExists if the file isn't in any pack.
+     */
+    Status getContentsFromAssetPacks(const std::string& fullPath, ResizableBuffer* buffer) const;
+
+    /** The size of a file in the mounted asset packs, -1 if the file isn't in any pack. */
+    long getFileSizeInAssetPacks(const std::string& fullPath) const;
+
+    /**
+     *  Makes data a view of a file with a full path in the mounted asset packs, which keeps the pack mapped.
+     *  @return False if the file isn't in any pack or is compressed in it.
+     */
+    bool getDataViewFromAssetPacks(const std::string& fullPath, Data* data) const;
+
     /**
     * mutex used to protect fields. 
     */
@@ -973,6 +1026,19 @@ protected:
      */
     std::string _writablePath;
 
+    /** An asset pack and the directory its files appear in */
+    struct MountedAssetPack
+    {
+        std::string filename;
+        std::string mountPoint;
+        std::shared_ptr<AssetPack> pack;
+    };
+
+    /**
+     * The mounted asset packs, the last mounted one first.
+     */
+    std::vector<MountedAssetPack> _assetPacks;
+
     /**
      *  The singleton pointer of FileUtils.
      */
@@ -491,6 +491,7 @@ Image::Image()
 , _renderFormat(Texture2D::PixelFormat::NONE)
 , _numberOfMipmaps(0)
 , _hasPremultipliedAlpha(false)
+, _dataBorrowed(false)
 {
 
 }
@@ -502,7 +503,7 @@ Image::~Image()
         for (int i = 0; i < _numberOfMipmaps; ++i)
             CC_SAFE_DELETE_ARRAY(_mipmaps[i].address);
     }
-    else
+    else if (!_dataBorrowed)
         CC_SAFE_FREE(_data);
 }
 
@@ -510,12 +511,19 @@ bool Image::initWithImageFile(const std::string& path)
 {
     bool ret = false;
     _filePath = FileUtils::getInstance()->fullPathForFilename(path);
+    CC_ASSET_COPY_SCOPE(_filePath);
+
+    _fileData = FileUtils::getInstance()->getDataViewFromFile(_filePath);
 
-    Data data = FileUtils::getInstance()->getDataFromFile(_filePath);
+    if (!_fileData.isNull())
+    {
+        ret = initWithImageData(_fileData.getBytes(), _fileData.getSize());
+    }
 
-    if (!data.isNull())
+    // compressed textures are used in place, the decoded ones don't need the file anymore
+    if (!_dataBorrowed)
     {
-        ret = initWithImageData(data.getBytes(), data.getSize());
+        _fileData.clear();
     }
 
     return ret;
@@ -525,12 +533,18 @@ bool Image::initWithImageFileThreadSafe(const std::string& fullpath)
 {
     bool ret = false;
     _filePath = fullpath;
+    CC_ASSET_COPY_SCOPE(_filePath);
+
+    _fileData = FileUtils::getInstance()->getDataViewFromFile(fullpath);
 
-    Data data = FileUtils::getInstance()->getDataFromFile(fullpath);
+    if (!_fileData.isNull())
+    {
+        ret = initWithImageData(_fileData.getBytes(), _fileData.getSize());
+    }
 
-    if (!data.isNull())
+    if (!_dataBorrowed)
     {
-        ret = initWithImageData(data.getBytes(), data.getSize());
+        _fileData.clear();
     }
 
     return ret;
@@ -618,6 +632,23 @@ bool Image::initWithImageData(const unsigned char * data, ssize_t dataLen)
     return ret;
 }
 
+void Image::setCompressedData(const unsigned char* data, ssize_t dataLen)
+{
+    const unsigned char* fileBytes = _fileData.getBytes();
+    if (fileBytes != nullptr && data >= fileBytes && data + dataLen <= fileBytes + _fileData.getSize())
+    {
+        _data = const_cast<unsigned char*>(data);
+        _dataLen = dataLen;
+        _dataBorrowed = true;
+        return;
+    }
+
+    _dataLen = dataLen;
+    _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
+    memcpy(_data, data, _dataLen);
+    CC_ASSET_COPY_RECORD(_dataLen);
+}
+
 bool Image::isPng(const unsigned char * data, ssize_t dataLen)
 {
     if (dataLen <= 8)
@@ -1457,9 +1488,7 @@ bool Image::initWithPVRv2Data(const unsigned char * data, ssize_t dataLen)
     dataLength = CC_SWAP_INT32_LITTLE_TO_HOST(header->dataLength);
 
     //Move by size of header
-    _dataLen = dataLen - sizeof(PVRv2TexHeader);
-    _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
-    memcpy(_data, (unsigned char*)data + sizeof(PVRv2TexHeader), _dataLen);
+    setCompressedData(data + sizeof(PVRv2TexHeader), dataLen - sizeof(PVRv2TexHeader));
 
     // Calculate the data size for each texture level and respect the minimum number of blocks
     while (dataOffset < dataLength)
@@ -1607,9 +1636,7 @@ bool Image::initWithPVRv3Data(const unsigned char * data, ssize_t dataLen)
     int dataOffset = 0, dataSize = 0;
     int blockSize = 0, widthBlocks = 0, heightBlocks = 0;
     
-    _dataLen = dataLen - (sizeof(PVRv3TexHeader) + header->metadataLength);
-    _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
-    memcpy(_data, static_cast<const unsigned char*>(data) + sizeof(PVRv3TexHeader) + header->metadataLength, _dataLen);
+    setCompressedData(data + sizeof(PVRv3TexHeader) + header->metadataLength, dataLen - (sizeof(PVRv3TexHeader) + header->metadataLength));
     
     _numberOfMipmaps = header->numberOfMipmaps;
     CCASSERT(_numberOfMipmaps < MIPMAP_MAX, "Image: Maximum number of mimpaps reached. Increase the CC_MIPMAP_MAX value");
@@ -1739,9 +1766,7 @@ bool Image::initWithETCData(const unsigned char * data, ssize_t dataLen)
         //old opengl version has no define for GL_ETC1_RGB8_OES, add macro to make compiler happy. 
 #ifdef GL_ETC1_RGB8_OES
         _renderFormat = Texture2D::PixelFormat::ETC;
-        _dataLen = dataLen - ETC_PKM_HEADER_SIZE;
-        _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
-        memcpy(_data, static_cast<const unsigned char*>(data) + ETC_PKM_HEADER_SIZE, _dataLen);
+        setCompressedData(data + ETC_PKM_HEADER_SIZE, dataLen - ETC_PKM_HEADER_SIZE);
         return true;
 #else
         CC_UNUSED_PARAM(dataLen);
@@ -1867,8 +1892,8 @@ bool Image::initWithS3TCData(const unsigned char * data, ssize_t dataLen)
     /* load the .dds file */
     
     S3TCTexHeader *header = (S3TCTexHeader *)data;
-    unsigned char *pixelData = static_cast<unsigned char*>(malloc((dataLen - sizeof(S3TCTexHeader)) * sizeof(unsigned char)));
-    memcpy((void *)pixelData, data + sizeof(S3TCTexHeader), dataLen - sizeof(S3TCTexHeader));
+    /* pixelData point to the compressed data address, the software decoder only reads it */
+    unsigned char *pixelData = (unsigned char *)data + sizeof(S3TCTexHeader);
     
     _width = header->ddsd.width;
     _height = header->ddsd.height;
@@ -1883,9 +1908,7 @@ bool Image::initWithS3TCData(const unsigned char * data, ssize_t dataLen)
     
     if (Configuration::getInstance()->supportsS3TC())  //compressed data length
     {
-        _dataLen = dataLen - sizeof(S3TCTexHeader);
-        _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
-        memcpy((void *)_data,(void *)pixelData , _dataLen);
+        setCompressedData(pixelData, dataLen - sizeof(S3TCTexHeader));
     }
     else                                               //decompressed data length
     {
@@ -1975,11 +1998,6 @@ bool Image::initWithS3TCData(const unsigned char * data, ssize_t dataLen)
     
     /* end load the mipmaps */
     
-    if (pixelData != nullptr)
-    {
-        free(pixelData);
-    };
-    
     return true;
 }
 
@@ -2017,9 +2035,7 @@ bool Image::initWithATITCData(const unsigned char *data, ssize_t dataLen)
     
     if (Configuration::getInstance()->supportsATITC())  //compressed data length
     {
-        _dataLen = dataLen - sizeof(ATITCTexHeader) - header->bytesOfKeyValueData - 4;
-        _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
-        memcpy((void *)_data,(void *)pixelData , _dataLen);
+        setCompressedData(pixelData, dataLen - sizeof(ATITCTexHeader) - header->bytesOfKeyValueData - 4);
     }
     else                                               //decompressed data length
     {
@@ -2185,6 +2201,7 @@ bool Image::initWithRawData(const unsigned char * data, ssize_t /*dataLen*/, int
         _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
         CC_BREAK_IF(! _data);
         memcpy(_data, data, _dataLen);
+        CC_ASSET_COPY_RECORD(_dataLen);
 
         ret = true;
     } while (0);
@@ -29,6 +29,7 @@ THE SOFTWARE.
 /// @cond DO_NOT_SHOW
 
 #include "base/CCRef.h"
+#include "base/CCData.h"
 #include "renderer/CCTexture2D.h"
 
 #if CC_USE_WIC
@@ -179,6 +180,12 @@ protected:
     typedef struct sImageTGA tImageTGA;
     bool initWithTGAData(tImageTGA* tgaData);
 
+    /**
+     @brief Sets _data to dataLen bytes of compressed texture data. They are used in place when they are
+     part of the image file kept in _fileData, otherwise they are copied.
+     */
+    void setCompressedData(const unsigned char* data, ssize_t dataLen);
+
     bool saveImageToPNG(const std::string& filePath, bool isToRGB = true);
     bool saveImageToJPG(const std::string& filePath);
     
@@ -206,6 +213,9 @@ protected:
     // false if we can't auto detect the image is premultiplied or not.
     bool _hasPremultipliedAlpha;
     std::string _filePath;
+    // the image file, kept while _data points into it
+    Data _fileData;
+    bool _dataBorrowed;
 
 
 protected:
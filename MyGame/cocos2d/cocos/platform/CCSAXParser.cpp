@@ -147,7 +147,8 @@ bool SAXParser::parse(const char* xmlData, size_t dataLength)
 bool SAXParser::parse(const std::string& filename)
 {
     bool ret = false;
-    Data data = FileUtils::getInstance()->getDataFromFile(filename);
+    // tinyxml2 only reads the document, so it can parse a file in an asset pack in place
+    Data data = FileUtils::getInstance()->getDataViewFromFile(filename);
     if (!data.isNull())
     {
         ret = parse((const char*)data.getBytes(), data.getSize());
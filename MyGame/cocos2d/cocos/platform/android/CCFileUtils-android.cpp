@@ -355,6 +355,10 @@ FileUtils::Status FileUtilsAndroid::getContents(const std::string& filename, Res
     if (fullPath[0] == '/')
         return FileUtils::getContents(fullPath, buffer);
 
+    FileUtils::Status packStatus = getContentsFromAssetPacks(fullPath, buffer);
+    if (packStatus != FileUtils::Status::NotExists)
+        return packStatus;
+
     string relativePath = string();
     size_t position = fullPath.find(apkprefix);
     if (0 == position) {
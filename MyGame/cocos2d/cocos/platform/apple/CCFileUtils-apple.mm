@@ -319,6 +319,15 @@ std::string FileUtilsApple::getFullPathForFilenameWithinDirectory(const std::str
 {
     if (directory[0] != '/')
     {
+        if (!_assetPacks.empty())
+        {
+            std::string packPath = [[pimpl_->getBundle() resourcePath] UTF8String];
+            packPath += '/';
+            packPath += directory + filename;
+            if (isFileExistInAssetPacks(packPath))
+                return packPath;
+        }
+
         NSString* fullpath = [pimpl_->getBundle() pathForResource:[NSString stringWithUTF8String:filename.c_str()]
                                                              ofType:nil
                                                         inDirectory:[NSString stringWithUTF8String:directory.c_str()]];
@@ -329,6 +338,8 @@ std::string FileUtilsApple::getFullPathForFilenameWithinDirectory(const std::str
     else
     {
         std::string fullPath = directory+filename;
+        if (isFileExistInAssetPacks(fullPath))
+            return fullPath;
         // Search path is an absolute path.
         if ([s_fileManager fileExistsAtPath:[NSString stringWithUTF8String:fullPath.c_str()]]) {
             return fullPath;
@@ -339,7 +350,7 @@ std::string FileUtilsApple::getFullPathForFilenameWithinDirectory(const std::str
 
 ValueMap FileUtilsApple::getValueMapFromFile(const std::string& filename) const
 {
-    auto d(FileUtils::getInstance()->getDataFromFile(filename));
+    auto d(FileUtils::getInstance()->getDataViewFromFile(filename));
     return getValueMapFromData(reinterpret_cast<char*>(d.getBytes()), static_cast<int>(d.getSize()));
 }
 
@@ -180,6 +180,10 @@ FileUtils::Status FileUtilsWin32::getContents(const std::string& filename, Resiz
     // read the file from hardware
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filename);
 
+    FileUtils::Status packStatus = getContentsFromAssetPacks(fullPath, buffer);
+    if (packStatus != FileUtils::Status::NotExists)
+        return packStatus;
+
     HANDLE fileHandle = ::CreateFile(StringUtf8ToWideChar(fullPath).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, NULL, nullptr);
     if (fileHandle == INVALID_HANDLE_VALUE)
         return FileUtils::Status::OpenFailed;
@@ -276,6 +280,10 @@ void FileUtilsWin32::listFilesRecursively(const std::string& dirPath, std::vecto
 
 long FileUtilsWin32::getFileSize(const std::string &filepath) const
 {
+    long packSize = getFileSizeInAssetPacks(convertPathFormatToUnixStyle(filepath));
+    if (packSize >= 0)
+        return packSize;
+
     struct _stat tmp;
     if (_stat(filepath.c_str(), &tmp) == 0)
     {
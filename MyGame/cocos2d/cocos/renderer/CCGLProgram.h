@@ -186,6 +186,8 @@ public:
     static const char* SHADER_NAME_POSITION_TEXTURE_COLOR;
     /**Built in shader for 2d. Support Position, Texture and Color vertex attribute, but without multiply vertex by MVP matrix.*/
     static const char* SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP;
+    /**Built in shader for 2d. Support Position, Texture and Color vertex attribute, vertices are transformed by a model-view matrix palette indexed by the blend index attribute.*/
+    static const char* SHADER_NAME_POSITION_TEXTURE_COLOR_GPU_TRANSFORM;
     /**Built in shader for 2d. Support Position, Texture vertex attribute, but include alpha test.*/
     static const char* SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST;
     /**Built in shader for 2d. Support Position, Texture and Color vertex attribute, include alpha test and without multiply vertex by MVP matrix.*/
@@ -214,9 +216,13 @@ public:
     */
     static const char* SHADER_NAME_LABEL_NORMAL;
     static const char* SHADER_NAME_LABEL_OUTLINE;
+    static const char* SHADER_NAME_LABEL_BATCHED;
     static const char* SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL;
     static const char* SHADER_NAME_LABEL_DISTANCEFIELD_GLOW;
 
+    /**Built in shader for particles drawn as instances of a quad, support per instance position, size, rotation and color.*/
+    static const char* SHADER_NAME_PARTICLE_INSTANCED;
+
     /**Built in shader used for 3D, support Position vertex attribute, with color specified by a uniform.*/
     static const char* SHADER_3D_POSITION;
     /**Built in shader used for 3D, support Position and Texture vertex attribute, with color specified by a uniform.*/
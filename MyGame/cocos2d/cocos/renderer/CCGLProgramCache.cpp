@@ -42,6 +42,7 @@ NS_CC_BEGIN
 enum {
     kShaderType_PositionTextureColor,
     kShaderType_PositionTextureColor_noMVP,
+    kShaderType_PositionTextureColor_gpuTransform,
     kShaderType_PositionTextureColorAlphaTest,
     kShaderType_PositionTextureColorAlphaTestNoMV,
     kShaderType_PositionColor,
@@ -57,6 +58,8 @@ enum {
     kShaderType_UIGrayScale,
     kShaderType_LabelNormal,
     kShaderType_LabelOutline,
+    kShaderType_LabelBatched,
+    kShaderType_ParticleInstanced,
     kShaderType_3DPosition,
     kShaderType_3DPositionTex,
     kShaderType_3DSkinPositionTex,
@@ -156,6 +159,11 @@ void GLProgramCache::loadDefaultGLPrograms()
     loadDefaultGLProgram(p, kShaderType_PositionTextureColor_noMVP);
     _programs.emplace(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP, p);
 
+    // Position Texture Color with GPU transform shader
+    p = new (std::nothrow) GLProgram();
+    loadDefaultGLProgram(p, kShaderType_PositionTextureColor_gpuTransform);
+    _programs.emplace(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_GPU_TRANSFORM, p);
+
     // Position Texture Color alpha test
     p = new (std::nothrow) GLProgram();
     loadDefaultGLProgram(p, kShaderType_PositionTextureColorAlphaTest);
@@ -239,6 +247,14 @@ void GLProgramCache::loadDefaultGLPrograms()
     loadDefaultGLProgram(p, kShaderType_LabelOutline);
     _programs.emplace(GLProgram::SHADER_NAME_LABEL_OUTLINE, p);
 
+    p = new (std::nothrow) GLProgram();
+    loadDefaultGLProgram(p, kShaderType_LabelBatched);
+    _programs.emplace(GLProgram::SHADER_NAME_LABEL_BATCHED, p);
+
+    p = new (std::nothrow) GLProgram();
+    loadDefaultGLProgram(p, kShaderType_ParticleInstanced);
+    _programs.emplace(GLProgram::SHADER_NAME_PARTICLE_INSTANCED, p);
+
     p = new (std::nothrow) GLProgram();
     loadDefaultGLProgram(p, kShaderType_3DPosition);
     _programs.emplace(GLProgram::SHADER_3D_POSITION, p);
@@ -328,6 +344,11 @@ void GLProgramCache::reloadDefaultGLPrograms()
     p->reset();
     loadDefaultGLProgram(p, kShaderType_PositionTextureColor_noMVP);
 
+    // Position Texture Color with GPU transform shader
+    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_GPU_TRANSFORM);
+    p->reset();
+    loadDefaultGLProgram(p, kShaderType_PositionTextureColor_gpuTransform);
+
     // Position Texture Color alpha test
     p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST);
     p->reset();
@@ -410,6 +431,14 @@ void GLProgramCache::reloadDefaultGLPrograms()
     p->reset();
     loadDefaultGLProgram(p, kShaderType_LabelOutline);
 
+    p = getGLProgram(GLProgram::SHADER_NAME_LABEL_BATCHED);
+    p->reset();
+    loadDefaultGLProgram(p, kShaderType_LabelBatched);
+
+    p = getGLProgram(GLProgram::SHADER_NAME_PARTICLE_INSTANCED);
+    p->reset();
+    loadDefaultGLProgram(p, kShaderType_ParticleInstanced);
+
     p = getGLProgram(GLProgram::SHADER_3D_POSITION);
     p->reset();
     loadDefaultGLProgram(p, kShaderType_3DPosition);
@@ -517,6 +546,9 @@ void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
         case kShaderType_PositionTextureColor_noMVP:
             p->initWithByteArrays(ccPositionTextureColor_noMVP_vert, ccPositionTextureColor_noMVP_frag);
             break;
+        case kShaderType_PositionTextureColor_gpuTransform:
+            p->initWithByteArrays(ccPositionTextureColor_gpuTransform_vert, ccPositionTextureColor_noMVP_frag);
+            break;
         case kShaderType_PositionTextureColorAlphaTest:
             p->initWithByteArrays(ccPositionTextureColor_vert, ccPositionTextureColorAlphaTest_frag);
             break;
@@ -564,6 +596,12 @@ void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
         case kShaderType_LabelOutline:
             p->initWithByteArrays(ccLabel_vert, ccLabelOutline_frag);
             break;
+        case kShaderType_LabelBatched:
+            p->initWithByteArrays(ccPositionTextureColor_noMVP_vert, ccLabelBatched_frag);
+            break;
+        case kShaderType_ParticleInstanced:
+            p->initWithByteArrays(ccParticleInstanced_vert, ccPositionTextureColor_frag);
+            break;
         case kShaderType_3DPosition:
             p->initWithByteArrays(cc3D_PositionTex_vert, cc3D_Color_frag);
             break;
@@ -26,6 +26,13 @@
 #include "renderer/CCRenderer.h"
 
 #include <algorithm>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 #include "renderer/CCTrianglesCommand.h"
 #include "renderer/CCBatchCommand.h"
@@ -41,6 +48,7 @@
 #include "renderer/ccGLStateCache.h"
 
 #include "base/CCConfiguration.h"
+#include "base/CCJobSystem.h"
 #include "base/CCDirector.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventListenerCustom.h"
@@ -51,14 +59,35 @@
 NS_CC_BEGIN
 
 // helper
-static bool compareRenderCommand(RenderCommand* a, RenderCommand* b)
+// sort keys are: queue group (3 bits) | global Z order or depth (32 bits) | material rank (29 bits)
+static const int SORT_KEY_RANK_BITS = 29;
+static const int SORT_KEY_ORDER_BITS = 32;
+
+// maps a float to an unsigned integer with the same ordering
+static uint32_t orderedFloatBits(float value)
+{
+    // -0.0 and 0.0 are the same order
+    if (value == 0)
+        value = 0;
+
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+static uint64_t makeSortKey(int group, uint32_t order, uint32_t rank)
 {
-    return a->getGlobalOrder() < b->getGlobalOrder();
+    return ((uint64_t) group << (SORT_KEY_ORDER_BITS + SORT_KEY_RANK_BITS))
+        | ((uint64_t) order << SORT_KEY_RANK_BITS)
+        | (rank & ((1u << SORT_KEY_RANK_BITS) - 1));
 }
 
-static bool compare3DCommand(RenderCommand* a, RenderCommand* b)
+// the material ranks of merged commands are sorted in one pass of the radix sort
+static const size_t MAX_MERGED_MATERIALS = 256;
+
+static bool isMergeableCommand(const RenderCommand* command)
 {
-    return  a->getDepth() > b->getDepth();
+    return command->getType() == RenderCommand::Type::TRIANGLES_COMMAND && !command->isSkipBatching();
 }
 
 // queue
@@ -112,9 +141,115 @@ ssize_t RenderQueue::size() const
 void RenderQueue::sort()
 {
     // Don't sort _queue0, it already comes sorted
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::TRANSPARENT_3D]), std::end(_commands[QUEUE_GROUP::TRANSPARENT_3D]), compare3DCommand);
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_NEG]), std::end(_commands[QUEUE_GROUP::GLOBALZ_NEG]), compareRenderCommand);
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_POS]), std::end(_commands[QUEUE_GROUP::GLOBALZ_POS]), compareRenderCommand);
+    for (int group : {QUEUE_GROUP::TRANSPARENT_3D, QUEUE_GROUP::GLOBALZ_NEG, QUEUE_GROUP::GLOBALZ_POS})
+    {
+        auto& commands = _commands[group];
+        if (commands.size() < 2)
+            continue;
+
+        // the keys are computed once and stored contiguously, so sorting doesn't touch the commands
+        _sortEntries.resize(commands.size());
+        for (size_t i = 0; i < commands.size(); ++i)
+        {
+            // transparent 3D objects are drawn back to front
+            const uint32_t order = group == QUEUE_GROUP::TRANSPARENT_3D
+                ? ~orderedFloatBits(commands[i]->getDepth())
+                : orderedFloatBits(commands[i]->getGlobalOrder());
+            _sortEntries[i] = {makeSortKey(group, order, 0), commands[i]};
+        }
+        radixSort(commands.data(), SORT_KEY_RANK_BITS, SORT_KEY_RANK_BITS + SORT_KEY_ORDER_BITS);
+    }
+}
+
+void RenderQueue::radixSort(RenderCommand** commands, int firstBit, int lastBit)
+{
+    const size_t count = _sortEntries.size();
+    _sortBuffer.resize(count);
+
+    // least significant digit first, each pass is stable
+    for (int shift = firstBit; shift < lastBit; shift += 8)
+    {
+        size_t offsets[256] = {0};
+        for (const auto& entry : _sortEntries)
+            ++offsets[(entry.key >> shift) & 0xff];
+
+        // all the keys have the same digit, nothing to do for this pass
+        if (offsets[(_sortEntries[0].key >> shift) & 0xff] == count)
+            continue;
+
+        size_t total = 0;
+        for (auto& offset : offsets)
+        {
+            const size_t digitCount = offset;
+            offset = total;
+            total += digitCount;
+        }
+
+        for (const auto& entry : _sortEntries)
+            _sortBuffer[offsets[(entry.key >> shift) & 0xff]++] = entry;
+        _sortEntries.swap(_sortBuffer);
+    }
+
+    for (size_t i = 0; i < count; ++i)
+        commands[i] = _sortEntries[i].command;
+}
+
+ssize_t RenderQueue::mergeBatches()
+{
+    ssize_t mergedBatches = 0;
+    for (int group : {QUEUE_GROUP::GLOBALZ_NEG, QUEUE_GROUP::GLOBALZ_ZERO, QUEUE_GROUP::GLOBALZ_POS})
+    {
+        auto& commands = _commands[group];
+        size_t begin = 0;
+        while (begin < commands.size())
+        {
+            // the batchable commands with the same global Z order, up to a command that can't be batched
+            const float globalOrder = commands[begin]->getGlobalOrder();
+            size_t end = begin;
+            while (end < commands.size() && isMergeableCommand(commands[end]) && commands[end]->getGlobalOrder() == globalOrder)
+                ++end;
+
+            if (end - begin > 2)
+                mergedBatches += mergeBatches(commands, begin, end);
+            begin = std::max(end, begin + 1);
+        }
+    }
+    return mergedBatches;
+}
+
+ssize_t RenderQueue::mergeBatches(std::vector<RenderCommand*>& commands, size_t begin, size_t end)
+{
+    // the rank of a command is the first appearance of its material, so the first batch stays first
+    _mergedMaterials.clear();
+    _sortEntries.resize(end - begin);
+    ssize_t batchesBefore = 0;
+    uint32_t prevMaterialID = 0;
+    for (size_t i = begin; i < end; ++i)
+    {
+        const uint32_t materialID = static_cast<TrianglesCommand*>(commands[i])->getMaterialID();
+        if (i == begin || materialID != prevMaterialID)
+            ++batchesBefore;
+        prevMaterialID = materialID;
+
+        auto found = std::find(_mergedMaterials.begin(), _mergedMaterials.end(), materialID);
+        if (found == _mergedMaterials.end())
+        {
+            // too many materials for one digit of the radix sort, keep the order
+            if (_mergedMaterials.size() == MAX_MERGED_MATERIALS)
+                return 0;
+            found = _mergedMaterials.insert(_mergedMaterials.end(), materialID);
+        }
+
+        _sortEntries[i - begin] = {makeSortKey(0, 0, (uint32_t) (found - _mergedMaterials.begin())), commands[i]};
+    }
+
+    // nothing to merge when every material already makes a single batch
+    const ssize_t batchesAfter = _mergedMaterials.size();
+    if (batchesAfter == batchesBefore)
+        return 0;
+
+    radixSort(commands.data() + begin, 0, 8);
+    return batchesBefore - batchesAfter;
 }
 
 RenderCommand* RenderQueue::operator[](ssize_t index) const
@@ -194,18 +329,62 @@ void RenderQueue::restoreRenderState()
 //
 static const int DEFAULT_RENDER_QUEUE = 0;
 
+// Copies the indices of a command, adding the offset of its first vertex, eight at a time when possible
+static void offsetIndices(const unsigned short* src, GLushort* dst, ssize_t count, GLushort offset)
+{
+    ssize_t i = 0;
+#if defined(__SSE2__)
+    const __m128i delta = _mm_set1_epi16((short) offset);
+    for (; i + 8 <= count; i += 8)
+    {
+        _mm_storeu_si128((__m128i*) (dst + i), _mm_add_epi16(_mm_loadu_si128((const __m128i*) (src + i)), delta));
+    }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+    const uint16x8_t delta = vdupq_n_u16(offset);
+    for (; i + 8 <= count; i += 8)
+    {
+        vst1q_u16(dst + i, vaddq_u16(vld1q_u16(src + i), delta));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        dst[i] = offset + src[i];
+    }
+}
+
 //
 // constructors, destructor, init
 //
 Renderer::Renderer()
 :_lastBatchedMeshCommand(nullptr)
+,_useStreamBuffers(false)
+,_useStreamFences(false)
+,_segmentVertexBase(0)
+,_isParallelFillEnabled(false)
 ,_triBatchesToDrawCapacity(-1)
 ,_triBatchesToDraw(nullptr)
 ,_filledVertex(0)
 ,_filledIndex(0)
+,_isGPUTransformEnabled(false)
+,_gpuTransformVAO(0)
+,_gpuTransformProgram(nullptr)
+,_gpuTransformSourceProgram(nullptr)
+,_gpuTransformValidVertex(0)
+,_gpuTransformValidIndex(0)
+,_gpuTransformVertexBase(0)
+,_gpuTransformIndexBase(0)
+,_dirtyVertexBegin(0)
+,_dirtyVertexEnd(0)
+,_dirtyIndexBegin(0)
+,_dirtyIndexEnd(0)
 ,_glViewAssigned(false)
+,_uploadedBytes(0)
+,_mergedBatches(0)
+,_isBatchMergingEnabled(false)
 ,_isRendering(false)
 ,_isDepthTestFor2D(false)
+,_capturedCommands(nullptr)
+,_captureRenderQueueID(DEFAULT_RENDER_QUEUE)
 #if CC_ENABLE_CACHE_TEXTURE_DATA
 ,_cacheTextureListener(nullptr)
 #endif
@@ -217,6 +396,10 @@ Renderer::Renderer()
     RenderQueue defaultRenderQueue;
     _renderGroups.push_back(defaultRenderQueue);
     _queuedTriangleCommands.reserve(BATCH_TRIAGCOMMAND_RESERVED_SIZE);
+    _trianglesToFill.reserve(BATCH_TRIAGCOMMAND_RESERVED_SIZE);
+
+    _verts.resize(VBO_SIZE);
+    _indices.resize(INDEX_VBO_SIZE);
 
     // default clear color
     _clearColor = Color4F::BLACK;
@@ -224,6 +407,11 @@ Renderer::Renderer()
     // for the batched TriangleCommand
     _triBatchesToDrawCapacity = 500;
     _triBatchesToDraw = (TriBatchToDraw*) malloc(sizeof(_triBatchesToDraw[0]) * _triBatchesToDrawCapacity);
+
+    _gpuTransformVBO[0] = _gpuTransformVBO[1] = _gpuTransformVBO[2] = 0;
+
+    memset(&_vertexStream, 0, sizeof(_vertexStream));
+    memset(&_indexStream, 0, sizeof(_indexStream));
 }
 
 Renderer::~Renderer()
@@ -235,11 +423,26 @@ Renderer::~Renderer()
 
     free(_triBatchesToDraw);
 
+    while (_vertexStream.framesInFlight > 0)
+        releaseStreamFrame(_vertexStream);
+    while (_indexStream.framesInFlight > 0)
+        releaseStreamFrame(_indexStream);
+
     if (Configuration::getInstance()->supportsShareableVAO())
     {
         glDeleteVertexArrays(1, &_buffersVAO);
         GL::bindVAO(0);
     }
+
+    if (_gpuTransformVBO[0])
+    {
+        glDeleteBuffers(3, _gpuTransformVBO);
+    }
+    if (_gpuTransformVAO)
+    {
+        glDeleteVertexArrays(1, &_gpuTransformVAO);
+        GL::bindVAO(0);
+    }
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     Director::getInstance()->getEventDispatcher()->removeEventListener(_cacheTextureListener);
 #endif
@@ -263,7 +466,13 @@ void Renderer::initGLView()
 
 void Renderer::setupBuffer()
 {
-    if(Configuration::getInstance()->supportsShareableVAO())
+    auto conf = Configuration::getInstance();
+#if CC_RENDERER_STREAM_BUFFER_SUPPORTED
+    _useStreamBuffers = conf->supportsShareableVAO() && conf->supportsMapBufferRange();
+    _useStreamFences = conf->supportsFenceSync();
+#endif
+
+    if(conf->supportsShareableVAO())
     {
         setupVBOAndVAO();
     }
@@ -271,6 +480,11 @@ void Renderer::setupBuffer()
     {
         setupVBO();
     }
+
+    if (_isGPUTransformEnabled)
+    {
+        setupGPUTransformBuffers();
+    }
 }
 
 void Renderer::setupVBOAndVAO()
@@ -304,16 +518,147 @@ void Renderer::setupVBOAndVAO()
     glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, texCoords));
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * INDEX_VBO_SIZE, _indices, GL_STATIC_DRAW);
+    if (!_useStreamBuffers)
+    {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * INDEX_VBO_SIZE, _indices.data(), GL_STATIC_DRAW);
+    }
 
     // Must unbind the VAO before changing the element buffer.
     GL::bindVAO(0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
+    if (_useStreamBuffers)
+    {
+        setupStreamBuffers();
+    }
+
     CHECK_GL_ERROR_DEBUG();
 }
 
+void Renderer::setupStreamBuffers()
+{
+    // the frames in flight belonged to the previous GL context, if any
+    _vertexStream.framesInFlight = 0;
+    _indexStream.framesInFlight = 0;
+
+    _vertexStream.target = GL_ARRAY_BUFFER;
+    _vertexStream.buffer = _buffersVBO[0];
+    _indexStream.target = GL_ELEMENT_ARRAY_BUFFER;
+    _indexStream.buffer = _buffersVBO[1];
+
+    // they grow when a frame needs more
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexStream.buffer);
+    resetStreamBuffer(_vertexStream, sizeof(_verts[0]) * VBO_SIZE);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexStream.buffer);
+    resetStreamBuffer(_indexStream, sizeof(_indices[0]) * INDEX_VBO_SIZE);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+void Renderer::resetStreamBuffer(StreamBuffer& stream, GLsizeiptr capacity)
+{
+    // Wait on the fences of the frames in flight, the GPU may still read the storage glBufferData replaces.
+    while (stream.framesInFlight > 0)
+        releaseStreamFrame(stream);
+
+    stream.capacity = capacity;
+    stream.head = 0;
+    stream.used = 0;
+    stream.frameBytes = 0;
+    glBufferData(stream.target, capacity, nullptr, GL_STREAM_DRAW);
+}
+
+void Renderer::releaseStreamFrame(StreamBuffer& stream)
+{
+    CCASSERT(stream.framesInFlight > 0, "No frame in flight");
+
+#if CC_RENDERER_STREAM_BUFFER_SUPPORTED
+    // wait until the GPU is done with the oldest frame
+    GLsync fence = (GLsync) stream.frameFences[0];
+    GLenum result;
+    do
+    {
+        result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+    } while (result == GL_TIMEOUT_EXPIRED);
+    glDeleteSync(fence);
+#endif
+
+    stream.used -= stream.frameSizes[0];
+    stream.framesInFlight--;
+    for (int i = 0; i < stream.framesInFlight; ++i)
+    {
+        stream.frameFences[i] = stream.frameFences[i + 1];
+        stream.frameSizes[i] = stream.frameSizes[i + 1];
+    }
+}
+
+void Renderer::nextStreamFrame(StreamBuffer& stream)
+{
+    if (stream.frameBytes == 0)
+        return;
+
+    if (!_useStreamFences)
+    {
+        // nothing tells when the GPU is done with it, orphan the memory instead
+        glBindBuffer(stream.target, stream.buffer);
+        resetStreamBuffer(stream, stream.capacity);
+        glBindBuffer(stream.target, 0);
+        return;
+    }
+
+#if CC_RENDERER_STREAM_BUFFER_SUPPORTED
+    if (stream.framesInFlight == STREAM_BUFFER_FRAMES)
+        releaseStreamFrame(stream);
+
+    stream.frameFences[stream.framesInFlight] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    stream.frameSizes[stream.framesInFlight] = stream.frameBytes;
+    stream.framesInFlight++;
+    stream.frameBytes = 0;
+#endif
+}
+
+GLintptr Renderer::streamData(StreamBuffer& stream, const void* data, GLsizeiptr size)
+{
+    // keep the offsets aligned for the attribute pointers
+    const GLsizeiptr alignedSize = (size + 3) & ~3;
+
+    glBindBuffer(stream.target, stream.buffer);
+
+    // data doesn't wrap around, the end of the buffer is skipped when it doesn't fit there
+    GLsizeiptr skipped = stream.head + alignedSize > stream.capacity ? stream.capacity - stream.head : 0;
+    while (stream.capacity - stream.used < skipped + alignedSize)
+    {
+        if (stream.framesInFlight == 0)
+        {
+            // the current frame alone doesn't fit, grow
+            resetStreamBuffer(stream, std::max(stream.capacity * 2, alignedSize));
+            skipped = 0;
+            break;
+        }
+        releaseStreamFrame(stream);
+    }
+
+    if (skipped > 0)
+        stream.head = 0;
+    const GLintptr offset = stream.head;
+
+#if CC_RENDERER_STREAM_BUFFER_SUPPORTED
+    // the range isn't used by any frame in flight, don't let the driver synchronize
+    void* buf = glMapBufferRange(stream.target, offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    memcpy(buf, data, size);
+    glUnmapBuffer(stream.target);
+#endif
+
+    stream.head += alignedSize;
+    stream.used += skipped + alignedSize;
+    stream.frameBytes += skipped + alignedSize;
+    _uploadedBytes += size;
+
+    return offset;
+}
+
 void Renderer::setupVBO()
 {
     glGenBuffers(2, &_buffersVBO[0]);
@@ -333,19 +678,87 @@ void Renderer::mapBuffers()
     GL::bindVAO(0);
 
     glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * VBO_SIZE, _verts, GL_DYNAMIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * VBO_SIZE, _verts.data(), GL_DYNAMIC_DRAW);
     
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * INDEX_VBO_SIZE, _indices, GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * INDEX_VBO_SIZE, _indices.data(), GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    CHECK_GL_ERROR_DEBUG();
+}
+
+void Renderer::setupGPUTransformBuffers()
+{
+    auto glProgramCache = GLProgramCache::getInstance();
+    _gpuTransformProgram = glProgramCache->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_GPU_TRANSFORM);
+    _gpuTransformSourceProgram = glProgramCache->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP);
+
+    _matrixIndices.resize(VBO_SIZE);
+    _transformPalette.reserve(GPU_TRANSFORM_PALETTE_SIZE * 3);
+
+    // Unlike the VBO of setupVBOAndVAO() (see Issue #15652), these buffers are allocated once with
+    // their full size: afterwards only the ranges which changed since the last frame are uploaded.
+    GL::bindVAO(0);
+    glGenBuffers(3, &_gpuTransformVBO[0]);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _gpuTransformVBO[0]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * VBO_SIZE, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, _gpuTransformVBO[1]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_matrixIndices[0]) * VBO_SIZE, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _gpuTransformVBO[2]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * INDEX_VBO_SIZE, nullptr, GL_DYNAMIC_DRAW);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
+    if (Configuration::getInstance()->supportsShareableVAO())
+    {
+        glGenVertexArrays(1, &_gpuTransformVAO);
+        GL::bindVAO(_gpuTransformVAO);
+
+        // attribute pointers are set by every flush, the vertices of a flush don't start at offset 0
+        glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
+        glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_COLOR);
+        glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORD);
+        glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_BLEND_INDEX);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _gpuTransformVBO[2]);
+
+        // Must unbind the VAO before changing the element buffer.
+        GL::bindVAO(0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+
+    // nothing has been uploaded yet
+    _gpuTransformValidVertex = 0;
+    _gpuTransformValidIndex = 0;
+    _gpuTransformVertexBase = 0;
+    _gpuTransformIndexBase = 0;
+
     CHECK_GL_ERROR_DEBUG();
 }
 
+void Renderer::setGPUTransformEnabled(bool enabled)
+{
+    CCASSERT(!_isRendering, "Cannot change the transform mode while rendering");
+    if (_isGPUTransformEnabled == enabled)
+        return;
+
+    _isGPUTransformEnabled = enabled;
+
+    // _verts/_indices were filled by the other mode meanwhile
+    _gpuTransformValidVertex = 0;
+    _gpuTransformValidIndex = 0;
+
+    if (enabled && _glViewAssigned && _gpuTransformVBO[0] == 0)
+    {
+        setupGPUTransformBuffers();
+    }
+}
+
 void Renderer::addCommand(RenderCommand* command)
 {
     int renderQueueID =_commandGroupStack.top();
@@ -358,6 +771,12 @@ void Renderer::addCommand(RenderCommand* command, int renderQueueID)
     CCASSERT(renderQueueID >=0, "Invalid render queue");
     CCASSERT(command->getType() != RenderCommand::Type::UNKNOWN_COMMAND, "Invalid Command Type");
 
+    if (_capturedCommands && renderQueueID == _captureRenderQueueID)
+    {
+        _capturedCommands->push_back(command);
+        return;
+    }
+
     _renderGroups[renderQueueID].push_back(command);
 }
 
@@ -373,6 +792,19 @@ void Renderer::popGroup()
     _commandGroupStack.pop();
 }
 
+void Renderer::beginCommandCapture(std::vector<RenderCommand*>* commands)
+{
+    CCASSERT(!_isRendering, "Cannot capture commands while rendering");
+    CCASSERT(_capturedCommands == nullptr, "Already capturing commands");
+    _capturedCommands = commands;
+    _captureRenderQueueID = _commandGroupStack.top();
+}
+
+void Renderer::endCommandCapture()
+{
+    _capturedCommands = nullptr;
+}
+
 int Renderer::createRenderQueue()
 {
     RenderQueue newRenderQueue;
@@ -390,8 +822,9 @@ void Renderer::processRenderCommand(RenderCommand* command)
 
         auto cmd = static_cast<TrianglesCommand*>(command);
         
-        // flush own queue when buffer is full
-        if(_filledVertex + cmd->getVertexCount() > VBO_SIZE || _filledIndex + cmd->getIndexCount() > INDEX_VBO_SIZE)
+        // flush own queue when buffer is full, streamed buffers are split in segments instead
+        const bool bufferLimited = !_useStreamBuffers || _isGPUTransformEnabled;
+        if(bufferLimited && (_filledVertex + cmd->getVertexCount() > VBO_SIZE || _filledIndex + cmd->getIndexCount() > INDEX_VBO_SIZE))
         {
             CCASSERT(cmd->getVertexCount()>= 0 && cmd->getVertexCount() < VBO_SIZE, "VBO for vertex is not big enough, please break the data down or use customized render command");
             CCASSERT(cmd->getIndexCount()>= 0 && cmd->getIndexCount() < INDEX_VBO_SIZE, "VBO for index is not big enough, please break the data down or use customized render command");
@@ -644,6 +1077,8 @@ void Renderer::render()
         for (auto &renderqueue : _renderGroups)
         {
             renderqueue.sort();
+            if (_isBatchMergingEnabled)
+                _mergedBatches += renderqueue.mergeBatches();
         }
         visitRenderQueue(_renderGroups[0]);
     }
@@ -669,10 +1104,23 @@ void Renderer::clean()
     _filledVertex = 0;
     _filledIndex = 0;
     _lastBatchedMeshCommand = nullptr;
+
+    // next frame writes its vertices at the same place, so that unchanged ones needn't be uploaded
+    _gpuTransformVertexBase = 0;
+    _gpuTransformIndexBase = 0;
 }
 
 void Renderer::clear()
 {
+    // Director clears once per frame: the streamed data of the previous frame is complete
+    if (_useStreamBuffers)
+    {
+        // Avoid changing the element buffer for whatever VAO might be bound.
+        GL::bindVAO(0);
+        nextStreamFrame(_vertexStream);
+        nextStreamFrame(_indexStream);
+    }
+
     //Enable Depth mask to make sure glClear clear the depth buffer correctly
     glDepthMask(true);
     glClearColor(_clearColor.r, _clearColor.g, _clearColor.b, _clearColor.a);
@@ -706,26 +1154,153 @@ void Renderer::setDepthTest(bool enable)
     CHECK_GL_ERROR_DEBUG();
 }
 
-void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd)
+void Renderer::fillVerticesAndIndices(const TrianglesToFill& fill)
 {
-    memcpy(&_verts[_filledVertex], cmd->getVertices(), sizeof(V3F_C4B_T2F) * cmd->getVertexCount());
+    const TrianglesCommand* cmd = fill.cmd;
+    V3F_C4B_T2F* verts = &_verts[fill.vertexStart];
+    memcpy(verts, cmd->getVertices(), sizeof(V3F_C4B_T2F) * cmd->getVertexCount());
 
     // fill vertex, and convert them to world coordinates
-    const Mat4& modelView = cmd->getModelView();
-    for(ssize_t i=0; i < cmd->getVertexCount(); ++i)
+    cmd->getModelView().transformPoints(&verts->vertices, &verts->vertices, cmd->getVertexCount(), sizeof(V3F_C4B_T2F));
+
+    // fill index, relative to the segment
+    offsetIndices(cmd->getIndices(), &_indices[fill.indexStart], cmd->getIndexCount(), fill.vertexStart - fill.segmentVertexBase);
+}
+
+void Renderer::fillQueuedTriangles()
+{
+    const size_t fillCount = _trianglesToFill.size();
+    auto jobSystem = JobSystem::getInstance();
+    const unsigned int threadCount = std::min(4u, jobSystem->getWorkerCount());
+    if (!_isParallelFillEnabled || _filledVertex < PARALLEL_FILL_MIN_VERTICES || threadCount < 2)
+    {
+        for (const auto& fill : _trianglesToFill)
+            fillVerticesAndIndices(fill);
+        return;
+    }
+
+    // every range gets about the same number of vertices, they don't overlap in _verts/_indices
+    const int verticesPerRange = _filledVertex / threadCount + 1;
+    auto fillRange = [this](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            fillVerticesAndIndices(_trianglesToFill[i]);
+    };
+
+    std::vector<JobSystem::JobHandle> workers;
+    size_t firstRangeEnd = 0;
+    size_t begin = 0;
+    while (begin < fillCount)
+    {
+        size_t end = begin;
+        int vertices = 0;
+        while (end < fillCount && vertices < verticesPerRange)
+        {
+            vertices += (int) _trianglesToFill[end].cmd->getVertexCount();
+            ++end;
+        }
+
+        // the first range is filled by this thread
+        if (begin == 0)
+            firstRangeEnd = end;
+        else
+            workers.push_back(jobSystem->schedule(std::bind(fillRange, begin, end), nullptr, JobSystem::Priority::HIGH));
+        begin = end;
+    }
+
+    fillRange(0, firstRangeEnd);
+    for (auto& worker : workers)
+        jobSystem->wait(worker);
+}
+
+bool Renderer::canTransformOnGPU(const TrianglesCommand* cmd) const
+{
+    // Only the default sprite program has a GPU transform counterpart,
+    // and custom uniforms would be lost when replacing the program.
+    auto glProgramState = cmd->getGLProgramState();
+    return glProgramState->getGLProgram() == _gpuTransformSourceProgram && glProgramState->getUniformCount() == 0;
+}
+
+void Renderer::fillVerticesAndIndicesForGPUTransform(const TrianglesCommand* cmd, int matrixIndex)
+{
+    const int vertexCount = (int) cmd->getVertexCount();
+    const int indexCount = (int) cmd->getIndexCount();
+    const int vertexStart = _gpuTransformVertexBase + _filledVertex;
+    const int indexStart = _gpuTransformIndexBase + _filledIndex;
+    V3F_C4B_T2F* verts = &_verts[vertexStart];
+    GLfloat* matrixIndices = &_matrixIndices[vertexStart];
+    GLushort* indices = &_indices[indexStart];
+
+    // fill vertex, they are only copied (and uploaded) when different from what is in the buffer already
+    bool vertsChanged = vertexStart + vertexCount > _gpuTransformValidVertex;
+    if (matrixIndex < 0)
+    {
+        // not drawn with the GPU transform program, convert them to world coordinates as fillVerticesAndIndices() does
+        memcpy(verts, cmd->getVertices(), sizeof(V3F_C4B_T2F) * vertexCount);
+        cmd->getModelView().transformPoints(&verts->vertices, &verts->vertices, vertexCount, sizeof(V3F_C4B_T2F));
+        matrixIndex = 0;
+        vertsChanged = true;
+    }
+    else if (vertsChanged || memcmp(verts, cmd->getVertices(), sizeof(V3F_C4B_T2F) * vertexCount) != 0)
+    {
+        memcpy(verts, cmd->getVertices(), sizeof(V3F_C4B_T2F) * vertexCount);
+        vertsChanged = true;
+    }
+
+    const GLfloat index = (GLfloat) matrixIndex;
+    for (int i = 0; i < vertexCount; ++i)
+    {
+        if (matrixIndices[i] != index)
+        {
+            matrixIndices[i] = index;
+            vertsChanged = true;
+        }
+    }
+
+    if (vertsChanged)
     {
-        modelView.transformPoint(&(_verts[i + _filledVertex].vertices));
+        _dirtyVertexBegin = std::min(_dirtyVertexBegin, vertexStart);
+        _dirtyVertexEnd = std::max(_dirtyVertexEnd, vertexStart + vertexCount);
     }
 
     // fill index
-    const unsigned short* indices = cmd->getIndices();
-    for(ssize_t i=0; i< cmd->getIndexCount(); ++i)
+    bool indicesChanged = indexStart + indexCount > _gpuTransformValidIndex;
+    const unsigned short* cmdIndices = cmd->getIndices();
+    for (int i = 0; i < indexCount; ++i)
     {
-        _indices[_filledIndex + i] = _filledVertex + indices[i];
+        const GLushort value = _filledVertex + cmdIndices[i];
+        if (indices[i] != value)
+        {
+            indices[i] = value;
+            indicesChanged = true;
+        }
     }
 
-    _filledVertex += cmd->getVertexCount();
-    _filledIndex += cmd->getIndexCount();
+    if (indicesChanged)
+    {
+        _dirtyIndexBegin = std::min(_dirtyIndexBegin, indexStart);
+        _dirtyIndexEnd = std::max(_dirtyIndexEnd, indexStart + indexCount);
+    }
+
+    _filledVertex += vertexCount;
+    _filledIndex += indexCount;
+}
+
+void Renderer::useGPUTransformMaterial(const TrianglesCommand* cmd, int paletteOffset, int paletteCount)
+{
+    //Set texture
+    GL::bindTexture2D(cmd->getTextureID());
+
+    //set blend mode
+    const BlendFunc& blendType = cmd->getBlendType();
+    GL::blendFunc(blendType.src, blendType.dst);
+
+    // the model-view matrices come from the palette, only the projection is needed
+    _gpuTransformProgram->use();
+    _gpuTransformProgram->setUniformsForBuiltins(Mat4::IDENTITY);
+
+    auto palette = _gpuTransformProgram->getUniform("u_matrixPalette");
+    CCASSERT(palette, "Invalid GPU transform program");
+    _gpuTransformProgram->setUniformLocationWith4fv(palette->location, (const GLfloat*) &_transformPalette[paletteOffset * 3], paletteCount * 3);
 }
 
 void Renderer::drawBatchedTriangles()
@@ -733,15 +1308,29 @@ void Renderer::drawBatchedTriangles()
     if(_queuedTriangleCommands.empty())
         return;
 
+    if (_isGPUTransformEnabled)
+    {
+        drawBatchedTrianglesWithGPUTransform();
+        return;
+    }
+
     CCGL_DEBUG_INSERT_EVENT_MARKER("RENDERER_BATCH_TRIANGLES");
 
+    // _filledVertex/_filledIndex are the totals of the queued commands
+    if (_verts.size() < (size_t) _filledVertex)
+        _verts.resize(_filledVertex);
+    if (_indices.size() < (size_t) _filledIndex)
+        _indices.resize(_filledIndex);
+
     _filledVertex = 0;
     _filledIndex = 0;
+    _segmentVertexBase = 0;
 
     /************** 1: Setup up vertices/indices *************/
 
     _triBatchesToDraw[0].offset = 0;
     _triBatchesToDraw[0].indicesToDraw = 0;
+    _triBatchesToDraw[0].vertexBase = 0;
     _triBatchesToDraw[0].cmd = nullptr;
 
     int batchesTotal = 0;
@@ -753,10 +1342,18 @@ void Renderer::drawBatchedTriangles()
         auto currentMaterialID = cmd->getMaterialID();
         const bool batchable = !cmd->isSkipBatching();
 
-        fillVerticesAndIndices(cmd);
+        // 16 bits indices can't address more than VBO_SIZE vertices, start a new segment
+        const bool newSegment = _filledVertex - _segmentVertexBase + cmd->getVertexCount() > VBO_SIZE;
+        if (newSegment)
+            _segmentVertexBase = _filledVertex;
+
+        // the vertices/indices are filled once all the batches are known
+        _trianglesToFill.push_back({cmd, _filledVertex, _filledIndex, _segmentVertexBase});
+        _filledVertex += cmd->getVertexCount();
+        _filledIndex += cmd->getIndexCount();
 
         // in the same batch ?
-        if (batchable && (prevMaterialID == currentMaterialID || firstCommand))
+        if (batchable && !newSegment && (prevMaterialID == currentMaterialID || firstCommand))
         {
             CC_ASSERT((firstCommand || _triBatchesToDraw[batchesTotal].cmd->getMaterialID() == cmd->getMaterialID()) && "argh... error in logic");
             _triBatchesToDraw[batchesTotal].indicesToDraw += cmd->getIndexCount();
@@ -772,6 +1369,7 @@ void Renderer::drawBatchedTriangles()
 
             _triBatchesToDraw[batchesTotal].cmd = cmd;
             _triBatchesToDraw[batchesTotal].indicesToDraw = (int) cmd->getIndexCount();
+            _triBatchesToDraw[batchesTotal].vertexBase = _segmentVertexBase;
 
             // is this a single batch ? Prevent creating a batch group then
             if (!batchable)
@@ -789,9 +1387,23 @@ void Renderer::drawBatchedTriangles()
     }
     batchesTotal++;
 
+    fillQueuedTriangles();
+    _trianglesToFill.clear();
+
     /************** 2: Copy vertices/indices to GL objects *************/
     auto conf = Configuration::getInstance();
-    if (conf->supportsShareableVAO() && conf->supportsMapBuffer())
+    GLintptr vertexOffset = 0;
+    GLintptr indexOffset = 0;
+    if (_useStreamBuffers)
+    {
+        //Bind VAO, the element buffer is bound to it
+        GL::bindVAO(_buffersVAO);
+
+        // option 4: ring buffers, appended with unsynchronized glMapBufferRange
+        vertexOffset = streamData(_vertexStream, _verts.data(), sizeof(_verts[0]) * _filledVertex);
+        indexOffset = streamData(_indexStream, _indices.data(), sizeof(_indices[0]) * _filledIndex);
+    }
+    else if (conf->supportsShareableVAO() && conf->supportsMapBuffer())
     {
         //Bind VAO
         GL::bindVAO(_buffersVAO);
@@ -810,13 +1422,15 @@ void Renderer::drawBatchedTriangles()
         // so most probably we won't have any benefit of using it
         glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * _filledVertex, nullptr, GL_STATIC_DRAW);
         void *buf = glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
-        memcpy(buf, _verts, sizeof(_verts[0]) * _filledVertex);
+        memcpy(buf, _verts.data(), sizeof(_verts[0]) * _filledVertex);
         glUnmapBuffer(GL_ARRAY_BUFFER);
 
         glBindBuffer(GL_ARRAY_BUFFER, 0);
         
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * _filledIndex, _indices, GL_STATIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * _filledIndex, _indices.data(), GL_STATIC_DRAW);
+
+        _uploadedBytes += sizeof(_verts[0]) * _filledVertex + sizeof(_indices[0]) * _filledIndex;
     }
     else
     {
@@ -824,7 +1438,7 @@ void Renderer::drawBatchedTriangles()
 #define kQuadSize sizeof(_verts[0])
         glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
 
-        glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * _filledVertex , _verts, GL_DYNAMIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * _filledVertex , _verts.data(), GL_DYNAMIC_DRAW);
 
         GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
 
@@ -838,21 +1452,41 @@ void Renderer::drawBatchedTriangles()
         glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, texCoords));
 
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * _filledIndex, _indices, GL_STATIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * _filledIndex, _indices.data(), GL_STATIC_DRAW);
+
+        _uploadedBytes += sizeof(_verts[0]) * _filledVertex + sizeof(_indices[0]) * _filledIndex;
     }
 
     /************** 3: Draw *************/
+    GLsizei currentVertexBase = -1;
     for (int i=0; i<batchesTotal; ++i)
     {
         CC_ASSERT(_triBatchesToDraw[i].cmd && "Invalid batch");
+
+        // streamed vertices don't start at offset 0, and each segment has its own start
+        if (_useStreamBuffers && _triBatchesToDraw[i].vertexBase != currentVertexBase)
+        {
+            currentVertexBase = _triBatchesToDraw[i].vertexBase;
+            const GLintptr segmentOffset = vertexOffset + sizeof(_verts[0]) * currentVertexBase;
+
+            glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+            // vertices
+            glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) (segmentOffset + offsetof(V3F_C4B_T2F, vertices)));
+            // colors
+            glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid*) (segmentOffset + offsetof(V3F_C4B_T2F, colors)));
+            // tex coords
+            glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) (segmentOffset + offsetof(V3F_C4B_T2F, texCoords)));
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+
         _triBatchesToDraw[i].cmd->useMaterial();
-        glDrawElements(GL_TRIANGLES, (GLsizei) _triBatchesToDraw[i].indicesToDraw, GL_UNSIGNED_SHORT, (GLvoid*) (_triBatchesToDraw[i].offset*sizeof(_indices[0])) );
+        glDrawElements(GL_TRIANGLES, (GLsizei) _triBatchesToDraw[i].indicesToDraw, GL_UNSIGNED_SHORT, (GLvoid*) (indexOffset + _triBatchesToDraw[i].offset*sizeof(_indices[0])) );
         _drawnBatches++;
         _drawnVertices += _triBatchesToDraw[i].indicesToDraw;
     }
 
     /************** 4: Cleanup *************/
-    if (conf->supportsShareableVAO() && conf->supportsMapBuffer())
+    if (_useStreamBuffers || (conf->supportsShareableVAO() && conf->supportsMapBuffer()))
     {
         //Unbind VAO
         GL::bindVAO(0);
@@ -868,6 +1502,154 @@ void Renderer::drawBatchedTriangles()
     _filledIndex = 0;
 }
 
+void Renderer::drawBatchedTrianglesWithGPUTransform()
+{
+    CCGL_DEBUG_INSERT_EVENT_MARKER("RENDERER_BATCH_TRIANGLES_GPU_TRANSFORM");
+
+    // the flushes of a frame are kept one after the other in the buffers, start over when they are full
+    if (_gpuTransformVertexBase + _filledVertex > VBO_SIZE || _gpuTransformIndexBase + _filledIndex > INDEX_VBO_SIZE)
+    {
+        _gpuTransformVertexBase = 0;
+        _gpuTransformIndexBase = 0;
+    }
+
+    _filledVertex = 0;
+    _filledIndex = 0;
+    _dirtyVertexBegin = VBO_SIZE;
+    _dirtyVertexEnd = 0;
+    _dirtyIndexBegin = INDEX_VBO_SIZE;
+    _dirtyIndexEnd = 0;
+    _transformPalette.clear();
+
+    /************** 1: Setup up vertices/indices and the matrix palettes *************/
+
+    int batchesTotal = 0;
+    TriBatchToDraw* batch = nullptr;
+    const Mat4* prevModelView = nullptr;
+
+    for(const auto& cmd : _queuedTriangleCommands)
+    {
+        const bool onGPU = canTransformOnGPU(cmd);
+        const Mat4& modelView = cmd->getModelView();
+
+        // commands with the same material share the batch as before, as long as their matrices fit in the palette
+        bool sameMatrix = onGPU && batch && batch->paletteCount > 0 && memcmp(prevModelView->m, modelView.m, sizeof(modelView.m)) == 0;
+        bool sameBatch = batch && !cmd->isSkipBatching() && !batch->cmd->isSkipBatching()
+            && batch->cmd->getMaterialID() == cmd->getMaterialID()
+            && (!onGPU || sameMatrix || batch->paletteCount < GPU_TRANSFORM_PALETTE_SIZE);
+
+        if (!sameBatch)
+        {
+            // capacity full ?
+            if (batchesTotal >= _triBatchesToDrawCapacity) {
+                _triBatchesToDrawCapacity *= 1.4;
+                _triBatchesToDraw = (TriBatchToDraw*) realloc(_triBatchesToDraw, sizeof(_triBatchesToDraw[0]) * _triBatchesToDrawCapacity);
+            }
+
+            batch = &_triBatchesToDraw[batchesTotal++];
+            batch->offset = _filledIndex;
+            batch->indicesToDraw = 0;
+            batch->paletteOffset = (int) _transformPalette.size() / 3;
+            batch->paletteCount = 0;
+            sameMatrix = false;
+        }
+
+        int matrixIndex = -1;
+        if (onGPU)
+        {
+            if (!sameMatrix)
+            {
+                // Mat4 is column major, the palette stores the first three rows
+                const float* m = modelView.m;
+                _transformPalette.push_back(Vec4(m[0], m[4], m[8], m[12]));
+                _transformPalette.push_back(Vec4(m[1], m[5], m[9], m[13]));
+                _transformPalette.push_back(Vec4(m[2], m[6], m[10], m[14]));
+                batch->paletteCount++;
+            }
+            matrixIndex = batch->paletteCount - 1;
+        }
+
+        fillVerticesAndIndicesForGPUTransform(cmd, matrixIndex);
+
+        batch->cmd = cmd;
+        batch->indicesToDraw += (GLsizei) cmd->getIndexCount();
+        prevModelView = &modelView;
+    }
+
+    /************** 2: Upload the modified vertices/indices to GL objects *************/
+    const bool useVAO = _gpuTransformVAO != 0;
+    if (useVAO)
+    {
+        GL::bindVAO(_gpuTransformVAO);
+    }
+    else
+    {
+        GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX | GL::VERTEX_ATTRIB_FLAG_BLEND_INDEX);
+    }
+
+    const bool vertsDirty = _dirtyVertexBegin < _dirtyVertexEnd;
+    const size_t vertexOffset = sizeof(_verts[0]) * _gpuTransformVertexBase;
+
+    glBindBuffer(GL_ARRAY_BUFFER, _gpuTransformVBO[0]);
+    if (vertsDirty)
+    {
+        glBufferSubData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * _dirtyVertexBegin, sizeof(_verts[0]) * (_dirtyVertexEnd - _dirtyVertexBegin), &_verts[_dirtyVertexBegin]);
+    }
+    // vertices
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) (vertexOffset + offsetof(V3F_C4B_T2F, vertices)));
+    // colors
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid*) (vertexOffset + offsetof(V3F_C4B_T2F, colors)));
+    // tex coords
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) (vertexOffset + offsetof(V3F_C4B_T2F, texCoords)));
+
+    glBindBuffer(GL_ARRAY_BUFFER, _gpuTransformVBO[1]);
+    if (vertsDirty)
+    {
+        glBufferSubData(GL_ARRAY_BUFFER, sizeof(_matrixIndices[0]) * _dirtyVertexBegin, sizeof(_matrixIndices[0]) * (_dirtyVertexEnd - _dirtyVertexBegin), &_matrixIndices[_dirtyVertexBegin]);
+    }
+    // matrix indices
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_BLEND_INDEX, 1, GL_FLOAT, GL_FALSE, sizeof(GLfloat), (GLvoid*) (sizeof(GLfloat) * _gpuTransformVertexBase));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _gpuTransformVBO[2]);
+    if (_dirtyIndexBegin < _dirtyIndexEnd)
+    {
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * _dirtyIndexBegin, sizeof(_indices[0]) * (_dirtyIndexEnd - _dirtyIndexBegin), &_indices[_dirtyIndexBegin]);
+    }
+
+    _gpuTransformValidVertex = std::max(_gpuTransformValidVertex, _gpuTransformVertexBase + _filledVertex);
+    _gpuTransformValidIndex = std::max(_gpuTransformValidIndex, _gpuTransformIndexBase + _filledIndex);
+
+    /************** 3: Draw *************/
+    for (int i=0; i<batchesTotal; ++i)
+    {
+        const auto& batchToDraw = _triBatchesToDraw[i];
+        CC_ASSERT(batchToDraw.cmd && "Invalid batch");
+        if (batchToDraw.paletteCount > 0)
+            useGPUTransformMaterial(batchToDraw.cmd, batchToDraw.paletteOffset, batchToDraw.paletteCount);
+        else
+            batchToDraw.cmd->useMaterial();
+        glDrawElements(GL_TRIANGLES, (GLsizei) batchToDraw.indicesToDraw, GL_UNSIGNED_SHORT, (GLvoid*) ((_gpuTransformIndexBase + batchToDraw.offset) * sizeof(_indices[0])) );
+        _drawnBatches++;
+        _drawnVertices += batchToDraw.indicesToDraw;
+    }
+
+    /************** 4: Cleanup *************/
+    if (useVAO)
+    {
+        //Unbind VAO
+        GL::bindVAO(0);
+    }
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    _gpuTransformVertexBase += _filledVertex;
+    _gpuTransformIndexBase += _filledIndex;
+
+    _queuedTriangleCommands.clear();
+    _filledVertex = 0;
+    _filledIndex = 0;
+}
+
 void Renderer::flush()
 {
     flush2D();
@@ -898,6 +1680,10 @@ void Renderer::flushTriangles()
 // helpers
 bool Renderer::checkVisibility(const Mat4 &transform, const Size &size)
 {
+    // a captured subtree is drawn again later from other positions, don't cull any part of it
+    if (_capturedCommands)
+        return true;
+
     auto director = Director::getInstance();
     auto scene = director->getRunningScene();
     
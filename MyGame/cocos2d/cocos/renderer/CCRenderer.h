@@ -52,6 +52,13 @@
 
 #endif
 
+// glMapBufferRange() and fence sync objects are only declared by the desktop OpenGL headers
+#if defined(GL_MAP_UNSYNCHRONIZED_BIT) && defined(GL_SYNC_GPU_COMMANDS_COMPLETE)
+#define CC_RENDERER_STREAM_BUFFER_SUPPORTED 1
+#else
+#define CC_RENDERER_STREAM_BUFFER_SUPPORTED 0
+#endif
+
 /**
  * @addtogroup renderer
  * @{
@@ -95,8 +102,15 @@ public:
     void push_back(RenderCommand* command);
     /**Return the number of render commands.*/
     ssize_t size() const;
-    /**Sort the render commands.*/
+    /**Sort the render commands, by global Z order, or by depth for transparent 3D objects.*/
     void sort();
+    /**
+     Reorder the sorted 2D commands that have the same global Z order so that TrianglesCommand sharing
+     a material ID are next to each other, and can be drawn in one batch.
+     Commands that can't be batched are never moved, nor crossed.
+     @return The number of batches saved.
+     */
+    ssize_t mergeBatches();
     /**Treat sorted commands as an array, access them one by one.*/
     RenderCommand* operator[](ssize_t index) const;
     /**Clear all rendered commands.*/
@@ -114,8 +128,24 @@ public:
     void restoreRenderState();
     
 protected:
+    /**A command with its sort key: queue group, global Z order or depth, and material rank.*/
+    struct SortEntry
+    {
+        uint64_t key;
+        RenderCommand* command;
+    };
+    /**Sort the commands by the bits [firstBit, lastBit) of their key, keeping the order of equal keys.*/
+    void radixSort(RenderCommand** commands, int firstBit, int lastBit);
+    /**Merge the batches of the commands in [begin, end), which are all batchable TrianglesCommand.*/
+    ssize_t mergeBatches(std::vector<RenderCommand*>& commands, size_t begin, size_t end);
+
     /**The commands in the render queue.*/
     std::vector<RenderCommand*> _commands[QUEUE_COUNT];
+    /**Contiguous keys of the commands being sorted, and the radix sort scratch buffer.*/
+    std::vector<SortEntry> _sortEntries;
+    std::vector<SortEntry> _sortBuffer;
+    /**First appearance of the materials of the commands being merged.*/
+    std::vector<uint32_t> _mergedMaterials;
     
     /**Cull state.*/
     bool _isCullEnabled;
@@ -141,7 +171,7 @@ Whenever possible prefer to use `TrianglesCommand` objects since the renderer wi
 class CC_DLL Renderer
 {
 public:
-    /**The max number of vertices in a vertex buffer object.*/
+    /**The max number of vertices in a vertex buffer object, or in one segment of a streamed vertex buffer since indices are 16 bits.*/
     static const int VBO_SIZE = 65536;
     /**The max number of indices in a index buffer.*/
     static const int INDEX_VBO_SIZE = VBO_SIZE * 6 / 4;
@@ -149,6 +179,12 @@ public:
     static const int BATCH_TRIAGCOMMAND_RESERVED_SIZE = 64;
     /**Reserved for material id, which means that the command could not be batched.*/
     static const int MATERIAL_ID_DO_NOT_BATCH = 0;
+    /**The max number of model-view matrices carried by one batch when transforming on GPU, must match the shader palette size.*/
+    static const int GPU_TRANSFORM_PALETTE_SIZE = 32;
+    /**The max number of frames whose vertices can be in flight in the streamed buffers.*/
+    static const int STREAM_BUFFER_FRAMES = 3;
+    /**The min number of batched vertices for the vertex fill to be split between several threads.*/
+    static const int PARALLEL_FILL_MIN_VERTICES = 16384;
     /**Constructor.*/
     Renderer();
     /**Destructor.*/
@@ -169,6 +205,19 @@ public:
     /** Pops a group from the render queue */
     void popGroup();
 
+    /**
+     * Collects the commands added to the current render queue into commands instead of queueing them,
+     * until endCommandCapture() is called. Commands added to other render queues are queued as usual.
+     * Culling is disabled while capturing, so everything is collected. Used by RetainedBatchNode.
+     */
+    void beginCommandCapture(std::vector<RenderCommand*>* commands);
+
+    /** Stops collecting the commands, see beginCommandCapture() */
+    void endCommandCapture();
+
+    /** Whether the commands are being collected, see beginCommandCapture() */
+    bool isCapturingCommands() const { return _capturedCommands != nullptr; }
+
     /** Creates a render queue and returns its Id */
     int createRenderQueue();
 
@@ -187,14 +236,18 @@ public:
     const Color4F& getClearColor() const { return _clearColor; };
     /* returns the number of drawn batches in the last frame */
     ssize_t getDrawnBatches() const { return _drawnBatches; }
+    /* returns the number of batches the last frame would have drawn without merging them, see setBatchMergingEnabled() */
+    ssize_t getDrawnBatchesBeforeMerging() const { return _drawnBatches + _mergedBatches; }
     /* RenderCommands (except) TrianglesCommand should update this value */
     void addDrawnBatches(ssize_t number) { _drawnBatches += number; };
     /* returns the number of drawn triangles in the last frame */
     ssize_t getDrawnVertices() const { return _drawnVertices; }
     /* RenderCommands (except) TrianglesCommand should update this value */
     void addDrawnVertices(ssize_t number) { _drawnVertices += number; };
+    /* returns the number of bytes of vertices and indices uploaded to the GPU in the last frame */
+    ssize_t getUploadedBytes() const { return _uploadedBytes; }
     /* clear draw stats */
-    void clearDrawStats() { _drawnBatches = _drawnVertices = 0; }
+    void clearDrawStats() { _drawnBatches = _drawnVertices = _uploadedBytes = _mergedBatches = 0; }
 
     /**
      * Enable/Disable depth test
@@ -209,6 +262,38 @@ public:
     /** returns whether or not a rectangle is visible or not */
     bool checkVisibility(const Mat4& transform, const Size& size);
 
+    /**
+     * Enable/Disable transforming the vertices of `TrianglesCommand` on the GPU.
+     * When enabled, commands drawn with the default position-texture-color program are uploaded
+     * untransformed and their model-view matrices travel with the batch as a matrix palette.
+     * Unchanged vertices are not uploaded again. Other commands are still transformed on the CPU.
+     * Batching by material ID is the same in both modes.
+     */
+    void setGPUTransformEnabled(bool enabled);
+    /** Whether the vertices of `TrianglesCommand` are transformed on the GPU or not */
+    bool isGPUTransformEnabled() const { return _isGPUTransformEnabled; }
+
+    /**
+     * Enable/Disable filling the vertices of batched `TrianglesCommand` on several threads.
+     * When a flush has more than PARALLEL_FILL_MIN_VERTICES vertices, the commands are split
+     * in ranges transformed by JobSystem workers, each one writing its own part of the buffers.
+     * Disabled by default.
+     */
+    void setParallelVertexFillEnabled(bool enabled) { _isParallelFillEnabled = enabled; }
+    /** Whether the vertices of batched `TrianglesCommand` are filled on several threads or not */
+    bool isParallelVertexFillEnabled() const { return _isParallelFillEnabled; }
+
+    /**
+     * Enable/Disable merging the batches of 2D `TrianglesCommand` that have the same global Z order.
+     * When enabled, the commands of a global Z order are reordered to put the ones with the same
+     * material ID next to each other, so overlapping sprites with the same global Z order may be
+     * drawn in a different order. Disabled by default.
+     * @see RenderQueue::mergeBatches(), getDrawnBatchesBeforeMerging()
+     */
+    void setBatchMergingEnabled(bool enabled) { _isBatchMergingEnabled = enabled; }
+    /** Whether the batches of 2D `TrianglesCommand` are merged or not */
+    bool isBatchMergingEnabled() const { return _isBatchMergingEnabled; }
+
 protected:
 
     //Setup VBO or VAO based on OpenGL extensions
@@ -216,7 +301,10 @@ protected:
     void setupVBOAndVAO();
     void setupVBO();
     void mapBuffers();
+    void setupGPUTransformBuffers();
+    void setupStreamBuffers();
     void drawBatchedTriangles();
+    void drawBatchedTrianglesWithGPUTransform();
 
     //Draw the previews queued triangles and flush previous context
     void flush();
@@ -230,7 +318,18 @@ protected:
     void processRenderCommand(RenderCommand* command);
     void visitRenderQueue(RenderQueue& queue);
 
-    void fillVerticesAndIndices(const TrianglesCommand* cmd);
+    // Internal structure that has where the vertices/indices of a command go
+    struct TrianglesToFill {
+        const TrianglesCommand* cmd;
+        int vertexStart;
+        int indexStart;
+        int segmentVertexBase;  // indices are relative to it
+    };
+    void fillVerticesAndIndices(const TrianglesToFill& fill);
+    void fillQueuedTriangles();
+    void fillVerticesAndIndicesForGPUTransform(const TrianglesCommand* cmd, int matrixIndex);
+    bool canTransformOnGPU(const TrianglesCommand* cmd) const;
+    void useGPUTransformMaterial(const TrianglesCommand* cmd, int paletteOffset, int paletteCount);
 
 
     /* clear color set outside be used in setGLDefaultValues() */
@@ -243,17 +342,50 @@ protected:
     MeshCommand* _lastBatchedMeshCommand;
     std::vector<TrianglesCommand*> _queuedTriangleCommands;
 
-    //for TrianglesCommand
-    V3F_C4B_T2F _verts[VBO_SIZE];
-    GLushort _indices[INDEX_VBO_SIZE];
+    //for TrianglesCommand, they grow beyond VBO_SIZE when the buffers are streamed
+    std::vector<V3F_C4B_T2F> _verts;
+    std::vector<GLushort> _indices;
     GLuint _buffersVAO;
     GLuint _buffersVBO[2]; //0: vertex  1: indices
 
+    // Ring buffer in a GL buffer object, written with unsynchronized glMapBufferRange().
+    // Memory of a frame is reused once its fence is signaled, or when the buffer is orphaned
+    // at the beginning of the next frame if fences aren't supported.
+    struct StreamBuffer {
+        GLenum target;
+        GLuint buffer;
+        GLsizeiptr capacity;
+        GLsizeiptr head;        // where the next data is written
+        GLsizeiptr used;        // bytes owned by the frames in flight, including the current one
+        GLsizeiptr frameBytes;  // bytes owned by the current frame
+        // frames in flight, oldest first
+        void* frameFences[STREAM_BUFFER_FRAMES];
+        GLsizeiptr frameSizes[STREAM_BUFFER_FRAMES];
+        int framesInFlight;
+    };
+    GLintptr streamData(StreamBuffer& stream, const void* data, GLsizeiptr size);
+    void nextStreamFrame(StreamBuffer& stream);
+    void releaseStreamFrame(StreamBuffer& stream);
+    void resetStreamBuffer(StreamBuffer& stream, GLsizeiptr capacity);
+
+    bool _useStreamBuffers;
+    bool _useStreamFences;
+    StreamBuffer _vertexStream;
+    StreamBuffer _indexStream;
+    // first vertex of the segment being filled, indices are relative to it
+    int _segmentVertexBase;
+    // the queued commands with their place in _verts/_indices, filled once the batches are known
+    std::vector<TrianglesToFill> _trianglesToFill;
+    bool _isParallelFillEnabled;
+
     // Internal structure that has the information for the batches
     struct TriBatchToDraw {
         TrianglesCommand* cmd;  // needed for the Material
         GLsizei indicesToDraw;
         GLsizei offset;
+        GLsizei vertexBase;     // first vertex of the segment of the batch
+        int paletteOffset;      // first matrix in _transformPalette, GPU transform only
+        int paletteCount;       // 0 when the vertices were transformed on the CPU
     };
     // capacity of the array of TriBatches
     int _triBatchesToDrawCapacity;
@@ -263,15 +395,44 @@ protected:
     int _filledVertex;
     int _filledIndex;
 
+    // for TrianglesCommand transformed on GPU
+    bool _isGPUTransformEnabled;
+    GLuint _gpuTransformVAO;
+    GLuint _gpuTransformVBO[3]; //0: vertex  1: matrix index  2: indices
+    // the program that replaces _gpuTransformSourceProgram
+    GLProgram* _gpuTransformProgram;
+    GLProgram* _gpuTransformSourceProgram;
+    // vertices/indices below these marks are known to be the same in _verts/_indices and in the GPU buffers
+    int _gpuTransformValidVertex;
+    int _gpuTransformValidIndex;
+    // position in the GPU buffers where the current flush starts, advanced by every flush in a frame
+    int _gpuTransformVertexBase;
+    int _gpuTransformIndexBase;
+    // range of _verts/_indices modified since the last upload
+    int _dirtyVertexBegin;
+    int _dirtyVertexEnd;
+    int _dirtyIndexBegin;
+    int _dirtyIndexEnd;
+    std::vector<GLfloat> _matrixIndices;
+    // three rows per model-view matrix
+    std::vector<Vec4> _transformPalette;
+
     bool _glViewAssigned;
 
     // stats
     ssize_t _drawnBatches;
     ssize_t _drawnVertices;
+    ssize_t _uploadedBytes;
+    ssize_t _mergedBatches;
+    bool _isBatchMergingEnabled;
     //the flag for checking whether renderer is rendering
     bool _isRendering;
     
     bool _isDepthTestFor2D;
+
+    // where the commands go while capturing, see beginCommandCapture()
+    std::vector<RenderCommand*>* _capturedCommands;
+    int _captureRenderQueueID;
     
     GroupCommandManager* _groupCommandManager;
     
@@ -109,6 +109,42 @@ namespace {
             0xFFFFFFFF, 0xFFFFFFFF, 8, true, false)),
 #endif
     };
+
+    // The converted pixels are uploaded right away, so each thread reuses one buffer for the conversions
+    // instead of allocating one per texture. The buffer of a huge texture isn't kept around.
+    const size_t MAX_KEPT_CONVERT_BUFFER_SIZE = 4 * 1024 * 1024;
+
+    struct ConvertBuffer
+    {
+        unsigned char* bytes;
+        size_t capacity;
+
+        ConvertBuffer() : bytes(nullptr), capacity(0) {}
+        ~ConvertBuffer() { free(bytes); }
+    };
+
+    thread_local ConvertBuffer s_convertBuffer;
+
+    unsigned char* getConvertBuffer(ssize_t size)
+    {
+        if ((size_t)size > s_convertBuffer.capacity)
+        {
+            free(s_convertBuffer.bytes);
+            s_convertBuffer.bytes = static_cast<unsigned char*>(malloc(size));
+            s_convertBuffer.capacity = s_convertBuffer.bytes ? (size_t)size : 0;
+        }
+        return s_convertBuffer.bytes;
+    }
+
+    void releaseConvertBuffer(unsigned char* buffer)
+    {
+        if (buffer == s_convertBuffer.bytes && s_convertBuffer.capacity > MAX_KEPT_CONVERT_BUFFER_SIZE)
+        {
+            free(s_convertBuffer.bytes);
+            s_convertBuffer.bytes = nullptr;
+            s_convertBuffer.capacity = 0;
+        }
+    }
 }
 
 //CLASS IMPLEMENTATIONS:
@@ -805,8 +841,7 @@ bool Texture2D::initWithImage(Image *image, PixelFormat format)
 
         if (outTempData != nullptr && outTempData != tempData)
         {
-
-            free(outTempData);
+            releaseConvertBuffer(outTempData);
         }
 
         // set the premultiplied tag
@@ -822,32 +857,32 @@ Texture2D::PixelFormat Texture2D::convertI8ToFormat(const unsigned char* data, s
     {
     case PixelFormat::RGBA8888:
         *outDataLen = dataLen*4;
-        *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+        *outData = getConvertBuffer(*outDataLen);
         convertI8ToRGBA8888(data, dataLen, *outData);
         break;
     case PixelFormat::RGB888:
         *outDataLen = dataLen*3;
-        *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+        *outData = getConvertBuffer(*outDataLen);
         convertI8ToRGB888(data, dataLen, *outData);
         break;
     case PixelFormat::RGB565:
         *outDataLen = dataLen*2;
-        *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+        *outData = getConvertBuffer(*outDataLen);
         convertI8ToRGB565(data, dataLen, *outData);
         break;
     case PixelFormat::AI88:
         *outDataLen = dataLen*2;
-        *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+        *outData = getConvertBuffer(*outDataLen);
         convertI8ToAI88(data, dataLen, *outData);
         break;
     case PixelFormat::RGBA4444:
         *outDataLen = dataLen*2;
-        *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+        *outData = getConvertBuffer(*outDataLen);
         convertI8ToRGBA4444(data, dataLen, *outData);
         break;
     case PixelFormat::RGB5A1:
         *outDataLen = dataLen*2;
-        *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+        *outData = getConvertBuffer(*outDataLen);
         convertI8ToRGB5A1(data, dataLen, *outData);
         break;
     default:
@@ -871,37 +906,37 @@ Texture2D::PixelFormat Texture2D::convertAI88ToFormat(const unsigned char* data,
     {
     case PixelFormat::RGBA8888:
         *outDataLen = dataLen*2;
-        *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+        *outData = getConvertBuffer(*outDataLen);
         convertAI88ToRGBA8888(data, dataLen, *outData);
         break;
     case PixelFormat::RGB888:
         *outDataLen = dataLen/2*3;
-        *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+        *outData = getConvertBuffer(*outDataLen);
         convertAI88ToRGB888(data, dataLen, *outData);
         break;
     case PixelFormat::RGB565:
         *outDataLen = dataLen;
-        *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+        *outData = getConvertBuffer(*outDataLen);
         convertAI88ToRGB565(data, dataLen, *outData);
         break;
     case PixelFormat::A8:
         *outDataLen = dataLen/2;
-        *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+        *outData = getConvertBuffer(*outDataLen);
         convertAI88ToA8(data, dataLen, *outData);
         break;
     case PixelFormat::I8:
         *outDataLen = dataLen/2;
-        *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+        *outData = getConvertBuffer(*outDataLen);
         convertAI88ToI8(data, dataLen, *outData);
         break;
     case PixelFormat::RGBA4444:
         *outDataLen = dataLen;
-        *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+        *outData = getConvertBuffer(*outDataLen);
         convertAI88ToRGBA4444(data, dataLen, *outData);
         break;
     case PixelFormat::RGB5A1:
         *outDataLen = dataLen;
-        *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+        *outData = getConvertBuffer(*outDataLen);
         convertAI88ToRGB5A1(data, dataLen, *outData);
         break;
     default:
@@ -926,37 +961,37 @@ Texture2D::PixelFormat Texture2D::convertRGB888ToFormat(const unsigned char* dat
     {
     case PixelFormat::RGBA8888:
         *outDataLen = dataLen/3*4;
-        *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+        *outData = getConvertBuffer(*outDataLen);
         convertRGB888ToRGBA8888(data, dataLen, *outData);
         break;
     case PixelFormat::RGB565:
         *outDataLen = dataLen/3*2;
-        *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+        *outData = getConvertBuffer(*outDataLen);
         convertRGB888ToRGB565(data, dataLen, *outData);
         break;
     case PixelFormat::A8:
         *outDataLen = dataLen/3;
-        *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+        *outData = getConvertBuffer(*outDataLen);
         convertRGB888ToA8(data, dataLen, *outData);
         break;
     case PixelFormat::I8:
         *outDataLen = dataLen/3;
-        *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+        *outData = getConvertBuffer(*outDataLen);
         convertRGB888ToI8(data, dataLen, *outData);
         break;
     case PixelFormat::AI88:
         *outDataLen = dataLen/3*2;
-        *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+        *outData = getConvertBuffer(*outDataLen);
         convertRGB888ToAI88(data, dataLen, *outData);
         break;
     case PixelFormat::RGBA4444:
         *outDataLen = dataLen/3*2;
-        *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+        *outData = getConvertBuffer(*outDataLen);
         convertRGB888ToRGBA4444(data, dataLen, *outData);
         break;
     case PixelFormat::RGB5A1:
         *outDataLen = dataLen;
-        *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+        *outData = getConvertBuffer(*outDataLen);
         convertRGB888ToRGB5A1(data, dataLen, *outData);
         break;
     default:
@@ -980,37 +1015,37 @@ Texture2D::PixelFormat Texture2D::convertRGBA8888ToFormat(const unsigned char* d
     {
     case PixelFormat::RGB888:
         *outDataLen = dataLen/4*3;
-        *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+        *outData = getConvertBuffer(*outDataLen);
         convertRGBA8888ToRGB888(data, dataLen, *outData);
         break;
     case PixelFormat::RGB565:
         *outDataLen = dataLen/2;
-        *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+        *outData = getConvertBuffer(*outDataLen);
         convertRGBA8888ToRGB565(data, dataLen, *outData);
         break;
     case PixelFormat::A8:
         *outDataLen = dataLen/4;
-        *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+        *outData = getConvertBuffer(*outDataLen);
         convertRGBA8888ToA8(data, dataLen, *outData);
         break;
     case PixelFormat::I8:
         *outDataLen = dataLen/4;
-        *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+        *outData = getConvertBuffer(*outDataLen);
         convertRGBA8888ToI8(data, dataLen, *outData);
         break;
     case PixelFormat::AI88:
         *outDataLen = dataLen/2;
-        *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+        *outData = getConvertBuffer(*outDataLen);
         convertRGBA8888ToAI88(data, dataLen, *outData);
         break;
     case PixelFormat::RGBA4444:
         *outDataLen = dataLen/2;
-        *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+        *outData = getConvertBuffer(*outDataLen);
         convertRGBA8888ToRGBA4444(data, dataLen, *outData);
         break;
     case PixelFormat::RGB5A1:
         *outDataLen = dataLen/2;
-        *outData = (unsigned char*)malloc(sizeof(unsigned char) * (*outDataLen));
+        *outData = getConvertBuffer(*outDataLen);
         convertRGBA8888ToRGB5A1(data, dataLen, *outData);
         break;
     default:
@@ -1163,7 +1198,7 @@ bool Texture2D::initWithString(const char *text, const FontDefinition& textDefin
 
     if (outTempData != nullptr && outTempData != outData.getBytes())
     {
-        free(outTempData);
+        releaseConvertBuffer(outTempData);
     }
     _hasPremultipliedAlpha = hasPremultipliedAlpha;
 
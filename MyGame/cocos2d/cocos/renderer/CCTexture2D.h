@@ -467,7 +467,8 @@ private:
 
     /**
     Convert the format to the format param you specified, if the format is PixelFormat::Automatic, it will detect it automatically and convert to the closest format for you.
-    It will return the converted format to you. if the outData != data, you must delete it manually.
+    It will return the converted format to you. if the outData != data, it is a buffer the next conversion on the same
+    thread reuses, so upload it before converting again and don't free it.
     */
     static PixelFormat convertDataToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat originFormat, PixelFormat format, unsigned char** outData, ssize_t* outDataLen);
 
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "renderer/CCTextureCache.h"
 
 #include <errno.h>
+#include <chrono>
 #include <stack>
 #include <cctype>
 #include <list>
@@ -38,6 +39,7 @@ THE SOFTWARE.
 #include "base/ccUTF8.h"
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
+#include "base/CCJobSystem.h"
 #include "platform/CCFileUtils.h"
 #include "base/ccUtils.h"
 #include "base/CCNinePatchImageParser.h"
@@ -68,9 +70,8 @@ TextureCache * TextureCache::getInstance()
 }
 
 TextureCache::TextureCache()
-: _loadingThread(nullptr)
-, _needQuit(false)
-, _asyncRefCount(0)
+: _asyncRefCount(0)
+, _asyncUploadTimeBudget(0.0f)
 {
 }
 
@@ -80,8 +81,6 @@ TextureCache::~TextureCache()
 
     for (auto& texture : _textures)
         texture.second->release();
-
-    CC_SAFE_DELETE(_loadingThread);
 }
 
 void TextureCache::destroyInstance()
@@ -107,10 +106,10 @@ struct TextureCache::AsyncStruct
 public:
     AsyncStruct
     ( const std::string& fn,const std::function<void(Texture2D*)>& f,
-      const std::string& key )
+      const std::string& key, TextureCache::AsyncPriority p )
       : filename(fn), callback(f),callbackKey( key ),
         pixelFormat(Texture2D::getDefaultAlphaPixelFormat()),
-        loadSuccess(false)
+        loadSuccess(false), loaded(false), priority(p), cancelled(false)
     {}
 
     std::string filename;
@@ -120,21 +119,24 @@ public:
     Image imageAlpha;
     Texture2D::PixelFormat pixelFormat;
     bool loadSuccess;
+    std::atomic<bool> loaded;
+    JobSystem::JobHandle job;
+    TextureCache::AsyncPriority priority;
+    bool cancelled;
 };
 
 /**
  The addImageAsync logic follow the steps:
- - find the image has been add or not, if not add an AsyncStruct to _requestQueue  (GL thread)
- - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load thread)
- - on schedule callback, get AsyncStruct from _responseQueue, convert image to texture, then delete AsyncStruct (GL thread)
+ - find the image has been add or not, if not add an AsyncStruct to _asyncStructQueue and schedule a job loading it (GL thread)
+ - load res and fill image data to AsyncStruct.image, then mark it loaded (JobSystem worker, images load in parallel)
+ - on schedule callback, take the loaded AsyncStructs from _asyncStructQueue, visible ones first, convert image to texture within the upload time budget, then delete AsyncStruct (GL thread)
 
  the Critical Area include these members:
- - _requestQueue: locked by _requestMutex
- - _responseQueue: locked by _responseMutex
+ - AsyncStruct::loaded: set by the job once the image data is filled, read in GL thread
 
  the object's life time:
  - AsyncStruct: construct and destruct in GL thread
- - image data: new in Load thread, delete in GL thread(by Image instance)
+ - image data: new in JobSystem worker, delete in GL thread(by Image instance)
 
  Note:
  - all AsyncStruct referenced in _asyncStructQueue, for unbind function use.
@@ -159,17 +161,16 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
 
 /**
  The addImageAsync logic follow the steps:
- - find the image has been add or not, if not add an AsyncStruct to _requestQueue  (GL thread)
- - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load thread)
- - on schedule callback, get AsyncStruct from _responseQueue, convert image to texture, then delete AsyncStruct (GL thread)
+ - find the image has been add or not, if not add an AsyncStruct to _asyncStructQueue and schedule a job loading it (GL thread)
+ - load res and fill image data to AsyncStruct.image, then mark it loaded (JobSystem worker, images load in parallel)
+ - on schedule callback, take the loaded AsyncStructs from _asyncStructQueue, visible ones first, convert image to texture within the upload time budget, then delete AsyncStruct (GL thread)
  
  the Critical Area include these members:
- - _requestQueue: locked by _requestMutex
- - _responseQueue: locked by _responseMutex
+ - AsyncStruct::loaded: set by the job once the image data is filled, read in GL thread
  
  the object's life time:
  - AsyncStruct: construct and destruct in GL thread
- - image data: new in Load thread, delete in GL thread(by Image instance)
+ - image data: new in JobSystem worker, delete in GL thread(by Image instance)
  
  Note:
  - all AsyncStruct referenced in _asyncStructQueue, for unbind function use.
@@ -190,6 +191,11 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
  unbindImageAsync(path) would be ambiguous.
  */
 void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey)
+{
+    addImageAsync(path, callback, callbackKey, AsyncPriority::VISIBLE);
+}
+
+void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey, AsyncPriority priority)
 {
     Texture2D *texture = nullptr;
 
@@ -211,14 +217,6 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
         return;
     }
 
-    // lazy init
-    if (_loadingThread == nullptr)
-    {
-        // create a new thread to load images
-        _needQuit = false;
-        _loadingThread = new (std::nothrow) std::thread(&TextureCache::loadImage, this);
-    }
-
     if (0 == _asyncRefCount)
     {
         Director::getInstance()->getScheduler()->schedule(CC_SCHEDULE_SELECTOR(TextureCache::addImageAsyncCallBack), this, 0, false);
@@ -228,13 +226,24 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
 
     // generate async struct
     AsyncStruct *data =
-      new (std::nothrow) AsyncStruct(fullpath, callback, callbackKey);
+      new (std::nothrow) AsyncStruct(fullpath, callback, callbackKey, priority);
     
     // add async struct into queue
     _asyncStructQueue.push_back(data);
-    std::unique_lock<std::mutex> ul(_requestMutex);
-    _requestQueue.push_back(data);
-    _sleepCondition.notify_one();
+    data->job = JobSystem::getInstance()->schedule([data]() {
+        loadImage(data);
+    }, nullptr, priority == AsyncPriority::VISIBLE ? JobSystem::Priority::NORMAL : JobSystem::Priority::LOW);
+}
+
+void TextureCache::cancelImageAsync(AsyncStruct* asyncStruct)
+{
+    asyncStruct->callback = nullptr;
+
+    // an image already loading is still turned into a texture
+    if (JobSystem::getInstance()->cancel(asyncStruct->job))
+    {
+        asyncStruct->cancelled = true;
+    }
 }
 
 void TextureCache::unbindImageAsync(const std::string& callbackKey)
@@ -248,7 +257,7 @@ void TextureCache::unbindImageAsync(const std::string& callbackKey)
     {
         if (asyncStruct->callbackKey == callbackKey)
         {
-            asyncStruct->callback = nullptr;
+            cancelImageAsync(asyncStruct);
         }
     }
 }
@@ -262,131 +271,133 @@ void TextureCache::unbindAllImageAsync()
     }
     for (auto& asyncStruct : _asyncStructQueue)
     {
-        asyncStruct->callback = nullptr;
+        cancelImageAsync(asyncStruct);
     }
 }
 
-void TextureCache::loadImage()
+void TextureCache::loadImage(AsyncStruct* asyncStruct)
 {
-    AsyncStruct *asyncStruct = nullptr;
-    while (!_needQuit)
-    {
-        std::unique_lock<std::mutex> ul(_requestMutex);
-        // pop an AsyncStruct from request queue
-        if (_requestQueue.empty())
-        {
-            asyncStruct = nullptr;
-        }
-        else
-        {
-            asyncStruct = _requestQueue.front();
-            _requestQueue.pop_front();
-        }
+    // load image
+    asyncStruct->loadSuccess = asyncStruct->image.initWithImageFileThreadSafe(asyncStruct->filename);
 
-        if (nullptr == asyncStruct) {
-            if (_needQuit) {
-                break;
-            }
-            _sleepCondition.wait(ul);
-            continue;
-        }
-        ul.unlock();
-
-        // load image
-        asyncStruct->loadSuccess = asyncStruct->image.initWithImageFileThreadSafe(asyncStruct->filename);
-
-        // ETC1 ALPHA supports.
-        if (asyncStruct->loadSuccess && asyncStruct->image.getFileType() == Image::Format::ETC && !s_etc1AlphaFileSuffix.empty())
-        { // check whether alpha texture exists & load it
-            auto alphaFile = asyncStruct->filename + s_etc1AlphaFileSuffix;
-            if (FileUtils::getInstance()->isFileExist(alphaFile))
-                asyncStruct->imageAlpha.initWithImageFileThreadSafe(alphaFile);
-        }
-        // push the asyncStruct to response queue
-        _responseMutex.lock();
-        _responseQueue.push_back(asyncStruct);
-        _responseMutex.unlock();
+    // ETC1 ALPHA supports.
+    if (asyncStruct->loadSuccess && asyncStruct->image.getFileType() == Image::Format::ETC && !s_etc1AlphaFileSuffix.empty())
+    { // check whether alpha texture exists & load it
+        auto alphaFile = asyncStruct->filename + s_etc1AlphaFileSuffix;
+        if (FileUtils::getInstance()->isFileExist(alphaFile))
+            asyncStruct->imageAlpha.initWithImageFileThreadSafe(alphaFile);
     }
+
+    asyncStruct->loaded.store(true, std::memory_order_release);
 }
 
 void TextureCache::addImageAsyncCallBack(float /*dt*/)
 {
-    Texture2D *texture = nullptr;
-    AsyncStruct *asyncStruct = nullptr;
-    while (true)
+    typedef std::chrono::steady_clock Clock;
+    const auto start = Clock::now();
+    auto jobSystem = JobSystem::getInstance();
+    bool isOutOfTime = false;
+    bool hasUploaded = false;
+
+    // the visible images first, then the prefetched ones. The callbacks may add requests,
+    // they are appended to _asyncStructQueue, so it is walked by index
+    for (int priority = (int)AsyncPriority::VISIBLE; priority <= (int)AsyncPriority::PREFETCH && !isOutOfTime; ++priority)
     {
-        // pop an AsyncStruct from response queue
-        _responseMutex.lock();
-        if (_responseQueue.empty())
+        size_t i = 0;
+        while (i < _asyncStructQueue.size())
         {
-            asyncStruct = nullptr;
-        }
-        else
-        {
-            asyncStruct = _responseQueue.front();
-            _responseQueue.pop_front();
+            AsyncStruct *asyncStruct = _asyncStructQueue[i];
+            if ((int)asyncStruct->priority != priority)
+            {
+                ++i;
+                continue;
+            }
 
-            // the asyncStruct's sequence order in _asyncStructQueue must equal to the order in _responseQueue
-            CC_ASSERT(asyncStruct == _asyncStructQueue.front());
-            _asyncStructQueue.pop_front();
-        }
-        _responseMutex.unlock();
+            // a cancelled load is dropped once its job is done with it
+            if (asyncStruct->cancelled)
+            {
+                if (jobSystem->isFinished(asyncStruct->job))
+                {
+                    _asyncStructQueue.erase(_asyncStructQueue.begin() + i);
+                    delete asyncStruct;
+                    --_asyncRefCount;
+                }
+                else
+                {
+                    ++i;
+                }
+                continue;
+            }
 
-        if (nullptr == asyncStruct) {
-            break;
-        }
+            if (!asyncStruct->loaded.load(std::memory_order_acquire))
+            {
+                ++i;
+                continue;
+            }
 
-        // check the image has been convert to texture or not
-        auto it = _textures.find(asyncStruct->filename);
-        if (it != _textures.end())
-        {
-            texture = it->second;
-        }
-        else
-        {
-            // convert image to texture
-            if (asyncStruct->loadSuccess)
+            if (hasUploaded && _asyncUploadTimeBudget > 0
+                && std::chrono::duration<float>(Clock::now() - start).count() >= _asyncUploadTimeBudget)
             {
-                Image* image = &(asyncStruct->image);
-                // generate texture in render thread
-                texture = new (std::nothrow) Texture2D();
+                isOutOfTime = true;
+                break;
+            }
 
-                texture->initWithImage(image, asyncStruct->pixelFormat);
-                //parse 9-patch info
-                this->parseNinePatchImage(image, texture, asyncStruct->filename);
+            _asyncStructQueue.erase(_asyncStructQueue.begin() + i);
+            hasUploaded = true;
+
+            // check the image has been convert to texture or not
+            Texture2D *texture = nullptr;
+            auto it = _textures.find(asyncStruct->filename);
+            if (it != _textures.end())
+            {
+                texture = it->second;
+            }
+            else
+            {
+                // convert image to texture
+                if (asyncStruct->loadSuccess)
+                {
+                    Image* image = &(asyncStruct->image);
+                    // generate texture in render thread
+                    texture = new (std::nothrow) Texture2D();
+
+                    texture->initWithImage(image, asyncStruct->pixelFormat);
+                    //parse 9-patch info
+                    this->parseNinePatchImage(image, texture, asyncStruct->filename);
 #if CC_ENABLE_CACHE_TEXTURE_DATA
-                // cache the texture file name
-                VolatileTextureMgr::addImageTexture(texture, asyncStruct->filename);
+                    // cache the texture file name
+                    VolatileTextureMgr::addImageTexture(texture, asyncStruct->filename);
 #endif
-                // cache the texture. retain it, since it is added in the map
-                _textures.emplace(asyncStruct->filename, texture);
-                texture->retain();
-
-                texture->autorelease();
-                // ETC1 ALPHA supports.
-                if (asyncStruct->imageAlpha.getFileType() == Image::Format::ETC) {
-                    auto alphaTexture = new(std::nothrow) Texture2D();
-                    if(alphaTexture != nullptr && alphaTexture->initWithImage(&asyncStruct->imageAlpha, asyncStruct->pixelFormat)) {
-                        texture->setAlphaTexture(alphaTexture);
+                    // cache the texture. retain it, since it is added in the map
+                    _textures.emplace(asyncStruct->filename, texture);
+                    texture->retain();
+
+                    texture->autorelease();
+                    // ETC1 ALPHA supports.
+                    if (asyncStruct->imageAlpha.getFileType() == Image::Format::ETC) {
+                        auto alphaTexture = new(std::nothrow) Texture2D();
+                        if(alphaTexture != nullptr && alphaTexture->initWithImage(&asyncStruct->imageAlpha, asyncStruct->pixelFormat)) {
+                            texture->setAlphaTexture(alphaTexture);
+                        }
+                        CC_SAFE_RELEASE(alphaTexture);
                     }
-                    CC_SAFE_RELEASE(alphaTexture);
+                }
+                else {
+                    texture = nullptr;
+                    CCLOG("cocos2d: failed to call TextureCache::addImageAsync(%s)", asyncStruct->filename.c_str());
                 }
             }
-            else {
-                texture = nullptr;
-                CCLOG("cocos2d: failed to call TextureCache::addImageAsync(%s)", asyncStruct->filename.c_str());
+
+            // call callback function
+            if (asyncStruct->callback)
+            {
+                (asyncStruct->callback)(texture);
             }
-        }
 
-        // call callback function
-        if (asyncStruct->callback)
-        {
-            (asyncStruct->callback)(texture);
+            // release the asyncStruct
+            delete asyncStruct;
+            --_asyncRefCount;
         }
-
-        // release the asyncStruct
-        delete asyncStruct;
-        --_asyncRefCount;
     }
 
     if (0 == _asyncRefCount)
@@ -659,12 +670,19 @@ std::string TextureCache::getTextureFilePath(cocos2d::Texture2D* texture) const
 
 void TextureCache::waitForQuit()
 {
-    // notify sub thread to quick
-    std::unique_lock<std::mutex> ul(_requestMutex);
-    _needQuit = true;
-    _sleepCondition.notify_one();
-    ul.unlock();
-    if (_loadingThread) _loadingThread->join();
+    // drop the loads not started yet, and wait for the others
+    auto jobSystem = JobSystem::getInstance();
+    for (auto& asyncStruct : _asyncStructQueue)
+    {
+        jobSystem->cancel(asyncStruct->job);
+    }
+    for (auto& asyncStruct : _asyncStructQueue)
+    {
+        jobSystem->wait(asyncStruct->job);
+        delete asyncStruct;
+    }
+    _asyncStructQueue.clear();
+    _asyncRefCount = 0;
 }
 
 std::string TextureCache::getCachedTextureInfo() const
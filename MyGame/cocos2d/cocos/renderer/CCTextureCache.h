@@ -127,9 +127,34 @@ public:
     
     void addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey );
 
+    /** Priority of an asynchronous image load. */
+    enum class AsyncPriority
+    {
+        /** The image is about to be shown, it is loaded and uploaded first. */
+        VISIBLE,
+        /** The image is loaded ahead of time, once the visible ones are done. */
+        PREFETCH,
+    };
+
+    /** Same as addImageAsync(path, callback, callbackKey), loading the image with the given priority.
+     * The images are loaded on several threads, their callbacks may be called in a different order than requested.
+     @since v3.17
+    */
+    void addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey, AsyncPriority priority);
+
+    /** Sets the time in seconds the textures of asynchronously loaded images may take to be created per frame.
+     * The textures left once it is spent are created in the next frames, at least one is created per frame.
+     * 0, the default, means no limit.
+     * @since v3.17
+     */
+    void setAsyncUploadTimeBudget(float seconds) { _asyncUploadTimeBudget = seconds; }
+    /** Gets the time in seconds the textures of asynchronously loaded images may take to be created per frame. */
+    float getAsyncUploadTimeBudget() const { return _asyncUploadTimeBudget; }
+
     /** Unbind a specified bound image asynchronous callback.
      * In the case an object who was bound to an image asynchronous callback was destroyed before the callback is invoked,
      * the object always need to unbind this callback manually.
+     * The loads of the callback not started yet are cancelled.
      * @param filename It's the related/absolute path of the file image.
      * @since v3.1
      */
@@ -221,27 +246,19 @@ public:
 
 
 private:
+    struct AsyncStruct;
+
     void addImageAsyncCallBack(float dt);
-    void loadImage();
+    void cancelImageAsync(AsyncStruct* asyncStruct);
+    static void loadImage(AsyncStruct* asyncStruct);
     void parseNinePatchImage(Image* image, Texture2D* texture, const std::string& path);
 public:
 protected:
-    struct AsyncStruct;
-    
-    std::thread* _loadingThread;
-
+    // the images are loaded by JobSystem jobs, the textures are created in the cocos2d thread
     std::deque<AsyncStruct*> _asyncStructQueue;
-    std::deque<AsyncStruct*> _requestQueue;
-    std::deque<AsyncStruct*> _responseQueue;
-
-    std::mutex _requestMutex;
-    std::mutex _responseMutex;
-    
-    std::condition_variable _sleepCondition;
-
-    bool _needQuit;
 
     int _asyncRefCount;
+    float _asyncUploadTimeBudget;
 
     std::unordered_map<std::string, Texture2D*> _textures;
 
@@ -0,0 +1,59 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+const char* ccLabelBatched_frag = R"(
+#ifdef GL_ES
+precision lowp float;
+varying mediump vec2 v_texCoord;
+#else
+varying vec2 v_texCoord;
+#endif
+
+varying vec4 v_fragmentColor;
+
+// The text, outline and shadow colors of the label are already multiplied into the vertex color,
+// so labels sharing a font atlas texture can be drawn in one batch.
+// Outline glyphs are marked by mirroring their u coordinate to (-1 - u), the shadow glyphs of
+// an outlined label mirror both u and v.
+void main()
+{
+#ifdef GL_ES
+    mediump vec2 mirrored = vec2(1.0) - step(vec2(0.0), v_texCoord);
+    mediump vec2 texCoord = mix(v_texCoord, vec2(-1.0) - v_texCoord, vec2(mirrored.x, mirrored.x * mirrored.y));
+#else
+    vec2 mirrored = vec2(1.0) - step(vec2(0.0), v_texCoord);
+    vec2 texCoord = mix(v_texCoord, vec2(-1.0) - v_texCoord, vec2(mirrored.x, mirrored.x * mirrored.y));
+#endif
+    vec4 sample = texture2D(CC_Texture0, texCoord);
+    float fontAlpha = sample.a;
+    float outlineAlpha = sample.r;
+
+    float outline = mirrored.x;
+    float shadow = mirrored.x * mirrored.y;
+    // text: fontAlpha, outline: outlineAlpha * (1.0 - fontAlpha), shadow: outlineAlpha
+    float alpha = mix(fontAlpha, outlineAlpha * mix(1.0 - fontAlpha, 1.0, shadow), outline);
+
+    gl_FragColor = vec4(v_fragmentColor.rgb, v_fragmentColor.a * alpha);
+}
+)";
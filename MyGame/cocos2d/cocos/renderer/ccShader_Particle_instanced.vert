@@ -0,0 +1,52 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+const char* ccParticleInstanced_vert = R"(
+attribute vec4 a_position;
+attribute vec4 a_particle;
+attribute vec4 a_color;
+
+uniform vec4 u_texRect;
+
+#ifdef GL_ES
+varying lowp vec4 v_fragmentColor;
+varying mediump vec2 v_texCoord;
+#else
+varying vec4 v_fragmentColor;
+varying vec2 v_texCoord;
+#endif
+
+void main()
+{
+    // a_position: corner of the quad in [-0.5, 0.5], a_particle: position, size and rotation in radians
+    vec2 corner = a_position.xy * a_particle.z;
+    float c = cos(a_particle.w);
+    float s = sin(a_particle.w);
+    vec2 position = vec2(corner.x * c - corner.y * s, corner.x * s + corner.y * c) + a_particle.xy;
+    gl_Position = CC_MVPMatrix * vec4(position, 0.0, 1.0);
+    v_fragmentColor = a_color;
+    // u_texRect: left, bottom, right, top texture coordinates
+    v_texCoord = mix(u_texRect.xy, u_texRect.zw, a_position.xy + 0.5);
+}
+)";
@@ -43,3 +43,37 @@ void main()
     v_texCoord = a_texCoord;
 }
 )";
+
+const char* ccPositionTextureColor_gpuTransform_vert = R"(
+attribute vec4 a_position;
+attribute vec2 a_texCoord;
+attribute vec4 a_color;
+attribute float a_blendIndex;
+
+const int TRANSFORM_PALETTE_SIZE = 32;
+// Model-view matrices of the batch, three rows per matrix
+uniform vec4 u_matrixPalette[TRANSFORM_PALETTE_SIZE * 3];
+
+#ifdef GL_ES
+varying lowp vec4 v_fragmentColor;
+varying mediump vec2 v_texCoord;
+#else
+varying vec4 v_fragmentColor;
+varying vec2 v_texCoord;
+#endif
+
+void main()
+{
+    int matrixIndex = int(a_blendIndex) * 3;
+    vec4 position = vec4(a_position.xyz, 1.0);
+    vec4 worldPosition;
+    worldPosition.x = dot(position, u_matrixPalette[matrixIndex]);
+    worldPosition.y = dot(position, u_matrixPalette[matrixIndex + 1]);
+    worldPosition.z = dot(position, u_matrixPalette[matrixIndex + 2]);
+    worldPosition.w = 1.0;
+
+    gl_Position = CC_PMatrix * worldPosition;
+    v_fragmentColor = a_color;
+    v_texCoord = a_texCoord;
+}
+)";
@@ -58,6 +58,7 @@ extern CC_DLL const GLchar * ccPositionTextureColor_vert;
 
 extern CC_DLL const GLchar * ccPositionTextureColor_noMVP_frag;
 extern CC_DLL const GLchar * ccPositionTextureColor_noMVP_vert;
+extern CC_DLL const GLchar * ccPositionTextureColor_gpuTransform_vert;
 
 extern CC_DLL const GLchar * ccPositionTextureColorAlphaTest_frag;
 
@@ -73,9 +74,12 @@ extern CC_DLL const GLchar * ccLabelDistanceFieldNormal_frag;
 extern CC_DLL const GLchar * ccLabelDistanceFieldGlow_frag;
 extern CC_DLL const GLchar * ccLabelNormal_frag;
 extern CC_DLL const GLchar * ccLabelOutline_frag;
+extern CC_DLL const GLchar * ccLabelBatched_frag;
 
 extern CC_DLL const GLchar * ccLabel_vert;
 
+extern CC_DLL const GLchar * ccParticleInstanced_vert;
+
 extern CC_DLL const GLchar * cc3D_PositionTex_vert;
 extern CC_DLL const GLchar * cc3D_SkinPositionTex_vert;
 extern CC_DLL const GLchar * cc3D_ColorTex_frag;
@@ -29,11 +29,19 @@ THE SOFTWARE.
 NS_CC_BEGIN
 
 static const float DEFAULT_TIME_IN_SEC_FOR_SCROLL_TO_ITEM = 1.0f;
+// Cells bound in one layout can measure different from the estimate and uncover more items, bind those in a few passes.
+static const int MAX_VIRTUAL_LAYOUT_PASSES = 4;
 
 namespace ui {
     
 IMPLEMENT_CLASS_GUI_INFO(ListView)
 
+static float getItemLength(Widget* item, ScrollView::Direction direction)
+{
+    const Size& size = item->getContentSize();
+    return (direction == ScrollView::Direction::HORIZONTAL) ? size.width : size.height;
+}
+
 ListView::ListView():
 _model(nullptr),
 _gravity(Gravity::CENTER_VERTICAL),
@@ -47,6 +55,8 @@ _bottomPadding(0.0f),
 _scrollTime(DEFAULT_TIME_IN_SEC_FOR_SCROLL_TO_ITEM),
 _curSelectedIndex(-1),
 _innerContainerDoLayoutDirty(true),
+_virtualItemCount(0),
+_estimatedItemSize(0.0f),
 _listViewEventListener(nullptr),
 _listViewEventSelector(nullptr),
 _eventCallback(nullptr)
@@ -59,6 +69,7 @@ ListView::~ListView()
     _listViewEventListener = nullptr;
     _listViewEventSelector = nullptr;
     _items.clear();
+    _virtualCells.clear();
     CC_SAFE_RELEASE(_model);
 }
 
@@ -327,6 +338,13 @@ void ListView::removeChild(cocos2d::Node *child, bool cleanup)
         }
         _items.eraseObject(widget);
         onItemListChanged();
+
+        ssize_t cellIndex = _virtualCells.getIndex(widget);
+        if (-1 != cellIndex)
+        {
+            _virtualCells.erase(cellIndex);
+            _virtualCellIndices.erase(_virtualCellIndices.begin() + cellIndex);
+        }
     }
    
     ScrollView::removeChild(child, cleanup);
@@ -343,6 +361,8 @@ void ListView::removeAllChildrenWithCleanup(bool cleanup)
     ScrollView::removeAllChildrenWithCleanup(cleanup);
     _curSelectedIndex = -1;
     _items.clear();
+    _virtualCells.clear();
+    _virtualCellIndices.clear();
     onItemListChanged();
 }
 
@@ -386,6 +406,17 @@ void ListView::removeAllItems()
 
 Widget* ListView::getItem(ssize_t index) const
 {
+    if (isVirtualized())
+    {
+        for (size_t i = 0; i < _virtualCellIndices.size(); ++i)
+        {
+            if (_virtualCellIndices[i] == index && -1 != index)
+            {
+                return _virtualCells.at(i);
+            }
+        }
+        return nullptr;
+    }
     if (index < 0 || index >= _items.size())
     {
         return nullptr;
@@ -404,9 +435,91 @@ ssize_t ListView::getIndex(Widget *item) const
     {
         return -1;
     }
+    if (isVirtualized())
+    {
+        ssize_t cellIndex = _virtualCells.getIndex(item);
+        return (-1 == cellIndex) ? -1 : _virtualCellIndices[cellIndex];
+    }
     return _items.getIndex(item);
 }
 
+void ListView::setItemProvider(const ItemProvider& provider)
+{
+    CCASSERT(_items.empty(), "Can't provide the items of a ListView with inserted items!");
+    CCASSERT(nullptr == provider.getItemCount || nullptr != provider.bindItem, "An ItemProvider must bind the items!");
+
+    clearVirtualCells();
+    _itemProvider = provider;
+    if (isVirtualized())
+    {
+        setLayoutType(Type::ABSOLUTE);
+        reloadItems();
+    }
+    else
+    {
+        setLayoutType(_direction == Direction::HORIZONTAL ? Type::HORIZONTAL : Type::VERTICAL);
+        _virtualItemCount = 0;
+        std::vector<float>().swap(_virtualItemSizes);
+        std::vector<double>().swap(_virtualSizeTree);
+        requestDoLayout();
+    }
+}
+
+void ListView::reloadItems()
+{
+    if (!isVirtualized())
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < _virtualCellIndices.size(); ++i)
+    {
+        _virtualCellIndices[i] = -1;
+        _virtualCells.at(i)->setVisible(false);
+    }
+    _curSelectedIndex = -1;
+    _virtualItemCount = std::max(_itemProvider.getItemCount(), (ssize_t)0);
+
+    float estimatedSize = _estimatedItemSize;
+    if (estimatedSize <= 0.0f && _virtualItemCount > 0)
+    {
+        estimatedSize = getItemLength(bindVirtualCell(0), _direction);
+    }
+
+    // All the items start with the estimated size, the Fenwick tree is built in linear time
+    _virtualItemSizes.assign(_virtualItemCount, estimatedSize);
+    _virtualSizeTree.assign(_virtualItemCount + 1, 0.0);
+    for (ssize_t i = 1; i <= _virtualItemCount; ++i)
+    {
+        _virtualSizeTree[i] += estimatedSize;
+        ssize_t parent = i + (i & -i);
+        if (parent <= _virtualItemCount)
+        {
+            _virtualSizeTree[parent] += _virtualSizeTree[i];
+        }
+    }
+
+    setVirtualContentLength(0.0);
+    requestDoLayout();
+}
+
+void ListView::reloadItem(ssize_t index)
+{
+    Widget* cell = isVirtualized() ? getItem(index) : nullptr;
+    if (nullptr == cell)
+    {
+        return;
+    }
+    _itemProvider.bindItem(index, cell);
+    setVirtualItemSize(index, getItemLength(cell, _direction));
+    requestDoLayout();
+}
+
+void ListView::setEstimatedItemSize(float size)
+{
+    _estimatedItemSize = size;
+}
+
 void ListView::setGravity(Gravity gravity)
 {
     if (_gravity == gravity)
@@ -546,16 +659,20 @@ void ListView::setDirection(Direction dir)
         case Direction::BOTH:
             break;
         case Direction::VERTICAL:
-            setLayoutType(Type::VERTICAL);
+            setLayoutType(isVirtualized() ? Type::ABSOLUTE : Type::VERTICAL);
             break;
         case Direction::HORIZONTAL:
-            setLayoutType(Type::HORIZONTAL);
+            setLayoutType(isVirtualized() ? Type::ABSOLUTE : Type::HORIZONTAL);
             break;
         default:
             return;
             break;
     }
     ScrollView::setDirection(dir);
+    if (isVirtualized())
+    {
+        reloadItems();
+    }
 }
     
 void ListView::refreshView()
@@ -570,6 +687,11 @@ void ListView::requestDoLayout()
 
 void ListView::doLayout()
 {
+    if (isVirtualized())
+    {
+        updateVirtualItems();
+        return;
+    }
     if(!_innerContainerDoLayoutDirty)
     {
         return;
@@ -852,16 +974,292 @@ Vec2 ListView::calculateItemDestination(const Vec2& positionRatioInView, Widget*
     return -(itemPosition - positionInView);
 }
 
-void ListView::jumpToItem(ssize_t itemIndex, const Vec2& positionRatioInView, const Vec2& itemAnchorPoint)
+void ListView::clearVirtualCells()
 {
-    Widget* item = getItem(itemIndex);
-    if (item == nullptr)
+    for (auto& cell : _virtualCells)
+    {
+        ScrollView::removeChild(cell, true);
+    }
+    _virtualCells.clear();
+    _virtualCellIndices.clear();
+}
+
+ssize_t ListView::dequeueVirtualCell()
+{
+    for (size_t i = 0; i < _virtualCellIndices.size(); ++i)
+    {
+        if (-1 == _virtualCellIndices[i])
+        {
+            return i;
+        }
+    }
+
+    Widget* cell = nullptr;
+    if (_itemProvider.createItem)
+    {
+        cell = _itemProvider.createItem();
+    }
+    else if (nullptr != _model)
+    {
+        cell = _model->clone();
+    }
+    CCASSERT(nullptr != cell, "An ItemProvider without createItem needs an item model!");
+
+    ScrollView::addChild(cell);
+    _virtualCells.pushBack(cell);
+    _virtualCellIndices.push_back(-1);
+    return _virtualCells.size() - 1;
+}
+
+Widget* ListView::bindVirtualCell(ssize_t index)
+{
+    ssize_t cellIndex = dequeueVirtualCell();
+    Widget* cell = _virtualCells.at(cellIndex);
+    _virtualCellIndices[cellIndex] = index;
+    cell->setVisible(true);
+    _itemProvider.bindItem(index, cell);
+    return cell;
+}
+
+void ListView::setVirtualItemSize(ssize_t index, float size)
+{
+    double delta = size - _virtualItemSizes[index];
+    _virtualItemSizes[index] = size;
+    for (ssize_t i = index + 1; i <= _virtualItemCount; i += (i & -i))
+    {
+        _virtualSizeTree[i] += delta;
+    }
+}
+
+double ListView::getVirtualItemOffset(ssize_t index) const
+{
+    double offset = (_direction == Direction::HORIZONTAL ? _leftPadding : _topPadding) + index * (double)_itemsMargin;
+    for (ssize_t i = index; i > 0; i -= (i & -i))
+    {
+        offset += _virtualSizeTree[i];
+    }
+    return offset;
+}
+
+ssize_t ListView::findVirtualItem(double offset) const
+{
+    // Descend the Fenwick tree to count the items that end, with their margin, before the offset
+    double target = offset - (_direction == Direction::HORIZONTAL ? _leftPadding : _topPadding);
+    ssize_t step = 1;
+    while (step * 2 <= _virtualItemCount)
+    {
+        step *= 2;
+    }
+    ssize_t count = 0;
+    double length = 0.0;
+    for (; step > 0; step /= 2)
+    {
+        ssize_t next = count + step;
+        if (next <= _virtualItemCount && length + _virtualSizeTree[next] + next * (double)_itemsMargin <= target)
+        {
+            count = next;
+            length += _virtualSizeTree[next];
+        }
+    }
+    return std::min(count, _virtualItemCount - 1);
+}
+
+double ListView::getVirtualScrollOffset() const
+{
+    if (_direction == Direction::HORIZONTAL)
+    {
+        return -_innerContainer->getLeftBoundary();
+    }
+    return _innerContainer->getTopBoundary() - _contentSize.height;
+}
+
+void ListView::setVirtualContentLength(double scrollOffset)
+{
+    double length = 0.0;
+    if (_virtualItemCount > 0)
+    {
+        length = getVirtualItemOffset(_virtualItemCount) - _itemsMargin;
+    }
+
+    Size innerSize = _contentSize;
+    Vec2 position = _innerContainer->getPosition();
+    const Vec2& anchorPoint = _innerContainer->getAnchorPoint();
+    if (_direction == Direction::HORIZONTAL)
+    {
+        length += (_virtualItemCount > 0 ? _rightPadding : _leftPadding + _rightPadding);
+        innerSize.width = std::max(_contentSize.width, (float)length);
+        position.x = -scrollOffset + anchorPoint.x * innerSize.width;
+    }
+    else
+    {
+        length += (_virtualItemCount > 0 ? _bottomPadding : _topPadding + _bottomPadding);
+        innerSize.height = std::max(_contentSize.height, (float)length);
+        position.y = _contentSize.height + scrollOffset - (1.0f - anchorPoint.y) * innerSize.height;
+    }
+
+    // The items don't move on screen, nor the auto scroll destination with them
+    Vec2 shift = position - _innerContainer->getPosition();
+    _autoScrollStartPosition += shift;
+    _autoScrollBrakingStartPosition += shift;
+
+    _innerContainer->setContentSize(innerSize);
+    _innerContainer->setPosition(position);
+    _outOfBoundaryAmountDirty = true;
+    updateScrollBar(getHowMuchOutOfBoundary());
+}
+
+void ListView::placeVirtualCell(Widget* cell, ssize_t index)
+{
+    const Size& innerSize = _innerContainer->getContentSize();
+    const Size& size = cell->getContentSize();
+    const Vec2& anchorPoint = cell->getAnchorPoint();
+    float offset = getVirtualItemOffset(index);
+    Vec2 position;
+    if (_direction == Direction::HORIZONTAL)
+    {
+        position.x = offset + anchorPoint.x * size.width;
+        switch (_gravity)
+        {
+            case Gravity::BOTTOM:
+                position.y = _bottomPadding + anchorPoint.y * size.height;
+                break;
+            case Gravity::CENTER_VERTICAL:
+                position.y = innerSize.height / 2.0f - size.height * (0.5f - anchorPoint.y);
+                break;
+            default:
+                position.y = innerSize.height - _topPadding - (1.0f - anchorPoint.y) * size.height;
+                break;
+        }
+    }
+    else
+    {
+        position.y = innerSize.height - offset - (1.0f - anchorPoint.y) * size.height;
+        switch (_gravity)
+        {
+            case Gravity::RIGHT:
+                position.x = innerSize.width - _rightPadding - (1.0f - anchorPoint.x) * size.width;
+                break;
+            case Gravity::CENTER_HORIZONTAL:
+                position.x = innerSize.width / 2.0f - size.width * (0.5f - anchorPoint.x);
+                break;
+            default:
+                position.x = _leftPadding + anchorPoint.x * size.width;
+                break;
+        }
+    }
+    cell->setPosition(position);
+}
+
+void ListView::updateVirtualItems()
+{
+    bool viewResized = !_contentSize.equals(_virtualLayoutViewSize);
+    if (!_innerContainerDoLayoutDirty && !viewResized && _innerContainer->getPosition() == _virtualLayoutPosition)
     {
         return;
     }
-    doLayout();
+    if (_innerContainerDoLayoutDirty || viewResized)
+    {
+        setVirtualContentLength(getVirtualScrollOffset());
+    }
 
-    Vec2 destination = calculateItemDestination(positionRatioInView, item, itemAnchorPoint);
+    float viewLength = (_direction == Direction::HORIZONTAL ? _contentSize.width : _contentSize.height);
+    ssize_t anchorIndex = -1;
+    double anchorDistance = 0.0;
+    bool settled = (0 == _virtualItemCount);
+    for (int pass = 0; pass < MAX_VIRTUAL_LAYOUT_PASSES && !settled; ++pass)
+    {
+        double scrollOffset = getVirtualScrollOffset();
+        ssize_t firstIndex = findVirtualItem(scrollOffset);
+        ssize_t lastIndex = findVirtualItem(scrollOffset + viewLength);
+        if (-1 == anchorIndex)
+        {
+            anchorIndex = firstIndex;
+            anchorDistance = getVirtualItemOffset(firstIndex) - scrollOffset;
+        }
+
+        // Free the cells of the items out of view, then bind the items coming into view
+        for (size_t i = 0; i < _virtualCellIndices.size(); ++i)
+        {
+            ssize_t index = _virtualCellIndices[i];
+            if (-1 != index && (index < firstIndex || index > lastIndex))
+            {
+                _virtualCellIndices[i] = -1;
+                _virtualCells.at(i)->setVisible(false);
+            }
+        }
+        settled = true;
+        for (ssize_t index = firstIndex; index <= lastIndex; ++index)
+        {
+            if (nullptr == getItem(index))
+            {
+                float size = getItemLength(bindVirtualCell(index), _direction);
+                if (size != _virtualItemSizes[index])
+                {
+                    setVirtualItemSize(index, size);
+                    settled = false;
+                }
+            }
+        }
+
+        if (!settled)
+        {
+            // Keep the first item that was in view where it was on screen, the measured items may have moved it
+            setVirtualContentLength(getVirtualItemOffset(anchorIndex) - anchorDistance);
+        }
+    }
+
+    for (size_t i = 0; i < _virtualCellIndices.size(); ++i)
+    {
+        if (-1 != _virtualCellIndices[i])
+        {
+            placeVirtualCell(_virtualCells.at(i), _virtualCellIndices[i]);
+        }
+    }
+    _virtualLayoutPosition = _innerContainer->getPosition();
+    _virtualLayoutViewSize = _contentSize;
+    _innerContainerDoLayoutDirty = !settled;
+}
+
+Vec2 ListView::calculateVirtualItemDestination(const Vec2& positionRatioInView, ssize_t index, const Vec2& itemAnchorPoint)
+{
+    Vec2 destination = getInnerContainerPosition();
+    float offset = getVirtualItemOffset(index);
+    float size = _virtualItemSizes[index];
+    if (_direction == Direction::HORIZONTAL)
+    {
+        float itemPositionX = offset + size * itemAnchorPoint.x;
+        destination.x = -(itemPositionX - _contentSize.width * positionRatioInView.x);
+    }
+    else
+    {
+        float itemPositionY = _innerContainer->getContentSize().height - offset - size * (1.0f - itemAnchorPoint.y);
+        destination.y = -(itemPositionY - _contentSize.height * positionRatioInView.y);
+    }
+    return destination;
+}
+
+void ListView::jumpToItem(ssize_t itemIndex, const Vec2& positionRatioInView, const Vec2& itemAnchorPoint)
+{
+    Vec2 destination;
+    if (isVirtualized())
+    {
+        if (itemIndex < 0 || itemIndex >= _virtualItemCount)
+        {
+            return;
+        }
+        doLayout();
+        destination = calculateVirtualItemDestination(positionRatioInView, itemIndex, itemAnchorPoint);
+    }
+    else
+    {
+        Widget* item = getItem(itemIndex);
+        if (item == nullptr)
+        {
+            return;
+        }
+        doLayout();
+        destination = calculateItemDestination(positionRatioInView, item, itemAnchorPoint);
+    }
     if(!_bounceEnabled)
     {
         Vec2 delta = destination - getInnerContainerPosition();
@@ -878,6 +1276,16 @@ void ListView::scrollToItem(ssize_t itemIndex, const Vec2& positionRatioInView,
 
 void ListView::scrollToItem(ssize_t itemIndex, const Vec2& positionRatioInView, const Vec2& itemAnchorPoint, float timeInSec)
 {
+    if (isVirtualized())
+    {
+        if (itemIndex < 0 || itemIndex >= _virtualItemCount)
+        {
+            return;
+        }
+        Vec2 destination = calculateVirtualItemDestination(positionRatioInView, itemIndex, itemAnchorPoint);
+        startAutoScrollToDestination(destination, timeInSec, true);
+        return;
+    }
     Widget* item = getItem(itemIndex);
     if (item == nullptr)
     {
@@ -894,8 +1302,7 @@ ssize_t ListView::getCurSelectedIndex() const
 
 void ListView::setCurSelectedIndex(int itemIndex)
 {
-    Widget* item = getItem(itemIndex);
-    if (item == nullptr)
+    if (isVirtualized() ? (itemIndex < 0 || itemIndex >= _virtualItemCount) : (getItem(itemIndex) == nullptr))
     {
         return;
     }
@@ -940,6 +1347,11 @@ void ListView::copySpecialProperties(Widget *widget)
         _listViewEventListener = listViewEx->_listViewEventListener;
         _listViewEventSelector = listViewEx->_listViewEventSelector;
         _eventCallback = listViewEx->_eventCallback;
+        if (listViewEx->isVirtualized())
+        {
+            setEstimatedItemSize(listViewEx->_estimatedItemSize);
+            setItemProvider(listViewEx->_itemProvider);
+        }
     }
 }
 
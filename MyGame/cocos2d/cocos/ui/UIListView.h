@@ -57,7 +57,8 @@ typedef void (Ref::*SEL_ListViewEvent)(Ref*,ListViewEventType);
 /**
  *@brief ListView is a view group that displays a list of scrollable items.
  *The list items are inserted to the list by using `addChild` or  `insertDefaultItem`.
- * @warning The list item in ListView doesn't support cell reuse at the moment, if you have a large amount of data need to be displayed, use  `TableView` instead.
+ * @warning Inserted items are never reused, if you have a large amount of data need to be displayed, set an `ItemProvider` with `setItemProvider` instead.
+ * In that virtualized mode, the ListView only keeps the few widgets the view can show, and binds them to the items scrolled into view.
  * ListView is a subclass of  `ScrollView`, so it shares many features of ScrollView.
  */
 class CC_GUI_DLL ListView : public ScrollView
@@ -107,6 +108,19 @@ public:
      * ListView item click callback.
      */
     typedef std::function<void(Ref*, EventType)> ccListViewCallback;
+
+    /**
+     * Callbacks of a virtualized ListView, see `setItemProvider`.
+     */
+    struct ItemProvider
+    {
+        /** Returns the number of items, called by `reloadItems`. */
+        std::function<ssize_t()> getItemCount;
+        /** Creates a cell widget, optional: the item model is cloned if it isn't set. */
+        std::function<Widget*()> createItem;
+        /** Shows the item at an index in a cell, the cell keeps the size it has when this returns. */
+        std::function<void(ssize_t, Widget*)> bindItem;
+    };
     
     /**
      * Default constructor
@@ -202,6 +216,50 @@ public:
      * @return The index of a given widget in ListView.
      */
     ssize_t getIndex(Widget* item) const;
+
+    /**
+     * @brief Turn the ListView into a virtualized list of items provided by callbacks.
+     *
+     * The ListView creates only the cells needed to fill its view, and when the list scrolls, binds the cells
+     * that leave the view to the items that come into it, so that the number of widgets doesn't depend on
+     * the number of items. An item is measured along the scroll direction the first time it is bound, the items
+     * never bound are assumed to be as long as `getEstimatedItemSize`.
+     * While virtualized, `getItems` is empty, `getItem` and `getIndex` only know the items bound to a cell,
+     * and magnetic scroll is not applied. Pass an empty provider to leave the virtualized mode.
+     * @param provider The callbacks, `getItemCount` and `bindItem` must be set.
+     * @note The ListView must have no inserted item.
+     */
+    void setItemProvider(const ItemProvider& provider);
+
+    /**
+     * Query whether the items are provided by an `ItemProvider`.
+     */
+    bool isVirtualized() const { return _itemProvider.getItemCount != nullptr; }
+
+    /**
+     * @brief Get the number of items again and rebind the cells, scrolling back to the first item.
+     * Call it when items were added or removed.
+     */
+    void reloadItems();
+
+    /**
+     * Rebind and measure again an item whose content changed, if it is in view.
+     * @param index The index of the item.
+     */
+    void reloadItem(ssize_t index);
+
+    /**
+     * Set the size along the scroll direction assumed for the items that were never bound.
+     * If it is not greater than 0, the default, the first item is measured by `reloadItems` and its size is used.
+     * It is taken by the next `reloadItems`.
+     * @param size The estimated size in float.
+     */
+    void setEstimatedItemSize(float size);
+
+    /**
+     * Get the size assumed for the items that were never bound, see `setEstimatedItemSize`.
+     */
+    float getEstimatedItemSize() const { return _estimatedItemSize; }
     
     /**
      * Set the gravity of ListView.
@@ -487,6 +545,18 @@ protected:
     
     void startMagneticScroll();
     Vec2 calculateItemDestination(const Vec2& positionRatioInView, Widget* item, const Vec2& itemAnchorPoint);
+
+    void updateVirtualItems();
+    void clearVirtualCells();
+    ssize_t dequeueVirtualCell();
+    Widget* bindVirtualCell(ssize_t index);
+    void setVirtualItemSize(ssize_t index, float size);
+    double getVirtualItemOffset(ssize_t index) const;
+    ssize_t findVirtualItem(double offset) const;
+    double getVirtualScrollOffset() const;
+    void setVirtualContentLength(double scrollOffset);
+    void placeVirtualCell(Widget* cell, ssize_t index);
+    Vec2 calculateVirtualItemDestination(const Vec2& positionRatioInView, ssize_t index, const Vec2& itemAnchorPoint);
     
 protected:
     Widget* _model;
@@ -510,6 +580,16 @@ protected:
     ssize_t _curSelectedIndex;
 
     bool _innerContainerDoLayoutDirty;
+
+    ItemProvider _itemProvider;
+    ssize_t _virtualItemCount;
+    float _estimatedItemSize;
+    std::vector<float> _virtualItemSizes;       ///< size of each item along the scroll direction
+    std::vector<double> _virtualSizeTree;       ///< Fenwick tree of _virtualItemSizes, 1-based
+    Vector<Widget*> _virtualCells;
+    std::vector<ssize_t> _virtualCellIndices;   ///< item bound to each cell, -1 for the free cells
+    Vec2 _virtualLayoutPosition;                ///< inner container position the cells were last placed for
+    Size _virtualLayoutViewSize;
     
     Ref*       _listViewEventListener;
 #if defined(__GNUC__) && ((__GNUC__ >= 4) || ((__GNUC__ == 3) && (__GNUC_MINOR__ >= 1)))
@@ -0,0 +1,128 @@
+#!/usr/bin/python
+#-*- coding: UTF-8 -*-
+# ----------------------------------------------------------------------------
+# Build an asset pack that can be mounted with FileUtils::addAssetPack().
+#
+# License: MIT
+# ----------------------------------------------------------------------------
+'''
+Build an asset pack (.ccpk) from a resources directory.
+
+The layout matches cocos/base/CCAssetPack.h: a header, the entry table, the
+hash directory (crc32 of the name, linear probing), the name table and the
+file data. All the values are little endian.
+'''
+
+import os
+import struct
+import zlib
+
+from argparse import ArgumentParser
+
+MAGIC = 0x4b504343
+VERSION = 1
+
+COMPRESSION_NONE = 0
+COMPRESSION_ZLIB = 1
+
+HEADER_FORMAT = '<IIIIQQQQ'
+ENTRY_FORMAT = '<IIIIQQQ'
+
+# files that are compressed already, deflating them again is a waste of loading time
+COMPRESSED_EXTENSIONS = [
+    '.png', '.jpg', '.jpeg', '.webp', '.pkm', '.pvr', '.ccz', '.gz', '.zip',
+    '.mp3', '.ogg', '.m4a', '.aac', '.mp4', '.ttf', '.otf', '.ccpk'
+]
+
+# compress a file only when it saves more than this ratio of its size
+MIN_SAVING = 0.1
+
+
+def align(value, alignment):
+    return (value + alignment - 1) // alignment * alignment
+
+
+def collect_files(res_dir):
+    files = []
+    for root, dirs, names in os.walk(res_dir):
+        dirs.sort()
+        for name in sorted(names):
+            if name.startswith('.'):
+                continue
+            path = os.path.join(root, name)
+            files.append((os.path.relpath(path, res_dir).replace(os.sep, '/'), path))
+    return files
+
+
+def build_pack(res_dir, output, alignment, compress):
+    files = collect_files(res_dir)
+    count = len(files)
+
+    bucket_count = 1
+    while bucket_count < count * 2:
+        bucket_count *= 2
+
+    names = bytearray()
+    name_offsets = []
+    for name, _ in files:
+        encoded = name.encode('utf-8')
+        name_offsets.append((len(names), len(encoded), encoded))
+        names += encoded
+
+    entries_offset = struct.calcsize(HEADER_FORMAT)
+    buckets_offset = entries_offset + count * struct.calcsize(ENTRY_FORMAT)
+    names_offset = buckets_offset + bucket_count * 4
+    data_offset = align(names_offset + len(names), alignment)
+
+    entries = []
+    blobs = []
+    offset = data_offset
+    for (name, path), (name_offset, name_length, encoded) in zip(files, name_offsets):
+        with open(path, 'rb') as f:
+            data = f.read()
+
+        stored = data
+        compression = COMPRESSION_NONE
+        if compress and data and os.path.splitext(name)[1].lower() not in COMPRESSED_EXTENSIONS:
+            deflated = zlib.compress(data, 9)
+            if len(deflated) < len(data) * (1 - MIN_SAVING):
+                stored = deflated
+                compression = COMPRESSION_ZLIB
+
+        name_hash = zlib.crc32(encoded) & 0xffffffff
+        entries.append((name_hash, name_offset, name_length, compression, offset, len(stored), len(data)))
+        blobs.append((offset, stored))
+        offset = align(offset + len(stored), alignment)
+
+    buckets = [0] * bucket_count
+    for index, entry in enumerate(entries):
+        bucket = entry[0] & (bucket_count - 1)
+        while buckets[bucket] != 0:
+            bucket = (bucket + 1) & (bucket_count - 1)
+        buckets[bucket] = index + 1
+
+    with open(output, 'wb') as f:
+        f.write(struct.pack(HEADER_FORMAT, MAGIC, VERSION, count, bucket_count,
+                            entries_offset, buckets_offset, names_offset, len(names)))
+        for entry in entries:
+            f.write(struct.pack(ENTRY_FORMAT, *entry))
+        f.write(struct.pack('<%dI' % bucket_count, *buckets))
+        f.write(names)
+        for blob_offset, stored in blobs:
+            f.write(b'\0' * (blob_offset - f.tell()))
+            f.write(stored)
+
+    print('%d files packed into %s' % (count, output))
+
+
+if __name__ == '__main__':
+    parser = ArgumentParser(description='Build an asset pack for FileUtils::addAssetPack().')
+    parser.add_argument('res_dir', help='The resources directory to pack.')
+    parser.add_argument('output', help='The pack file to write.')
+    parser.add_argument('--align', dest='alignment', type=int, default=16,
+                        help='The alignment of the file data in the pack, 16 by default.')
+    parser.add_argument('--no-compress', dest='compress', action='store_false',
+                        help="Don't deflate any file.")
+    args = parser.parse_args()
+
+    build_pack(args.res_dir, args.output, args.alignment, args.compress)
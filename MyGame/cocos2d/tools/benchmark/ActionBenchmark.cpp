@@ -0,0 +1,95 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// Updates MoveBy, ScaleTo, RotateBy and FadeTo actions, half of them eased, on 10k nodes.
+
+#include "Benchmark.h"
+
+#include "cocos2d.h"
+
+USING_NS_CC;
+
+namespace {
+
+const int NODE_COUNT = 10000;
+const int FRAMES = 100;
+// the actions don't finish during the benchmark
+const float DURATION = 1000;
+
+// not the exact type ActionManager pools, so updated by the virtual ActionInterval::step() as before
+template <typename T>
+class VirtualAction : public T
+{
+public:
+    using T::initWithDuration;
+};
+
+template <typename T, typename... Args>
+ActionInterval* createAction(bool pooled, Args... args)
+{
+    T* action = pooled ? new (std::nothrow) T() : new (std::nothrow) VirtualAction<T>();
+    action->initWithDuration(DURATION, args...);
+    action->autorelease();
+    return action;
+}
+
+Scene* createScene(bool pooled)
+{
+    auto scene = Scene::create();
+    for (int i = 0; i < NODE_COUNT; ++i)
+    {
+        auto node = Node::create();
+        scene->addChild(node);
+
+        ActionInterval* action = nullptr;
+        switch (i % 4)
+        {
+        case 0: action = createAction<MoveBy>(pooled, Vec2(100, 50)); break;
+        case 1: action = createAction<ScaleTo>(pooled, 2.0f); break;
+        case 2: action = createAction<RotateBy>(pooled, 360.0f); break;
+        default: action = createAction<FadeTo>(pooled, (GLubyte)0); break;
+        }
+        if (i % 8 >= 4)
+            action = EaseInOut::create(action, 2);
+        node->runAction(action);
+    }
+    return scene;
+}
+
+} // namespace
+
+BENCHMARK(actions, "updates 10k nodes running interval actions, from the pools and through virtual calls")
+{
+    auto actionManager = Director::getInstance()->getActionManager();
+    for (const bool pooled : { false, true })
+    {
+        benchmark::runScene(createScene(pooled));
+        double time = benchmark::measure(FRAMES, [actionManager]() {
+            actionManager->update(1.0f / 60);
+        });
+        benchmark::report(pooled ? "ActionManager::update(), pooled" : "ActionManager::update(), virtual", time, "ms/frame");
+    }
+
+    benchmark::runScene(Scene::create());
+}
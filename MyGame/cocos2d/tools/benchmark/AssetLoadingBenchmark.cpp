@@ -0,0 +1,110 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// Reads every file of the resource root, loose and from an asset pack, the first pass and then warm.
+// The pack is --pack, res.ccpk by default, built with tools/asset-pack/build_asset_pack.py from the same resources.
+// The first pass starts with empty FileUtils caches and, for the pack, includes mounting it. Drop the caches
+// of the OS before running the benchmark (echo 3 > /proc/sys/vm/drop_caches on Linux) to read from the disk.
+
+#include "Benchmark.h"
+
+#include <stdio.h>
+#include <vector>
+
+#include "cocos2d.h"
+
+USING_NS_CC;
+
+namespace {
+
+const int WARM_PASSES = 10;
+
+std::vector<std::string> listResources(const std::string& packFile)
+{
+    auto fileUtils = FileUtils::getInstance();
+    const std::string root = fileUtils->getDefaultResourceRootPath();
+    std::vector<std::string> files;
+    fileUtils->listFilesRecursively(root, &files);
+
+    // relative to the resource root like the names the game loads, without the pack itself
+    std::vector<std::string> names;
+    for (const auto& file : files)
+    {
+        if (file.back() == '/' || file.compare(0, root.size(), root) != 0)
+            continue;
+        std::string name = file.substr(root.size());
+        if (name != packFile)
+            names.push_back(name);
+    }
+    return names;
+}
+
+ssize_t readAll(const std::vector<std::string>& names)
+{
+    auto fileUtils = FileUtils::getInstance();
+    ssize_t bytes = 0;
+    for (const auto& name : names)
+        bytes += fileUtils->getDataFromFile(name).getSize();
+    return bytes;
+}
+
+void measurePasses(const std::string& caseName, const std::vector<std::string>& names, const std::function<void()>& mount)
+{
+    auto fileUtils = FileUtils::getInstance();
+    fileUtils->purgeCachedEntries();
+
+    ssize_t bytes = 0;
+    double first = benchmark::measureOnce([&]() {
+        mount();
+        bytes = readAll(names);
+    });
+    double warm = benchmark::measure(WARM_PASSES, [&names]() {
+        readAll(names);
+    });
+    benchmark::report(caseName + ", size", bytes / 1024.0, "KB");
+    benchmark::report(caseName + ", first pass", first, "ms");
+    benchmark::report(caseName + ", warm pass", warm, "ms");
+}
+
+} // namespace
+
+BENCHMARK(asset_loading, "reads the resources loose and from an asset pack, the first pass and then warm")
+{
+    auto fileUtils = FileUtils::getInstance();
+    const std::string packFile = benchmark::getOption("pack", "res.ccpk");
+    auto names = listResources(packFile);
+    benchmark::report("files", (double)names.size(), "");
+
+    measurePasses("loose files", names, []() {});
+
+    if (!fileUtils->isFileExist(packFile))
+    {
+        printf("  no asset pack %s, build it with tools/asset-pack/build_asset_pack.py\n", packFile.c_str());
+        return;
+    }
+    measurePasses("asset pack", names, [fileUtils, &packFile]() {
+        fileUtils->addAssetPack(packFile);
+    });
+    fileUtils->removeAssetPack(packFile);
+}
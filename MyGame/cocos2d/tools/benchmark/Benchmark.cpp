@@ -0,0 +1,176 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+USING_NS_CC;
+
+namespace benchmark {
+
+namespace {
+
+struct Entry
+{
+    const char* name;
+    const char* description;
+    BenchmarkFunction function;
+};
+
+std::vector<Entry>& getEntries()
+{
+    static std::vector<Entry> entries;
+    return entries;
+}
+
+std::vector<std::string> s_options;
+std::vector<std::string> s_names;
+
+} // namespace
+
+Registrar::Registrar(const char* name, const char* description, BenchmarkFunction function)
+{
+    Entry entry = { name, description, function };
+    getEntries().push_back(entry);
+}
+
+void parseArguments(int argc, char** argv)
+{
+    // `--<name> <value>` are options, the other arguments name the benchmarks to run
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strncmp(argv[i], "--", 2) == 0 && i + 1 < argc)
+        {
+            s_options.push_back(argv[i] + 2);
+            s_options.push_back(argv[++i]);
+        }
+        else
+        {
+            s_names.push_back(argv[i]);
+        }
+    }
+}
+
+int runBenchmarks()
+{
+    auto& entries = getEntries();
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return strcmp(a.name, b.name) < 0;
+    });
+
+    int count = 0;
+    for (const auto& entry : entries)
+    {
+        if (!s_names.empty() && std::find(s_names.begin(), s_names.end(), entry.name) == s_names.end())
+            continue;
+
+        printf("%s: %s\n", entry.name, entry.description);
+        entry.function();
+        fflush(stdout);
+        ++count;
+    }
+
+    if (count == 0)
+    {
+        fprintf(stderr, "no benchmark to run, the benchmarks are:\n");
+        for (const auto& entry : entries)
+            fprintf(stderr, "  %s\n", entry.name);
+    }
+    return count;
+}
+
+std::string getOption(const std::string& name, const std::string& defaultValue)
+{
+    for (size_t i = 0; i + 1 < s_options.size(); i += 2)
+    {
+        if (s_options[i] == name)
+            return s_options[i + 1];
+    }
+    return defaultValue;
+}
+
+double measureOnce(const std::function<void()>& body)
+{
+    auto start = std::chrono::steady_clock::now();
+    body();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+double measure(int iterations, const std::function<void()>& body)
+{
+    body();
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+        body();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+double measureFrames(int frames)
+{
+    auto director = Director::getInstance();
+    auto glview = director->getOpenGLView();
+    auto frame = [director, glview]() {
+        director->mainLoop();
+        glview->pollEvents();
+    };
+
+    for (int i = 0; i < 10; ++i)
+        frame();
+    return measure(frames, frame);
+}
+
+void runScene(Scene* scene)
+{
+    auto director = Director::getInstance();
+    director->replaceScene(scene);
+    // the scene replaces the running one the next frame
+    director->mainLoop();
+    director->getOpenGLView()->pollEvents();
+}
+
+void runFramesUntil(const std::function<bool()>& done)
+{
+    auto director = Director::getInstance();
+    auto glview = director->getOpenGLView();
+    while (!done())
+    {
+        director->mainLoop();
+        glview->pollEvents();
+    }
+}
+
+void report(const std::string& caseName, double value, const char* unit)
+{
+    printf("  %-48s %12.3f %s\n", caseName.c_str(), value, unit);
+}
+
+} // namespace benchmark
@@ -0,0 +1,81 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+#include <functional>
+#include <string>
+
+#include "cocos2d.h"
+
+namespace benchmark {
+
+typedef void (*BenchmarkFunction)();
+
+/** Registers a benchmark, see BENCHMARK(). */
+struct Registrar
+{
+    Registrar(const char* name, const char* description, BenchmarkFunction function);
+};
+
+/** Reads the options and the names of the benchmarks to run from the command line. */
+void parseArguments(int argc, char** argv);
+
+/** Runs the benchmarks named on the command line, or all of them. Returns the number of benchmarks run. */
+int runBenchmarks();
+
+/** Returns the value following `--<name>` on the command line, or defaultValue. */
+std::string getOption(const std::string& name, const std::string& defaultValue);
+
+/** Performs body once. Returns its time in milliseconds. */
+double measureOnce(const std::function<void()>& body);
+
+/** Performs body once to warm up, then `iterations` times. Returns the mean time of an iteration in milliseconds. */
+double measure(int iterations, const std::function<void()>& body);
+
+/** Runs `frames` frames of the director after a few warm-up frames. Returns the mean time of a frame in milliseconds. */
+double measureFrames(int frames);
+
+/** Makes scene the running scene of the director, entered once this returns. */
+void runScene(cocos2d::Scene* scene);
+
+/** Runs frames of the director until done() returns true. */
+void runFramesUntil(const std::function<bool()>& done);
+
+/** Prints a result of the running benchmark. */
+void report(const std::string& caseName, double value, const char* unit);
+
+} // namespace benchmark
+
+/**
+ * Defines a benchmark run with the director and the GL view of the benchmark application:
+ *   BENCHMARK(png_decode, "decodes the PNG files of the resources") { ... }
+ */
+#define BENCHMARK(name, description) \
+    static void benchmark_##name(); \
+    static benchmark::Registrar benchmark_##name##_registrar(#name, description, benchmark_##name); \
+    static void benchmark_##name()
+
+#endif // __BENCHMARK_H__
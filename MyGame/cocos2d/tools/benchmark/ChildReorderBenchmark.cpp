@@ -0,0 +1,109 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// Changes the local Z order of a few children every frame, then sorts them, with Node::reorderChild() and
+// Node::sortAllChildren(), and the way they did it before: the children were sorted again every time.
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "cocos2d.h"
+
+USING_NS_CC;
+
+namespace {
+
+const int FRAMES = 1000;
+const int Z_ORDER_RANGE = 100;
+
+// the orders given to the children, the same for both implementations
+std::vector<std::pair<int, int>> createReorders(int childCount, int reordersPerFrame)
+{
+    std::mt19937 random(childCount);
+    std::uniform_int_distribution<int> childDistribution(0, childCount - 1);
+    std::uniform_int_distribution<int> zDistribution(0, Z_ORDER_RANGE - 1);
+    std::vector<std::pair<int, int>> reorders;
+    for (int i = 0; i < (FRAMES + 1) * reordersPerFrame; ++i)
+        reorders.push_back(std::make_pair(childDistribution(random), zDistribution(random)));
+    return reorders;
+}
+
+double measureReorders(int childCount, int reordersPerFrame)
+{
+    auto parent = Node::create();
+    std::vector<Node*> children;
+    for (int i = 0; i < childCount; ++i)
+    {
+        auto child = Node::create();
+        parent->addChild(child, i % Z_ORDER_RANGE);
+        children.push_back(child);
+    }
+
+    auto reorders = createReorders(childCount, reordersPerFrame);
+    size_t next = 0;
+    return benchmark::measure(FRAMES, [&]() {
+        for (int i = 0; i < reordersPerFrame; ++i, ++next)
+            children[reorders[next].first]->setLocalZOrder(reorders[next].second);
+        parent->sortAllChildren();
+    });
+}
+
+// the children aren't moved when reordered and sortNodes() always sorted them, as before
+double measureFormerReorders(int childCount, int reordersPerFrame)
+{
+    Vector<Node*> nodes;
+    for (int i = 0; i < childCount; ++i)
+    {
+        auto node = Node::create();
+        node->setLocalZOrder(i % Z_ORDER_RANGE);
+        nodes.pushBack(node);
+    }
+    std::sort(nodes.begin(), nodes.end(), Node::isNodeOrderLess);
+
+    auto reorders = createReorders(childCount, reordersPerFrame);
+    size_t next = 0;
+    return benchmark::measure(FRAMES, [&]() {
+        for (int i = 0; i < reordersPerFrame; ++i, ++next)
+            nodes.at(reorders[next].first)->setLocalZOrder(reorders[next].second);
+        std::sort(nodes.begin(), nodes.end(), Node::isNodeOrderLess);
+    });
+}
+
+} // namespace
+
+BENCHMARK(child_reorder, "reorders a few children of a node every frame, then sorts them")
+{
+    for (const int childCount : { 100, 1000 })
+    {
+        for (const int reordersPerFrame : { 1, 10, 100 })
+        {
+            std::string caseName = StringUtils::format("%d children, %d reordered", childCount, reordersPerFrame);
+            benchmark::report(caseName + ", sorted every frame", measureFormerReorders(childCount, reordersPerFrame) * 1000, "us/frame");
+            benchmark::report(caseName + ", kept sorted", measureReorders(childCount, reordersPerFrame) * 1000, "us/frame");
+        }
+    }
+}
@@ -0,0 +1,111 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// Decodes the PNG files of a folder, searched recursively, the resource root unless --png-dir is given.
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <vector>
+
+#include "cocos2d.h"
+
+USING_NS_CC;
+
+namespace {
+
+const int PASSES = 10;
+
+std::vector<std::string> findPNGFiles(const std::string& dir)
+{
+    auto fileUtils = FileUtils::getInstance();
+    std::vector<std::string> files;
+    fileUtils->listFilesRecursively(dir, &files);
+    files.erase(std::remove_if(files.begin(), files.end(), [fileUtils](const std::string& file) {
+        return fileUtils->getFileExtension(file) != ".png";
+    }), files.end());
+    return files;
+}
+
+void decode(const Data& data)
+{
+    auto image = new (std::nothrow) Image();
+    image->initWithImageData(data.getBytes(), data.getSize());
+    image->release();
+}
+
+} // namespace
+
+BENCHMARK(png_decode, "decodes a folder of PNG files serially, on the JobSystem and with TextureCache::addImageAsync")
+{
+    auto fileUtils = FileUtils::getInstance();
+    std::string dir = benchmark::getOption("png-dir", fileUtils->getDefaultResourceRootPath());
+    auto files = findPNGFiles(dir);
+    if (files.empty())
+    {
+        printf("  no PNG file in %s\n", dir.c_str());
+        return;
+    }
+
+    std::vector<Data> contents;
+    ssize_t bytes = 0;
+    for (const auto& file : files)
+    {
+        contents.push_back(fileUtils->getDataFromFile(file));
+        bytes += contents.back().getSize();
+    }
+    benchmark::report("files", (double)files.size(), "");
+    benchmark::report("size", bytes / 1024.0, "KB");
+
+    // the single loading thread of the texture cache used to decode the images one after the other
+    double serial = benchmark::measure(PASSES, [&contents]() {
+        for (const auto& data : contents)
+            decode(data);
+    });
+    benchmark::report("serial decode", serial, "ms/pass");
+
+    auto jobSystem = JobSystem::getInstance();
+    double parallel = benchmark::measure(PASSES, [&contents, jobSystem]() {
+        std::vector<JobSystem::JobHandle> jobs;
+        jobs.reserve(contents.size());
+        for (const auto& data : contents)
+            jobs.push_back(jobSystem->schedule([&data]() { decode(data); }));
+        for (const auto& job : jobs)
+            jobSystem->wait(job);
+    });
+    benchmark::report(StringUtils::format("JobSystem decode, %u workers", jobSystem->getWorkerCount()), parallel, "ms/pass");
+    benchmark::report("speed-up", serial / parallel, "x");
+
+    // reads, decodes and uploads the textures, the uploads are spread over frames by the upload budget
+    auto textureCache = Director::getInstance()->getTextureCache();
+    double async = benchmark::measure(PASSES, [&files, textureCache]() {
+        size_t loaded = 0;
+        for (const auto& file : files)
+            textureCache->addImageAsync(file, [&loaded](Texture2D*) { ++loaded; });
+        benchmark::runFramesUntil([&loaded, &files]() { return loaded == files.size(); });
+        textureCache->removeAllTextures();
+    });
+    benchmark::report("TextureCache::addImageAsync", async, "ms/pass");
+}
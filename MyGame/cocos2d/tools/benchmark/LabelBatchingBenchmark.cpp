@@ -0,0 +1,86 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// Draws 100 TTF labels of one font, a third of them outlined and a third shadowed, and counts the draw calls.
+// The labels given the former label programs take the former CustomCommand path, one draw call per pass and label.
+// Their colors are left unset, they only count the draw calls.
+
+#include "Benchmark.h"
+
+#include <stdio.h>
+
+#include "cocos2d.h"
+
+USING_NS_CC;
+
+namespace {
+
+const int LABEL_COUNT = 100;
+const int FRAMES = 100;
+
+Scene* createScene(const std::string& fontFile, bool batched)
+{
+    auto scene = Scene::create();
+    for (int i = 0; i < LABEL_COUNT; ++i)
+    {
+        auto label = Label::createWithTTF(StringUtils::format("Score %d", i * 37), fontFile, 24);
+        label->setPosition(Vec2(48 + (i % 10) * 96.0f, 32 + (i / 10) * 64.0f));
+        if (i % 3 == 1)
+            label->enableOutline(Color4B::BLACK, 2);
+        else if (i % 3 == 2)
+            label->enableShadow();
+
+        if (!batched)
+        {
+            const char* programName = (i % 3 == 1) ? GLProgram::SHADER_NAME_LABEL_OUTLINE : GLProgram::SHADER_NAME_LABEL_NORMAL;
+            label->setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(programName));
+        }
+        scene->addChild(label);
+    }
+    return scene;
+}
+
+} // namespace
+
+BENCHMARK(label_batching, "draws 100 TTF labels of one font, batched and through the former per-label draws")
+{
+    const std::string fontFile = benchmark::getOption("font", "fonts/arial.ttf");
+    if (!FileUtils::getInstance()->isFileExist(fontFile))
+    {
+        printf("  no font %s\n", fontFile.c_str());
+        return;
+    }
+
+    auto renderer = Director::getInstance()->getRenderer();
+    for (const bool batched : { false, true })
+    {
+        benchmark::runScene(createScene(fontFile, batched));
+        double time = benchmark::measureFrames(FRAMES);
+        const char* caseName = batched ? "batched" : "one command per label";
+        benchmark::report(StringUtils::format("%s, draw calls", caseName), (double)renderer->getDrawnBatches(), "");
+        benchmark::report(StringUtils::format("%s, frame", caseName), time, "ms/frame");
+    }
+
+    benchmark::runScene(Scene::create());
+}
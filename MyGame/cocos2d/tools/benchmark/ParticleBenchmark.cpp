@@ -0,0 +1,97 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// Updates and draws 50 emitters of 2,000 particles.
+// The engine built with CC_USE_PARTICLE_SIMD=0 gives the numbers of the scalar loops.
+
+#include "Benchmark.h"
+
+#include <stdio.h>
+#include <vector>
+
+#include "cocos2d.h"
+
+USING_NS_CC;
+
+namespace {
+
+const int EMITTER_COUNT = 50;
+const int PARTICLES_PER_EMITTER = 2000;
+const int FRAMES = 100;
+
+std::vector<ParticleSystemQuad*> createEmitters(Scene* scene)
+{
+    std::vector<ParticleSystemQuad*> emitters;
+    for (int i = 0; i < EMITTER_COUNT; ++i)
+    {
+        auto emitter = ParticleFire::createWithTotalParticles(PARTICLES_PER_EMITTER);
+        // all the particles are alive, and stay alive for the whole benchmark
+        emitter->setLife(1000);
+        emitter->setLifeVar(0);
+        emitter->addParticles(PARTICLES_PER_EMITTER);
+        emitter->setPosition(Vec2(48 + (i % 10) * 96.0f, 64 + (i / 10) * 128.0f));
+        scene->addChild(emitter);
+        emitters.push_back(emitter);
+    }
+    return emitters;
+}
+
+} // namespace
+
+BENCHMARK(particles, "updates and draws 50 emitters of 2,000 particles")
+{
+    benchmark::report("CC_USE_PARTICLE_SIMD", CC_USE_PARTICLE_SIMD, "");
+
+    auto scene = Scene::create();
+    auto emitters = createEmitters(scene);
+    benchmark::runScene(scene);
+
+    // ParticleSystem::update() only, the SIMD integration and the parallel ranges
+    const bool parallelUpdateEnabled = ParticleSystem::isParallelUpdateEnabled();
+    for (const bool parallel : { false, true })
+    {
+        ParticleSystem::setParallelUpdateEnabled(parallel);
+        double time = benchmark::measure(FRAMES, [&emitters]() {
+            for (auto emitter : emitters)
+                emitter->update(1.0f / 60);
+        });
+        benchmark::report(parallel ? "update, parallel" : "update", time, "ms/frame");
+    }
+    ParticleSystem::setParallelUpdateEnabled(parallelUpdateEnabled);
+
+    // whole frames, the particles drawn as quads or as instances
+    benchmark::report("frame, quads", benchmark::measureFrames(FRAMES), "ms/frame");
+    if (ParticleSystemQuad::isInstancingSupported())
+    {
+        for (auto emitter : emitters)
+            emitter->setInstancingEnabled(true);
+        benchmark::report("frame, instances", benchmark::measureFrames(FRAMES), "ms/frame");
+    }
+    else
+    {
+        printf("  instancing isn't supported\n");
+    }
+
+    benchmark::runScene(Scene::create());
+}
@@ -0,0 +1,99 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// Computes the world transforms of a scene of 20k nodes, of which a varying ratio moves every frame.
+
+#include "Benchmark.h"
+
+#include <vector>
+
+#include "cocos2d.h"
+
+USING_NS_CC;
+
+namespace {
+
+const int GROUP_COUNT = 100;
+const int NODES_PER_GROUP = 199;
+const int ITERATIONS = 100;
+
+Scene* createScene(std::vector<Node*>* movingNodes)
+{
+    auto scene = Scene::create();
+    for (int g = 0; g < GROUP_COUNT; ++g)
+    {
+        auto group = Node::create();
+        group->setPosition(Vec2(g * 9.0f, 0));
+        scene->addChild(group);
+        for (int n = 0; n < NODES_PER_GROUP; ++n)
+        {
+            auto node = Node::create();
+            node->setContentSize(Size(8, 8));
+            node->setPosition(Vec2(0, n * 3.0f));
+            node->setRotation(n % 360);
+            group->addChild(node);
+            movingNodes->push_back(node);
+        }
+    }
+    return scene;
+}
+
+} // namespace
+
+BENCHMARK(transform_hierarchy, "renders a scene of 20k nodes with and without a (parallel) TransformHierarchy")
+{
+    const int dirtyPercents[] = { 0, 1, 10, 50, 100 };
+    enum Mode { VISIT, HIERARCHY, PARALLEL_HIERARCHY };
+    const char* modeNames[] = { "Node::visit()", "TransformHierarchy", "TransformHierarchy, parallel" };
+
+    auto renderer = Director::getInstance()->getRenderer();
+    for (int mode = VISIT; mode <= PARALLEL_HIERARCHY; ++mode)
+    {
+        std::vector<Node*> nodes;
+        auto scene = createScene(&nodes);
+        if (mode != VISIT)
+        {
+            scene->setTransformHierarchyEnabled(true);
+            scene->getTransformHierarchy()->setParallelUpdateEnabled(mode == PARALLEL_HIERARCHY);
+        }
+        benchmark::runScene(scene);
+
+        for (const int percent : dirtyPercents)
+        {
+            // moves back and forth the given percentage of the nodes, spread over the groups
+            float offset = 0;
+            double time = benchmark::measure(ITERATIONS, [&]() {
+                offset = 1 - offset;
+                for (size_t i = 0; i < nodes.size(); ++i)
+                {
+                    if ((i + 1) * percent / 100 != i * percent / 100)
+                        nodes[i]->setPositionX(offset);
+                }
+                scene->render(renderer, Mat4::IDENTITY);
+            });
+            benchmark::report(StringUtils::format("%s, %d%% dirty", modeNames[mode], percent), time, "ms/frame");
+        }
+    }
+    benchmark::runScene(Scene::create());
+}
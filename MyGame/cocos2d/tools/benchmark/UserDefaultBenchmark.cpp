@@ -0,0 +1,152 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// 10,000 sets then 10,000 gets of 100 integer keys, with UserDefault and with the former implementation,
+// which parsed the XML file for every get and set and saved it for every set.
+
+#include "Benchmark.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "cocos2d.h"
+#include "tinyxml2/tinyxml2.h"
+
+USING_NS_CC;
+
+namespace {
+
+const int KEY_COUNT = 100;
+const int OPERATION_COUNT = 10000;
+
+// the former UserDefault, on its own file
+class XMLFileStore
+{
+public:
+    explicit XMLFileStore(const std::string& filePath) : _filePath(filePath) {}
+
+    int getIntegerForKey(const char* key, int defaultValue)
+    {
+        tinyxml2::XMLDocument doc;
+        tinyxml2::XMLElement* rootNode;
+        auto node = findNode(key, &doc, &rootNode);
+        if (node && node->FirstChild())
+            return atoi(node->FirstChild()->Value());
+        return defaultValue;
+    }
+
+    void setIntegerForKey(const char* key, int value)
+    {
+        tinyxml2::XMLDocument doc;
+        tinyxml2::XMLElement* rootNode;
+        auto node = findNode(key, &doc, &rootNode);
+        auto text = StringUtils::toString(value);
+        if (node)
+        {
+            if (node->FirstChild())
+                node->FirstChild()->SetValue(text.c_str());
+            else
+                node->LinkEndChild(doc.NewText(text.c_str()));
+        }
+        else
+        {
+            node = doc.NewElement(key);
+            rootNode->LinkEndChild(node);
+            node->LinkEndChild(doc.NewText(text.c_str()));
+        }
+        doc.SaveFile(FileUtils::getInstance()->getSuitableFOpen(_filePath).c_str());
+    }
+
+private:
+    tinyxml2::XMLElement* findNode(const char* key, tinyxml2::XMLDocument* doc, tinyxml2::XMLElement** rootNode)
+    {
+        std::string xmlBuffer = FileUtils::getInstance()->getStringFromFile(_filePath);
+        *rootNode = nullptr;
+        if (!xmlBuffer.empty())
+        {
+            doc->Parse(xmlBuffer.c_str(), xmlBuffer.size());
+            *rootNode = doc->RootElement();
+        }
+        if (!*rootNode)
+        {
+            doc->LinkEndChild(doc->NewDeclaration(nullptr));
+            *rootNode = doc->NewElement("userDefaultRoot");
+            doc->LinkEndChild(*rootNode);
+        }
+
+        auto node = (*rootNode)->FirstChildElement();
+        while (node && strcmp(node->Value(), key) != 0)
+            node = node->NextSiblingElement();
+        return node;
+    }
+
+    std::string _filePath;
+};
+
+} // namespace
+
+BENCHMARK(user_default, "10,000 sets and gets of UserDefault and of the former XML file store")
+{
+    std::vector<std::string> keys;
+    for (int i = 0; i < KEY_COUNT; ++i)
+        keys.push_back(StringUtils::format("benchmark_key_%d", i));
+
+    int sum = 0;
+    auto userDefault = UserDefault::getInstance();
+    double set = benchmark::measure(1, [&keys, userDefault]() {
+        for (int i = 0; i < OPERATION_COUNT; ++i)
+            userDefault->setIntegerForKey(keys[i % KEY_COUNT].c_str(), i);
+        userDefault->flush();
+    });
+    double get = benchmark::measure(1, [&keys, userDefault, &sum]() {
+        for (int i = 0; i < OPERATION_COUNT; ++i)
+            sum += userDefault->getIntegerForKey(keys[i % KEY_COUNT].c_str(), 0);
+    });
+    for (const auto& key : keys)
+        userDefault->deleteValueForKey(key.c_str());
+    userDefault->flush();
+    benchmark::report("UserDefault, 10k sets and a flush", set, "ms");
+    benchmark::report("UserDefault, 10k gets", get, "ms");
+
+    auto fileUtils = FileUtils::getInstance();
+    std::string filePath = fileUtils->getWritablePath() + "UserDefaultBenchmark.xml";
+    XMLFileStore store(filePath);
+    double xmlSet = benchmark::measure(1, [&keys, &store]() {
+        for (int i = 0; i < OPERATION_COUNT; ++i)
+            store.setIntegerForKey(keys[i % KEY_COUNT].c_str(), i);
+    });
+    double xmlGet = benchmark::measure(1, [&keys, &store, &sum]() {
+        for (int i = 0; i < OPERATION_COUNT; ++i)
+            sum += store.getIntegerForKey(keys[i % KEY_COUNT].c_str(), 0);
+    });
+    fileUtils->removeFile(filePath);
+    benchmark::report("XML file store, 10k sets", xmlSet, "ms");
+    benchmark::report("XML file store, 10k gets", xmlGet, "ms");
+
+    // keeps the gets from being optimized away
+    if (sum == -1)
+        printf("  %d\n", sum);
+}
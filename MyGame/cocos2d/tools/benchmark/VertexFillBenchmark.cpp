@@ -0,0 +1,110 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// Fills the vertices of batched triangles: the transform kernel alone, then whole frames of 10k sprites.
+
+#include "Benchmark.h"
+
+#include <string.h>
+#include <vector>
+
+#include "cocos2d.h"
+
+USING_NS_CC;
+
+namespace {
+
+const int KERNEL_VERTEX_COUNT = 65536;
+const int KERNEL_ITERATIONS = 100;
+const int SPRITE_COUNT = 10000;
+const int FRAMES = 100;
+
+// copies and transforms the vertices of commands of verticesPerCommand vertices each, like Renderer::fillVerticesAndIndices()
+double measureKernel(int verticesPerCommand, bool transformPoints)
+{
+    std::vector<V3F_C4B_T2F> src(KERNEL_VERTEX_COUNT);
+    std::vector<V3F_C4B_T2F> dst(KERNEL_VERTEX_COUNT);
+    for (int i = 0; i < KERNEL_VERTEX_COUNT; ++i)
+        src[i].vertices = Vec3((float)(i % 960), (float)(i % 640), 0);
+
+    Mat4 modelView;
+    Mat4::createRotationZ(0.3f, &modelView);
+    modelView.translate(10, 20, 0);
+
+    double time = benchmark::measure(KERNEL_ITERATIONS, [&]() {
+        for (int start = 0; start < KERNEL_VERTEX_COUNT; start += verticesPerCommand)
+        {
+            V3F_C4B_T2F* verts = &dst[start];
+            memcpy(verts, &src[start], sizeof(V3F_C4B_T2F) * verticesPerCommand);
+            if (transformPoints)
+            {
+                modelView.transformPoints(&verts->vertices, &verts->vertices, verticesPerCommand, sizeof(V3F_C4B_T2F));
+            }
+            else
+            {
+                for (int i = 0; i < verticesPerCommand; ++i)
+                    modelView.transformPoint(&verts[i].vertices);
+            }
+        }
+    });
+    return KERNEL_VERTEX_COUNT / (time * 1000);
+}
+
+} // namespace
+
+BENCHMARK(vertex_fill, "transforms the vertices of batched triangles, alone and in frames of 10k sprites")
+{
+    for (const int verticesPerCommand : { 4, 256 })
+    {
+        benchmark::report(StringUtils::format("Mat4::transformPoint(), %d vertices/command", verticesPerCommand),
+                          measureKernel(verticesPerCommand, false), "Mvertices/s");
+        benchmark::report(StringUtils::format("Mat4::transformPoints(), %d vertices/command", verticesPerCommand),
+                          measureKernel(verticesPerCommand, true), "Mvertices/s");
+    }
+
+    auto scene = Scene::create();
+    for (int i = 0; i < SPRITE_COUNT; ++i)
+    {
+        auto sprite = Sprite::create();
+        sprite->setTextureRect(Rect(0, 0, 8, 8));
+        sprite->setPosition(Vec2((float)(i * 7 % 960), (float)(i * 13 % 640)));
+        sprite->setRotation((float)(i % 360));
+        scene->addChild(sprite);
+    }
+    benchmark::runScene(scene);
+
+    auto renderer = Director::getInstance()->getRenderer();
+    const bool parallelFillEnabled = renderer->isParallelVertexFillEnabled();
+    for (const bool parallel : { false, true })
+    {
+        renderer->setParallelVertexFillEnabled(parallel);
+        double time = benchmark::measureFrames(FRAMES);
+        benchmark::report(parallel ? "10k sprites, parallel fill" : "10k sprites", time, "ms/frame");
+        benchmark::report(parallel ? "10k sprites, parallel fill" : "10k sprites",
+                          renderer->getDrawnVertices() / (time * 1000), "Mvertices/s");
+    }
+    renderer->setParallelVertexFillEnabled(parallelFillEnabled);
+
+    benchmark::runScene(Scene::create());
+}
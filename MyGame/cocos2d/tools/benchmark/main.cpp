@@ -0,0 +1,78 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// Runs the engine benchmarks in a window and prints their results:
+//   benchmark [--resources <resource folder>] [--<option> <value>...] [benchmark name...]
+
+#include "cocos2d.h"
+#include "Benchmark.h"
+
+USING_NS_CC;
+
+namespace {
+
+class BenchmarkApplication : public Application
+{
+public:
+    virtual void initGLContextAttrs() override
+    {
+        GLContextAttrs glContextAttrs = {8, 8, 8, 8, 24, 8, 0};
+        GLView::setGLContextAttrs(glContextAttrs);
+    }
+
+    virtual bool applicationDidFinishLaunching() override
+    {
+        auto director = Director::getInstance();
+        auto glview = GLViewImpl::createWithRect("benchmark", Rect(0, 0, 960, 640));
+        director->setOpenGLView(glview);
+        glview->setDesignResolutionSize(960, 640, ResolutionPolicy::SHOW_ALL);
+        // frames are not paced by the display
+        glfwSwapInterval(0);
+
+        director->runWithScene(Scene::create());
+        director->mainLoop();
+
+        benchmark::runBenchmarks();
+
+        // the window is closed and the director purged by the next frame of Application::run()
+        director->end();
+        return true;
+    }
+
+    virtual void applicationDidEnterBackground() override {}
+    virtual void applicationWillEnterForeground() override {}
+};
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    benchmark::parseArguments(argc, argv);
+
+    BenchmarkApplication app;
+    std::string resources = benchmark::getOption("resources", "");
+    if (!resources.empty())
+        FileUtils::getInstance()->setDefaultResourceRootPath(resources);
+    return Application::getInstance()->run();
+}
@@ -0,0 +1,88 @@
+#!/usr/bin/python
+#-*- coding: UTF-8 -*-
+# ----------------------------------------------------------------------------
+# Bake TTF fonts into distance field fonts that FontAtlasCache loads instead.
+#
+# License: MIT
+# ----------------------------------------------------------------------------
+'''
+Bake the distance field fonts (.sdf) of TTF fonts, as a build step.
+
+The baking is done by FontSDF::bake() in the engine, so that the pages are
+rendered exactly as the engine would. It is run by the bake_sdf_font tool, built
+from this directory with the desktop builds, as
+"bake_sdf_font <font file> <font size> <charset file> <output file>", which
+prints why a font couldn't be baked. Every font is written next to itself,
+"fonts/arial.ttf" gives "fonts/arial.sdf", which is where
+FontSDF::getBakedFilePath() looks for it.
+'''
+
+import os
+import subprocess
+import sys
+
+from argparse import ArgumentParser
+
+FONT_EXTENSIONS = ['.ttf', '.otf']
+
+# the printable ASCII characters, baked when no charset file is given
+DEFAULT_CHARSET = ''.join(chr(c) for c in range(32, 127))
+
+
+def collect_fonts(paths):
+    fonts = []
+    for path in paths:
+        if os.path.isdir(path):
+            for root, dirs, names in os.walk(path):
+                dirs.sort()
+                for name in sorted(names):
+                    if os.path.splitext(name)[1].lower() in FONT_EXTENSIONS:
+                        fonts.append(os.path.join(root, name))
+        else:
+            fonts.append(path)
+    return fonts
+
+
+def bake_fonts(baker, paths, font_size, charset_file):
+    fonts = collect_fonts(paths)
+    if not fonts:
+        print('no font to bake')
+        return True
+
+    temporary_charset = None
+    if charset_file is None:
+        temporary_charset = os.path.abspath('.sdf_charset.txt')
+        with open(temporary_charset, 'wb') as f:
+            f.write(DEFAULT_CHARSET.encode('utf-8'))
+        charset_file = temporary_charset
+
+    succeeded = True
+    try:
+        for font in fonts:
+            output = os.path.splitext(font)[0] + '.sdf'
+            command = [baker, os.path.abspath(font), str(font_size),
+                       os.path.abspath(charset_file), os.path.abspath(output)]
+            if subprocess.call(command) != 0:
+                print('failed to bake %s' % font)
+                succeeded = False
+            else:
+                print('%s baked into %s' % (font, output))
+    finally:
+        if temporary_charset is not None:
+            os.remove(temporary_charset)
+
+    return succeeded
+
+
+if __name__ == '__main__':
+    parser = ArgumentParser(description='Bake distance field fonts with FontSDF::bake().')
+    parser.add_argument('baker', help='The bake_sdf_font tool of a desktop build.')
+    parser.add_argument('fonts', nargs='+', help='The fonts to bake, or directories searched for .ttf and .otf files.')
+    parser.add_argument('--size', dest='font_size', type=float, default=48,
+                        help='The size in pixels the glyphs are rasterized at, 48 by default.')
+    parser.add_argument('--charset', dest='charset_file',
+                        help='A UTF-8 file with the characters to bake, the printable ASCII characters by default.')
+    args = parser.parse_args()
+
+    if not bake_fonts(args.baker, args.fonts, args.font_size, args.charset_file):
+        sys.exit(1)
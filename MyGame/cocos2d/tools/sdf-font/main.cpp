@@ -0,0 +1,65 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// Bakes a TTF font into a distance field font with FontSDF::bake(), run at build time by bake_sdf_fonts.py:
+//   bake_sdf_font <font file> <font size> <UTF-8 charset file> <output file>
+
+#include "cocos2d.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+USING_NS_CC;
+
+int main(int argc, char **argv)
+{
+    if (argc != 5)
+    {
+        fprintf(stderr, "usage: %s <font file> <font size> <UTF-8 charset file> <output file>\n", argv[0]);
+        return 2;
+    }
+
+    const float fontSize = (float)atof(argv[2]);
+    if (fontSize <= 0)
+    {
+        fprintf(stderr, "invalid font size %s\n", argv[2]);
+        return 2;
+    }
+
+    std::string charset = FileUtils::getInstance()->getStringFromFile(argv[3]);
+    if (charset.empty())
+    {
+        fprintf(stderr, "can't read the charset %s\n", argv[3]);
+        return 1;
+    }
+
+    std::string errorMessage;
+    if (!FontSDF::bake(argv[1], fontSize, charset, argv[4], &errorMessage))
+    {
+        fprintf(stderr, "can't bake %s: %s\n", argv[1], errorMessage.c_str());
+        return 1;
+    }
+    return 0;
+}